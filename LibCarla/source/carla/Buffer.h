@@ -13,6 +13,7 @@
 #include <boost/asio/buffer.hpp>
 
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <memory>
 #include <type_traits>
@@ -270,9 +271,11 @@ namespace carla {
     void resize(uint64_t size) {
       if(_capacity < size) {
         std::unique_ptr<value_type[]> data = std::move(_data);
-        uint64_t old_size = size;
+        const size_type old_size = _size;
         reset(size);
-        copy_from(data.get(), static_cast<size_type>(old_size));
+        if (old_size > 0u) {
+          std::memcpy(_data.get(), data.get(), old_size);
+        }
       }
       _size = static_cast<size_type>(size);
     }
@@ -0,0 +1,85 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/BufferPool.h"
+
+#include "carla/Debug.h"
+#include "carla/Logging.h"
+
+#include <algorithm>
+
+#if defined(__linux__)
+#  include <sys/mman.h>
+#endif
+
+namespace carla {
+
+  // ===========================================================================
+  // -- Static local methods ---------------------------------------------------
+  // ===========================================================================
+
+  /// Ask the kernel to back the huge-page-aligned part of @a data with
+  /// transparent huge pages. Only a hint, failures are ignored.
+  static void AdviseHugePages(unsigned char *data, size_t size) {
+#if defined(MADV_HUGEPAGE)
+    constexpr uintptr_t huge_page_size = 2u * 1024u * 1024u;
+    const auto begin = reinterpret_cast<uintptr_t>(data);
+    const auto end = begin + size;
+    const auto aligned_begin = (begin + huge_page_size - 1u) & ~(huge_page_size - 1u);
+    const auto aligned_end = end & ~(huge_page_size - 1u);
+    if (aligned_begin < aligned_end) {
+      if (madvise(reinterpret_cast<void *>(aligned_begin), aligned_end - aligned_begin, MADV_HUGEPAGE) != 0) {
+        log_debug("buffer pool: huge pages not available");
+      }
+    }
+#else
+    (void) data;
+    (void) size;
+#endif // MADV_HUGEPAGE
+  }
+
+  // ===========================================================================
+  // -- BufferPool -------------------------------------------------------------
+  // ===========================================================================
+
+  std::shared_ptr<BufferPool> BufferPool::GetDefault() {
+    static auto pool = []() {
+      auto result = std::make_shared<BufferPool>();
+      // Sensor streams keep several frames in flight each, bound the memory
+      // kept around once they are gone.
+      result->SetMaxBytesHeld(512u * 1024u * 1024u);
+      result->SetHugePageThreshold(4u * 1024u * 1024u);
+      return result;
+    }();
+    return pool;
+  }
+
+  void BufferPool::Trim(const size_t max_bytes) {
+    Buffer item;
+    for (auto i = NumberOfSizeClasses; i > 0u && _bytes_held > max_bytes; --i) {
+      while ((_bytes_held > max_bytes) && _queues[i - 1u].try_dequeue(item)) {
+        _buffers_held.fetch_sub(1u);
+        _bytes_held.fetch_sub(item.capacity());
+        ++_trimmed;
+        // Deletes the memory without returning it to the pool.
+        item.clear();
+      }
+    }
+  }
+
+  void BufferPool::Allocate(Buffer &buffer, const size_t size) const {
+    DEBUG_ASSERT(size > 0u);
+    const size_t rounded = std::max(size_t(1u) << SizeClassOf(size), size);
+    const auto capacity = static_cast<uint64_t>(
+        std::min<size_t>(rounded, Buffer::max_size()));
+    buffer.reset(capacity);
+    const size_t threshold = _huge_page_threshold;
+    if ((threshold > 0u) && (capacity >= threshold)) {
+      AdviseHugePages(buffer.data(), buffer.size());
+    }
+  }
+
+} // namespace carla
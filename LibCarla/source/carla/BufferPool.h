@@ -17,6 +17,10 @@
 #  pragma clang diagnostic pop
 #endif
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 
 namespace carla {
@@ -24,20 +28,67 @@ namespace carla {
   /// A pool of Buffer. Buffers popped from this pool automatically return to
   /// the pool on destruction so the allocated memory can be reused.
   ///
+  /// Buffers are kept in power-of-two size classes by capacity, so a Pop
+  /// requesting a given size gets a buffer that is already big enough if there
+  /// is any. The memory held by the pool can be bounded with SetMaxBytesHeld,
+  /// buffers returning to a pool above its limit are deleted instead.
+  ///
   /// @warning Buffers adjust their size only by growing, they never shrink
-  /// unless explicitly cleared. The allocated memory is only deleted when this
-  /// pool is destroyed.
+  /// unless explicitly cleared.
   class BufferPool : public std::enable_shared_from_this<BufferPool> {
   public:
 
+    struct Stats {
+      /// Pops served with a buffer already in the pool.
+      uint64_t hits;
+      /// Pops that had to return a new buffer.
+      uint64_t misses;
+      /// Buffers deleted instead of returned to the pool, because of the
+      /// memory limit or Trim.
+      uint64_t trimmed;
+      /// Number of buffers currently in the pool.
+      size_t buffers_held;
+      /// Capacity in bytes of the buffers currently in the pool.
+      size_t bytes_held;
+    };
+
     BufferPool() = default;
 
-    explicit BufferPool(size_t estimated_size) : _queue(estimated_size) {}
+    explicit BufferPool(size_t estimated_size) {
+      for (auto &queue : _queues) {
+        queue = moodycamel::ConcurrentQueue<Buffer>(estimated_size);
+      }
+    }
+
+    /// Process-wide pool shared by streaming, multi-GPU and serializers.
+    static std::shared_ptr<BufferPool> GetDefault();
 
     /// Pop a Buffer from the queue, creates a new one if the queue is empty.
-    Buffer Pop() {
+    ///
+    /// If @a size is given, the returned buffer has at least this capacity,
+    /// new buffers are allocated rounded up to the next power of two so they
+    /// can be reused for messages of similar size. The size of the returned
+    /// buffer is unspecified, use reset or copy_from to set its contents.
+    Buffer Pop(size_t size = 0u) {
       Buffer item;
-      _queue.try_dequeue(item); // we don't care if it fails.
+      const auto first = SizeClassOf(size);
+      const auto last = std::min(first + MaxSizeClassesToSkip, NumberOfSizeClasses);
+      // Without a size any buffer will do, start from the smallest.
+      const auto end = (size == 0u) ? NumberOfSizeClasses : last;
+      bool found = false;
+      for (auto i = first; i < end && !found; ++i) {
+        found = _queues[i].try_dequeue(item);
+      }
+      if (found) {
+        ++_hits;
+        _buffers_held.fetch_sub(1u);
+        _bytes_held.fetch_sub(item.capacity());
+      } else {
+        ++_misses;
+        if (size > 0u) {
+          Allocate(item, size);
+        }
+      }
 #if __cplusplus >= 201703L // C++17
       item._parent_pool = weak_from_this();
 #else
@@ -46,15 +97,92 @@ namespace carla {
       return item;
     }
 
+    /// Limit the memory held by the pool, in bytes. Zero means no limit.
+    void SetMaxBytesHeld(size_t max_bytes) {
+      _max_bytes_held = max_bytes;
+    }
+
+    size_t GetMaxBytesHeld() const {
+      return _max_bytes_held;
+    }
+
+    /// New buffers of at least @a bytes are backed by huge pages when the
+    /// platform supports it. Zero disables it.
+    void SetHugePageThreshold(size_t bytes) {
+      _huge_page_threshold = bytes;
+    }
+
+    /// Delete buffers held by the pool, largest first, until the pool holds
+    /// at most @a max_bytes.
+    void Trim(size_t max_bytes = 0u);
+
+    Stats GetStats() const {
+      return {_hits, _misses, _trimmed, _buffers_held, _bytes_held};
+    }
+
   private:
 
     friend class Buffer;
 
+    static constexpr size_t NumberOfSizeClasses = 8u * sizeof(Buffer::size_type);
+
+    /// A request never takes a buffer more than 2^N times bigger than needed.
+    static constexpr size_t MaxSizeClassesToSkip = 3u;
+
+    /// Size class to look for buffers able to hold @a size bytes, i.e.,
+    /// ceil(log2(size)).
+    static size_t SizeClassOf(size_t size) {
+      size_t i = 0u;
+      while ((i < NumberOfSizeClasses - 1u) && ((size_t(1u) << i) < size)) {
+        ++i;
+      }
+      return i;
+    }
+
+    /// Size class where a buffer of @a capacity is stored, i.e.,
+    /// floor(log2(capacity)). Every buffer in class i can hold 2^i bytes.
+    static size_t SizeClassOfCapacity(size_t capacity) {
+      size_t i = 0u;
+      while ((i < NumberOfSizeClasses - 1u) && ((size_t(2u) << i) <= capacity)) {
+        ++i;
+      }
+      return i;
+    }
+
+    void Allocate(Buffer &buffer, size_t size) const;
+
     void Push(Buffer &&buffer) {
-      _queue.enqueue(std::move(buffer));
+      const size_t capacity = buffer.capacity();
+      const size_t max_bytes = _max_bytes_held;
+      // Check the limit and add the capacity in a single step, so concurrent
+      // pushes cannot exceed the limit together.
+      size_t bytes_held = _bytes_held;
+      do {
+        if ((max_bytes > 0u) && (bytes_held + capacity > max_bytes)) {
+          // Let the buffer be deleted by its owner.
+          ++_trimmed;
+          return;
+        }
+      } while (!_bytes_held.compare_exchange_weak(bytes_held, bytes_held + capacity));
+      _buffers_held.fetch_add(1u);
+      _queues[SizeClassOfCapacity(capacity)].enqueue(std::move(buffer));
     }
 
-    moodycamel::ConcurrentQueue<Buffer> _queue;
+    std::array<moodycamel::ConcurrentQueue<Buffer>, NumberOfSizeClasses> _queues;
+
+    std::atomic<size_t> _max_bytes_held{0u};
+
+    std::atomic<size_t> _huge_page_threshold{0u};
+
+    std::atomic<uint64_t> _hits{0u};
+
+    std::atomic<uint64_t> _misses{0u};
+
+    std::atomic<uint64_t> _trimmed{0u};
+
+    std::atomic<size_t> _buffers_held{0u};
+
+    std::atomic<size_t> _bytes_held{0u};
   };
 
 } // namespace carla
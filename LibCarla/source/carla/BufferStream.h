@@ -0,0 +1,95 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Buffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <streambuf>
+
+namespace carla {
+
+  /// A std::streambuf that writes straight into a Buffer, growing it as
+  /// needed. Allows code written against std::ostream to serialize into a
+  /// Buffer without going through an std::ostringstream and std::string.
+  ///
+  /// If the given Buffer comes from a BufferPool, its capacity is reused and
+  /// the memory returns to the pool once the released Buffer is destroyed.
+  class BufferOutputStreamBuf : public std::streambuf {
+  public:
+
+    explicit BufferOutputStreamBuf(Buffer buffer = Buffer())
+      : _buffer(std::move(buffer)) {
+      _buffer.reset(std::max<Buffer::size_type>(_buffer.capacity(), 64u));
+      char *begin = reinterpret_cast<char *>(_buffer.data());
+      setp(begin, begin + _buffer.size());
+    }
+
+    /// Number of bytes written so far.
+    size_t size() const {
+      return static_cast<size_t>(pptr() - pbase());
+    }
+
+    /// Return the Buffer containing the bytes written so far. The stream
+    /// buffer must not be used after this call.
+    Buffer Release() {
+      _buffer.resize(size());
+      setp(nullptr, nullptr);
+      return std::move(_buffer);
+    }
+
+  protected:
+
+    int_type overflow(int_type ch) override {
+      if (traits_type::eq_int_type(ch, traits_type::eof())) {
+        return traits_type::not_eof(ch);
+      }
+      Grow(1u);
+      *pptr() = traits_type::to_char_type(ch);
+      pbump(1);
+      return ch;
+    }
+
+    std::streamsize xsputn(const char *data, std::streamsize count) override {
+      const auto bytes = static_cast<size_t>(count);
+      if (static_cast<size_t>(epptr() - pptr()) < bytes) {
+        Grow(bytes);
+      }
+      std::memcpy(pptr(), data, bytes);
+      pbump(static_cast<int>(count));
+      return count;
+    }
+
+  private:
+
+    void Grow(size_t min_extra_bytes) {
+      const size_t used = size();
+      const size_t capacity = std::max<size_t>(2u * _buffer.size(), used + min_extra_bytes);
+      _buffer.resize(used);
+      _buffer.resize(static_cast<uint64_t>(capacity));
+      char *begin = reinterpret_cast<char *>(_buffer.data());
+      setp(begin, begin + _buffer.size());
+      pbump(static_cast<int>(used));
+    }
+
+    Buffer _buffer;
+  };
+
+  /// A read-only std::streambuf over the contents of a Buffer, so data can be
+  /// deserialized through an std::istream without copying it first. The
+  /// Buffer must outlive the stream buffer.
+  class BufferInputStreamBuf : public std::streambuf {
+  public:
+
+    explicit BufferInputStreamBuf(const Buffer &buffer) {
+      char *begin = reinterpret_cast<char *>(const_cast<Buffer::value_type *>(buffer.data()));
+      setg(begin, begin, begin + buffer.size());
+    }
+  };
+
+} // namespace carla
@@ -0,0 +1,139 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/ContentHash.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace carla {
+
+namespace {
+
+  constexpr uint32_t K[64u] = {
+    0x428a2f98u, 0x71374491u, 0xb5c0fbcfu, 0xe9b5dba5u, 0x3956c25bu, 0x59f111f1u, 0x923f82a4u, 0xab1c5ed5u,
+    0xd807aa98u, 0x12835b01u, 0x243185beu, 0x550c7dc3u, 0x72be5d74u, 0x80deb1feu, 0x9bdc06a7u, 0xc19bf174u,
+    0xe49b69c1u, 0xefbe4786u, 0x0fc19dc6u, 0x240ca1ccu, 0x2de92c6fu, 0x4a7484aau, 0x5cb0a9dcu, 0x76f988dau,
+    0x983e5152u, 0xa831c66du, 0xb00327c8u, 0xbf597fc7u, 0xc6e00bf3u, 0xd5a79147u, 0x06ca6351u, 0x14292967u,
+    0x27b70a85u, 0x2e1b2138u, 0x4d2c6dfcu, 0x53380d13u, 0x650a7354u, 0x766a0abbu, 0x81c2c92eu, 0x92722c85u,
+    0xa2bfe8a1u, 0xa81a664bu, 0xc24b8b70u, 0xc76c51a3u, 0xd192e819u, 0xd6990624u, 0xf40e3585u, 0x106aa070u,
+    0x19a4c116u, 0x1e376c08u, 0x2748774cu, 0x34b0bcb5u, 0x391c0cb3u, 0x4ed8aa4au, 0x5b9cca4fu, 0x682e6ff3u,
+    0x748f82eeu, 0x78a5636fu, 0x84c87814u, 0x8cc70208u, 0x90befffau, 0xa4506cebu, 0xbef9a3f7u, 0xc67178f2u};
+
+  uint32_t RotateRight(uint32_t x, uint32_t n) {
+    return (x >> n) | (x << (32u - n));
+  }
+
+} // namespace
+
+  ContentHash::ContentHash()
+    : _state{{
+        0x6a09e667u, 0xbb67ae85u, 0x3c6ef372u, 0xa54ff53au,
+        0x510e527fu, 0x9b05688cu, 0x1f83d9abu, 0x5be0cd19u}} {}
+
+  void ContentHash::Update(const void *data, size_t size) {
+    auto *bytes = static_cast<const uint8_t *>(data);
+    _total_size += size;
+    if (_block_size > 0u) {
+      const size_t count = std::min(size, _block.size() - _block_size);
+      std::memcpy(_block.data() + _block_size, bytes, count);
+      _block_size += count;
+      bytes += count;
+      size -= count;
+      if (_block_size < _block.size()) {
+        return;
+      }
+      ProcessBlock(_block.data());
+      _block_size = 0u;
+    }
+    for (; size >= _block.size(); bytes += _block.size(), size -= _block.size()) {
+      ProcessBlock(bytes);
+    }
+    std::memcpy(_block.data(), bytes, size);
+    _block_size = size;
+  }
+
+  std::string ContentHash::Finish() {
+    const uint64_t total_bits = _total_size * 8u;
+    const uint8_t padding = 0x80u;
+    Update(&padding, 1u);
+    const uint8_t zero = 0u;
+    while (_block_size != 56u) {
+      Update(&zero, 1u);
+    }
+    uint8_t length[8u];
+    for (size_t i = 0u; i < 8u; ++i) {
+      length[i] = static_cast<uint8_t>(total_bits >> (56u - 8u * i));
+    }
+    Update(length, sizeof(length));
+
+    static constexpr char digits[] = "0123456789abcdef";
+    std::string result;
+    result.reserve(64u);
+    for (uint32_t word : _state) {
+      for (int shift = 28; shift >= 0; shift -= 4) {
+        result.push_back(digits[(word >> shift) & 0xfu]);
+      }
+    }
+    return result;
+  }
+
+  std::string ContentHash::Compute(const void *data, size_t size) {
+    ContentHash hash;
+    hash.Update(data, size);
+    return hash.Finish();
+  }
+
+  bool ContentHash::IsValid(const std::string &hash) {
+    if (hash.size() != 64u) {
+      return false;
+    }
+    for (char c : hash) {
+      if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void ContentHash::ProcessBlock(const uint8_t *block) {
+    uint32_t w[64u];
+    for (size_t i = 0u; i < 16u; ++i) {
+      w[i] =
+          (uint32_t(block[4u * i]) << 24u) |
+          (uint32_t(block[4u * i + 1u]) << 16u) |
+          (uint32_t(block[4u * i + 2u]) << 8u) |
+          uint32_t(block[4u * i + 3u]);
+    }
+    for (size_t i = 16u; i < 64u; ++i) {
+      const uint32_t s0 = RotateRight(w[i - 15u], 7u) ^ RotateRight(w[i - 15u], 18u) ^ (w[i - 15u] >> 3u);
+      const uint32_t s1 = RotateRight(w[i - 2u], 17u) ^ RotateRight(w[i - 2u], 19u) ^ (w[i - 2u] >> 10u);
+      w[i] = w[i - 16u] + s0 + w[i - 7u] + s1;
+    }
+
+    uint32_t a = _state[0u], b = _state[1u], c = _state[2u], d = _state[3u];
+    uint32_t e = _state[4u], f = _state[5u], g = _state[6u], h = _state[7u];
+    for (size_t i = 0u; i < 64u; ++i) {
+      const uint32_t s1 = RotateRight(e, 6u) ^ RotateRight(e, 11u) ^ RotateRight(e, 25u);
+      const uint32_t choice = (e & f) ^ (~e & g);
+      const uint32_t t1 = h + s1 + choice + K[i] + w[i];
+      const uint32_t s0 = RotateRight(a, 2u) ^ RotateRight(a, 13u) ^ RotateRight(a, 22u);
+      const uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+      const uint32_t t2 = s0 + majority;
+      h = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + t2;
+    }
+    _state[0u] += a; _state[1u] += b; _state[2u] += c; _state[3u] += d;
+    _state[4u] += e; _state[5u] += f; _state[6u] += g; _state[7u] += h;
+  }
+
+} // namespace carla
@@ -0,0 +1,48 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace carla {
+
+  /// SHA-256 of a sequence of bytes, used to identify and check the integrity
+  /// of the files the server shares with the clients.
+  class ContentHash {
+  public:
+
+    ContentHash();
+
+    void Update(const void *data, size_t size);
+
+    /// Complete the hash and return it as 64 lowercase hexadecimal digits.
+    /// The hash cannot be updated afterwards.
+    std::string Finish();
+
+    static std::string Compute(const void *data, size_t size);
+
+    /// Whether @a hash has the format of the values returned by Finish, so it
+    /// is safe to use it as a file name.
+    static bool IsValid(const std::string &hash);
+
+  private:
+
+    void ProcessBlock(const uint8_t *block);
+
+    std::array<uint32_t, 8u> _state;
+
+    std::array<uint8_t, 64u> _block;
+
+    size_t _block_size = 0u;
+
+    uint64_t _total_size = 0u;
+  };
+
+} // namespace carla
@@ -0,0 +1,83 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/ThreadGroup.h"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace carla {
+
+  /// Return the number of chunks ParallelFor splits a range of @a size
+  /// elements into, so callers can allocate per-chunk state beforehand. Each
+  /// chunk gets at least @a min_chunk_size elements, and no more chunks than
+  /// hardware threads are used.
+  inline size_t ParallelChunkCount(size_t size, size_t min_chunk_size = 1u) {
+    const size_t hardware_threads =
+        std::max<size_t>(1u, std::thread::hardware_concurrency());
+    const size_t max_chunks = size / std::max<size_t>(1u, min_chunk_size);
+    return std::max<size_t>(1u, std::min(hardware_threads, max_chunks));
+  }
+
+  /// Split the range [0, @a size) in @a chunk_count contiguous chunks and call
+  /// `functor(chunk_index, begin, end)` for each of them, every chunk in its
+  /// own thread. The first chunk runs in the calling thread. Chunks are
+  /// assigned in order, so the results of each chunk can be merged
+  /// deterministically afterwards.
+  ///
+  /// Blocks until every chunk has finished. If any chunk throws, the first
+  /// exception is re-thrown in the calling thread.
+  template <typename FunctorT>
+  void ParallelFor(size_t size, size_t chunk_count, FunctorT &&functor) {
+    chunk_count = std::max<size_t>(1u, std::min(chunk_count, size));
+    if (chunk_count == 1u) {
+      functor(0u, 0u, size);
+      return;
+    }
+    auto chunk_begin = [=](size_t chunk) { return (chunk * size) / chunk_count; };
+#ifndef LIBCARLA_NO_EXCEPTIONS
+    std::vector<std::exception_ptr> errors(chunk_count);
+    auto run_chunk = [&](size_t chunk) {
+      try {
+        functor(chunk, chunk_begin(chunk), chunk_begin(chunk + 1u));
+      } catch (...) {
+        errors[chunk] = std::current_exception();
+      }
+    };
+#else
+    auto run_chunk = [&](size_t chunk) {
+      functor(chunk, chunk_begin(chunk), chunk_begin(chunk + 1u));
+    };
+#endif // LIBCARLA_NO_EXCEPTIONS
+    {
+      ThreadGroup workers;
+      for (size_t chunk = 1u; chunk < chunk_count; ++chunk) {
+        workers.CreateThread([&run_chunk, chunk]() { run_chunk(chunk); });
+      }
+      run_chunk(0u);
+    }
+#ifndef LIBCARLA_NO_EXCEPTIONS
+    for (auto &error : errors) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+#endif // LIBCARLA_NO_EXCEPTIONS
+  }
+
+  /// @copydoc ParallelFor(size_t, size_t, FunctorT &&)
+  ///
+  /// Uses ParallelChunkCount(@a size, @a min_chunk_size) chunks.
+  template <typename FunctorT>
+  void ParallelForChunks(size_t size, size_t min_chunk_size, FunctorT &&functor) {
+    ParallelFor(size, ParallelChunkCount(size, min_chunk_size), std::forward<FunctorT>(functor));
+  }
+
+} // namespace carla
@@ -25,10 +25,14 @@ namespace client {
     /// @param port TCP port to connect with the simulator.
     /// @param worker_threads number of asynchronous threads to use, or 0 to use
     ///        all available hardware concurrency.
+    /// @param share_connection share the connection to the simulator and the
+    ///        asynchronous threads with the other clients of the process
+    ///        connected to the same host and port with this flag set.
     explicit Client(
         const std::string &host,
         uint16_t port,
-        size_t worker_threads = 0u);
+        size_t worker_threads = 0u,
+        bool share_connection = false);
 
     /// Set a timeout for networking operations. If set, any networking
     /// operation taking longer than @a timeout throws rpc::timeout.
@@ -153,6 +157,14 @@ namespace client {
       return responses;
     }
 
+    /// Apply the controls and transforms in @a batch, waiting until the
+    /// simulator has applied them. Vehicles not found are skipped.
+    void ApplyVehicleControlBatch(
+        const rpc::VehicleControlBatch &batch,
+        bool do_tick_cue = false) const {
+      _simulator->ApplyVehicleControlBatch(batch, do_tick_cue);
+    }
+
   private:
 
     std::shared_ptr<detail::Simulator> _simulator;
@@ -161,9 +173,10 @@ namespace client {
   inline Client::Client(
       const std::string &host,
       uint16_t port,
-      size_t worker_threads)
+      size_t worker_threads,
+      bool share_connection)
     : _simulator(
-        new detail::Simulator(host, port, worker_threads),
+        new detail::Simulator(host, port, worker_threads, false, share_connection),
         PythonUtil::ReleaseGILDeleter()) {}
 
 } // namespace client
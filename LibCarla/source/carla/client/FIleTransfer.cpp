@@ -7,6 +7,8 @@
 #include "FileTransfer.h"
 #include "carla/Version.h"
 
+#include <cstdio>
+
 namespace carla {
 namespace client {
 
@@ -20,9 +22,10 @@ namespace client {
     if (path.empty()) return false;
 
     // Check that the path ends in a slash, add it otherwise
+    _filesBaseFolder = path;
     if (path[path.size() - 1] != '/' && path[path.size() - 1] != '\\') {
-      _filesBaseFolder = path + "/";
-  }
+      _filesBaseFolder += "/";
+    }
 
     return true;
   }
@@ -31,50 +34,51 @@ namespace client {
     return _filesBaseFolder;
   }
 
-  bool FileTransfer::FileExists(std::string file) {
-    // Check if the file exists or not
-    struct stat buffer;
+  std::string FileTransfer::GetFullPath(const std::string &file) {
     std::string fullpath = _filesBaseFolder;
     fullpath += "/";
     fullpath += ::carla::version();
     fullpath += "/";
     fullpath += file;
+    return fullpath;
+  }
+
+  bool FileTransfer::FileExists(std::string file) {
+    // Check if the file exists or not
+    struct stat buffer;
+    std::string fullpath = GetFullPath(file);
 
     return (stat(fullpath.c_str(), &buffer) == 0);
   }
 
   bool FileTransfer::WriteFile(std::string path, std::vector<uint8_t> content) {
-    std::string writePath = _filesBaseFolder;
-    writePath += "/";
-    writePath += ::carla::version();
-    writePath += "/";
-    writePath += path;
+    std::string writePath = GetFullPath(path);
 
     // Validate and create the file path
     carla::FileSystem::ValidateFilePath(writePath);
 
+    // Remove it first, it may be a hard link to a file of the FileCache
+    std::remove(writePath.c_str());
+
     // Open the file to truncate it in binary mode
     std::ofstream out(writePath, std::ios::trunc | std::ios::binary);
     if(!out.good()) return false;
 
     // Write the content on and close it
-    for(auto file : content) {
-          out << file;
-    }
+    out.write(reinterpret_cast<const char *>(content.data()), static_cast<std::streamsize>(content.size()));
     out.close();
 
     return true;
   }
 
   std::vector<uint8_t> FileTransfer::ReadFile(std::string path) {
-    std::string fullpath = _filesBaseFolder;
-    fullpath += "/";
-    fullpath += ::carla::version();
-    fullpath += "/";
-    fullpath += path;
+    std::string fullpath = GetFullPath(path);
     // Read the binary file from the base folder
-    std::ifstream file(fullpath, std::ios::binary);
-    std::vector<uint8_t> content(std::istreambuf_iterator<char>(file), {});
+    std::ifstream file(fullpath, std::ios::binary | std::ios::ate);
+    if (!file.good()) return {};
+    std::vector<uint8_t> content(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(content.data()), static_cast<std::streamsize>(content.size()));
     return content;
   }
 
@@ -0,0 +1,144 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/FileCache.h"
+
+#include "carla/Exception.h"
+#include "carla/FileSystem.h"
+#include "carla/Logging.h"
+#include "carla/client/FileTransfer.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <stdexcept>
+
+namespace carla {
+namespace client {
+
+  namespace fs = boost::filesystem;
+  namespace bip = boost::interprocess;
+
+  // ===========================================================================
+  // -- FileCache::MappedFile --------------------------------------------------
+  // ===========================================================================
+
+  struct FileCache::MappedFile::Mapping {
+    bip::file_mapping file;
+    bip::mapped_region region;
+  };
+
+  FileCache::MappedFile::MappedFile(const std::string &path) {
+    // Empty files cannot be mapped.
+    if (fs::file_size(path) > 0u) {
+      _mapping = std::make_unique<Mapping>();
+      _mapping->file = bip::file_mapping(path.c_str(), bip::read_only);
+      _mapping->region = bip::mapped_region(_mapping->file, bip::read_only);
+      _data = static_cast<const uint8_t *>(_mapping->region.get_address());
+      _size = _mapping->region.get_size();
+    }
+  }
+
+  FileCache::MappedFile::~MappedFile() = default;
+
+  // ===========================================================================
+  // -- FileCache::Writer ------------------------------------------------------
+  // ===========================================================================
+
+  FileCache::Writer::Writer(rpc::FileInfo info)
+    : _info(std::move(info)) {
+    // A unique name, several clients may be downloading the same file.
+    _temporary_path = GetPath(_info.hash) + "." + fs::unique_path().string() + ".tmp";
+    FileSystem::ValidateFilePath(_temporary_path);
+    _out.open(_temporary_path, std::ios::binary | std::ios::trunc);
+    if (!_out.good()) {
+      throw_exception(std::runtime_error("failed to create file " + _temporary_path));
+    }
+  }
+
+  FileCache::Writer::~Writer() {
+    if (!_committed) {
+      _out.close();
+      boost::system::error_code ec;
+      fs::remove(_temporary_path, ec);
+    }
+  }
+
+  void FileCache::Writer::Write(const uint8_t *data, const size_t size) {
+    _out.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(size));
+    _hash.Update(data, size);
+    _size += size;
+  }
+
+  void FileCache::Writer::Commit() {
+    DEBUG_ASSERT(!_committed);
+    _out.close();
+    if (_out.fail()) {
+      throw_exception(std::runtime_error("failed to write file " + _temporary_path));
+    }
+    if ((_size != _info.size) || (_hash.Finish() != _info.hash)) {
+      throw_exception(std::runtime_error("corrupted download of file " + _info.name));
+    }
+    // Replacing an existing file is fine, it has the same content.
+    fs::rename(_temporary_path, GetPath(_info.hash));
+    _committed = true;
+  }
+
+  // ===========================================================================
+  // -- FileCache --------------------------------------------------------------
+  // ===========================================================================
+
+  std::string FileCache::GetPath(const std::string &hash) {
+    if (!ContentHash::IsValid(hash)) {
+      throw_exception(std::invalid_argument("invalid file hash: " + hash));
+    }
+    // Spread the files in folders by the first two digits of their hash.
+    return FileTransfer::GetFilesBaseFolder() + "/objects/" + hash.substr(0u, 2u) + "/" + hash;
+  }
+
+  bool FileCache::Contains(const rpc::FileInfo &info) {
+    boost::system::error_code ec;
+    const auto size = fs::file_size(GetPath(info.hash), ec);
+    return !ec && (size == info.size);
+  }
+
+  SharedPtr<const FileCache::MappedFile> FileCache::Open(const rpc::FileInfo &info) {
+    if (!Contains(info)) {
+      return nullptr;
+    }
+    try {
+      return MakeShared<MappedFile>(GetPath(info.hash));
+    } catch (const std::exception &e) {
+      log_warning("failed to open cached file", info.name + ':', e.what());
+      return nullptr;
+    }
+  }
+
+  void FileCache::Store(const rpc::FileInfo &info, const uint8_t *data, const size_t size) {
+    Writer writer(info);
+    writer.Write(data, size);
+    writer.Commit();
+  }
+
+  void FileCache::Export(const rpc::FileInfo &info) {
+    const fs::path source = GetPath(info.hash);
+    std::string destination = FileTransfer::GetFullPath(info.name);
+    boost::system::error_code ec;
+    if (fs::equivalent(source, destination, ec)) {
+      return;
+    }
+    FileSystem::ValidateFilePath(destination);
+    fs::remove(destination, ec);
+    // A hard link does not take any space, copy the file if not supported.
+    fs::create_hard_link(source, destination, ec);
+    if (ec) {
+      fs::copy_file(source, destination, fs::copy_options::overwrite_existing);
+    }
+  }
+
+} // namespace client
+} // namespace carla
@@ -0,0 +1,116 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/ContentHash.h"
+#include "carla/Memory.h"
+#include "carla/NonCopyable.h"
+#include "carla/rpc/FileInfo.h"
+
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace carla {
+namespace client {
+
+  /// Content-addressed store of the files downloaded from the server, kept in
+  /// the "objects" folder of FileTransfer's base folder.
+  ///
+  /// Every file is saved under its ContentHash, so it is downloaded once for
+  /// all the clients, servers and versions sharing the folder. Files are
+  /// checked against their hash before being moved into place and are never
+  /// modified afterwards, so several processes can fill the cache at the
+  /// same time.
+  class FileCache {
+  public:
+
+    FileCache() = delete;
+
+    /// Read-only memory mapping of a file of the cache.
+    class MappedFile : private NonCopyable {
+    public:
+
+      explicit MappedFile(const std::string &path);
+
+      ~MappedFile();
+
+      const uint8_t *data() const {
+        return _data;
+      }
+
+      size_t size() const {
+        return _size;
+      }
+
+    private:
+
+      struct Mapping;
+
+      std::unique_ptr<Mapping> _mapping;
+
+      const uint8_t *_data = nullptr;
+
+      size_t _size = 0u;
+    };
+
+    /// Writes a file to the cache chunk by chunk. Nothing is visible in the
+    /// cache until the file is committed.
+    class Writer : private NonCopyable {
+    public:
+
+      explicit Writer(rpc::FileInfo info);
+
+      /// Discards the data written if the file was not committed.
+      ~Writer();
+
+      void Write(const uint8_t *data, size_t size);
+
+      /// Check the written data and move it into the cache.
+      ///
+      /// @throw std::runtime_error if its size or hash do not match the
+      /// FileInfo.
+      void Commit();
+
+    private:
+
+      const rpc::FileInfo _info;
+
+      std::string _temporary_path;
+
+      std::ofstream _out;
+
+      ContentHash _hash;
+
+      uint64_t _size = 0u;
+
+      bool _committed = false;
+    };
+
+    /// Path of the file with @a hash in the cache.
+    ///
+    /// @throw std::invalid_argument if @a hash is not a valid ContentHash.
+    static std::string GetPath(const std::string &hash);
+
+    /// Whether the file described by @a info is in the cache.
+    static bool Contains(const rpc::FileInfo &info);
+
+    /// Map the file described by @a info, nullptr if it is not in the cache.
+    static SharedPtr<const MappedFile> Open(const rpc::FileInfo &info);
+
+    /// Add @a data to the cache.
+    ///
+    /// @throw std::runtime_error if it does not match @a info.
+    static void Store(const rpc::FileInfo &info, const uint8_t *data, size_t size);
+
+    /// Make a file of the cache also available at its name in the folder of
+    /// FileTransfer, where older clients look for it.
+    static void Export(const rpc::FileInfo &info);
+  };
+
+} // namespace client
+} // namespace carla
@@ -26,6 +26,9 @@ namespace client {
 
     static const std::string& GetFilesBaseFolder();
 
+    /// Path of @a file in the folder of the current version.
+    static std::string GetFullPath(const std::string &file);
+
     static bool FileExists(std::string file);
 
     static bool WriteFile(std::string path, std::vector<uint8_t> content);
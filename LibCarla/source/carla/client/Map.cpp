@@ -6,6 +6,8 @@
 
 #include "carla/client/Map.h"
 
+#include "carla/Exception.h"
+#include "carla/ParallelFor.h"
 #include "carla/client/Junction.h"
 #include "carla/client/Waypoint.h"
 #include "carla/opendrive/OpenDriveParser.h"
@@ -14,6 +16,7 @@
 #include "carla/trafficmanager/InMemoryMap.h"
 
 #include <sstream>
+#include <stdexcept>
 
 namespace carla {
 namespace client {
@@ -31,6 +34,11 @@ namespace client {
     : _description(std::move(description)),
       _map(MakeMap(xodr_content)){
     open_drive_file = xodr_content;
+    const auto signal_references = _map.GetAllSignalReferences();
+    _landmarks.reserve(signal_references.size());
+    for (auto *signal_reference : signal_references) {
+      _landmarks.push_back(Landmark(nullptr, nullptr, signal_reference, 0));
+    }
   }
   Map::Map(std::string name, std::string xodr_content)
     : Map(rpc::MapInfo{
@@ -56,6 +64,23 @@ namespace client {
     nullptr;
   }
 
+  std::vector<boost::optional<road::element::Waypoint>> Map::GetWaypoints(
+      const std::vector<geom::Location> &locations,
+      bool project_to_road,
+      int32_t lane_type) const {
+    std::vector<boost::optional<road::element::Waypoint>> result(locations.size());
+    ParallelForChunks(locations.size(), 256u, [&](size_t, size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        if (project_to_road) {
+          result[i] = _map.GetClosestWaypointOnRoad(locations[i], lane_type);
+        } else {
+          result[i] = _map.GetWaypoint(locations[i], lane_type);
+        }
+      }
+    });
+    return result;
+  }
+
   SharedPtr<Waypoint> Map::GetWaypointXODR(
       carla::road::RoadId road_id,
       carla::road::LaneId lane_id,
@@ -92,6 +117,20 @@ namespace client {
     return result;
   }
 
+  std::pair<road::element::WaypointColumns, road::element::WaypointColumns>
+      Map::GetTopologyColumns() const {
+    const auto topology = _map.GenerateTopology();
+    std::vector<road::element::Waypoint> starts;
+    std::vector<road::element::Waypoint> ends;
+    starts.reserve(topology.size());
+    ends.reserve(topology.size());
+    for (const auto &pair : topology) {
+      starts.emplace_back(pair.first);
+      ends.emplace_back(pair.second);
+    }
+    return {_map.ExportWaypoints(starts), _map.ExportWaypoints(ends)};
+  }
+
   std::vector<SharedPtr<Waypoint>> Map::GenerateWaypoints(double distance) const {
     std::vector<SharedPtr<Waypoint>> result;
     const auto waypoints = _map.GenerateWaypoints(distance);
@@ -102,6 +141,10 @@ namespace client {
     return result;
   }
 
+  road::element::WaypointColumns Map::GenerateWaypointColumns(double distance) const {
+    return _map.ExportWaypoints(_map.GenerateWaypoints(distance));
+  }
+
   std::vector<road::element::LaneMarking> Map::CalculateCrossedLanes(
   const geom::Location &origin,
   const geom::Location &destination) const {
@@ -135,23 +178,25 @@ namespace client {
     return result;
   }
 
+  SharedPtr<Landmark> Map::MakeLandmarkPtr(const Landmark &landmark) const {
+    // Aliasing constructor, the landmark lives as long as this map.
+    return SharedPtr<Landmark>(shared_from_this(), const_cast<Landmark *>(&landmark));
+  }
+
   std::vector<SharedPtr<Landmark>> Map::GetAllLandmarks() const {
     std::vector<SharedPtr<Landmark>> result;
-    auto signal_references = _map.GetAllSignalReferences();
-    for(auto* signal_reference : signal_references) {
-      result.emplace_back(
-          new Landmark(nullptr, shared_from_this(), signal_reference, 0));
+    result.reserve(_landmarks.size());
+    for (auto &landmark : _landmarks) {
+      result.emplace_back(MakeLandmarkPtr(landmark));
     }
     return result;
   }
 
   std::vector<SharedPtr<Landmark>> Map::GetLandmarksFromId(std::string id) const {
     std::vector<SharedPtr<Landmark>> result;
-    auto signal_references = _map.GetAllSignalReferences();
-    for(auto* signal_reference : signal_references) {
-      if(signal_reference->GetSignalId() == id) {
-        result.emplace_back(
-            new Landmark(nullptr, shared_from_this(), signal_reference, 0));
+    for (auto &landmark : _landmarks) {
+      if(landmark._signal->GetSignalId() == id) {
+        result.emplace_back(MakeLandmarkPtr(landmark));
       }
     }
     return result;
@@ -159,11 +204,9 @@ namespace client {
 
   std::vector<SharedPtr<Landmark>> Map::GetAllLandmarksOfType(std::string type) const {
     std::vector<SharedPtr<Landmark>> result;
-    auto signal_references = _map.GetAllSignalReferences();
-    for(auto* signal_reference : signal_references) {
-      if(signal_reference->GetSignal()->GetType() == type) {
-        result.emplace_back(
-            new Landmark(nullptr, shared_from_this(), signal_reference, 0));
+    for (auto &landmark : _landmarks) {
+      if(landmark._signal->GetSignal()->GetType() == type) {
+        result.emplace_back(MakeLandmarkPtr(landmark));
       }
     }
     return result;
@@ -188,5 +231,43 @@ namespace client {
     traffic_manager::InMemoryMap::Cook(shared_from_this(), path);
   }
 
+  const road::RoutingGraph &Map::GetRoutingGraph() const {
+    std::call_once(_routing_graph_flag, [this]() {
+      _routing_graph = std::make_unique<road::RoutingGraph>(_map);
+    });
+    return *_routing_graph;
+  }
+
+  std::vector<SharedPtr<Waypoint>> Map::ComputeRoute(
+      const Waypoint &origin,
+      const Waypoint &destination) const {
+    std::vector<SharedPtr<Waypoint>> result;
+    const auto route = GetRoutingGraph().ComputeRoute(origin._waypoint, destination._waypoint);
+    result.reserve(route.size());
+    for (const auto &waypoint : route) {
+      result.emplace_back(SharedPtr<Waypoint>(new Waypoint{shared_from_this(), waypoint}));
+    }
+    return result;
+  }
+
+  std::vector<double> Map::ComputeRouteDistances(
+      const std::vector<SharedPtr<Waypoint>> &origins,
+      const std::vector<SharedPtr<Waypoint>> &destinations) const {
+    const auto to_road_waypoints = [](const std::vector<SharedPtr<Waypoint>> &waypoints) {
+      std::vector<road::element::Waypoint> result;
+      result.reserve(waypoints.size());
+      for (const auto &waypoint : waypoints) {
+        if (waypoint == nullptr) {
+          throw_exception(std::invalid_argument("null waypoint in route distances"));
+        }
+        result.emplace_back(waypoint->_waypoint);
+      }
+      return result;
+    };
+    return GetRoutingGraph().ComputeDistances(
+        to_road_waypoints(origins),
+        to_road_waypoints(destinations));
+  }
+
 } // namespace client
 } // namespace carla
@@ -12,9 +12,12 @@
 #include "carla/road/Lane.h"
 #include "carla/road/Map.h"
 #include "carla/road/RoadTypes.h"
+#include "carla/road/RoutingGraph.h"
 #include "carla/rpc/MapInfo.h"
 #include "Landmark.h"
 
+#include <memory>
+#include <mutex>
 #include <string>
 
 namespace carla {
@@ -56,6 +59,13 @@ namespace client {
         bool project_to_road = true,
         int32_t lane_type = static_cast<uint32_t>(road::Lane::LaneType::Driving)) const;
 
+    /// GetWaypoint for each of @a locations, computed in parallel. None where
+    /// GetWaypoint would return null.
+    std::vector<boost::optional<road::element::Waypoint>> GetWaypoints(
+        const std::vector<geom::Location> &locations,
+        bool project_to_road = true,
+        int32_t lane_type = static_cast<uint32_t>(road::Lane::LaneType::Driving)) const;
+
     SharedPtr<Waypoint> GetWaypointXODR(
       carla::road::RoadId road_id,
       carla::road::LaneId lane_id,
@@ -65,8 +75,16 @@ namespace client {
 
     TopologyList GetTopology() const;
 
+    /// Same as GetTopology, with the start and the end of each segment column
+    /// by column.
+    std::pair<road::element::WaypointColumns, road::element::WaypointColumns>
+        GetTopologyColumns() const;
+
     std::vector<SharedPtr<Waypoint>> GenerateWaypoints(double distance) const;
 
+    /// Same as GenerateWaypoints, column by column.
+    road::element::WaypointColumns GenerateWaypointColumns(double distance) const;
+
     std::vector<road::element::LaneMarking> CalculateCrossedLanes(
         const geom::Location &origin,
         const geom::Location &destination) const;
@@ -97,13 +115,43 @@ namespace client {
     /// Cooks InMemoryMap used by the traffic manager
     void CookInMemoryMap(const std::string& path) const;
 
+    /// Returns the routing graph of the map, built the first time it is
+    /// requested.
+    const road::RoutingGraph &GetRoutingGraph() const;
+
+    /// Returns the shortest route from @a origin to @a destination: @a
+    /// origin, a waypoint at the start of each lane the route drives into and
+    /// @a destination. Empty if there is no route.
+    std::vector<SharedPtr<Waypoint>> ComputeRoute(
+        const Waypoint &origin,
+        const Waypoint &destination) const;
+
+    /// Returns the cost, in meters, of the shortest route from each of @a
+    /// origins to each of @a destinations, one row per origin. Infinity where
+    /// there is no route.
+    ///
+    /// @throw std::invalid_argument if any of the waypoints is null.
+    std::vector<double> ComputeRouteDistances(
+        const std::vector<SharedPtr<Waypoint>> &origins,
+        const std::vector<SharedPtr<Waypoint>> &destinations) const;
+
   private:
 
+    /// Shares the cached @a landmark, keeping this map alive.
+    SharedPtr<Landmark> MakeLandmarkPtr(const Landmark &landmark) const;
+
     std::string open_drive_file;
 
     const rpc::MapInfo _description;
 
     const road::Map _map;
+
+    /// One landmark without waypoint per signal reference, created once.
+    std::vector<Landmark> _landmarks;
+
+    mutable std::once_flag _routing_graph_flag;
+
+    mutable std::unique_ptr<road::RoutingGraph> _routing_graph;
   };
 
 } // namespace client
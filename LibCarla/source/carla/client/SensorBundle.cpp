@@ -0,0 +1,73 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/SensorBundle.h"
+
+#include "carla/Debug.h"
+#include "carla/Logging.h"
+#include "carla/sensor/SensorData.h"
+
+namespace carla {
+namespace client {
+
+  SensorBundle::SensorBundle(
+      std::vector<SharedPtr<Sensor>> sensors,
+      Policy policy,
+      size_t max_queued_frames)
+    : _sensors(std::move(sensors)),
+      _queue(_sensors.size(), policy, max_queued_frames) {
+    for (auto &sensor : _sensors) {
+      DEBUG_ASSERT(sensor != nullptr);
+    }
+  }
+
+  SensorBundle::~SensorBundle() {
+    if (IsListening()) {
+      try {
+        Stop();
+      } catch (const std::exception &e) {
+        log_error("exception trying to stop sensor bundle:", e.what());
+      }
+    }
+  }
+
+  void SensorBundle::Listen() {
+    WeakPtr<SensorBundle> weak_self = shared_from_this();
+    for (auto i = 0u; i < _sensors.size(); ++i) {
+      _sensors[i]->Listen([weak_self, i](SharedPtr<sensor::SensorData> data) {
+        auto self = weak_self.lock();
+        if (self != nullptr && data != nullptr) {
+          self->_queue.Push(i, std::move(data));
+        }
+      });
+    }
+    _queue.Open();
+  }
+
+  void SensorBundle::Stop() {
+    for (auto &sensor : _sensors) {
+      sensor->Stop();
+    }
+    _queue.Close();
+  }
+
+  boost::optional<SensorDataBundle> SensorBundle::WaitForFrame(
+      const size_t frame,
+      const time_duration timeout,
+      const bool allow_incomplete) {
+    return _queue.WaitForFrame(frame, timeout, allow_incomplete);
+  }
+
+  boost::optional<SensorDataBundle> SensorBundle::WaitForNext(const time_duration timeout) {
+    return _queue.WaitForNext(timeout);
+  }
+
+  size_t SensorBundle::GetNumberOfDroppedFrames() const {
+    return _queue.GetNumberOfDroppedFrames();
+  }
+
+} // namespace client
+} // namespace carla
@@ -0,0 +1,90 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Memory.h"
+#include "carla/NonCopyable.h"
+#include "carla/Time.h"
+#include "carla/client/Sensor.h"
+#include "carla/client/SensorDataBundle.h"
+#include "carla/client/detail/SensorFrameQueue.h"
+
+#include <boost/optional.hpp>
+
+#include <vector>
+
+namespace carla {
+namespace client {
+
+  /// Listens to a set of sensors and joins their measurements by frame, so
+  /// the data of every sensor for a given frame can be retrieved at once.
+  ///
+  /// Sensor callbacks only store the data and never block, frames are kept
+  /// until retrieved with WaitForFrame or WaitForNext. At most
+  /// @a max_queued_frames frames are kept, older frames are dropped when a
+  /// new one arrives so a lagging sensor cannot make the queue grow without
+  /// bounds.
+  class SensorBundle
+    : public EnableSharedFromThis<SensorBundle>,
+      private NonCopyable {
+  public:
+
+    using Policy = detail::SensorFrameQueue::Policy;
+
+    explicit SensorBundle(
+        std::vector<SharedPtr<Sensor>> sensors,
+        Policy policy = Policy::Queue,
+        size_t max_queued_frames = 8u);
+
+    ~SensorBundle();
+
+    /// Start listening to every sensor of the bundle.
+    ///
+    /// @warning This steals the data stream of the sensors from any
+    /// previously set callback.
+    void Listen();
+
+    /// Stop listening to the sensors and wake up any waiting thread.
+    void Stop();
+
+    bool IsListening() const {
+      return _queue.IsOpen();
+    }
+
+    const std::vector<SharedPtr<Sensor>> &GetSensors() const {
+      return _sensors;
+    }
+
+    /// Block until the data of every sensor for @a frame is received, or
+    /// @a timeout is met. On timeout, if @a allow_incomplete is true, return
+    /// whatever data was received for this frame. The frame is removed from
+    /// the bundle once returned.
+    ///
+    /// @return empty optional if the frame was not received in time or was
+    /// already dropped.
+    boost::optional<SensorDataBundle> WaitForFrame(
+        size_t frame,
+        time_duration timeout,
+        bool allow_incomplete = false);
+
+    /// Block until the oldest queued frame (or the latest one with
+    /// Policy::LatestOnly) is complete, or @a timeout is met.
+    boost::optional<SensorDataBundle> WaitForNext(time_duration timeout);
+
+    /// Number of frames dropped so far because they were not retrieved in
+    /// time.
+    size_t GetNumberOfDroppedFrames() const;
+
+  private:
+
+    const std::vector<SharedPtr<Sensor>> _sensors;
+
+    detail::SensorFrameQueue _queue;
+  };
+
+} // namespace client
+} // namespace carla
@@ -0,0 +1,71 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Memory.h"
+
+#include <vector>
+
+namespace carla {
+namespace sensor { class SensorData; }
+namespace client {
+namespace detail { class SensorFrameQueue; }
+
+  /// Measurements of every sensor of a SensorBundle for a single frame. The
+  /// data is stored in the same order the sensors were given to the bundle;
+  /// sensors that did not send data for this frame have a null entry.
+  class SensorDataBundle {
+  public:
+
+    SensorDataBundle() = default;
+
+    SensorDataBundle(size_t frame, size_t number_of_sensors)
+      : _frame(frame),
+        _data(number_of_sensors) {}
+
+    size_t GetFrame() const {
+      return _frame;
+    }
+
+    /// Return whether every sensor sent data for this frame.
+    bool IsComplete() const {
+      return _received == _data.size();
+    }
+
+    SharedPtr<sensor::SensorData> at(size_t pos) const {
+      return _data.at(pos);
+    }
+
+    SharedPtr<sensor::SensorData> operator[](size_t pos) const {
+      return _data[pos];
+    }
+
+    size_t size() const {
+      return _data.size();
+    }
+
+    auto begin() const {
+      return _data.begin();
+    }
+
+    auto end() const {
+      return _data.end();
+    }
+
+  private:
+
+    friend class detail::SensorFrameQueue;
+
+    size_t _frame = 0u;
+
+    size_t _received = 0u;
+
+    std::vector<SharedPtr<sensor::SensorData>> _data;
+  };
+
+} // namespace client
+} // namespace carla
@@ -35,6 +35,12 @@ namespace client {
       return _state->GetTimestamp();
     }
 
+    /// Get the weather at this snapshot, if the simulator sent it. Unlike
+    /// World::GetWeather, it does not query the simulator.
+    const boost::optional<rpc::WeatherParameters> &GetWeather() const {
+      return _state->GetWeather();
+    }
+
     /// Check if an actor is present in this snapshot.
     bool Contains(ActorId actor_id) const {
       return _state->ContainsActorSnapshot(actor_id);
@@ -0,0 +1,162 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/detail/CachedActorList.h"
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  // ===========================================================================
+  // -- Static local methods ---------------------------------------------------
+  // ===========================================================================
+
+  static std::string MakeAttributeKey(const rpc::ActorAttributeValue &attribute) {
+    std::string key;
+    key.reserve(attribute.id.size() + attribute.value.size() + 3u);
+    key += attribute.id;
+    key += '\0';
+    key += static_cast<char>(attribute.type);
+    key += '\0';
+    key += attribute.value;
+    return key;
+  }
+
+  /// Remove the interned values referenced only by @a pool.
+  template <typename MapT>
+  static void RemoveUnused(MapT &pool) {
+    for (auto it = pool.begin(); it != pool.end();) {
+      if (it->second.use_count() == 1) {
+        it = pool.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  // ===========================================================================
+  // -- CachedActorList::Entry -------------------------------------------------
+  // ===========================================================================
+
+  rpc::Actor CachedActorList::Entry::MakeActor() const {
+    rpc::Actor actor;
+    actor.id = id;
+    actor.parent_id = parent_id;
+    actor.description.uid = uid;
+    actor.description.id = *type_id;
+    actor.description.attributes.reserve(attributes.size());
+    for (auto &&attribute : attributes) {
+      actor.description.attributes.emplace_back(*attribute);
+    }
+    actor.bounding_box = bounding_box;
+    actor.semantic_tags = semantic_tags;
+    actor.stream_token = stream_token;
+    return actor;
+  }
+
+  // ===========================================================================
+  // -- CachedActorList --------------------------------------------------------
+  // ===========================================================================
+
+  CachedActorList::CachedActorList()
+    : _entries(std::make_shared<const EntryList>()) {}
+
+  void CachedActorList::Insert(rpc::Actor actor) {
+    std::vector<rpc::Actor> actors;
+    actors.emplace_back(std::move(actor));
+    InsertActors(std::move(actors));
+  }
+
+  boost::optional<rpc::Actor> CachedActorList::GetActorById(ActorId id) const {
+    const auto entries = _entries.load();
+    const auto *entry = Find(*entries, id);
+    if (entry != nullptr) {
+      return entry->MakeActor();
+    }
+    return boost::none;
+  }
+
+  void CachedActorList::Clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries = std::make_shared<const EntryList>();
+    _type_ids.clear();
+    _attributes.clear();
+  }
+
+  const CachedActorList::Entry *CachedActorList::Find(const EntryList &list, ActorId id) {
+    auto it = std::lower_bound(list.begin(), list.end(), id, [](const auto &entry, ActorId actor_id) {
+      return entry->id < actor_id;
+    });
+    return ((it != list.end()) && ((*it)->id == id)) ? it->get() : nullptr;
+  }
+
+  void CachedActorList::InsertActors(std::vector<rpc::Actor> actors) {
+    if (actors.empty()) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto entries = _entries.load();
+    std::vector<std::shared_ptr<const Entry>> new_entries;
+    new_entries.reserve(actors.size());
+    for (auto &&actor : actors) {
+      // Actor descriptions never change, keep the one we already have.
+      if (Find(*entries, actor.id) == nullptr) {
+        new_entries.emplace_back(MakeEntry(std::move(actor)));
+      }
+    }
+    if (new_entries.empty()) {
+      return;
+    }
+    auto by_id = [](const auto &lhs, const auto &rhs) { return lhs->id < rhs->id; };
+    std::sort(new_entries.begin(), new_entries.end(), by_id);
+    new_entries.erase(
+        std::unique(new_entries.begin(), new_entries.end(), [](const auto &lhs, const auto &rhs) {
+          return lhs->id == rhs->id;
+        }),
+        new_entries.end());
+    auto next = std::make_shared<EntryList>();
+    next->reserve(entries->size() + new_entries.size());
+    std::merge(
+        entries->begin(), entries->end(),
+        new_entries.begin(), new_entries.end(),
+        std::back_inserter(*next),
+        by_id);
+    _entries = std::move(next);
+  }
+
+  std::shared_ptr<const CachedActorList::Entry> CachedActorList::MakeEntry(rpc::Actor &&actor) {
+    auto entry = std::make_shared<Entry>();
+    entry->id = actor.id;
+    entry->parent_id = actor.parent_id;
+    entry->uid = actor.description.uid;
+    auto &type_id = _type_ids[actor.description.id];
+    if (type_id == nullptr) {
+      type_id = std::make_shared<const std::string>(actor.description.id);
+    }
+    entry->type_id = type_id;
+    entry->attributes.reserve(actor.description.attributes.size());
+    for (auto &&attribute : actor.description.attributes) {
+      auto &interned = _attributes[MakeAttributeKey(attribute)];
+      if (interned == nullptr) {
+        interned = std::make_shared<const rpc::ActorAttributeValue>(std::move(attribute));
+      }
+      entry->attributes.emplace_back(interned);
+    }
+    entry->bounding_box = actor.bounding_box;
+    entry->semantic_tags = std::move(actor.semantic_tags);
+    entry->stream_token = std::move(actor.stream_token);
+    entry->generation = _generation;
+    return entry;
+  }
+
+  void CachedActorList::ReleaseUnusedInternedValues() {
+    RemoveUnused(_type_ids);
+    RemoveUnused(_attributes);
+  }
+
+} // namespace detail
+} // namespace client
+} // namespace carla
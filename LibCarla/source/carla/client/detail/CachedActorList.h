@@ -6,14 +6,20 @@
 
 #pragma once
 
+#include "carla/AtomicSharedPtr.h"
 #include "carla/NonCopyable.h"
 #include "carla/rpc/Actor.h"
 
-#include <boost/iterator/transform_iterator.hpp>
+#include <boost/optional.hpp>
 
 #include <algorithm>
+#include <cstdint>
 #include <iterator>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace carla {
 namespace client {
@@ -26,14 +32,23 @@ namespace detail {
   /// Keeps a list of actor descriptions to avoid requesting each time the
   /// descriptions to the server.
   ///
-  /// @todo Dead actors are never removed from the list.
+  /// Reads are lock-free, they work on an immutable snapshot of the list that
+  /// writers replace. Blueprint ids and attributes are interned, actors with
+  /// the same blueprint and attributes share them. Actors no longer in the
+  /// episode are removed with EvictIf.
   class CachedActorList : private MovableNonCopyable {
   public:
 
+    CachedActorList();
+
     /// Inserts an actor into the list.
+    ///
+    /// Each insert copies the whole list, it is meant for the rare actors
+    /// registered one at a time (e.g. after spawning them). Use InsertRange
+    /// to insert many actors at once.
     void Insert(rpc::Actor actor);
 
-    /// Inserts a @a range containing actors.
+    /// Inserts a @a range containing actors, copying the list only once.
     template <typename RangeT>
     void InsertRange(RangeT range);
 
@@ -50,75 +65,120 @@ namespace detail {
     template <typename RangeT>
     std::vector<rpc::Actor> GetActorsById(const RangeT &range) const;
 
+    /// Remove the actors for which `is_gone(id)` returns true. Each call
+    /// starts a new generation, actors inserted during the current
+    /// generation are kept regardless, since the episode state used to decide
+    /// may be older than them.
+    ///
+    /// @return the number of actors removed.
+    template <typename PredicateT>
+    size_t EvictIf(PredicateT &&is_gone);
+
+    size_t size() const {
+      return _entries.load()->size();
+    }
+
     void Clear();
 
   private:
 
-    mutable std::mutex _mutex;
+    using Attribute = std::shared_ptr<const rpc::ActorAttributeValue>;
+
+    /// Compact version of an rpc::Actor.
+    struct Entry {
+      ActorId id;
+      ActorId parent_id;
+      ActorId uid;
+      std::shared_ptr<const std::string> type_id;
+      std::vector<Attribute> attributes;
+      geom::BoundingBox bounding_box;
+      std::vector<uint8_t> semantic_tags;
+      std::vector<unsigned char> stream_token;
+      uint64_t generation;
+
+      rpc::Actor MakeActor() const;
+    };
+
+    /// Immutable list of entries sorted by id.
+    using EntryList = std::vector<std::shared_ptr<const Entry>>;
+
+    static const Entry *Find(const EntryList &list, ActorId id);
+
+    void InsertActors(std::vector<rpc::Actor> actors);
 
-    std::unordered_map<ActorId, rpc::Actor> _actors;
+    /// Requires _mutex.
+    std::shared_ptr<const Entry> MakeEntry(rpc::Actor &&actor);
+
+    /// Drop the interned strings and attributes no entry uses anymore.
+    /// Requires _mutex.
+    void ReleaseUnusedInternedValues();
+
+    AtomicSharedPtr<const EntryList> _entries;
+
+    /// Serializes writers.
+    std::mutex _mutex;
+
+    uint64_t _generation = 0u;
+
+    std::unordered_map<std::string, std::shared_ptr<const std::string>> _type_ids;
+
+    std::unordered_map<std::string, Attribute> _attributes;
   };
 
   // ===========================================================================
   // -- CachedActorList implementation -----------------------------------------
   // ===========================================================================
 
-  inline void CachedActorList::Insert(rpc::Actor actor) {
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto id = actor.id;
-    _actors.emplace(id, std::move(actor));
-  }
-
   template <typename RangeT>
   inline void CachedActorList::InsertRange(RangeT range) {
-    auto make_a_pair = [](rpc::Actor actor) {
-      auto id = actor.id;
-      return std::make_pair(id, std::move(actor));
-    };
-    auto make_iterator = [&make_a_pair](auto it) {
-      return boost::make_transform_iterator(std::make_move_iterator(it), make_a_pair);
-    };
-    std::lock_guard<std::mutex> lock(_mutex);
-    _actors.insert(make_iterator(std::begin(range)), make_iterator(std::end(range)));
+    InsertActors(std::vector<rpc::Actor>{
+        std::make_move_iterator(std::begin(range)),
+        std::make_move_iterator(std::end(range))});
   }
 
   template <typename RangeT>
   inline std::vector<ActorId> CachedActorList::GetMissingIds(const RangeT &range) const {
     std::vector<ActorId> result;
     result.reserve(range.size());
-    std::lock_guard<std::mutex> lock(_mutex);
-    std::copy_if(std::begin(range), std::end(range), std::back_inserter(result), [this](auto id) {
-      return _actors.find(id) == _actors.end();
+    const auto entries = _entries.load();
+    std::copy_if(std::begin(range), std::end(range), std::back_inserter(result), [&](auto id) {
+      return Find(*entries, id) == nullptr;
     });
     return result;
   }
 
-  inline boost::optional<rpc::Actor> CachedActorList::GetActorById(ActorId id) const {
-    std::lock_guard<std::mutex> lock(_mutex);
-    auto it = _actors.find(id);
-    if (it != _actors.end()) {
-      return it->second;
-    }
-    return boost::none;
-  }
-
   template <typename RangeT>
   inline std::vector<rpc::Actor> CachedActorList::GetActorsById(const RangeT &range) const {
     std::vector<rpc::Actor> result;
     result.reserve(range.size());
-    std::lock_guard<std::mutex> lock(_mutex);
+    const auto entries = _entries.load();
     for (auto &&id : range) {
-      auto it = _actors.find(id);
-      if (it != _actors.end()) {
-        result.emplace_back(it->second);
+      const auto *entry = Find(*entries, id);
+      if (entry != nullptr) {
+        result.emplace_back(entry->MakeActor());
       }
     }
     return result;
   }
 
-  inline void CachedActorList::Clear() {
+  template <typename PredicateT>
+  inline size_t CachedActorList::EvictIf(PredicateT &&is_gone) {
     std::lock_guard<std::mutex> lock(_mutex);
-    _actors.clear();
+    const auto current_generation = _generation++;
+    const auto entries = _entries.load();
+    auto should_evict = [&](const std::shared_ptr<const Entry> &entry) {
+      return (entry->generation < current_generation) && is_gone(entry->id);
+    };
+    const auto count = static_cast<size_t>(
+        std::count_if(entries->begin(), entries->end(), should_evict));
+    if (count > 0u) {
+      auto next = std::make_shared<EntryList>();
+      next->reserve(entries->size() - count);
+      std::remove_copy_if(entries->begin(), entries->end(), std::back_inserter(*next), should_evict);
+      _entries = std::move(next);
+      ReleaseUnusedInternedValues();
+    }
+    return count;
   }
 
 } // namespace detail
@@ -7,7 +7,10 @@
 #include "carla/client/detail/Client.h"
 
 #include "carla/Exception.h"
+#include "carla/NonCopyable.h"
+#include "carla/ThreadPool.h"
 #include "carla/Version.h"
+#include "carla/client/FileCache.h"
 #include "carla/client/FileTransfer.h"
 #include "carla/client/TimeoutException.h"
 #include "carla/rpc/AckermannControllerSettings.h"
@@ -15,6 +18,7 @@
 #include "carla/rpc/BoneTransformDataIn.h"
 #include "carla/rpc/Client.h"
 #include "carla/rpc/DebugShape.h"
+#include "carla/rpc/FileInfo.h"
 #include "carla/rpc/Response.h"
 #include "carla/rpc/VehicleAckermannControl.h"
 #include "carla/rpc/VehicleControl.h"
@@ -26,7 +30,11 @@
 
 #include <rpc/rpc_error.h>
 
+#include <atomic>
+#include <future>
+#include <mutex>
 #include <thread>
+#include <unordered_map>
 
 namespace carla {
 namespace client {
@@ -41,6 +49,64 @@ namespace detail {
     return true;
   }
 
+  /// Files are downloaded in chunks of this size, so big files do not hit
+  /// the timeout of a single call.
+  static constexpr uint64_t FILE_CHUNK_SIZE = 4u * 1024u * 1024u;
+
+  // ===========================================================================
+  // -- Connection -------------------------------------------------------------
+  // ===========================================================================
+
+  /// The rpc connection of a client and the threads running its sensor
+  /// streams. A shared connection is used by every client of the process
+  /// connected to the same endpoint that asked for it.
+  class Connection : private NonCopyable {
+  public:
+
+    Connection(const std::string &host, uint16_t port, size_t worker_threads)
+      : rpc_client(host, port),
+        streaming_service(std::make_shared<ThreadPool>()) {
+      streaming_service->AsyncRun(
+          worker_threads > 0u ? worker_threads : std::thread::hardware_concurrency());
+      ++Count();
+    }
+
+    ~Connection() {
+      --Count();
+    }
+
+    /// Number of connections open in the process.
+    static std::atomic_size_t &Count() {
+      static std::atomic_size_t count{0u};
+      return count;
+    }
+
+    /// Return the shared connection to @a host and @a port, opening it if no
+    /// client is using it. It is closed with its last client.
+    static std::shared_ptr<Connection> GetShared(
+        const std::string &host,
+        uint16_t port,
+        size_t worker_threads) {
+      static std::mutex mutex;
+      static std::unordered_map<std::string, std::weak_ptr<Connection>> connections;
+      const auto endpoint = host + ":" + std::to_string(port);
+      std::lock_guard<std::mutex> lock(mutex);
+      for (auto it = connections.begin(); it != connections.end();) {
+        it = it->second.expired() ? connections.erase(it) : std::next(it);
+      }
+      auto connection = connections[endpoint].lock();
+      if (connection == nullptr) {
+        connection = std::make_shared<Connection>(host, port, worker_threads);
+        connections[endpoint] = connection;
+      }
+      return connection;
+    }
+
+    rpc::Client rpc_client;
+
+    std::shared_ptr<ThreadPool> streaming_service;
+  };
+
   // ===========================================================================
   // -- Client::Pimpl ----------------------------------------------------------
   // ===========================================================================
@@ -48,22 +114,34 @@ namespace detail {
   class Client::Pimpl {
   public:
 
-    Pimpl(const std::string &host, uint16_t port, size_t worker_threads)
+    Pimpl(const std::string &host, uint16_t port, size_t worker_threads, bool share_connection)
       : endpoint(host + ":" + std::to_string(port)),
-        rpc_client(host, port),
-        streaming_client(host) {
-      rpc_client.set_timeout(5000u);
-      streaming_client.AsyncRun(
-          worker_threads > 0u ? worker_threads : std::thread::hardware_concurrency());
+        is_connection_shared(share_connection),
+        connection(share_connection ?
+            Connection::GetShared(host, port, worker_threads) :
+            std::make_shared<Connection>(host, port, worker_threads)),
+        rpc_client(connection->rpc_client),
+        streaming_client(host, connection->streaming_service) {}
+
+    ~Pimpl() {
+      // Wait for the stream callbacks of this client running in other threads
+      // before destroying anything they may use. The threads are only stopped
+      // if no other client uses them.
+      streaming_client.Stop();
+      if (!is_connection_shared) {
+        connection->streaming_service->Stop();
+      }
     }
 
     template <typename ... Args>
     auto RawCall(const std::string &function, Args && ... args) {
-      try {
-        return rpc_client.call(function, std::forward<Args>(args) ...);
-      } catch (const ::rpc::timeout &) {
-        throw_exception(TimeoutException(endpoint, GetTimeout()));
+      auto future = rpc_client.async_call_with_future(function, std::forward<Args>(args) ...);
+      // Wait with the timeout of this client, the connection may be shared.
+      const auto timeout = GetTimeout();
+      if (future.wait_for(timeout.to_chrono()) == std::future_status::timeout) {
+        throw_exception(TimeoutException(endpoint, timeout));
       }
+      return future.get();
     }
 
     template <typename T, typename ... Args>
@@ -77,6 +155,18 @@ namespace detail {
       return Get(response);
     }
 
+    /// Same as CallAndWait, but returns false if the server does not offer
+    /// @a function, as older servers.
+    template <typename T, typename ... Args>
+    bool CallIfAvailable(T &result, const std::string &function, Args && ... args) {
+      try {
+        result = CallAndWait<T>(function, std::forward<Args>(args) ...);
+        return true;
+      } catch (const ::rpc::rpc_error &) {
+        return false;
+      }
+    }
+
     template <typename ... Args>
     void AsyncCall(const std::string &function, Args && ... args) {
       // Discard returned future.
@@ -84,16 +174,62 @@ namespace detail {
     }
 
     time_duration GetTimeout() const {
-      auto timeout = rpc_client.get_timeout();
-      DEBUG_ASSERT(timeout.has_value());
-      return time_duration::milliseconds(static_cast<size_t>(*timeout));
+      return time_duration::milliseconds(timeout_milliseconds);
+    }
+
+    void AddFileInfo(const rpc::FileInfo &info) {
+      std::lock_guard<std::mutex> lock(file_infos_mutex);
+      file_infos[info.name] = info;
+    }
+
+    bool FindFileInfo(const std::string &name, rpc::FileInfo &info) {
+      std::lock_guard<std::mutex> lock(file_infos_mutex);
+      auto it = file_infos.find(name);
+      if (it == file_infos.end()) {
+        return false;
+      }
+      info = it->second;
+      return true;
+    }
+
+    /// Make sure the file is in the FileCache, downloading it otherwise.
+    void FetchFile(const rpc::FileInfo &info) {
+      if (!FileCache::Contains(info)) {
+        log_info("Could not find the required file in cache, downloading... ", info.name);
+        FileCache::Writer writer(info);
+        uint64_t offset = 0u;
+        while (offset < info.size) {
+          const auto chunk = CallAndWait<std::vector<uint8_t>>(
+              "request_file_chunk", info.name, offset, FILE_CHUNK_SIZE);
+          if (chunk.empty()) {
+            throw_exception(std::runtime_error("failed to download file " + info.name));
+          }
+          writer.Write(chunk.data(), chunk.size());
+          offset += chunk.size();
+        }
+        writer.Commit();
+      } else {
+        log_info("Found the required file in cache! ", info.name);
+      }
+      FileCache::Export(info);
     }
 
     const std::string endpoint;
 
-    rpc::Client rpc_client;
+    const bool is_connection_shared;
+
+    std::shared_ptr<Connection> connection;
+
+    rpc::Client &rpc_client;
 
     streaming::Client streaming_client;
+
+    std::atomic_size_t timeout_milliseconds{5000u};
+
+    /// Files listed by the server, by name.
+    std::unordered_map<std::string, rpc::FileInfo> file_infos;
+
+    std::mutex file_infos_mutex;
   };
 
   // ===========================================================================
@@ -103,8 +239,9 @@ namespace detail {
   Client::Client(
       const std::string &host,
       const uint16_t port,
-      const size_t worker_threads)
-    : _pimpl(std::make_unique<Pimpl>(host, port, worker_threads)) {}
+      const size_t worker_threads,
+      const bool share_connection)
+    : _pimpl(std::make_unique<Pimpl>(host, port, worker_threads, share_connection)) {}
 
   bool Client::IsTrafficManagerRunning(uint16_t port) const {
     return _pimpl->CallAndWait<bool>("is_traffic_manager_running", port);
@@ -124,8 +261,12 @@ namespace detail {
 
   Client::~Client() = default;
 
+  size_t Client::GetNumberOfConnections() {
+    return Connection::Count();
+  }
+
   void Client::SetTimeout(time_duration timeout) {
-    _pimpl->rpc_client.set_timeout(static_cast<int64_t>(timeout.milliseconds()));
+    _pimpl->timeout_milliseconds = timeout.milliseconds();
   }
 
   time_duration Client::GetTimeout() const {
@@ -191,7 +332,20 @@ namespace detail {
   }
 
   std::string Client::GetMapData() const{
-    return _pimpl->CallAndWait<std::string>("get_map_data");
+    rpc::FileInfo info;
+    if (!_pimpl->CallIfAvailable(info, "get_map_data_info")) {
+      return _pimpl->CallAndWait<std::string>("get_map_data");
+    }
+    if (auto file = FileCache::Open(info)) {
+      return std::string(reinterpret_cast<const char *>(file->data()), file->size());
+    }
+    auto map_data = _pimpl->CallAndWait<std::string>("get_map_data");
+    try {
+      FileCache::Store(info, reinterpret_cast<const uint8_t *>(map_data.data()), map_data.size());
+    } catch (const std::exception &e) {
+      log_warning("failed to cache the map data:", e.what());
+    }
+    return map_data;
   }
 
   std::vector<uint8_t> Client::GetNavigationMesh() const {
@@ -203,6 +357,22 @@ namespace detail {
   }
 
   std::vector<std::string> Client::GetRequiredFiles(const std::string &folder, const bool download) const {
+    // Get the list of required files with their hashes, if the server has
+    // them, and keep them in the FileCache
+    std::vector<rpc::FileInfo> infos;
+    if (_pimpl->CallIfAvailable(infos, "get_required_files_info", folder)) {
+      std::vector<std::string> result;
+      result.reserve(infos.size());
+      for (const auto &info : infos) {
+        _pimpl->AddFileInfo(info);
+        if (download) {
+          _pimpl->FetchFile(info);
+        }
+        result.emplace_back(info.name);
+      }
+      return result;
+    }
+
     // Get the list of required files
     auto requiredFiles = _pimpl->CallAndWait<std::vector<std::string>>("get_required_files", folder);
 
@@ -222,12 +392,32 @@ namespace detail {
   }
 
   void Client::RequestFile(const std::string &name) const {
+    rpc::FileInfo info;
+    if (_pimpl->FindFileInfo(name, info)) {
+      _pimpl->FetchFile(info);
+      return;
+    }
+
     // Download the binary content of the file from the server and write it on the client
     auto content = _pimpl->CallAndWait<std::vector<uint8_t>>("request_file", name);
     FileTransfer::WriteFile(name, content);
   }
 
   std::vector<uint8_t> Client::GetCacheFile(const std::string &name, const bool request_otherwise) const {
+    // Map the file from the FileCache if the server gave us its hash
+    rpc::FileInfo info;
+    if (_pimpl->FindFileInfo(name, info)) {
+      auto file = FileCache::Open(info);
+      if (file == nullptr && request_otherwise) {
+        _pimpl->FetchFile(info);
+        file = FileCache::Open(info);
+      }
+      if (file == nullptr) {
+        return {};
+      }
+      return std::vector<uint8_t>(file->data(), file->data() + file->size());
+    }
+
     // Get the file from the cache in the file transfer
     std::vector<uint8_t> file = FileTransfer::ReadFile(name);
 
@@ -622,6 +812,12 @@ namespace detail {
     return result.as<std::vector<rpc::CommandResponse>>();
   }
 
+  void Client::ApplyVehicleControlBatch(
+      const rpc::VehicleControlBatch &batch,
+      bool do_tick_cue) {
+    _pimpl->CallAndWait<void>("apply_vehicle_control_batch", batch, do_tick_cue);
+  }
+
   uint64_t Client::SendTickCue() {
     return _pimpl->CallAndWait<uint64_t>("tick_cue");
   }
@@ -25,6 +25,7 @@
 #include "carla/rpc/MapLayer.h"
 #include "carla/rpc/OpendriveGenerationParameters.h"
 #include "carla/rpc/TrafficLightState.h"
+#include "carla/rpc/VehicleControlBatch.h"
 #include "carla/rpc/VehicleDoor.h"
 #include "carla/rpc/VehicleLightStateList.h"
 #include "carla/rpc/VehicleLightState.h"
@@ -69,13 +70,21 @@ namespace detail {
   class Client : private NonCopyable {
   public:
 
+    /// @param share_connection use the same rpc connection and streaming
+    /// threads as the other clients of the process connected to the same
+    /// endpoint with this flag set. Each client keeps its own timeout.
     explicit Client(
         const std::string &host,
         uint16_t port,
-        size_t worker_threads = 0u);
+        size_t worker_threads = 0u,
+        bool share_connection = false);
 
     ~Client();
 
+    /// Number of rpc connections open by the clients of this process; clients
+    /// sharing a connection count once.
+    static size_t GetNumberOfConnections();
+
     /// Querry to know if a Traffic Manager is running on port
     bool IsTrafficManagerRunning(uint16_t port) const;
 
@@ -389,6 +398,10 @@ namespace detail {
         std::vector<rpc::Command> commands,
         bool do_tick_cue);
 
+    void ApplyVehicleControlBatch(
+        const rpc::VehicleControlBatch &batch,
+        bool do_tick_cue);
+
     uint64_t SendTickCue();
 
     std::vector<rpc::LightState> QueryLightsStateToServer() const;
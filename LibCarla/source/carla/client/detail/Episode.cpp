@@ -97,6 +97,11 @@ using namespace std::chrono_literals;
           /// Episode change
           if(episode_changed) {
             self->OnEpisodeChanged();
+          } else {
+            // Forget the descriptions of the actors destroyed.
+            self->_actors.EvictIf([&](ActorId id) {
+              return !next->ContainsActorSnapshot(id);
+            });
           }
 
           // Notify waiting threads and do the callbacks.
@@ -122,17 +127,44 @@ using namespace std::chrono_literals;
   }
 
   std::shared_ptr<WalkerNavigation> Episode::CreateNavigationIfMissing() {
-    std::shared_ptr<WalkerNavigation> navigation;
-    do {
-      navigation = _navigation.load();
-      if (navigation == nullptr) {
-        auto new_navigation = std::make_shared<WalkerNavigation>(_client);
-        _navigation.compare_exchange(&navigation, new_navigation);
+    auto navigation = _navigation.load();
+    while (navigation == nullptr) {
+      auto new_navigation = std::make_shared<WalkerNavigation>(_client);
+      if (_navigation.compare_exchange(&navigation, new_navigation)) {
+        // Step the crowd as soon as each new state arrives.
+        std::weak_ptr<WalkerNavigation> weak = new_navigation;
+        std::weak_ptr<Episode> weak_episode = shared_from_this();
+        RegisterOnTickEvent([weak, weak_episode](const WorldSnapshot &) {
+          auto self = weak.lock();
+          auto episode = weak_episode.lock();
+          if (self != nullptr && episode != nullptr) {
+            self->OnTick(episode->GetState());
+          }
+        });
+        navigation = std::move(new_navigation);
       }
-    } while (navigation == nullptr);
+    }
     return navigation;
   }
 
+  std::shared_ptr<LaneInvasionDetector> Episode::CreateLaneInvasionDetectorIfMissing() {
+    auto detector = _lane_invasion_detector.load();
+    while (detector == nullptr) {
+      auto new_detector = std::make_shared<LaneInvasionDetector>();
+      if (_lane_invasion_detector.compare_exchange(&detector, new_detector)) {
+        std::weak_ptr<LaneInvasionDetector> weak = new_detector;
+        RegisterOnTickEvent([weak](const WorldSnapshot &snapshot) {
+          auto self = weak.lock();
+          if (self != nullptr) {
+            self->OnTick(snapshot);
+          }
+        });
+        detector = std::move(new_detector);
+      }
+    }
+    return detector;
+  }
+
   std::vector<rpc::Actor> Episode::GetActorsById(const std::vector<ActorId> &actor_ids) {
     return GetActorsById_Impl(_client, _actors, actor_ids);
   }
@@ -145,6 +177,7 @@ using namespace std::chrono_literals;
     _actors.Clear();
     _on_tick_callbacks.Clear();
     _navigation.reset();
+    _lane_invasion_detector.reset();
     traffic_manager::TrafficManager::Release();
   }
 
@@ -14,6 +14,7 @@
 #include "carla/client/detail/CachedActorList.h"
 #include "carla/client/detail/CallbackList.h"
 #include "carla/client/detail/EpisodeState.h"
+#include "carla/client/detail/LaneInvasionDetector.h"
 #include "carla/client/detail/WalkerNavigation.h"
 #include "carla/rpc/EpisodeInfo.h"
 
@@ -57,6 +58,14 @@ namespace detail {
       return nav;
     }
 
+    /// Lane invasion detector shared by every LaneInvasionSensor of this
+    /// episode, created on first use.
+    std::shared_ptr<LaneInvasionDetector> CreateLaneInvasionDetectorIfMissing();
+
+    std::shared_ptr<LaneInvasionDetector> GetLaneInvasionDetector() const {
+      return _lane_invasion_detector.load();
+    }
+
     void RegisterActor(rpc::Actor actor) {
       _actors.Insert(std::move(actor));
     }
@@ -130,6 +139,8 @@ namespace detail {
 
     AtomicSharedPtr<WalkerNavigation> _navigation;
 
+    AtomicSharedPtr<LaneInvasionDetector> _lane_invasion_detector;
+
     std::string _pending_exceptions_msg;
 
     CachedActorList _actors;
@@ -18,7 +18,8 @@ namespace detail {
           state.GetDeltaSeconds(),
           state.GetPlatformTimeStamp()),
       _map_origin(state.GetMapOrigin()),
-      _simulation_state(state.GetSimulationState()) {
+      _simulation_state(state.GetSimulationState()),
+      _weather(state.GetWeather()) {
     _actors.reserve(state.size());
     for (auto &&actor : state) {
       DEBUG_ONLY(auto result = )
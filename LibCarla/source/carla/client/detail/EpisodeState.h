@@ -60,6 +60,11 @@ namespace detail {
       return (_simulation_state & SimulationState::PendingLightUpdate)  != 0;
     }
 
+    /// Weather at this frame, if the simulator sent it.
+    const boost::optional<rpc::WeatherParameters> &GetWeather() const {
+      return _weather;
+    }
+
     bool ContainsActorSnapshot(ActorId actor_id) const {
       return _actors.find(actor_id) != _actors.end();
     }
@@ -112,6 +117,8 @@ namespace detail {
 
     SimulationState _simulation_state;
 
+    boost::optional<rpc::WeatherParameters> _weather;
+
     std::unordered_map<ActorId, ActorSnapshot> _actors;
   };
 
@@ -0,0 +1,262 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/detail/LaneInvasionDetector.h"
+
+#include "carla/Logging.h"
+#include "carla/ParallelFor.h"
+#include "carla/client/Map.h"
+#include "carla/geom/TransformMatrix.h"
+#include "carla/road/Map.h"
+#include "carla/sensor/data/LaneInvasionEvent.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <limits>
+#include <thread>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  // ===========================================================================
+  // -- Static local methods ---------------------------------------------------
+  // ===========================================================================
+
+  static std::array<geom::Location, 4u> MakeCorners(
+      const geom::BoundingBox &box,
+      const geom::Transform &transform) {
+    std::array<geom::Location, 4u> corners = {
+        geom::Location( box.extent.x,  box.extent.y, 0.0f),
+        geom::Location(-box.extent.x,  box.extent.y, 0.0f),
+        geom::Location( box.extent.x, -box.extent.y, 0.0f),
+        geom::Location(-box.extent.x, -box.extent.y, 0.0f)};
+    // Only the yaw matters, the corners are projected on the road.
+    const geom::TransformMatrix matrix{geom::Transform{
+        transform.location + box.location,
+        geom::Rotation{0.0f, transform.rotation.yaw, 0.0f}}};
+    matrix.TransformPoints(corners.data(), corners.size());
+    return corners;
+  }
+
+  // ===========================================================================
+  // -- LaneInvasionDetector::Subscription -------------------------------------
+  // ===========================================================================
+
+  struct LaneInvasionDetector::Subscription {
+    size_t id;
+    ActorId vehicle;
+    geom::BoundingBox bounding_box;
+    SharedPtr<const Map> map;
+    CallbackFunctionType callback;
+    std::atomic_bool is_active{true};
+
+    /// State of the previous frame, only accessed by the thread processing
+    /// the snapshots.
+    /// @{
+    bool has_corners = false;
+    size_t frame = 0u;
+    std::array<geom::Location, 4u> corners;
+    /// Located corners, valid if located at the corner's current location.
+    std::array<boost::optional<Calculator::Endpoint>, 4u> endpoints;
+    /// Lane containing each corner, if known.
+    std::array<boost::optional<Calculator::LaneArea>, 4u> lanes;
+    /// @}
+  };
+
+  // ===========================================================================
+  // -- LaneInvasionDetector::Batch --------------------------------------------
+  // ===========================================================================
+
+  /// A snapshot being processed, split in chunks of subscriptions.
+  struct LaneInvasionDetector::Batch {
+    boost::optional<WorldSnapshot> snapshot;
+    std::vector<std::shared_ptr<Subscription>> subscriptions;
+    size_t chunk_count = 1u;
+    std::atomic_size_t next_chunk{0u};
+    std::mutex mutex;
+    std::condition_variable finished_condition;
+    size_t finished_chunks = 0u;
+  };
+
+  // ===========================================================================
+  // -- LaneInvasionDetector ---------------------------------------------------
+  // ===========================================================================
+
+  LaneInvasionDetector::LaneInvasionDetector()
+    : _number_of_workers(std::max(2u, std::thread::hardware_concurrency() / 2u)) {
+    _workers.AsyncRun(_number_of_workers);
+  }
+
+  size_t LaneInvasionDetector::Subscribe(
+      const ActorId vehicle,
+      const geom::BoundingBox &bounding_box,
+      SharedPtr<const Map> map,
+      CallbackFunctionType callback) {
+    DEBUG_ASSERT(map != nullptr);
+    auto subscription = std::make_shared<Subscription>();
+    subscription->vehicle = vehicle;
+    subscription->bounding_box = bounding_box;
+    subscription->map = std::move(map);
+    subscription->callback = std::move(callback);
+    std::lock_guard<std::mutex> lock(_mutex);
+    subscription->id = _next_id++;
+    _subscriptions.emplace_back(std::move(subscription));
+    return _subscriptions.back()->id;
+  }
+
+  void LaneInvasionDetector::Unsubscribe(const size_t id) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = std::find_if(_subscriptions.begin(), _subscriptions.end(), [id](const auto &item) {
+      return item->id == id;
+    });
+    if (it != _subscriptions.end()) {
+      (*it)->is_active = false;
+      _subscriptions.erase(it);
+    }
+  }
+
+  size_t LaneInvasionDetector::GetNumberOfSubscribers() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _subscriptions.size();
+  }
+
+  void LaneInvasionDetector::OnTick(const WorldSnapshot &snapshot) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_subscriptions.empty()) {
+      return;
+    }
+    if (_pending_snapshot.has_value() &&
+        (_pending_snapshot->GetFrame() >= snapshot.GetFrame())) {
+      return;
+    }
+    _pending_snapshot = snapshot;
+    if (!_is_processing) {
+      _is_processing = true;
+      _workers.Post([this]() { ProcessPendingSnapshots(); });
+    }
+  }
+
+  void LaneInvasionDetector::ProcessPendingSnapshots() {
+    for (;;) {
+      boost::optional<WorldSnapshot> snapshot;
+      std::vector<std::shared_ptr<Subscription>> subscriptions;
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_pending_snapshot.has_value()) {
+          _is_processing = false;
+          return;
+        }
+        snapshot.swap(_pending_snapshot);
+        subscriptions = _subscriptions;
+      }
+
+      // Chunks are claimed by whoever gets to them first, this thread
+      // included, so it never waits for a chunk that has not started yet.
+      constexpr size_t min_vehicles_per_chunk = 32u;
+      auto batch = std::make_shared<Batch>();
+      batch->snapshot = std::move(*snapshot);
+      batch->subscriptions = std::move(subscriptions);
+      batch->chunk_count = std::min(
+          _number_of_workers,
+          ParallelChunkCount(batch->subscriptions.size(), min_vehicles_per_chunk));
+      for (size_t i = 1u; i < batch->chunk_count; ++i) {
+        _workers.Post([this, batch]() { ProcessChunks(*batch); });
+      }
+      ProcessChunks(*batch);
+      std::unique_lock<std::mutex> lock(batch->mutex);
+      batch->finished_condition.wait(lock, [&]() {
+        return batch->finished_chunks == batch->chunk_count;
+      });
+    }
+  }
+
+  void LaneInvasionDetector::ProcessChunks(Batch &batch) const {
+    const auto size = batch.subscriptions.size();
+    for (auto chunk = batch.next_chunk++; chunk < batch.chunk_count; chunk = batch.next_chunk++) {
+      const size_t begin = (chunk * size) / batch.chunk_count;
+      const size_t end = ((chunk + 1u) * size) / batch.chunk_count;
+      for (auto i = begin; i < end; ++i) {
+        try {
+          Process(*batch.snapshot, *batch.subscriptions[i]);
+        } catch (const std::exception &e) {
+          log_error("LaneInvasionSensor:", e.what());
+        }
+      }
+      std::lock_guard<std::mutex> lock(batch.mutex);
+      if (++batch.finished_chunks == batch.chunk_count) {
+        batch.finished_condition.notify_one();
+      }
+    }
+  }
+
+  void LaneInvasionDetector::Process(
+      const WorldSnapshot &snapshot,
+      Subscription &subscription) const {
+    // Make sure the parent is alive.
+    auto parent = snapshot.Find(subscription.vehicle);
+    if (!parent || !subscription.is_active) {
+      return;
+    }
+
+    const auto next = MakeCorners(subscription.bounding_box, parent->transform);
+
+    // First frame there is nothing to compare with.
+    if (!subscription.has_corners) {
+      subscription.has_corners = true;
+      subscription.frame = snapshot.GetFrame();
+      subscription.corners = next;
+      return;
+    }
+
+    // Make sure the distance is long enough and the frame is up-to-date.
+    constexpr float distance_threshold = 10.0f * std::numeric_limits<float>::epsilon();
+    for (auto i = 0u; i < 4u; ++i) {
+      if ((next[i] - subscription.corners[i]).Length() < distance_threshold) {
+        return;
+      }
+    }
+    if (subscription.frame >= snapshot.GetFrame()) {
+      return;
+    }
+
+    const auto &map = subscription.map->GetMap();
+    std::vector<road::element::LaneMarking> crossed_lanes;
+    for (auto i = 0u; i < 4u; ++i) {
+      auto &lane = subscription.lanes[i];
+      auto &endpoint = subscription.endpoints[i];
+      if (lane.has_value() && lane->Contains(next[i])) {
+        // Still inside the same lane, nothing crossed.
+        endpoint.reset();
+        continue;
+      }
+      const auto &prev = subscription.corners[i];
+      const auto origin = (endpoint.has_value() && (endpoint->location == prev)) ?
+          *endpoint :
+          Calculator::Locate(map, prev);
+      endpoint = Calculator::Locate(map, next[i]);
+      lane = Calculator::MakeLaneArea(map, *endpoint);
+      const auto lanes = Calculator::Calculate(map, origin, *endpoint);
+      crossed_lanes.insert(crossed_lanes.end(), lanes.begin(), lanes.end());
+    }
+
+    subscription.frame = snapshot.GetFrame();
+    subscription.corners = next;
+
+    if (!crossed_lanes.empty() && subscription.is_active) {
+      subscription.callback(MakeShared<sensor::data::LaneInvasionEvent>(
+          snapshot.GetTimestamp().frame,
+          snapshot.GetTimestamp().elapsed_seconds,
+          parent->transform,
+          subscription.vehicle,
+          std::move(crossed_lanes)));
+    }
+  }
+
+} // namespace detail
+} // namespace client
+} // namespace carla
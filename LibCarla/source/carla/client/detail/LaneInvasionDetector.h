@@ -0,0 +1,103 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Memory.h"
+#include "carla/NonCopyable.h"
+#include "carla/ThreadPool.h"
+#include "carla/client/WorldSnapshot.h"
+#include "carla/geom/BoundingBox.h"
+#include "carla/road/element/LaneCrossingCalculator.h"
+#include "carla/rpc/ActorId.h"
+
+#include <boost/optional.hpp>
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace carla {
+namespace sensor { class SensorData; }
+namespace client {
+
+  class Map;
+
+namespace detail {
+
+  /// Computes the lane invasions of every vehicle with a LaneInvasionSensor
+  /// attached, all of them at once from a single tick callback.
+  ///
+  /// Snapshots are processed in a worker thread, if they arrive faster than
+  /// they can be processed the intermediate ones are skipped and crossings are
+  /// computed between the last two processed snapshots. Vehicles are split in
+  /// chunks computed in parallel, and each corner of a vehicle remembers the
+  /// lane it was in the previous frame so the map is only queried when it
+  /// moves out of it.
+  class LaneInvasionDetector
+    : public std::enable_shared_from_this<LaneInvasionDetector>,
+      private NonCopyable {
+  public:
+
+    using CallbackFunctionType = std::function<void(SharedPtr<sensor::SensorData>)>;
+
+    LaneInvasionDetector();
+
+    /// Start computing the lane invasions of @a vehicle.
+    ///
+    /// @return an id to be passed to Unsubscribe.
+    size_t Subscribe(
+        ActorId vehicle,
+        const geom::BoundingBox &bounding_box,
+        SharedPtr<const Map> map,
+        CallbackFunctionType callback);
+
+    /// Stop computing the lane invasions of subscription @a id. A callback
+    /// already running in a worker thread is not waited for.
+    void Unsubscribe(size_t id);
+
+    /// To be registered as tick callback of the episode.
+    void OnTick(const WorldSnapshot &snapshot);
+
+    size_t GetNumberOfSubscribers() const;
+
+  private:
+
+    using Calculator = road::element::LaneCrossingCalculator;
+
+    struct Subscription;
+
+    struct Batch;
+
+    void ProcessPendingSnapshots();
+
+    void ProcessChunks(Batch &batch) const;
+
+    void Process(const WorldSnapshot &snapshot, Subscription &subscription) const;
+
+    mutable std::mutex _mutex;
+
+    std::vector<std::shared_ptr<Subscription>> _subscriptions;
+
+    size_t _next_id = 1u;
+
+    boost::optional<WorldSnapshot> _pending_snapshot;
+
+    bool _is_processing = false;
+
+    const size_t _number_of_workers;
+
+    /// Declared last so the workers are joined before anything they use is
+    /// destroyed.
+    ThreadPool _workers;
+  };
+
+} // namespace detail
+} // namespace client
+} // namespace carla
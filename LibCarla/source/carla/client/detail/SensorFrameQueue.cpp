@@ -0,0 +1,152 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/client/detail/SensorFrameQueue.h"
+
+#include "carla/Debug.h"
+#include "carla/Logging.h"
+#include "carla/sensor/SensorData.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  SensorFrameQueue::SensorFrameQueue(
+      const size_t number_of_sensors,
+      const Policy policy,
+      const size_t max_queued_frames)
+    : _number_of_sensors(number_of_sensors),
+      _policy(policy),
+      _max_queued_frames(std::max<size_t>(1u, max_queued_frames)) {}
+
+  void SensorFrameQueue::Open() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _is_open = true;
+  }
+
+  void SensorFrameQueue::Close() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _is_open = false;
+    }
+    _cv.notify_all();
+  }
+
+  bool SensorFrameQueue::IsOpen() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _is_open;
+  }
+
+  boost::optional<SensorDataBundle> SensorFrameQueue::WaitForFrame(
+      const size_t frame,
+      const time_duration timeout,
+      const bool allow_incomplete) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto is_ready = [&]() {
+      if (!_is_open) {
+        return true;
+      }
+      auto it = _frames.find(frame);
+      if (it != _frames.end()) {
+        return it->second.IsComplete();
+      }
+      // Already returned or dropped, it is not coming anymore.
+      return frame < _first_pending_frame;
+    };
+    _cv.wait_for(lock, timeout.to_chrono(), is_ready);
+    auto it = _frames.find(frame);
+    if ((it == _frames.end()) || !(allow_incomplete || it->second.IsComplete())) {
+      return boost::none;
+    }
+    return PopFrame(frame);
+  }
+
+  boost::optional<SensorDataBundle> SensorFrameQueue::WaitForNext(const time_duration timeout) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    auto find_complete = [this]() {
+      for (auto it = _frames.begin(); it != _frames.end(); ++it) {
+        if (it->second.IsComplete()) {
+          return it;
+        }
+      }
+      return _frames.end();
+    };
+    _cv.wait_for(lock, timeout.to_chrono(), [&]() {
+      return !_is_open || (find_complete() != _frames.end());
+    });
+    auto it = find_complete();
+    if (it == _frames.end()) {
+      return boost::none;
+    }
+    const size_t frame = it->first;
+    // Incomplete frames older than this one are not going to be completed.
+    DropFramesOlderThan(frame);
+    return PopFrame(frame);
+  }
+
+  size_t SensorFrameQueue::GetNumberOfDroppedFrames() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _dropped_frames;
+  }
+
+  void SensorFrameQueue::Push(const size_t index, SharedPtr<sensor::SensorData> data) {
+    DEBUG_ASSERT(data != nullptr);
+    const size_t frame = data->GetFrame();
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto it = _frames.find(frame);
+      if (it == _frames.end()) {
+        if (frame < _first_pending_frame) {
+          // Late data for a frame already returned or dropped.
+          return;
+        }
+        it = _frames.emplace(frame, SensorDataBundle{frame, _number_of_sensors}).first;
+        if (_frames.size() > _max_queued_frames) {
+          log_debug("sensor bundle: dropping frame", _frames.begin()->first);
+          DropFramesOlderThan(std::next(_frames.begin())->first);
+          if (frame < _first_pending_frame) {
+            return;
+          }
+        }
+      }
+      auto &bundle = it->second;
+      DEBUG_ASSERT(index < bundle._data.size());
+      if (bundle._data[index] == nullptr) {
+        ++bundle._received;
+      }
+      bundle._data[index] = std::move(data);
+      if (!bundle.IsComplete()) {
+        return;
+      }
+      if (_policy == Policy::LatestOnly) {
+        DropFramesOlderThan(frame);
+      }
+    }
+    _cv.notify_all();
+  }
+
+  void SensorFrameQueue::DropFramesOlderThan(const size_t frame) {
+    auto end = _frames.lower_bound(frame);
+    _dropped_frames += static_cast<size_t>(std::distance(_frames.begin(), end));
+    _frames.erase(_frames.begin(), end);
+    _first_pending_frame = std::max(_first_pending_frame, frame);
+  }
+
+  boost::optional<SensorDataBundle> SensorFrameQueue::PopFrame(const size_t frame) {
+    auto it = _frames.find(frame);
+    DEBUG_ASSERT(it != _frames.end());
+    SensorDataBundle result = std::move(it->second);
+    _frames.erase(it);
+    _first_pending_frame = std::max(_first_pending_frame, frame + 1u);
+    return result;
+  }
+
+} // namespace detail
+} // namespace client
+} // namespace carla
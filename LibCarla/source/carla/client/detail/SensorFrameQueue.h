@@ -0,0 +1,95 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Memory.h"
+#include "carla/NonCopyable.h"
+#include "carla/Time.h"
+#include "carla/client/SensorDataBundle.h"
+
+#include <boost/optional.hpp>
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
+namespace carla {
+namespace sensor { class SensorData; }
+namespace client {
+namespace detail {
+
+  /// Joins by frame the measurements pushed for each of a fixed number of
+  /// sensors, on behalf of SensorBundle.
+  ///
+  /// Pushing never blocks, frames are kept until retrieved with WaitForFrame
+  /// or WaitForNext. At most @a max_queued_frames frames are kept, older
+  /// frames are dropped when a new one arrives. Data for a frame already
+  /// returned or dropped is discarded. Waiting only blocks while the queue is
+  /// open.
+  class SensorFrameQueue : private NonCopyable {
+  public:
+
+    enum class Policy {
+      /// Keep every frame, up to @a max_queued_frames, until it is retrieved.
+      Queue,
+      /// Keep only the most recent complete frame. When a frame completes,
+      /// any older frame is dropped.
+      LatestOnly
+    };
+
+    SensorFrameQueue(size_t number_of_sensors, Policy policy, size_t max_queued_frames);
+
+    void Open();
+
+    /// Close the queue and wake up any waiting thread.
+    void Close();
+
+    bool IsOpen() const;
+
+    /// Store the measurement of the sensor at @a index.
+    void Push(size_t index, SharedPtr<sensor::SensorData> data);
+
+    /// @copydoc SensorBundle::WaitForFrame
+    boost::optional<SensorDataBundle> WaitForFrame(
+        size_t frame,
+        time_duration timeout,
+        bool allow_incomplete = false);
+
+    /// @copydoc SensorBundle::WaitForNext
+    boost::optional<SensorDataBundle> WaitForNext(time_duration timeout);
+
+    size_t GetNumberOfDroppedFrames() const;
+
+  private:
+
+    void DropFramesOlderThan(size_t frame);
+
+    boost::optional<SensorDataBundle> PopFrame(size_t frame);
+
+    const size_t _number_of_sensors;
+
+    const Policy _policy;
+
+    const size_t _max_queued_frames;
+
+    mutable std::mutex _mutex;
+
+    std::condition_variable _cv;
+
+    std::map<size_t, SensorDataBundle> _frames;
+
+    /// Frames below this one were already returned or dropped.
+    size_t _first_pending_frame = 0u;
+
+    size_t _dropped_frames = 0u;
+
+    bool _is_open = false;
+  };
+
+} // namespace detail
+} // namespace client
+} // namespace carla
@@ -72,9 +72,10 @@ namespace detail {
       const std::string &host,
       const uint16_t port,
       const size_t worker_threads,
-      const bool enable_garbage_collection)
+      const bool enable_garbage_collection,
+      const bool share_connection)
     : LIBCARLA_INITIALIZE_LIFETIME_PROFILER("SimulatorClient("s + host + ":" + std::to_string(port) + ")"),
-      _client(host, port, worker_threads),
+      _client(host, port, worker_threads, share_connection),
       _light_manager(new LightManager()),
       _gc_policy(enable_garbage_collection ?
         GarbageCollectionPolicy::Enabled : GarbageCollectionPolicy::Disabled) {}
@@ -59,7 +59,8 @@ namespace detail {
         const std::string &host,
         uint16_t port,
         size_t worker_threads = 0u,
-        bool enable_garbage_collection = false);
+        bool enable_garbage_collection = false,
+        bool share_connection = false);
 
     /// @}
     // =========================================================================
@@ -187,6 +188,16 @@ namespace detail {
       _episode->RemoveOnTickEvent(id);
     }
 
+    std::shared_ptr<LaneInvasionDetector> CreateLaneInvasionDetectorIfMissing() {
+      DEBUG_ASSERT(_episode != nullptr);
+      return _episode->CreateLaneInvasionDetectorIfMissing();
+    }
+
+    std::shared_ptr<LaneInvasionDetector> GetLaneInvasionDetector() const {
+      DEBUG_ASSERT(_episode != nullptr);
+      return _episode->GetLaneInvasionDetector();
+    }
+
     uint64_t Tick(time_duration timeout);
 
     /// @}
@@ -667,6 +678,10 @@ namespace detail {
       return _client.ApplyBatchSync(std::move(commands), do_tick_cue);
     }
 
+    void ApplyVehicleControlBatch(const rpc::VehicleControlBatch &batch, bool do_tick_cue) {
+      _client.ApplyVehicleControlBatch(batch, do_tick_cue);
+    }
+
     /// @}
     // =========================================================================
     /// @name Operations lights
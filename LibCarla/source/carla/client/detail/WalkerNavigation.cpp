@@ -6,6 +6,7 @@
 
 #include "carla/client/detail/WalkerNavigation.h"
 
+#include "carla/Logging.h"
 #include "carla/client/detail/Client.h"
 #include "carla/client/detail/Episode.h"
 #include "carla/client/detail/EpisodeState.h"
@@ -14,6 +15,7 @@
 #include "carla/rpc/DebugShape.h"
 #include "carla/rpc/WalkerControl.h"
 
+#include <exception>
 #include <sstream>
 
 namespace carla {
@@ -26,39 +28,76 @@ namespace detail {
     if (!files.empty()) {
       _nav.Load(_client.GetCacheFile(files[0]));
     }
+    _worker.AsyncRun(1u);
   }
 
   void WalkerNavigation::Tick(std::shared_ptr<Episode> episode) {
-    auto walkers = _walkers.Load();
-    if (walkers->empty()) {
+    if (_walkers.Load()->empty()) {
       return;
     }
 
-    // get current state
-    std::shared_ptr<const EpisodeState> state = episode->GetState();
+    std::vector<rpc::Command> commands;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      // step now if the worker didn't get to it
+      Step(episode->GetState());
+      commands = std::move(_commands);
+      _commands.clear();
+      _schedule.OnSent();
+    }
+
+    // wait for the answer, the RPC server may run the tick cue sent after
+    // this batch before it, so the walker states would miss their frame
+    if (!commands.empty()) {
+      _client.ApplyBatchSync(std::move(commands), false);
+    }
+  }
+
+  void WalkerNavigation::OnTick(std::shared_ptr<const EpisodeState> state) {
+    if (_walkers.Load()->empty() || _is_step_posted.exchange(true)) {
+      return;
+    }
+    _worker.Post([this, state]() {
+      try {
+        std::lock_guard<std::mutex> lock(_mutex);
+        Step(state);
+      } catch (const std::exception &e) {
+        log_error("exception updating the walkers:", e.what());
+      }
+      _is_step_posted = false;
+    });
+  }
+
+  void WalkerNavigation::Step(std::shared_ptr<const EpisodeState> state) {
+    auto walkers = _walkers.Load();
+    // skip if the previous step has not been sent yet or the state is not
+    // newer than the last one stepped
+    if (walkers->empty() || !_schedule.ShouldStep(state->GetFrame())) {
+      return;
+    }
 
     // purge all possible dead walkers
     CheckIfWalkerExist(*walkers, *state);
 
     // add/update/delete all vehicles in crowd
-    UpdateVehiclesInCrowd(episode, false);
+    UpdateVehiclesInCrowd(*state, false);
 
     // update crowd in navigation module
     _nav.UpdateCrowd(*state);
 
     carla::geom::Transform trans;
     using Cmd = rpc::Command;
-    std::vector<Cmd> commands;
-    commands.reserve(walkers->size());
+    _commands.clear();
+    _commands.reserve(walkers->size());
     for (auto handle : *walkers) {
       // get the transform of the walker
       if (_nav.GetWalkerTransform(handle.walker, trans)) {
         float speed = _nav.GetWalkerSpeed(handle.walker);
-        commands.emplace_back(Cmd::ApplyWalkerState{ handle.walker, trans, speed });
+        _commands.emplace_back(Cmd::ApplyWalkerState{ handle.walker, trans, speed });
       }
     }
 
-    _client.ApplyBatchSync(std::move(commands), false);
+    _schedule.OnStepped(state->GetFrame());
   }
 
   void WalkerNavigation::CheckIfWalkerExist(std::vector<WalkerHandle> walkers, const EpisodeState &state) {
@@ -82,20 +121,44 @@ namespace detail {
   }
 
   // add/update/delete all vehicles in crowd
-  void WalkerNavigation::UpdateVehiclesInCrowd(std::shared_ptr<Episode> episode, bool show_debug) {
+  void WalkerNavigation::UpdateVehiclesInCrowd(const EpisodeState &state, bool show_debug) {
     std::vector<carla::nav::VehicleCollisionInfo> vehicles;
 
-    // get current state
-    std::shared_ptr<const EpisodeState> state = episode->GetState();
+    // forget the actors destroyed
+    for (auto it = _actor_index.begin(); it != _actor_index.end();) {
+      if (state.ContainsActorSnapshot(it->first)) {
+        ++it;
+      } else {
+        it = _actor_index.erase(it);
+      }
+    }
+
+    // classify the new actors, only these need to be asked for
+    std::vector<ActorId> new_actors;
+    for (auto id : state.GetActorIds()) {
+      if (_actor_index.find(id) == _actor_index.end()) {
+        new_actors.emplace_back(id);
+      }
+    }
+    if (!new_actors.empty()) {
+      for (auto &&actor : _client.GetActorsById(new_actors)) {
+        boost::optional<geom::BoundingBox> bounding_box;
+        // only vehicles
+        if (actor.description.id.rfind("vehicle.", 0) == 0) {
+          bounding_box = actor.bounding_box;
+        }
+        _actor_index.emplace(actor.id, bounding_box);
+      }
+    }
 
-    // get all vehicles from episode
-    for (auto &&actor : episode->GetActors()) {
-      // only vehicles
-      if (actor.description.id.rfind("vehicle.", 0) == 0) {
+    // get all vehicles from the index
+    vehicles.reserve(_actor_index.size());
+    for (auto &&entry : _actor_index) {
+      if (entry.second.has_value()) {
         // get the snapshot
-        ActorSnapshot snapshot = state->GetActorSnapshot(actor.id);
+        ActorSnapshot snapshot = state.GetActorSnapshot(entry.first);
         // add to the vector
-        vehicles.emplace_back(carla::nav::VehicleCollisionInfo{actor.id, snapshot.transform, actor.bounding_box});
+        vehicles.emplace_back(carla::nav::VehicleCollisionInfo{entry.first, snapshot.transform, *entry.second});
       }
     }
 
@@ -9,11 +9,21 @@
 #include "carla/AtomicList.h"
 #include "carla/nav/Navigation.h"
 #include "carla/NonCopyable.h"
+#include "carla/ThreadPool.h"
 #include "carla/client/Timestamp.h"
 #include "carla/client/detail/EpisodeProxy.h"
+#include "carla/client/detail/WalkerStepSchedule.h"
+#include "carla/geom/BoundingBox.h"
 #include "carla/rpc/ActorId.h"
+#include "carla/rpc/Command.h"
 
+#include <boost/optional.hpp>
+
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace carla {
 namespace client {
@@ -23,6 +33,14 @@ namespace detail {
   class Episode;
   class EpisodeState;
 
+  /// Moves the walkers controlled by the AI controllers with Detour's crowd.
+  ///
+  /// The crowd is stepped in a worker thread as soon as a new episode state
+  /// arrives, so it overlaps with whatever the client does until its next
+  /// tick; Tick only sends the resulting walker states and waits for the
+  /// server to apply them. If the worker has not finished yet Tick waits for
+  /// it, and if it has not started Tick steps the crowd itself. The crowd is
+  /// stepped at most once per Tick.
   class WalkerNavigation
     : public std::enable_shared_from_this<WalkerNavigation>,
     private NonCopyable {
@@ -50,19 +68,27 @@ namespace detail {
     }
 
     void RemoveWalker(ActorId walker_id) {
+      std::lock_guard<std::mutex> lock(_mutex);
       // remove the walker in the crowd
       _nav.RemoveAgent(walker_id);
     }
 
     void AddWalker(ActorId walker_id, carla::geom::Location location) {
+      std::lock_guard<std::mutex> lock(_mutex);
       // create the walker in the crowd (to manage its movement in Detour)
       _nav.AddWalker(walker_id, location);
     }
 
+    /// Send the walker states to the simulator, called before each tick.
     void Tick(std::shared_ptr<Episode> episode);
 
+    /// Start stepping the crowd with @a state in the worker thread, to be
+    /// called when a new episode state arrives.
+    void OnTick(std::shared_ptr<const EpisodeState> state);
+
     // Get Random location in nav mesh
     boost::optional<geom::Location> GetRandomLocation() {
+      std::lock_guard<std::mutex> lock(_mutex);
       geom::Location random_location(0, 0, 0);
       if (_nav.GetRandomLocation(random_location))
         return boost::optional<geom::Location>(random_location);
@@ -72,20 +98,24 @@ namespace detail {
 
     // set a new target point to go
     bool SetWalkerTarget(ActorId id, const carla::geom::Location to) {
+      std::lock_guard<std::mutex> lock(_mutex);
       return _nav.SetWalkerTarget(id, to);
     }
 
     // set new max speed
     bool SetWalkerMaxSpeed(ActorId id, float max_speed) {
+      std::lock_guard<std::mutex> lock(_mutex);
       return _nav.SetWalkerMaxSpeed(id, max_speed);
     }
 
     // set percentage of pedestrians that can cross the road
     void SetPedestriansCrossFactor(float percentage) {
+      std::lock_guard<std::mutex> lock(_mutex);
       _nav.SetPedestriansCrossFactor(percentage);
     }
 
     void SetPedestriansSeed(unsigned int seed) {
+      std::lock_guard<std::mutex> lock(_mutex);
       _nav.SetSeed(seed);
     }
 
@@ -104,10 +134,31 @@ namespace detail {
 
     AtomicList<WalkerHandle> _walkers;
 
+    /// Guards _nav and every member below.
+    std::mutex _mutex;
+
+    /// Walker states of the last step, not sent yet.
+    std::vector<rpc::Command> _commands;
+
+    WalkerStepSchedule _schedule;
+
+    std::atomic_bool _is_step_posted { false };
+
+    /// Bounding box of every actor seen that is a vehicle, none for the other
+    /// actors, so each actor is only classified once.
+    std::unordered_map<ActorId, boost::optional<geom::BoundingBox>> _actor_index;
+
+    /// step the crowd with @a state and keep the walker states if the schedule
+    /// allows it, requires _mutex
+    void Step(std::shared_ptr<const EpisodeState> state);
     /// check a few walkers and if they don't exist then remove from the crowd
     void CheckIfWalkerExist(std::vector<WalkerHandle> walkers, const EpisodeState &state);
     /// add/update/delete all vehicles in crowd
-    void UpdateVehiclesInCrowd(std::shared_ptr<Episode> episode, bool show_debug = false);
+    void UpdateVehiclesInCrowd(const EpisodeState &state, bool show_debug = false);
+
+    /// Declared last so the worker is joined before anything it uses is
+    /// destroyed.
+    ThreadPool _worker;
   };
 
 } // namespace detail
@@ -0,0 +1,54 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include <cstddef>
+
+namespace carla {
+namespace client {
+namespace detail {
+
+  /// Decides which episode states WalkerNavigation steps the crowd with.
+  ///
+  /// The crowd is stepped at most once between two sends of the walker
+  /// states, and only with states newer than the last one it was stepped
+  /// with, whether the step runs in the worker or inline in Tick. A worker
+  /// job that waited for the lock while Tick stepped with a newer state is
+  /// therefore discarded. Not thread-safe, the owner guards it.
+  class WalkerStepSchedule {
+  public:
+
+    /// Whether the crowd should be stepped with the state of @a frame.
+    bool ShouldStep(std::size_t frame) const {
+      return !_has_pending_step &&
+          (!_stepped_frame.has_value() || (frame > *_stepped_frame));
+    }
+
+    /// The crowd was stepped with the state of @a frame, its walker states
+    /// are pending to be sent.
+    void OnStepped(std::size_t frame) {
+      _stepped_frame = frame;
+      _has_pending_step = true;
+    }
+
+    /// The walker states of the last step were sent.
+    void OnSent() {
+      _has_pending_step = false;
+    }
+
+  private:
+
+    boost::optional<std::size_t> _stepped_frame;
+
+    bool _has_pending_step = false;
+  };
+
+} // namespace detail
+} // namespace client
+} // namespace carla
@@ -9,6 +9,7 @@
 #include "carla/Debug.h"
 #include "carla/MsgPack.h"
 #include "carla/geom/Transform.h"
+#include "carla/geom/TransformMatrix.h"
 #include "carla/geom/Location.h"
 #include "carla/geom/Vector3D.h"
 
@@ -74,17 +75,18 @@ namespace geom {
      *  Returns the positions of the 8 vertices of this BoundingBox in local space.
      */
     std::array<Location, 8> GetLocalVertices() const {
-
-        return {{
-            location + Location(rotation.RotateVector({-extent.x,-extent.y,-extent.z})),
-            location + Location(rotation.RotateVector({-extent.x,-extent.y, extent.z})),
-            location + Location(rotation.RotateVector({-extent.x, extent.y,-extent.z})),
-            location + Location(rotation.RotateVector({-extent.x, extent.y, extent.z})),
-            location + Location(rotation.RotateVector({ extent.x,-extent.y,-extent.z})),
-            location + Location(rotation.RotateVector({ extent.x,-extent.y, extent.z})),
-            location + Location(rotation.RotateVector({ extent.x, extent.y,-extent.z})),
-            location + Location(rotation.RotateVector({ extent.x, extent.y, extent.z}))
+        std::array<Location, 8> vertices = {{
+            Location(-extent.x,-extent.y,-extent.z),
+            Location(-extent.x,-extent.y, extent.z),
+            Location(-extent.x, extent.y,-extent.z),
+            Location(-extent.x, extent.y, extent.z),
+            Location( extent.x,-extent.y,-extent.z),
+            Location( extent.x,-extent.y, extent.z),
+            Location( extent.x, extent.y,-extent.z),
+            Location( extent.x, extent.y, extent.z)
         }};
+        TransformMatrix(Transform(location, rotation)).TransformPoints(vertices.data(), vertices.size());
+        return vertices;
     }
 
     /**
@@ -110,9 +112,7 @@ namespace geom {
      */
     std::array<Location, 8> GetWorldVertices(const Transform &in_bbox_to_world_tr) const {
         auto world_vertices = GetLocalVertices();
-        std::for_each(world_vertices.begin(), world_vertices.end(), [&in_bbox_to_world_tr](auto &world_vertex) {
-          in_bbox_to_world_tr.TransformPoint(world_vertex);
-        });
+        TransformMatrix(in_bbox_to_world_tr).TransformPoints(world_vertices.data(), world_vertices.size());
         return world_vertices;
     }
 
@@ -0,0 +1,450 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include <carla/geom/CompactMesh.h>
+
+#include <carla/Debug.h>
+#include <carla/Exception.h>
+#include <carla/geom/Math.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace carla {
+namespace geom {
+
+  // ===========================================================================
+  // -- Static local methods ---------------------------------------------------
+  // ===========================================================================
+
+  static constexpr uint32_t MAGIC = 0x48534D43u; // "CMSH"
+  static constexpr uint32_t VERSION = 1u;
+
+  static constexpr uint32_t FLAG_NORMALS = 1u << 0u;
+  static constexpr uint32_t FLAG_UVS = 1u << 1u;
+  static constexpr uint32_t FLAG_HALF_PRECISION = 1u << 2u;
+
+  /// Meters to Unreal units.
+  static constexpr float TO_CENTIMETERS = 1e2f;
+
+  /// IEEE 754 binary32 to binary16, rounding to nearest.
+  static uint16_t FloatToHalf(const float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = (bits >> 16u) & 0x8000u;
+    const uint32_t biased_exponent = (bits >> 23u) & 0xFFu;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+    if (biased_exponent == 0xFFu) {
+      // Infinity or NaN.
+      return static_cast<uint16_t>(sign | 0x7C00u | (mantissa != 0u ? 0x200u : 0u));
+    }
+    const int32_t exponent = static_cast<int32_t>(biased_exponent) - 127 + 15;
+    if (exponent >= 0x1F) {
+      return static_cast<uint16_t>(sign | 0x7C00u);
+    }
+    if (exponent <= 0) {
+      // Subnormal half, or zero if too small.
+      if (exponent < -10) {
+        return static_cast<uint16_t>(sign);
+      }
+      mantissa |= 0x800000u;
+      const uint32_t shift = static_cast<uint32_t>(14 - exponent);
+      uint32_t half = mantissa >> shift;
+      if ((mantissa >> (shift - 1u)) & 1u) {
+        ++half;
+      }
+      return static_cast<uint16_t>(sign | half);
+    }
+    uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10u) | (mantissa >> 13u);
+    if (mantissa & 0x1000u) {
+      // A carry into the exponent still gives the right result.
+      ++half;
+    }
+    return static_cast<uint16_t>(half);
+  }
+
+  static float HalfToFloat(const uint16_t half) {
+    const uint32_t sign = (static_cast<uint32_t>(half) & 0x8000u) << 16u;
+    const uint32_t exponent = (half >> 10u) & 0x1Fu;
+    const uint32_t mantissa = half & 0x3FFu;
+    uint32_t bits;
+    if (exponent == 0u) {
+      const float value = std::ldexp(static_cast<float>(mantissa), -24);
+      return sign != 0u ? -value : value;
+    } else if (exponent == 0x1Fu) {
+      bits = sign | 0x7F800000u | (mantissa << 13u);
+    } else {
+      bits = sign | ((exponent + 112u) << 23u) | (mantissa << 13u);
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  static uint64_t GetCellKey(int64_t x, int64_t y, int64_t z) {
+    // Collisions only cost an extra distance check.
+    constexpr uint64_t mask = (1u << 21u) - 1u;
+    return ((static_cast<uint64_t>(x) & mask) << 42u) |
+           ((static_cast<uint64_t>(y) & mask) << 21u) |
+           (static_cast<uint64_t>(z) & mask);
+  }
+
+  template <typename T>
+  static void Write(std::vector<uint8_t> &out, const T *data, size_t count) {
+    const auto bytes = reinterpret_cast<const uint8_t *>(data);
+    out.insert(out.end(), bytes, bytes + count * sizeof(T));
+  }
+
+  template <typename T>
+  static void Write(std::vector<uint8_t> &out, const T &value) {
+    Write(out, &value, 1u);
+  }
+
+  /// Reads POD arrays from a blob, checking its bounds.
+  class BlobReader {
+  public:
+
+    BlobReader(const uint8_t *data, size_t size) : _data(data), _size(size) {}
+
+    template <typename T>
+    void Read(T *out, size_t count) {
+      const size_t bytes = count * sizeof(T);
+      if (count > _size / sizeof(T) || bytes > _size - _offset) {
+        throw_exception(std::invalid_argument("CompactMesh: truncated blob"));
+      }
+      if (bytes > 0u) {
+        std::memcpy(out, _data + _offset, bytes);
+        _offset += bytes;
+      }
+    }
+
+    template <typename T>
+    T Read() {
+      T value;
+      Read(&value, 1u);
+      return value;
+    }
+
+  private:
+
+    const uint8_t *_data;
+
+    size_t _size;
+
+    size_t _offset = 0u;
+  };
+
+  // ===========================================================================
+  // -- CompactMesh ------------------------------------------------------------
+  // ===========================================================================
+
+  CompactMesh::normal_type CompactMesh::GetNormal(const size_t vertex_index) const {
+    DEBUG_ASSERT(_has_normals && vertex_index < _vertices.size());
+    const size_t i = 3u * vertex_index;
+    if (_half_precision) {
+      return {
+          HalfToFloat(_half_normals[i]),
+          HalfToFloat(_half_normals[i + 1u]),
+          HalfToFloat(_half_normals[i + 2u])};
+    }
+    return {_normals[i], _normals[i + 1u], _normals[i + 2u]};
+  }
+
+  CompactMesh::uv_type CompactMesh::GetUV(const size_t vertex_index) const {
+    DEBUG_ASSERT(_has_uvs && vertex_index < _vertices.size());
+    const size_t i = 2u * vertex_index;
+    if (_half_precision) {
+      return {HalfToFloat(_half_uvs[i]), HalfToFloat(_half_uvs[i + 1u])};
+    }
+    return {_uvs[i], _uvs[i + 1u]};
+  }
+
+  size_t CompactMesh::GetSizeInBytes() const {
+    return
+        _vertices.size() * sizeof(vertex_type) +
+        _indexes.size() * sizeof(index_type) +
+        _normals.size() * sizeof(float) +
+        _half_normals.size() * sizeof(uint16_t) +
+        _uvs.size() * sizeof(float) +
+        _half_uvs.size() * sizeof(uint16_t);
+  }
+
+  std::vector<uint8_t> CompactMesh::Serialize() const {
+    uint32_t flags = 0u;
+    flags |= _has_normals ? FLAG_NORMALS : 0u;
+    flags |= _has_uvs ? FLAG_UVS : 0u;
+    flags |= _half_precision ? FLAG_HALF_PRECISION : 0u;
+
+    std::vector<uint8_t> out;
+    out.reserve(6u * sizeof(uint32_t) + GetSizeInBytes());
+    Write(out, MAGIC);
+    Write(out, VERSION);
+    Write(out, flags);
+    Write(out, static_cast<uint32_t>(_vertices.size()));
+    Write(out, static_cast<uint32_t>(_indexes.size()));
+    Write(out, static_cast<uint32_t>(_sections.size()));
+    Write(out, _vertices.data(), _vertices.size());
+    Write(out, _indexes.data(), _indexes.size());
+    Write(out, _normals.data(), _normals.size());
+    Write(out, _half_normals.data(), _half_normals.size());
+    Write(out, _uvs.data(), _uvs.size());
+    Write(out, _half_uvs.data(), _half_uvs.size());
+    for (const auto &section : _sections) {
+      Write(out, section.index_start);
+      Write(out, section.index_end);
+      Write(out, static_cast<uint32_t>(section.material.size()));
+      Write(out, section.material.data(), section.material.size());
+    }
+    return out;
+  }
+
+  CompactMesh CompactMesh::Deserialize(const uint8_t *data, const size_t size) {
+    BlobReader reader(data, size);
+    if (reader.Read<uint32_t>() != MAGIC || reader.Read<uint32_t>() != VERSION) {
+      throw_exception(std::invalid_argument("CompactMesh: not a compact mesh blob"));
+    }
+    const auto flags = reader.Read<uint32_t>();
+    const auto vertex_count = reader.Read<uint32_t>();
+    const auto index_count = reader.Read<uint32_t>();
+    const auto section_count = reader.Read<uint32_t>();
+
+    CompactMesh mesh;
+    mesh._has_normals = (flags & FLAG_NORMALS) != 0u;
+    mesh._has_uvs = (flags & FLAG_UVS) != 0u;
+    mesh._half_precision = (flags & FLAG_HALF_PRECISION) != 0u;
+
+    // Check the counts before allocating anything.
+    if (vertex_count > size / sizeof(vertex_type) || index_count > size / sizeof(index_type)) {
+      throw_exception(std::invalid_argument("CompactMesh: truncated blob"));
+    }
+    mesh._vertices.resize(vertex_count);
+    reader.Read(mesh._vertices.data(), vertex_count);
+    mesh._indexes.resize(index_count);
+    reader.Read(mesh._indexes.data(), index_count);
+    for (auto index : mesh._indexes) {
+      if (index >= vertex_count) {
+        throw_exception(std::invalid_argument("CompactMesh: index out of range"));
+      }
+    }
+    if (mesh._has_normals) {
+      if (mesh._half_precision) {
+        mesh._half_normals.resize(3u * vertex_count);
+        reader.Read(mesh._half_normals.data(), mesh._half_normals.size());
+      } else {
+        mesh._normals.resize(3u * vertex_count);
+        reader.Read(mesh._normals.data(), mesh._normals.size());
+      }
+    }
+    if (mesh._has_uvs) {
+      if (mesh._half_precision) {
+        mesh._half_uvs.resize(2u * vertex_count);
+        reader.Read(mesh._half_uvs.data(), mesh._half_uvs.size());
+      } else {
+        mesh._uvs.resize(2u * vertex_count);
+        reader.Read(mesh._uvs.data(), mesh._uvs.size());
+      }
+    }
+    for (uint32_t i = 0u; i < section_count; ++i) {
+      Section section;
+      section.index_start = reader.Read<uint32_t>();
+      section.index_end = reader.Read<uint32_t>();
+      const auto name_length = reader.Read<uint32_t>();
+      if (name_length > size) {
+        throw_exception(std::invalid_argument("CompactMesh: truncated blob"));
+      }
+      section.material.resize(name_length);
+      reader.Read(&section.material[0], name_length);
+      mesh._sections.emplace_back(std::move(section));
+    }
+    return mesh;
+  }
+
+  // ===========================================================================
+  // -- CompactMeshBuilder -----------------------------------------------------
+  // ===========================================================================
+
+  CompactMeshBuilder::CompactMeshBuilder()
+    : CompactMeshBuilder(Parameters{}) {}
+
+  CompactMeshBuilder::CompactMeshBuilder(Parameters parameters)
+    : _parameters(parameters) {}
+
+  CompactMesh::index_type CompactMeshBuilder::AddVertex(
+      const Vector3D &position,
+      const Vector2D &uv) {
+    const float weld_distance = _parameters.weld_distance;
+    if (weld_distance <= 0.0f) {
+      _positions.emplace_back(position);
+      _uvs.emplace_back(uv);
+      return static_cast<CompactMesh::index_type>(_positions.size() - 1u);
+    }
+
+    // With cells of twice the weld distance, any vertex close enough is in
+    // this cell or in the neighbour towards which the position is closer, so
+    // at most eight cells are checked.
+    const float cell_size = 2.0f * weld_distance;
+    const float cell[3] = {
+        position.x / cell_size,
+        position.y / cell_size,
+        position.z / cell_size};
+    int64_t base[3];
+    int64_t side[3];
+    for (auto i = 0u; i < 3u; ++i) {
+      const float floor = std::floor(cell[i]);
+      base[i] = static_cast<int64_t>(floor);
+      side[i] = (cell[i] - floor) < 0.5f ? -1 : 1;
+    }
+    const float max_distance_squared = weld_distance * weld_distance;
+    for (auto corner = 0u; corner < 8u; ++corner) {
+      const auto key = GetCellKey(
+          base[0] + ((corner & 1u) ? side[0] : 0),
+          base[1] + ((corner & 2u) ? side[1] : 0),
+          base[2] + ((corner & 4u) ? side[2] : 0));
+      const auto range = _grid.equal_range(key);
+      for (auto it = range.first; it != range.second; ++it) {
+        const auto index = it->second;
+        if (Math::DistanceSquared(_positions[index], position) <= max_distance_squared &&
+            _uvs[index] == uv) {
+          return index;
+        }
+      }
+    }
+
+    const auto index = static_cast<CompactMesh::index_type>(_positions.size());
+    _positions.emplace_back(position);
+    _uvs.emplace_back(uv);
+    _grid.emplace(GetCellKey(base[0], base[1], base[2]), index);
+    return index;
+  }
+
+  void CompactMeshBuilder::AddTriangle(
+      const CompactMesh::index_type a,
+      const CompactMesh::index_type b,
+      const CompactMesh::index_type c) {
+    // Unreal's winding is the opposite of geom::Mesh's.
+    _indexes.emplace_back(a);
+    _indexes.emplace_back(c);
+    _indexes.emplace_back(b);
+  }
+
+  void CompactMeshBuilder::AddTriangle(
+      const Vector3D &v0,
+      const Vector3D &v1,
+      const Vector3D &v2) {
+    const auto a = AddVertex(v0, Vector2D());
+    const auto b = AddVertex(v1, Vector2D());
+    const auto c = AddVertex(v2, Vector2D());
+    if (a != b && b != c && a != c) {
+      AddTriangle(a, b, c);
+    }
+  }
+
+  void CompactMeshBuilder::AddMesh(const Mesh &mesh) {
+    const auto &vertices = mesh.GetVertices();
+    const auto &uvs = mesh.GetUVs();
+    const bool has_uvs = !uvs.empty() && uvs.size() == vertices.size();
+    _has_uvs |= has_uvs;
+
+    std::vector<CompactMesh::index_type> remap;
+    remap.reserve(vertices.size());
+    for (size_t i = 0u; i < vertices.size(); ++i) {
+      remap.emplace_back(AddVertex(vertices[i], has_uvs ? uvs[i] : Vector2D()));
+    }
+
+    // Welding can collapse triangles, so keep count of the indexes written
+    // before each triangle to move the material ranges along.
+    const auto &indexes = mesh.GetIndexes();
+    const size_t triangle_count = indexes.size() / 3u;
+    std::vector<size_t> written_before(triangle_count + 1u);
+    const size_t first_index = _indexes.size();
+    for (size_t t = 0u; t < triangle_count; ++t) {
+      written_before[t] = _indexes.size() - first_index;
+      // geom::Mesh indexes start at 1.
+      const auto a = remap.at(indexes[3u * t] - 1u);
+      const auto b = remap.at(indexes[3u * t + 1u] - 1u);
+      const auto c = remap.at(indexes[3u * t + 2u] - 1u);
+      if (a != b && b != c && a != c) {
+        AddTriangle(a, b, c);
+      }
+    }
+    written_before[triangle_count] = _indexes.size() - first_index;
+
+    for (const auto &material : mesh.GetMaterials()) {
+      // Materials not closed extend to the end of the mesh.
+      const size_t end = material.index_end == 0u ? indexes.size() : material.index_end;
+      _sections.push_back(CompactMesh::Section{
+          material.name,
+          static_cast<CompactMesh::index_type>(
+              first_index + written_before[std::min(material.index_start / 3u, triangle_count)]),
+          static_cast<CompactMesh::index_type>(
+              first_index + written_before[std::min(end / 3u, triangle_count)])});
+    }
+  }
+
+  CompactMesh CompactMeshBuilder::Build() {
+    CompactMesh mesh;
+    mesh._has_normals = _parameters.compute_normals;
+    mesh._has_uvs = _has_uvs;
+    mesh._half_precision = _parameters.half_precision;
+    mesh._sections = std::move(_sections);
+    mesh._indexes = std::move(_indexes);
+
+    mesh._vertices.reserve(_positions.size());
+    for (const auto &position : _positions) {
+      mesh._vertices.emplace_back(position * TO_CENTIMETERS);
+    }
+
+    if (mesh._has_normals) {
+      // Sum of the face normals around each vertex, weighted by area.
+      std::vector<Vector3D> normals(_positions.size());
+      for (size_t i = 0u; i + 2u < mesh._indexes.size(); i += 3u) {
+        const auto a = mesh._indexes[i];
+        const auto b = mesh._indexes[i + 2u];
+        const auto c = mesh._indexes[i + 1u];
+        auto normal = Math::Cross(_positions[b] - _positions[a], _positions[c] - _positions[a]);
+        if (normal.z < 0.0f) {
+          normal *= -1.0f;
+        }
+        normals[a] += normal;
+        normals[b] += normal;
+        normals[c] += normal;
+      }
+      for (auto &normal : normals) {
+        normal = normal.SquaredLength() > 0.0f ?
+            normal.MakeUnitVector() :
+            Vector3D(0.0f, 0.0f, 1.0f);
+        if (mesh._half_precision) {
+          mesh._half_normals.insert(mesh._half_normals.end(), {
+              FloatToHalf(normal.x), FloatToHalf(normal.y), FloatToHalf(normal.z)});
+        } else {
+          mesh._normals.insert(mesh._normals.end(), {normal.x, normal.y, normal.z});
+        }
+      }
+    }
+
+    if (mesh._has_uvs) {
+      for (const auto &uv : _uvs) {
+        if (mesh._half_precision) {
+          mesh._half_uvs.insert(mesh._half_uvs.end(), {FloatToHalf(uv.x), FloatToHalf(uv.y)});
+        } else {
+          mesh._uvs.insert(mesh._uvs.end(), {uv.x, uv.y});
+        }
+      }
+    }
+
+    _positions.clear();
+    _uvs.clear();
+    _indexes.clear();
+    _sections.clear();
+    _has_uvs = false;
+    _grid.clear();
+    return mesh;
+  }
+
+} // namespace geom
+} // namespace carla
@@ -0,0 +1,228 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <carla/geom/Mesh.h>
+#include <carla/geom/Vector2D.h>
+#include <carla/geom/Vector3D.h>
+
+#ifdef LIBCARLA_INCLUDED_FROM_UE4
+#include <compiler/enable-ue4-macros.h>
+#include "Util/ProceduralCustomMesh.h"
+#include <compiler/disable-ue4-macros.h>
+#endif // LIBCARLA_INCLUDED_FROM_UE4
+
+namespace carla {
+namespace geom {
+
+  /// Triangle mesh laid out the way Unreal's procedural mesh component takes
+  /// it: positions in centimeters, zero-based 32-bit indexes with Unreal's
+  /// winding, and optional per-vertex normals and UVs, stored in full or half
+  /// precision. Vertices are shared between triangles, see CompactMeshBuilder.
+  class CompactMesh {
+  public:
+
+    using vertex_type = Vector3D;
+    using normal_type = Vector3D;
+    using index_type = uint32_t;
+    using uv_type = Vector2D;
+
+    /// Range of indexes [index_start, index_end) that uses a material.
+    struct Section {
+      std::string material;
+      index_type index_start;
+      index_type index_end;
+    };
+
+    // =========================================================================
+    // -- Accessors ------------------------------------------------------------
+    // =========================================================================
+
+    size_t GetVerticesNum() const {
+      return _vertices.size();
+    }
+
+    size_t GetIndexesNum() const {
+      return _indexes.size();
+    }
+
+    /// Vertex positions, in centimeters.
+    const std::vector<vertex_type> &GetVertices() const {
+      return _vertices;
+    }
+
+    const std::vector<index_type> &GetIndexes() const {
+      return _indexes;
+    }
+
+    const std::vector<Section> &GetSections() const {
+      return _sections;
+    }
+
+    bool HasNormals() const {
+      return _has_normals;
+    }
+
+    bool HasUVs() const {
+      return _has_uvs;
+    }
+
+    bool IsHalfPrecision() const {
+      return _half_precision;
+    }
+
+    normal_type GetNormal(size_t vertex_index) const;
+
+    uv_type GetUV(size_t vertex_index) const;
+
+    /// Bytes used by the vertex, index, normal and UV arrays.
+    size_t GetSizeInBytes() const;
+
+    // =========================================================================
+    // -- Serialization --------------------------------------------------------
+    // =========================================================================
+
+    /// Encodes the mesh in a binary blob: a header of six uint32 (magic,
+    /// version, flags and the number of vertices, indexes and sections),
+    /// followed by the vertices as float triplets, the indexes, the normals
+    /// and UVs if present, and the sections. Positions and indexes can be
+    /// copied as they are into TArray<FVector> and TArray<int32>.
+    std::vector<uint8_t> Serialize() const;
+
+    /// Decodes a blob written by Serialize. Throws std::invalid_argument if
+    /// the blob is malformed.
+    static CompactMesh Deserialize(const uint8_t *data, size_t size);
+
+    // =========================================================================
+    // -- Conversions to UE4 types ---------------------------------------------
+    // =========================================================================
+
+#ifdef LIBCARLA_INCLUDED_FROM_UE4
+
+    operator FProceduralCustomMesh() const {
+      static_assert(sizeof(FVector) == sizeof(vertex_type), "FVector must be three floats");
+      FProceduralCustomMesh Mesh;
+      Mesh.Vertices.Append(
+          reinterpret_cast<const FVector *>(_vertices.data()),
+          static_cast<int32>(_vertices.size()));
+      Mesh.Triangles.Append(
+          reinterpret_cast<const int32 *>(_indexes.data()),
+          static_cast<int32>(_indexes.size()));
+      if (_has_normals) {
+        Mesh.Normals.Reserve(static_cast<int32>(_vertices.size()));
+        for (size_t i = 0u; i < _vertices.size(); ++i) {
+          const auto Normal = GetNormal(i);
+          Mesh.Normals.Add(FVector{Normal.x, Normal.y, Normal.z});
+        }
+      }
+      if (_has_uvs) {
+        Mesh.UV0.Reserve(static_cast<int32>(_vertices.size()));
+        for (size_t i = 0u; i < _vertices.size(); ++i) {
+          const auto UV = GetUV(i);
+          Mesh.UV0.Add(FVector2D{UV.x, UV.y});
+        }
+      }
+      return Mesh;
+    }
+
+#endif // LIBCARLA_INCLUDED_FROM_UE4
+
+  private:
+
+    friend class CompactMeshBuilder;
+
+    std::vector<vertex_type> _vertices;
+
+    std::vector<index_type> _indexes;
+
+    /// Either three floats or three halves per vertex.
+    std::vector<float> _normals;
+
+    std::vector<uint16_t> _half_normals;
+
+    /// Either two floats or two halves per vertex.
+    std::vector<float> _uvs;
+
+    std::vector<uint16_t> _half_uvs;
+
+    std::vector<Section> _sections;
+
+    bool _has_normals = false;
+
+    bool _has_uvs = false;
+
+    bool _half_precision = false;
+  };
+
+  /// Builds a CompactMesh out of geom::Mesh triangles, merging the vertices
+  /// closer than a weld distance into one, such as the border vertices that
+  /// MeshFactory emits once for each of the lanes sharing them.
+  class CompactMeshBuilder {
+  public:
+
+    struct Parameters {
+      /// Vertices closer than this, in meters, are merged. Zero disables
+      /// welding.
+      float weld_distance = 0.001f;
+      /// Compute smooth per-vertex normals facing up, like the Unreal
+      /// conversion of geom::Mesh does per face.
+      bool compute_normals = true;
+      /// Store normals and UVs as 16-bit floats.
+      bool half_precision = false;
+    };
+
+    CompactMeshBuilder();
+
+    explicit CompactMeshBuilder(Parameters parameters);
+
+    /// Adds the triangles and materials of @a mesh. UVs are kept if the mesh
+    /// has one per vertex; vertices with different UVs are not welded.
+    void AddMesh(const Mesh &mesh);
+
+    /// Adds a triangle, vertex order is counterclockwise as in geom::Mesh.
+    void AddTriangle(const Vector3D &v0, const Vector3D &v1, const Vector3D &v2);
+
+    size_t GetVerticesNum() const {
+      return _positions.size();
+    }
+
+    /// Returns the mesh built so far and resets the builder.
+    CompactMesh Build();
+
+  private:
+
+    CompactMesh::index_type AddVertex(const Vector3D &position, const Vector2D &uv);
+
+    void AddTriangle(
+        CompactMesh::index_type a,
+        CompactMesh::index_type b,
+        CompactMesh::index_type c);
+
+    Parameters _parameters;
+
+    /// Positions in meters.
+    std::vector<Vector3D> _positions;
+
+    std::vector<Vector2D> _uvs;
+
+    bool _has_uvs = false;
+
+    std::vector<CompactMesh::index_type> _indexes;
+
+    std::vector<CompactMesh::Section> _sections;
+
+    /// Vertices by cell of a grid of twice the weld distance.
+    std::unordered_multimap<uint64_t, CompactMesh::index_type> _grid;
+  };
+
+} // namespace geom
+} // namespace carla
@@ -114,6 +114,25 @@ namespace geom {
     return Vector3D(p.x * c - p.y * s, p.x * s + p.y * c, 0.0f);
   }
 
+  void Math::RotatePointsOnOrigin2D(Vector3D *points, const size_t count, const float angle) {
+    const float s = std::sin(angle);
+    const float c = std::cos(angle);
+    for (size_t i = 0u; i < count; ++i) {
+      const Vector3D p = points[i];
+      points[i] = Vector3D(p.x * c - p.y * s, p.x * s + p.y * c, 0.0f);
+    }
+  }
+
+  void Math::DistanceSquared(
+      const Vector3D &a,
+      const Vector3D *points,
+      const size_t count,
+      float *out) {
+    for (size_t i = 0u; i < count; ++i) {
+      out[i] = DistanceSquared(a, points[i]);
+    }
+  }
+
   Vector3D Math::GetForwardVector(const Rotation &rotation) {
     const float cp = std::cos(ToRadians(rotation.pitch));
     const float sp = std::sin(ToRadians(rotation.pitch));
@@ -111,6 +111,14 @@ namespace geom {
 
     static Vector3D RotatePointOnOrigin2D(Vector3D p, float angle);
 
+    /// RotatePointOnOrigin2D on @a count points in place, with the sine and
+    /// cosine computed once.
+    static void RotatePointsOnOrigin2D(Vector3D *points, size_t count, float angle);
+
+    /// Writes to @a out the squared distance from @a a to each of the @a
+    /// count @a points.
+    static void DistanceSquared(const Vector3D &a, const Vector3D *points, size_t count, float *out);
+
     /// Compute the unit vector pointing towards the X-axis of @a rotation.
     static Vector3D GetForwardVector(const Rotation &rotation);
 
@@ -137,6 +137,11 @@ namespace geom {
     _materials.back().index_end = close_index;
   }
 
+  void Mesh::Reserve(size_t num_vertices, size_t num_indexes) {
+    _vertices.reserve(num_vertices);
+    _indexes.reserve(num_indexes);
+  }
+
   std::string Mesh::GenerateOBJ() const {
     if (!IsValid()) {
       return "";
@@ -101,6 +101,10 @@ namespace geom {
     /// Stops applying the material to the new added triangles.
     void EndMaterial();
 
+    /// Reserves space for @a num_vertices vertices and @a num_indexes indexes,
+    /// so merging several meshes into this one copies each of them once.
+    void Reserve(size_t num_vertices, size_t num_indexes);
+
     // =========================================================================
     // -- Export methods -------------------------------------------------------
     // =========================================================================
@@ -0,0 +1,393 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/geom/TransformMatrix.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX__)
+#  include <immintrin.h>
+#  define LIBCARLA_GEOM_AVX
+#  define LIBCARLA_GEOM_SIMD
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <xmmintrin.h>
+#  define LIBCARLA_GEOM_SSE
+#  define LIBCARLA_GEOM_SIMD
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  include <arm_neon.h>
+#  define LIBCARLA_GEOM_NEON
+#  define LIBCARLA_GEOM_SIMD
+#endif
+
+namespace carla {
+namespace geom {
+
+  // ===========================================================================
+  // -- Kernels ----------------------------------------------------------------
+  // ===========================================================================
+
+namespace {
+
+  /// out = m * (in + pre) + post, one point at a time.
+  void ApplyScalar(
+      const float *m,
+      const Vector3D &pre,
+      const Vector3D &post,
+      const float *in,
+      float *out,
+      const size_t count,
+      const size_t stride) {
+    for (size_t i = 0u; i < count; ++i, in += stride, out += stride) {
+      const float x = in[0u] + pre.x;
+      const float y = in[1u] + pre.y;
+      const float z = in[2u] + pre.z;
+      if (in != out) {
+        std::copy(in + 3u, in + stride, out + 3u);
+      }
+      out[0u] = m[0u] * x + m[1u] * y + m[2u] * z + post.x;
+      out[1u] = m[3u] * x + m[4u] * y + m[5u] * z + post.y;
+      out[2u] = m[6u] * x + m[7u] * y + m[8u] * z + post.z;
+    }
+  }
+
+#if defined(LIBCARLA_GEOM_AVX) || defined(LIBCARLA_GEOM_SSE)
+
+#  if defined(LIBCARLA_GEOM_AVX)
+
+  /// Two groups of four points per register, one per 128-bit lane; @a half
+  /// is the offset in floats between the groups.
+  struct Avx {
+    using reg = __m256;
+
+    static constexpr size_t Lanes = 2u;
+
+    static reg Load(const float *p, size_t half) {
+      return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(p)), _mm_loadu_ps(p + half), 1);
+    }
+
+    static void Store(float *p, size_t half, reg r) {
+      _mm_storeu_ps(p, _mm256_castps256_ps128(r));
+      _mm_storeu_ps(p + half, _mm256_extractf128_ps(r, 1));
+    }
+
+    static reg Set(float f) {
+      return _mm256_set1_ps(f);
+    }
+
+    static reg Add(reg a, reg b) {
+      return _mm256_add_ps(a, b);
+    }
+
+    static reg Mul(reg a, reg b) {
+      return _mm256_mul_ps(a, b);
+    }
+
+    template <int Imm>
+    static reg Shuffle(reg a, reg b) {
+      return _mm256_shuffle_ps(a, b, Imm);
+    }
+  };
+
+  using SimdBase = Avx;
+
+#  else
+
+  struct Sse {
+    using reg = __m128;
+
+    static constexpr size_t Lanes = 1u;
+
+    static reg Load(const float *p, size_t) {
+      return _mm_loadu_ps(p);
+    }
+
+    static void Store(float *p, size_t, reg r) {
+      _mm_storeu_ps(p, r);
+    }
+
+    static reg Set(float f) {
+      return _mm_set1_ps(f);
+    }
+
+    static reg Add(reg a, reg b) {
+      return _mm_add_ps(a, b);
+    }
+
+    static reg Mul(reg a, reg b) {
+      return _mm_mul_ps(a, b);
+    }
+
+    template <int Imm>
+    static reg Shuffle(reg a, reg b) {
+      return _mm_shuffle_ps(a, b, Imm);
+    }
+  };
+
+  using SimdBase = Sse;
+
+#  endif
+
+  /// Conversions between interleaved points and one register per coordinate,
+  /// done with in-lane shuffles of groups of four points.
+  struct Simd : SimdBase {
+    static constexpr size_t Width = 4u * Lanes;
+
+    /// Loads Width points of three floats.
+    static void Load3(const float *p, reg &x, reg &y, reg &z) {
+      // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3.
+      const reg a = Load(p, 12u);
+      const reg b = Load(p + 4u, 12u);
+      const reg c = Load(p + 8u, 12u);
+      x = Shuffle<_MM_SHUFFLE(2, 0, 3, 0)>(a, Shuffle<_MM_SHUFFLE(0, 1, 0, 2)>(b, c));
+      y = Shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(
+          Shuffle<_MM_SHUFFLE(0, 0, 1, 1)>(a, b),
+          Shuffle<_MM_SHUFFLE(2, 2, 3, 3)>(b, c));
+      z = Shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(
+          Shuffle<_MM_SHUFFLE(1, 1, 2, 2)>(a, b),
+          Shuffle<_MM_SHUFFLE(3, 3, 0, 0)>(c, c));
+    }
+
+    static void Store3(float *p, reg x, reg y, reg z) {
+      Store(p, 12u, Shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(
+          Shuffle<_MM_SHUFFLE(0, 0, 0, 0)>(x, y),
+          Shuffle<_MM_SHUFFLE(1, 1, 0, 0)>(z, x)));
+      Store(p + 4u, 12u, Shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(
+          Shuffle<_MM_SHUFFLE(1, 1, 1, 1)>(y, z),
+          Shuffle<_MM_SHUFFLE(2, 2, 2, 2)>(x, y)));
+      Store(p + 8u, 12u, Shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(
+          Shuffle<_MM_SHUFFLE(3, 3, 2, 2)>(z, x),
+          Shuffle<_MM_SHUFFLE(3, 3, 3, 3)>(y, z)));
+    }
+
+    static void Transpose(reg &r0, reg &r1, reg &r2, reg &r3) {
+      const reg t0 = Shuffle<_MM_SHUFFLE(1, 0, 1, 0)>(r0, r1);
+      const reg t1 = Shuffle<_MM_SHUFFLE(1, 0, 1, 0)>(r2, r3);
+      const reg t2 = Shuffle<_MM_SHUFFLE(3, 2, 3, 2)>(r0, r1);
+      const reg t3 = Shuffle<_MM_SHUFFLE(3, 2, 3, 2)>(r2, r3);
+      r0 = Shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(t0, t1);
+      r1 = Shuffle<_MM_SHUFFLE(3, 1, 3, 1)>(t0, t1);
+      r2 = Shuffle<_MM_SHUFFLE(2, 0, 2, 0)>(t2, t3);
+      r3 = Shuffle<_MM_SHUFFLE(3, 1, 3, 1)>(t2, t3);
+    }
+
+    /// Loads Width points of four floats.
+    static void Load4(const float *p, reg &x, reg &y, reg &z, reg &w) {
+      x = Load(p, 16u);
+      y = Load(p + 4u, 16u);
+      z = Load(p + 8u, 16u);
+      w = Load(p + 12u, 16u);
+      Transpose(x, y, z, w);
+    }
+
+    static void Store4(float *p, reg x, reg y, reg z, reg w) {
+      Transpose(x, y, z, w);
+      Store(p, 16u, x);
+      Store(p + 4u, 16u, y);
+      Store(p + 8u, 16u, z);
+      Store(p + 12u, 16u, w);
+    }
+  };
+
+#elif defined(LIBCARLA_GEOM_NEON)
+
+  struct Simd {
+    using reg = float32x4_t;
+
+    static constexpr size_t Width = 4u;
+
+    static reg Set(float f) {
+      return vdupq_n_f32(f);
+    }
+
+    static reg Add(reg a, reg b) {
+      return vaddq_f32(a, b);
+    }
+
+    static reg Mul(reg a, reg b) {
+      return vmulq_f32(a, b);
+    }
+
+    static void Load3(const float *p, reg &x, reg &y, reg &z) {
+      const float32x4x3_t v = vld3q_f32(p);
+      x = v.val[0u];
+      y = v.val[1u];
+      z = v.val[2u];
+    }
+
+    static void Store3(float *p, reg x, reg y, reg z) {
+      float32x4x3_t v;
+      v.val[0u] = x;
+      v.val[1u] = y;
+      v.val[2u] = z;
+      vst3q_f32(p, v);
+    }
+
+    static void Load4(const float *p, reg &x, reg &y, reg &z, reg &w) {
+      const float32x4x4_t v = vld4q_f32(p);
+      x = v.val[0u];
+      y = v.val[1u];
+      z = v.val[2u];
+      w = v.val[3u];
+    }
+
+    static void Store4(float *p, reg x, reg y, reg z, reg w) {
+      float32x4x4_t v;
+      v.val[0u] = x;
+      v.val[1u] = y;
+      v.val[2u] = z;
+      v.val[3u] = w;
+      vst4q_f32(p, v);
+    }
+  };
+
+#endif
+
+#ifdef LIBCARLA_GEOM_SIMD
+
+  /// The coefficients of ApplyScalar broadcast to every lane.
+  class SimdKernel {
+  public:
+
+    using reg = Simd::reg;
+
+    SimdKernel(const float *m, const Vector3D &pre, const Vector3D &post) {
+      for (auto i = 0u; i < 9u; ++i) {
+        _m[i] = Simd::Set(m[i]);
+      }
+      _pre[0u] = Simd::Set(pre.x);
+      _pre[1u] = Simd::Set(pre.y);
+      _pre[2u] = Simd::Set(pre.z);
+      _post[0u] = Simd::Set(post.x);
+      _post[1u] = Simd::Set(post.y);
+      _post[2u] = Simd::Set(post.z);
+    }
+
+    /// Applies the kernel to every complete group of Simd::Width points and
+    /// returns the number of points processed.
+    size_t operator()(const float *in, float *out, size_t count, size_t stride) const {
+      const size_t blocks = count / Simd::Width;
+      const size_t block_size = Simd::Width * stride;
+      if (stride == 3u) {
+        for (size_t i = 0u; i < blocks; ++i) {
+          reg x, y, z;
+          Simd::Load3(in + i * block_size, x, y, z);
+          Apply(x, y, z);
+          Simd::Store3(out + i * block_size, x, y, z);
+        }
+      } else if (stride == 4u) {
+        for (size_t i = 0u; i < blocks; ++i) {
+          reg x, y, z, w;
+          Simd::Load4(in + i * block_size, x, y, z, w);
+          Apply(x, y, z);
+          Simd::Store4(out + i * block_size, x, y, z, w);
+        }
+      } else {
+        return 0u;
+      }
+      return blocks * Simd::Width;
+    }
+
+  private:
+
+    void Apply(reg &x, reg &y, reg &z) const {
+      const reg px = Simd::Add(x, _pre[0u]);
+      const reg py = Simd::Add(y, _pre[1u]);
+      const reg pz = Simd::Add(z, _pre[2u]);
+      x = Row(0u, px, py, pz);
+      y = Row(1u, px, py, pz);
+      z = Row(2u, px, py, pz);
+    }
+
+    reg Row(size_t row, reg x, reg y, reg z) const {
+      // Same order of operations as ApplyScalar.
+      const reg *m = _m + 3u * row;
+      return Simd::Add(
+          Simd::Add(Simd::Add(Simd::Mul(m[0u], x), Simd::Mul(m[1u], y)), Simd::Mul(m[2u], z)),
+          _post[row]);
+    }
+
+    reg _m[9u];
+
+    reg _pre[3u];
+
+    reg _post[3u];
+  };
+
+#endif // LIBCARLA_GEOM_SIMD
+
+  void Apply(
+      const float *m,
+      const Vector3D &pre,
+      const Vector3D &post,
+      const float *in,
+      float *out,
+      const size_t count,
+      const size_t stride) {
+    DEBUG_ASSERT(stride >= 3u);
+    size_t done = 0u;
+#ifdef LIBCARLA_GEOM_SIMD
+    done = SimdKernel{m, pre, post}(in, out, count, stride);
+#endif // LIBCARLA_GEOM_SIMD
+    ApplyScalar(m, pre, post, in + done * stride, out + done * stride, count - done, stride);
+  }
+
+} // namespace
+
+  // ===========================================================================
+  // -- TransformMatrix --------------------------------------------------------
+  // ===========================================================================
+
+  TransformMatrix::TransformMatrix(const Rotation &rotation) {
+    const float cy = std::cos(Math::ToRadians(rotation.yaw));
+    const float sy = std::sin(Math::ToRadians(rotation.yaw));
+    const float cr = std::cos(Math::ToRadians(rotation.roll));
+    const float sr = std::sin(Math::ToRadians(rotation.roll));
+    const float cp = std::cos(Math::ToRadians(rotation.pitch));
+    const float sp = std::sin(Math::ToRadians(rotation.pitch));
+    // Same as Rotation::RotateVector.
+    const float m[9u] = {
+        cp * cy, cy * sp * sr - sy * cr, -cy * sp * cr - sy * sr,
+        cp * sy, sy * sp * sr + cy * cr, -sy * sp * cr + cy * sr,
+        sp, -cp * sr, cp * cr};
+    std::copy(m, m + 9u, _m);
+  }
+
+  TransformMatrix::TransformMatrix(const Transform &transform)
+    : TransformMatrix(transform.rotation) {
+    _post = transform.location;
+  }
+
+  TransformMatrix TransformMatrix::GetInverse() const {
+    TransformMatrix inverse;
+    for (auto row = 0u; row < 3u; ++row) {
+      for (auto column = 0u; column < 3u; ++column) {
+        inverse._m[3u * row + column] = _m[3u * column + row];
+      }
+    }
+    inverse._pre = -1.0f * _post;
+    inverse._post = -1.0f * _pre;
+    return inverse;
+  }
+
+  void TransformMatrix::TransformPoints(
+      const float *in,
+      float *out,
+      const size_t count,
+      const size_t stride) const {
+    Apply(_m, _pre, _post, in, out, count, stride);
+  }
+
+  void TransformMatrix::TransformVectors(
+      const float *in,
+      float *out,
+      const size_t count,
+      const size_t stride) const {
+    Apply(_m, Vector3D{}, Vector3D{}, in, out, count, stride);
+  }
+
+} // namespace geom
+} // namespace carla
@@ -0,0 +1,139 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/geom/Transform.h"
+
+#include <type_traits>
+
+namespace carla {
+namespace geom {
+
+  /// A Transform with its rotation matrix precomputed, for applying the same
+  /// transformation to many points without the trigonometry that
+  /// Transform::TransformPoint does on every call.
+  ///
+  /// The batch methods work in place or out of place on contiguous arrays of
+  /// floats, and use SSE/AVX on x86 and NEON on ARM when the compiler targets
+  /// them. Results match those of Transform up to floating point rounding.
+  class TransformMatrix {
+  public:
+
+    // =========================================================================
+    // -- Constructors ---------------------------------------------------------
+    // =========================================================================
+
+    /// Identity.
+    TransformMatrix() = default;
+
+    explicit TransformMatrix(const Rotation &rotation);
+
+    explicit TransformMatrix(const Transform &transform);
+
+    // =========================================================================
+    // -- Accessors ------------------------------------------------------------
+    // =========================================================================
+
+    /// Unit vector pointing towards the X-axis of the rotation.
+    Vector3D GetForwardVector() const {
+      return {_m[0], _m[3], _m[6]};
+    }
+
+    /// Unit vector pointing towards the Y-axis of the rotation.
+    Vector3D GetRightVector() const {
+      return {_m[1], _m[4], _m[7]};
+    }
+
+    /// Unit vector pointing towards the Z-axis of the rotation.
+    Vector3D GetUpVector() const {
+      return {_m[2], _m[5], _m[8]};
+    }
+
+    /// The inverse transformation.
+    TransformMatrix GetInverse() const;
+
+    // =========================================================================
+    // -- Single points --------------------------------------------------------
+    // =========================================================================
+
+    Vector3D TransformPoint(const Vector3D &point) const {
+      const Vector3D p = point + _pre;
+      return {
+          _m[0] * p.x + _m[1] * p.y + _m[2] * p.z + _post.x,
+          _m[3] * p.x + _m[4] * p.y + _m[5] * p.z + _post.y,
+          _m[6] * p.x + _m[7] * p.y + _m[8] * p.z + _post.z};
+    }
+
+    /// Rotation only.
+    Vector3D TransformVector(const Vector3D &vector) const {
+      return {
+          _m[0] * vector.x + _m[1] * vector.y + _m[2] * vector.z,
+          _m[3] * vector.x + _m[4] * vector.y + _m[5] * vector.z,
+          _m[6] * vector.x + _m[7] * vector.y + _m[8] * vector.z};
+    }
+
+    // =========================================================================
+    // -- Batches --------------------------------------------------------------
+    // =========================================================================
+
+    /// Transforms @a count points read from @a in and written to @a out, that
+    /// may be the same array. Each point takes @a stride floats of which the
+    /// first three are x, y and z, e.g. a stride of 4 transforms lidar
+    /// detections in place. The remaining floats of each point are copied.
+    void TransformPoints(const float *in, float *out, size_t count, size_t stride = 3u) const;
+
+    /// Same as TransformPoints, rotation only.
+    void TransformVectors(const float *in, float *out, size_t count, size_t stride = 3u) const;
+
+    /// Same as TransformPoints with the inverse transformation.
+    void InverseTransformPoints(const float *in, float *out, size_t count, size_t stride = 3u) const {
+      GetInverse().TransformPoints(in, out, count, stride);
+    }
+
+    /// Transforms in place an array of Vector3D or Location.
+    template <typename T>
+    void TransformPoints(T *points, size_t count) const {
+      auto *data = GetFloats(points);
+      TransformPoints(data, data, count);
+    }
+
+    /// Transforms in place an array of Vector3D or Location, rotation only.
+    template <typename T>
+    void TransformVectors(T *vectors, size_t count) const {
+      auto *data = GetFloats(vectors);
+      TransformVectors(data, data, count);
+    }
+
+    /// Transforms in place an array of Vector3D or Location with the inverse
+    /// transformation.
+    template <typename T>
+    void InverseTransformPoints(T *points, size_t count) const {
+      auto *data = GetFloats(points);
+      InverseTransformPoints(data, data, count);
+    }
+
+  private:
+
+    template <typename T>
+    static float *GetFloats(T *points) {
+      static_assert(std::is_base_of<Vector3D, T>::value, "T must be a Vector3D");
+      static_assert(sizeof(T) == 3u * sizeof(float), "T must be three floats");
+      return reinterpret_cast<float *>(points);
+    }
+
+    /// Rotation, row-major. Points are rotated after adding _pre, and _post
+    /// is added afterwards, so the inverse is exact: the transposed matrix
+    /// with _pre and _post swapped and negated.
+    float _m[9u] = {1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+
+    Vector3D _pre;
+
+    Vector3D _post;
+  };
+
+} // namespace geom
+} // namespace carla
@@ -0,0 +1,265 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/image/ColorConverterKernels.h"
+
+#include "carla/Debug.h"
+#include "carla/ParallelFor.h"
+#include "carla/geom/Math.h"
+#include "carla/image/CityScapesPalette.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define LIBCARLA_IMAGE_SSE2
+#endif
+
+namespace carla {
+namespace image {
+
+namespace {
+
+  /// Below this number of pixels per thread it is not worth to split the
+  /// image among threads.
+  constexpr size_t MIN_PIXELS_PER_THREAD = 1u << 16u;
+
+  constexpr float MAX_DEPTH = static_cast<float>(256 * 256 * 256 - 1);
+
+  template <typename KernelT>
+  void Run(size_t pixel_count, bool parallel, KernelT &&kernel) {
+    if (parallel) {
+      ParallelForChunks(pixel_count, MIN_PIXELS_PER_THREAD, [&](size_t, size_t begin, size_t end) {
+        kernel(begin, end);
+      });
+    } else {
+      kernel(0u, pixel_count);
+    }
+  }
+
+  /// The 24-bit depth encoded in the red, green and blue channels of a BGRA
+  /// pixel.
+  uint32_t DecodeDepth(const uint8_t *pixel) {
+    return uint32_t(pixel[2u]) + (uint32_t(pixel[1u]) << 8u) + (uint32_t(pixel[0u]) << 16u);
+  }
+
+  /// Same conversion of a float in [0, 1] to 8 bits as Boost.GIL's.
+  uint8_t ToChannel(float value) {
+    return static_cast<uint8_t>(value * 255.0f + 0.5f);
+  }
+
+  void WriteGray(uint8_t *pixel, uint8_t value) {
+    pixel[0u] = value;
+    pixel[1u] = value;
+    pixel[2u] = value;
+    pixel[3u] = 255u;
+  }
+
+  uint8_t DepthToGray(uint32_t depth) {
+    return ToChannel(static_cast<float>(depth) / MAX_DEPTH);
+  }
+
+  uint8_t LogarithmicDepthToGray(uint32_t depth) {
+    const float normalized = static_cast<float>(depth) / MAX_DEPTH;
+    const float value = 1.0f + std::log(normalized) / 5.70378f;
+    return ToChannel(std::max(std::min(value, 1.0f), 0.005f));
+  }
+
+  /// The logarithmic depth is a non-decreasing function of the 24-bit depth
+  /// that changes at most once within each bucket of 256 consecutive
+  /// depths, so it is stored as the value at the beginning of each bucket
+  /// and the offset in the bucket at which it increases by one, zero if it
+  /// does not. Both fit in 16 bits, so the table is small enough to stay in
+  /// cache.
+  class LogarithmicDepthTable {
+  public:
+
+    static const LogarithmicDepthTable &Get() {
+      static const LogarithmicDepthTable table;
+      return table;
+    }
+
+    uint8_t operator()(uint32_t depth) const {
+      const uint32_t entry = _entries[depth >> 8u];
+      const uint32_t offset = entry >> 8u;
+      const uint32_t increment = ((offset != 0u) && ((depth & 0xffu) >= offset)) ? 1u : 0u;
+      return static_cast<uint8_t>((entry & 0xffu) + increment);
+    }
+
+  private:
+
+    static constexpr uint32_t BucketCount = 1u << 16u;
+
+    LogarithmicDepthTable() {
+      for (uint32_t bucket = 0u; bucket < BucketCount; ++bucket) {
+        uint32_t first = bucket << 8u;
+        uint32_t last = first + 255u;
+        const uint8_t base = LogarithmicDepthToGray(first);
+        _entries[bucket] = base;
+        if (LogarithmicDepthToGray(last) != base) {
+          DEBUG_ASSERT(LogarithmicDepthToGray(last) == base + 1u);
+          // Binary search of the first depth with a higher value.
+          while (first + 1u < last) {
+            const uint32_t middle = first + (last - first) / 2u;
+            if (LogarithmicDepthToGray(middle) == base) {
+              first = middle;
+            } else {
+              last = middle;
+            }
+          }
+          _entries[bucket] = static_cast<uint16_t>(base | ((last & 0xffu) << 8u));
+        }
+      }
+    }
+
+    uint16_t _entries[BucketCount];
+  };
+
+  /// The BGRA pixel of each semantic tag.
+  class CityScapesTable {
+  public:
+
+    static const CityScapesTable &Get() {
+      static const CityScapesTable table;
+      return table;
+    }
+
+    const uint8_t *operator[](uint8_t tag) const {
+      return _pixels[tag];
+    }
+
+  private:
+
+    CityScapesTable() {
+      for (size_t tag = 0u; tag < 256u; ++tag) {
+        const auto color = image::CityScapesPalette::GetColor(static_cast<uint8_t>(tag));
+        _pixels[tag][0u] = color[2u];
+        _pixels[tag][1u] = color[1u];
+        _pixels[tag][2u] = color[0u];
+        _pixels[tag][3u] = 255u;
+      }
+    }
+
+    uint8_t _pixels[256u][4u];
+  };
+
+} // namespace
+
+  // ===========================================================================
+  // -- ColorConverterKernels --------------------------------------------------
+  // ===========================================================================
+
+  void ColorConverterKernels::Depth(
+      const uint8_t *src,
+      uint8_t *dst,
+      const size_t pixel_count,
+      const bool parallel) {
+    Run(pixel_count, parallel, [=](size_t begin, size_t end) {
+      size_t i = begin;
+#ifdef LIBCARLA_IMAGE_SSE2
+      // Four pixels at a time, read as little-endian 32-bit words 0xAARRGGBB.
+      const __m128i byte_mask = _mm_set1_epi32(0xff);
+      const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xff000000u));
+      const __m128 max_depth = _mm_set1_ps(MAX_DEPTH);
+      const __m128 scale = _mm_set1_ps(255.0f);
+      const __m128 half = _mm_set1_ps(0.5f);
+      for (; i + 4u <= end; i += 4u) {
+        const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 4u * i));
+        const __m128i b = _mm_and_si128(pixels, byte_mask);
+        const __m128i g = _mm_and_si128(_mm_srli_epi32(pixels, 8), byte_mask);
+        const __m128i r = _mm_and_si128(_mm_srli_epi32(pixels, 16), byte_mask);
+        const __m128i depth = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 8)), _mm_slli_epi32(b, 16));
+        const __m128 normalized = _mm_div_ps(_mm_cvtepi32_ps(depth), max_depth);
+        const __m128i value = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(normalized, scale), half));
+        const __m128i gray = _mm_or_si128(
+            _mm_or_si128(value, _mm_slli_epi32(value, 8)),
+            _mm_or_si128(_mm_slli_epi32(value, 16), alpha));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 4u * i), gray);
+      }
+#endif // LIBCARLA_IMAGE_SSE2
+      for (; i < end; ++i) {
+        WriteGray(dst + 4u * i, DepthToGray(DecodeDepth(src + 4u * i)));
+      }
+    });
+  }
+
+  void ColorConverterKernels::LogarithmicDepth(
+      const uint8_t *src,
+      uint8_t *dst,
+      const size_t pixel_count,
+      const bool parallel) {
+    const auto &table = LogarithmicDepthTable::Get();
+    Run(pixel_count, parallel, [=, &table](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        WriteGray(dst + 4u * i, table(DecodeDepth(src + 4u * i)));
+      }
+    });
+  }
+
+  void ColorConverterKernels::CityScapesPalette(
+      const uint8_t *src,
+      uint8_t *dst,
+      const size_t pixel_count,
+      const bool parallel) {
+    const auto &table = CityScapesTable::Get();
+    Run(pixel_count, parallel, [=, &table](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        std::memcpy(dst + 4u * i, table[src[4u * i + 2u]], 4u);
+      }
+    });
+  }
+
+  void ColorConverterKernels::OpticalFlow(
+      const float *src,
+      uint8_t *dst,
+      const size_t pixel_count,
+      const bool parallel) {
+    constexpr float pi = 3.1415f;
+    constexpr float rad2ang = 360.f / (2.f * pi);
+    constexpr float shift = 0.999f;
+    const float a = 1.f / std::log(0.1f + shift);
+    Run(pixel_count, parallel, [=](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        const float vx = src[2u * i];
+        const float vy = src[2u * i + 1u];
+
+        float angle = 180.f + std::atan2(vy, vx) * rad2ang;
+        if (angle < 0) angle = 360.f + angle;
+        angle = std::fmod(angle, 360.f);
+
+        const float norm = std::sqrt(vx * vx + vy * vy);
+        const float intensity = geom::Math::Clamp(a * std::log(norm + shift), 0.f, 1.f);
+
+        // HSV to RGB with full saturation.
+        const float H_60 = angle * (1.f / 60.f);
+        const float C = intensity;
+        const float X = C * (1.f - std::abs(std::fmod(H_60, 2.f) - 1.f));
+        const float m = intensity - C;
+
+        float r, g, b;
+        switch (static_cast<unsigned int>(H_60)) {
+          case 0:  r = C; g = X; b = 0; break;
+          case 1:  r = X; g = C; b = 0; break;
+          case 2:  r = 0; g = C; b = X; break;
+          case 3:  r = 0; g = X; b = C; break;
+          case 4:  r = X; g = 0; b = C; break;
+          case 5:  r = C; g = 0; b = X; break;
+          default: r = 1; g = 1; b = 1; break;
+        }
+
+        uint8_t *pixel = dst + 4u * i;
+        pixel[0u] = static_cast<uint8_t>((b + m) * 255.f);
+        pixel[1u] = static_cast<uint8_t>((g + m) * 255.f);
+        pixel[2u] = static_cast<uint8_t>((r + m) * 255.f);
+        pixel[3u] = 0u;
+      }
+    });
+  }
+
+} // namespace image
+} // namespace carla
@@ -0,0 +1,39 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace carla {
+namespace image {
+
+  /// Batch versions of the converters in ColorConverter working directly on
+  /// buffers of 8-bit BGRA pixels, the pixel format of the cameras. They
+  /// give the same result as ImageConverter with the matching converter, the
+  /// depth channels written to blue, green and red and alpha set to 255.
+  ///
+  /// @a src and @a dst may be the same buffer to convert in place. If
+  /// @a parallel is true big images are split in contiguous bands of rows
+  /// converted in different threads.
+  class ColorConverterKernels {
+  public:
+
+    static void Depth(const uint8_t *src, uint8_t *dst, size_t pixel_count, bool parallel = false);
+
+    static void LogarithmicDepth(const uint8_t *src, uint8_t *dst, size_t pixel_count, bool parallel = false);
+
+    static void CityScapesPalette(const uint8_t *src, uint8_t *dst, size_t pixel_count, bool parallel = false);
+
+    /// Color code an optical flow image, two floats (x, y) per pixel, into
+    /// BGRA pixels: the hue is the direction of the flow and the value its
+    /// magnitude in a logarithmic scale. Alpha is left at zero.
+    static void OpticalFlow(const float *src, uint8_t *dst, size_t pixel_count, bool parallel = false);
+  };
+
+} // namespace image
+} // namespace carla
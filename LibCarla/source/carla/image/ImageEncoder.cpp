@@ -0,0 +1,366 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/image/ImageEncoder.h"
+
+#include "carla/Exception.h"
+#include "carla/StringUtil.h"
+#include "carla/image/ImageIOConfig.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace carla {
+namespace image {
+
+  // ===========================================================================
+  // -- Helpers ----------------------------------------------------------------
+  // ===========================================================================
+
+  static void AppendLittleEndian(std::vector<uint8_t> &out, uint32_t value, size_t bytes) {
+    for (size_t i = 0u; i < bytes; ++i) {
+      out.push_back(static_cast<uint8_t>(value >> (8u * i)));
+    }
+  }
+
+  static uint32_t ReadBigEndian(const uint8_t *data) {
+    return (uint32_t(data[0u]) << 24u) | (uint32_t(data[1u]) << 16u) |
+           (uint32_t(data[2u]) << 8u) | uint32_t(data[3u]);
+  }
+
+  // ===========================================================================
+  // -- ImageEncoder -----------------------------------------------------------
+  // ===========================================================================
+
+  bool ImageEncoder::FormatFromPath(const std::string &path, Format &format) {
+    const auto lower = StringUtil::ToLowerCopy(path);
+    if (StringUtil::EndsWith(lower, ".bmp")) {
+      format = Format::BMP;
+    } else if (StringUtil::EndsWith(lower, ".png")) {
+      format = Format::PNG;
+    } else if (StringUtil::EndsWith(lower, ".qoi")) {
+      format = Format::QOI;
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  const char *ImageEncoder::GetDefaultExtension(Format format) {
+    switch (format) {
+      case Format::BMP: return ".bmp";
+      case Format::QOI: return ".qoi";
+      default:          return ".png";
+    }
+  }
+
+  void ImageEncoder::Encode(
+      Format format,
+      const uint8_t *bgra,
+      uint32_t width,
+      uint32_t height,
+      std::vector<uint8_t> &out,
+      int png_compression_level) {
+    switch (format) {
+      case Format::BMP:
+        return EncodeBMP(bgra, width, height, out);
+      case Format::PNG:
+        return EncodePNG(bgra, width, height, out, png_compression_level);
+      case Format::QOI:
+        return EncodeQOI(bgra, width, height, out);
+      default:
+        throw_exception(std::invalid_argument("invalid image format"));
+    }
+  }
+
+  // ===========================================================================
+  // -- BMP --------------------------------------------------------------------
+  // ===========================================================================
+
+  void ImageEncoder::EncodeBMP(
+      const uint8_t *bgra,
+      uint32_t width,
+      uint32_t height,
+      std::vector<uint8_t> &out) {
+    constexpr uint32_t HeaderSize = 14u + 40u;
+    const uint32_t image_size = 4u * width * height;
+    out.reserve(out.size() + HeaderSize + image_size);
+    // File header.
+    out.push_back('B');
+    out.push_back('M');
+    AppendLittleEndian(out, HeaderSize + image_size, 4u);
+    AppendLittleEndian(out, 0u, 4u);
+    AppendLittleEndian(out, HeaderSize, 4u);
+    // BITMAPINFOHEADER, a negative height stores the rows top-down as they
+    // are in memory, and BI_RGB 32-bit pixels are BGRA.
+    AppendLittleEndian(out, 40u, 4u);
+    AppendLittleEndian(out, width, 4u);
+    AppendLittleEndian(out, static_cast<uint32_t>(-static_cast<int32_t>(height)), 4u);
+    AppendLittleEndian(out, 1u, 2u);
+    AppendLittleEndian(out, 32u, 2u);
+    AppendLittleEndian(out, 0u, 4u);
+    AppendLittleEndian(out, image_size, 4u);
+    AppendLittleEndian(out, 2835u, 4u);
+    AppendLittleEndian(out, 2835u, 4u);
+    AppendLittleEndian(out, 0u, 4u);
+    AppendLittleEndian(out, 0u, 4u);
+    out.insert(out.end(), bgra, bgra + image_size);
+  }
+
+  // ===========================================================================
+  // -- PNG --------------------------------------------------------------------
+  // ===========================================================================
+
+#if LIBCARLA_IMAGE_WITH_PNG_SUPPORT
+
+  static void WritePNGData(png_structp png, png_bytep data, png_size_t length) {
+    auto *out = static_cast<std::vector<uint8_t> *>(png_get_io_ptr(png));
+    out->insert(out->end(), data, data + length);
+  }
+
+  static void FlushPNGData(png_structp) {}
+
+  void ImageEncoder::EncodePNG(
+      const uint8_t *bgra,
+      uint32_t width,
+      uint32_t height,
+      std::vector<uint8_t> &out,
+      int compression_level) {
+    compression_level = std::min(std::max(compression_level, 0), 9);
+    png_structp png = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    if (png == nullptr) {
+      throw_exception(std::runtime_error("failed to create PNG writer"));
+    }
+    png_infop info = png_create_info_struct(png);
+    if (info == nullptr) {
+      png_destroy_write_struct(&png, nullptr);
+      throw_exception(std::runtime_error("failed to create PNG writer"));
+    }
+    if (setjmp(png_jmpbuf(png))) {
+      png_destroy_write_struct(&png, &info);
+      throw_exception(std::runtime_error("failed to encode PNG image"));
+    }
+    png_set_write_fn(png, &out, WritePNGData, FlushPNGData);
+    png_set_IHDR(
+        png,
+        info,
+        width,
+        height,
+        8,
+        PNG_COLOR_TYPE_RGB_ALPHA,
+        PNG_INTERLACE_NONE,
+        PNG_COMPRESSION_TYPE_DEFAULT,
+        PNG_FILTER_TYPE_DEFAULT);
+    png_set_compression_level(png, compression_level);
+    // At fast levels choosing the best filter of every row costs more than
+    // what it saves.
+    if (compression_level == 0) {
+      png_set_filter(png, PNG_FILTER_TYPE_BASE, PNG_FILTER_NONE);
+    } else if (compression_level <= 3) {
+      png_set_filter(png, PNG_FILTER_TYPE_BASE, PNG_FILTER_SUB);
+    }
+    png_write_info(png, info);
+    png_set_bgr(png);
+    for (uint32_t row = 0u; row < height; ++row) {
+      png_write_row(png, const_cast<png_bytep>(bgra + 4u * width * row));
+    }
+    png_write_end(png, nullptr);
+    png_destroy_write_struct(&png, &info);
+  }
+
+#else
+
+  void ImageEncoder::EncodePNG(const uint8_t *, uint32_t, uint32_t, std::vector<uint8_t> &, int) {
+    throw_exception(std::runtime_error("LibCarla was compiled without PNG support"));
+  }
+
+#endif // LIBCARLA_IMAGE_WITH_PNG_SUPPORT
+
+  // ===========================================================================
+  // -- QOI --------------------------------------------------------------------
+  // ===========================================================================
+
+  // See the specification at https://qoiformat.org/qoi-specification.pdf
+
+  static constexpr uint8_t QOI_OP_INDEX = 0x00u;
+  static constexpr uint8_t QOI_OP_DIFF = 0x40u;
+  static constexpr uint8_t QOI_OP_LUMA = 0x80u;
+  static constexpr uint8_t QOI_OP_RUN = 0xc0u;
+  static constexpr uint8_t QOI_OP_RGB = 0xfeu;
+  static constexpr uint8_t QOI_OP_RGBA = 0xffu;
+  static constexpr uint8_t QOI_MASK = 0xc0u;
+  static constexpr size_t QOI_HEADER_SIZE = 14u;
+  static constexpr uint8_t QOI_PADDING[8u] = {0u, 0u, 0u, 0u, 0u, 0u, 0u, 1u};
+
+  namespace {
+
+    struct QOIPixel {
+      uint8_t r;
+      uint8_t g;
+      uint8_t b;
+      uint8_t a;
+
+      bool operator==(const QOIPixel &rhs) const {
+        return (r == rhs.r) && (g == rhs.g) && (b == rhs.b) && (a == rhs.a);
+      }
+
+      size_t Hash() const {
+        return (r * 3u + g * 5u + b * 7u + a * 11u) % 64u;
+      }
+    };
+
+  } // namespace
+
+  void ImageEncoder::EncodeQOI(
+      const uint8_t *bgra,
+      uint32_t width,
+      uint32_t height,
+      std::vector<uint8_t> &out) {
+    const size_t pixel_count = size_t(width) * size_t(height);
+    // Worst case is one QOI_OP_RGBA per pixel.
+    const size_t begin = out.size();
+    out.resize(begin + QOI_HEADER_SIZE + 5u * pixel_count + sizeof(QOI_PADDING));
+    uint8_t *header = out.data() + begin;
+    std::memcpy(header, "qoif", 4u);
+    for (size_t i = 0u; i < 4u; ++i) {
+      header[4u + i] = static_cast<uint8_t>(width >> (24u - 8u * i));
+      header[8u + i] = static_cast<uint8_t>(height >> (24u - 8u * i));
+    }
+    header[12u] = 4u; // Channels.
+    header[13u] = 0u; // sRGB with linear alpha.
+
+    uint8_t *dst = header + QOI_HEADER_SIZE;
+    // The index starts zeroed, alpha included, and the previous pixel opaque
+    // black.
+    QOIPixel index[64u] = {};
+    QOIPixel previous = {0u, 0u, 0u, 255u};
+    uint8_t run = 0u;
+    for (size_t i = 0u; i < pixel_count; ++i) {
+      const uint8_t *src = bgra + 4u * i;
+      const QOIPixel pixel = {src[2u], src[1u], src[0u], src[3u]};
+
+      if (pixel == previous) {
+        ++run;
+        if ((run == 62u) || (i + 1u == pixel_count)) {
+          *dst++ = static_cast<uint8_t>(QOI_OP_RUN | (run - 1u));
+          run = 0u;
+        }
+        continue;
+      }
+      if (run > 0u) {
+        *dst++ = static_cast<uint8_t>(QOI_OP_RUN | (run - 1u));
+        run = 0u;
+      }
+      const size_t hash = pixel.Hash();
+      if (index[hash] == pixel) {
+        *dst++ = QOI_OP_INDEX | static_cast<uint8_t>(hash);
+      } else {
+        index[hash] = pixel;
+        if (pixel.a == previous.a) {
+          const int8_t vr = static_cast<int8_t>(pixel.r - previous.r);
+          const int8_t vg = static_cast<int8_t>(pixel.g - previous.g);
+          const int8_t vb = static_cast<int8_t>(pixel.b - previous.b);
+          const int8_t vg_r = static_cast<int8_t>(vr - vg);
+          const int8_t vg_b = static_cast<int8_t>(vb - vg);
+          if ((vr > -3) && (vr < 2) && (vg > -3) && (vg < 2) && (vb > -3) && (vb < 2)) {
+            *dst++ = QOI_OP_DIFF | static_cast<uint8_t>(((vr + 2) << 4) | ((vg + 2) << 2) | (vb + 2));
+          } else if ((vg_r > -9) && (vg_r < 8) && (vg > -33) && (vg < 32) && (vg_b > -9) && (vg_b < 8)) {
+            *dst++ = QOI_OP_LUMA | static_cast<uint8_t>(vg + 32);
+            *dst++ = static_cast<uint8_t>(((vg_r + 8) << 4) | (vg_b + 8));
+          } else {
+            *dst++ = QOI_OP_RGB;
+            *dst++ = pixel.r;
+            *dst++ = pixel.g;
+            *dst++ = pixel.b;
+          }
+        } else {
+          *dst++ = QOI_OP_RGBA;
+          *dst++ = pixel.r;
+          *dst++ = pixel.g;
+          *dst++ = pixel.b;
+          *dst++ = pixel.a;
+        }
+      }
+      previous = pixel;
+    }
+    std::memcpy(dst, QOI_PADDING, sizeof(QOI_PADDING));
+    dst += sizeof(QOI_PADDING);
+    out.resize(static_cast<size_t>(dst - out.data()));
+  }
+
+  void ImageEncoder::DecodeQOI(
+      const uint8_t *data,
+      size_t size,
+      std::vector<uint8_t> &bgra,
+      uint32_t &width,
+      uint32_t &height) {
+    if ((size < QOI_HEADER_SIZE + sizeof(QOI_PADDING)) || (std::memcmp(data, "qoif", 4u) != 0)) {
+      throw_exception(std::runtime_error("invalid QOI image"));
+    }
+    width = ReadBigEndian(data + 4u);
+    height = ReadBigEndian(data + 8u);
+    const size_t pixel_count = size_t(width) * size_t(height);
+    bgra.resize(4u * pixel_count);
+
+    const uint8_t *src = data + QOI_HEADER_SIZE;
+    const uint8_t *const end = data + size - sizeof(QOI_PADDING);
+    QOIPixel index[64u] = {};
+    QOIPixel pixel = {0u, 0u, 0u, 255u};
+    size_t run = 0u;
+    for (size_t i = 0u; i < pixel_count; ++i) {
+      if (run > 0u) {
+        --run;
+      } else {
+        if (src >= end) {
+          throw_exception(std::runtime_error("truncated QOI image"));
+        }
+        const uint8_t b1 = *src++;
+        if (b1 == QOI_OP_RGB) {
+          if (end - src < 3) {
+            throw_exception(std::runtime_error("truncated QOI image"));
+          }
+          pixel.r = *src++;
+          pixel.g = *src++;
+          pixel.b = *src++;
+        } else if (b1 == QOI_OP_RGBA) {
+          if (end - src < 4) {
+            throw_exception(std::runtime_error("truncated QOI image"));
+          }
+          pixel.r = *src++;
+          pixel.g = *src++;
+          pixel.b = *src++;
+          pixel.a = *src++;
+        } else if ((b1 & QOI_MASK) == QOI_OP_INDEX) {
+          pixel = index[b1];
+        } else if ((b1 & QOI_MASK) == QOI_OP_DIFF) {
+          pixel.r = static_cast<uint8_t>(pixel.r + ((b1 >> 4) & 0x03) - 2);
+          pixel.g = static_cast<uint8_t>(pixel.g + ((b1 >> 2) & 0x03) - 2);
+          pixel.b = static_cast<uint8_t>(pixel.b + (b1 & 0x03) - 2);
+        } else if ((b1 & QOI_MASK) == QOI_OP_LUMA) {
+          if (src >= end) {
+            throw_exception(std::runtime_error("truncated QOI image"));
+          }
+          const uint8_t b2 = *src++;
+          const int vg = (b1 & 0x3f) - 32;
+          pixel.r = static_cast<uint8_t>(pixel.r + vg - 8 + ((b2 >> 4) & 0x0f));
+          pixel.g = static_cast<uint8_t>(pixel.g + vg);
+          pixel.b = static_cast<uint8_t>(pixel.b + vg - 8 + (b2 & 0x0f));
+        } else {
+          run = b1 & 0x3fu;
+        }
+        index[pixel.Hash()] = pixel;
+      }
+      uint8_t *dst = bgra.data() + 4u * i;
+      dst[0u] = pixel.b;
+      dst[1u] = pixel.g;
+      dst[2u] = pixel.r;
+      dst[3u] = pixel.a;
+    }
+  }
+
+} // namespace image
+} // namespace carla
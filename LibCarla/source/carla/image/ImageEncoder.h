@@ -0,0 +1,74 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace carla {
+namespace image {
+
+  /// Encoders of 8-bit BGRA images, the pixel format of the cameras, that
+  /// write directly from the pixel buffer without going through Boost.GIL.
+  class ImageEncoder {
+  public:
+
+    enum class Format {
+      /// Uncompressed 32-bit BMP, the pixels are copied as they are.
+      BMP,
+      /// PNG with a configurable zlib compression level.
+      PNG,
+      /// "Quite OK Image" format, lossless and several times faster than PNG.
+      QOI
+    };
+
+    /// Return the format matching the extension of @a path, or false if
+    /// none matches.
+    static bool FormatFromPath(const std::string &path, Format &format);
+
+    static const char *GetDefaultExtension(Format format);
+
+    /// Encode @a width x @a height BGRA pixels at @a bgra, row by row, and
+    /// append the result to @a out.
+    ///
+    /// @a png_compression_level ranges from 0 (store) to 9 (smallest), low
+    /// levels are much faster.
+    ///
+    /// @throw std::runtime_error if the format is not supported.
+    static void Encode(
+        Format format,
+        const uint8_t *bgra,
+        uint32_t width,
+        uint32_t height,
+        std::vector<uint8_t> &out,
+        int png_compression_level = 1);
+
+    static void EncodeBMP(const uint8_t *bgra, uint32_t width, uint32_t height, std::vector<uint8_t> &out);
+
+    static void EncodePNG(
+        const uint8_t *bgra,
+        uint32_t width,
+        uint32_t height,
+        std::vector<uint8_t> &out,
+        int compression_level);
+
+    static void EncodeQOI(const uint8_t *bgra, uint32_t width, uint32_t height, std::vector<uint8_t> &out);
+
+    /// Decode a QOI image into BGRA pixels.
+    ///
+    /// @throw std::runtime_error if the data is not a valid QOI image.
+    static void DecodeQOI(
+        const uint8_t *data,
+        size_t size,
+        std::vector<uint8_t> &bgra,
+        uint32_t &width,
+        uint32_t &height);
+  };
+
+} // namespace image
+} // namespace carla
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "carla/Debug.h"
 #include "carla/FileSystem.h"
 #include "carla/Logging.h"
 #include "carla/StringUtil.h"
@@ -0,0 +1,118 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/image/ImageWriter.h"
+
+#include "carla/Exception.h"
+#include "carla/FileSystem.h"
+#include "carla/image/ImageEncoder.h"
+#include "carla/image/ImageIO.h"
+#include "carla/image/ImageView.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace carla {
+namespace image {
+
+  ImageWriter::ImageWriter(
+      const size_t worker_threads,
+      const size_t max_queued_images,
+      const int png_compression_level)
+    : _max_queued_images(max_queued_images),
+      _png_compression_level(png_compression_level) {
+    _pool.AsyncRun(worker_threads > 0u ?
+        worker_threads :
+        std::max(1u, std::thread::hardware_concurrency()));
+  }
+
+  ImageWriter::~ImageWriter() {
+    Flush();
+    _pool.Stop();
+  }
+
+  std::future<std::string> ImageWriter::Write(
+      SharedPtr<const sensor::data::Image> image,
+      std::string path) {
+    DEBUG_ASSERT(image != nullptr);
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_queued_images >= _max_queued_images) {
+        ++_dropped_images;
+        return {};
+      }
+      ++_queued_images;
+    }
+    return _pool.Post([this, image=std::move(image), path=std::move(path)]() {
+      // Always leave the queue, the exception is given back in the future.
+      struct Dequeue {
+        ImageWriter &self;
+        ~Dequeue() {
+          std::lock_guard<std::mutex> lock(self._mutex);
+          --self._queued_images;
+          self._condition.notify_all();
+        }
+      } dequeue{*this};
+      try {
+        return WriteImage(*image, path, _png_compression_level);
+      } catch (...) {
+        ++_failed_images;
+        throw;
+      }
+    });
+  }
+
+  void ImageWriter::Flush() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _condition.wait(lock, [this]() { return _queued_images == 0u; });
+  }
+
+  size_t ImageWriter::GetQueuedCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _queued_images;
+  }
+
+  size_t ImageWriter::GetDroppedCount() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _dropped_images;
+  }
+
+  std::string ImageWriter::WriteImage(
+      const sensor::data::Image &image,
+      std::string path,
+      const int png_compression_level) {
+    ImageEncoder::Format format;
+    if (!ImageEncoder::FormatFromPath(path, format)) {
+      FileSystem::ValidateFilePath(path, ImageEncoder::GetDefaultExtension(ImageEncoder::Format::PNG));
+      if (!ImageEncoder::FormatFromPath(path, format)) {
+        return ImageIO::WriteView(std::move(path), ImageView::MakeView(image));
+      }
+    }
+    FileSystem::ValidateFilePath(path);
+
+    // Each worker thread reuses its own buffer.
+    static thread_local std::vector<uint8_t> encoded;
+    encoded.clear();
+    ImageEncoder::Encode(
+        format,
+        reinterpret_cast<const uint8_t *>(image.data()),
+        image.GetWidth(),
+        image.GetHeight(),
+        encoded,
+        png_compression_level);
+
+    std::ofstream out(path, std::ios::out | std::ios::binary);
+    out.write(reinterpret_cast<const char *>(encoded.data()), static_cast<std::streamsize>(encoded.size()));
+    if (!out) {
+      throw_exception(std::runtime_error("failed to write image " + path));
+    }
+    return path;
+  }
+
+} // namespace image
+} // namespace carla
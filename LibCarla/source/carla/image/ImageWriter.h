@@ -0,0 +1,97 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Memory.h"
+#include "carla/NonCopyable.h"
+#include "carla/ThreadPool.h"
+#include "carla/sensor/data/Image.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <string>
+
+namespace carla {
+namespace image {
+
+  /// Encodes and writes camera images to disk in a pool of worker threads,
+  /// so saving images does not block the sensor callbacks.
+  ///
+  /// The image is handed over by shared pointer and encoded straight from the
+  /// sensor's buffer. The format is chosen by the extension of the path:
+  /// ".bmp", ".png" and ".qoi" use the encoders in ImageEncoder, any other
+  /// extension supported by ImageIO goes through Boost.GIL. Paths without
+  /// extension are saved as PNG.
+  ///
+  /// At most @a max_queued_images images wait to be written; when the queue
+  /// is full new images are dropped instead of blocking the caller.
+  class ImageWriter : private NonCopyable {
+  public:
+
+    /// @param worker_threads number of encoding threads, 0 for one per
+    /// hardware thread.
+    /// @param png_compression_level zlib level of PNG images, from 0 (store)
+    /// to 9 (smallest).
+    explicit ImageWriter(
+        size_t worker_threads = 0u,
+        size_t max_queued_images = 32u,
+        int png_compression_level = 1);
+
+    /// Writes the queued images before returning.
+    ~ImageWriter();
+
+    /// Queue @a image to be written to @a path.
+    ///
+    /// @return a future with the path of the written file, or the exception
+    /// thrown while writing it. The future is not valid if the queue was
+    /// full and the image was dropped.
+    std::future<std::string> Write(SharedPtr<const sensor::data::Image> image, std::string path);
+
+    /// Block until every queued image has been written.
+    void Flush();
+
+    size_t GetQueuedCount() const;
+
+    /// Number of images dropped because the queue was full.
+    size_t GetDroppedCount() const;
+
+    /// Number of images that could not be written.
+    size_t GetFailedCount() const {
+      return _failed_images;
+    }
+
+    /// Encode and write @a image to @a path in this thread.
+    static std::string WriteImage(
+        const sensor::data::Image &image,
+        std::string path,
+        int png_compression_level = 1);
+
+  private:
+
+    const size_t _max_queued_images;
+
+    const int _png_compression_level;
+
+    mutable std::mutex _mutex;
+
+    std::condition_variable _condition;
+
+    size_t _queued_images = 0u;
+
+    size_t _dropped_images = 0u;
+
+    std::atomic_size_t _failed_images{0u};
+
+    /// Declared last so its threads are joined before the members they use
+    /// are destroyed.
+    ThreadPool _pool;
+  };
+
+} // namespace image
+} // namespace carla
@@ -36,7 +36,7 @@ namespace multigpu {
       _timeout(timeout),
       _deadline(io_context),
       _strand(io_context),
-      _buffer_pool(std::make_shared<BufferPool>()) {}
+      _buffer_pool(BufferPool::GetDefault()) {}
 
   Primary::~Primary() {
     if (_socket.is_open()) {
@@ -125,7 +125,7 @@ namespace multigpu {
       auto self = weak.lock();
       if (!self) return;
 
-      auto message = std::make_shared<IncomingMessage>(self->_buffer_pool->Pop());
+      auto message = std::make_shared<IncomingMessage>(self->_buffer_pool);
 
       auto handle_read_data = [weak, message](boost::system::error_code ec, size_t DEBUG_ONLY(bytes)) {
         auto self = weak.lock();
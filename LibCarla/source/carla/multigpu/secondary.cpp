@@ -32,7 +32,7 @@ namespace multigpu {
       _endpoint(ep),
       _strand(_pool.io_context()),
       _connection_timer(_pool.io_context()),
-      _buffer_pool(std::make_shared<BufferPool>()) {
+      _buffer_pool(BufferPool::GetDefault()) {
         
       _commander.set_callback(callback);
     }
@@ -46,7 +46,7 @@ namespace multigpu {
       _socket(_pool.io_context()),
       _strand(_pool.io_context()),
       _connection_timer(_pool.io_context()),
-      _buffer_pool(std::make_shared<BufferPool>()) {
+      _buffer_pool(BufferPool::GetDefault()) {
 
     boost::asio::ip::address ip_address = boost::asio::ip::address::from_string(ip);
     _endpoint = boost::asio::ip::tcp::endpoint(ip_address, port);
@@ -229,7 +229,7 @@ namespace multigpu {
         return;
       }
 
-      auto message = std::make_shared<IncomingMessage>(self->_buffer_pool->Pop());
+      auto message = std::make_shared<IncomingMessage>(self->_buffer_pool);
 
       auto handle_read_data = [weak, message](boost::system::error_code ec, size_t DEBUG_ONLY(bytes)) {
         auto self = weak.lock();
@@ -7,6 +7,7 @@
 #include "carla/opendrive/OpenDriveParser.h"
 
 #include "carla/Logging.h"
+#include "carla/ParallelFor.h"
 #include "carla/opendrive/parser/ControllerParser.h"
 #include "carla/opendrive/parser/GeoReferenceParser.h"
 #include "carla/opendrive/parser/GeometryParser.h"
@@ -21,9 +22,45 @@
 
 #include <pugixml/pugixml.hpp>
 
+#include <vector>
+
 namespace carla {
 namespace opendrive {
 
+  /// Parse geometries, lanes and profiles of every road. These only depend on
+  /// the road skeleton created by the RoadParser, and each road only touches
+  /// its own infos, so chunks of roads are parsed concurrently into worker
+  /// builders. Workers are merged in chunk order, which gives the same result
+  /// as parsing the roads one after another.
+  static void ParseRoadsInParallel(
+      const pugi::xml_document &xml,
+      road::MapBuilder &map_builder) {
+    std::vector<pugi::xml_node> road_nodes;
+    for (pugi::xml_node road_node : xml.child("OpenDRIVE").children("road")) {
+      road_nodes.emplace_back(road_node);
+    }
+
+    const size_t chunk_count = ParallelChunkCount(road_nodes.size(), 32u);
+    std::vector<road::MapBuilder> workers;
+    workers.reserve(chunk_count);
+    for (size_t i = 0u; i < chunk_count; ++i) {
+      workers.emplace_back(map_builder.CreateWorker());
+    }
+
+    ParallelFor(road_nodes.size(), chunk_count, [&](size_t chunk, size_t begin, size_t end) {
+      auto &worker = workers[chunk];
+      for (size_t i = begin; i < end; ++i) {
+        parser::GeometryParser::ParseRoad(road_nodes[i], worker);
+        parser::LaneParser::ParseRoad(road_nodes[i], worker);
+        parser::ProfilesParser::ParseRoad(road_nodes[i], worker);
+      }
+    });
+
+    for (auto &worker : workers) {
+      map_builder.Merge(std::move(worker));
+    }
+  }
+
   boost::optional<road::Map> OpenDriveParser::Load(const std::string &opendrive) {
     pugi::xml_document xml;
     pugi::xml_parse_result parse_result = xml.load_string(opendrive.c_str());
@@ -38,9 +75,7 @@ namespace opendrive {
     parser::GeoReferenceParser::Parse(xml, map_builder);
     parser::RoadParser::Parse(xml, map_builder);
     parser::JunctionParser::Parse(xml, map_builder);
-    parser::GeometryParser::Parse(xml, map_builder);
-    parser::LaneParser::Parse(xml, map_builder);
-    parser::ProfilesParser::Parse(xml, map_builder);
+    ParseRoadsInParallel(xml, map_builder);
     parser::TrafficGroupParser::Parse(xml, map_builder);
     parser::SignalParser::Parse(xml, map_builder);
     parser::ObjectParser::Parse(xml, map_builder);
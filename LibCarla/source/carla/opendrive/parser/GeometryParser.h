@@ -8,6 +8,7 @@
 
 namespace pugi {
   class xml_document;
+  class xml_node;
 } // namespace pugi
 
 namespace carla {
@@ -26,6 +27,11 @@ namespace parser {
         const pugi::xml_document &xml,
         carla::road::MapBuilder &map_builder);
 
+    /// Parse the plan view geometries of a single road node.
+    static void ParseRoad(
+        const pugi::xml_node &road_node,
+        carla::road::MapBuilder &map_builder);
+
   };
 
 } // namespace parser
@@ -192,26 +192,32 @@ namespace parser {
 
     // Lanes
     for (pugi::xml_node road_node : open_drive_node.children("road")) {
-      road::RoadId road_id = road_node.attribute("id").as_uint();
+      ParseRoad(road_node, map_builder);
+    }
+  }
 
-      for (pugi::xml_node lanes_node : road_node.children("lanes")) {
+  void LaneParser::ParseRoad(
+      const pugi::xml_node &road_node,
+      carla::road::MapBuilder &map_builder) {
+    road::RoadId road_id = road_node.attribute("id").as_uint();
 
-        for (pugi::xml_node lane_section_node : lanes_node.children("laneSection")) {
-          double s = lane_section_node.attribute("s").as_double();
-          pugi::xml_node left_node = lane_section_node.child("left");
-          if (left_node) {
-            ParseLanes(road_id, s, left_node, map_builder);
-          }
+    for (pugi::xml_node lanes_node : road_node.children("lanes")) {
 
-          pugi::xml_node center_node = lane_section_node.child("center");
-          if (center_node) {
-            ParseLanes(road_id, s, center_node, map_builder);
-          }
+      for (pugi::xml_node lane_section_node : lanes_node.children("laneSection")) {
+        double s = lane_section_node.attribute("s").as_double();
+        pugi::xml_node left_node = lane_section_node.child("left");
+        if (left_node) {
+          ParseLanes(road_id, s, left_node, map_builder);
+        }
 
-          pugi::xml_node right_node = lane_section_node.child("right");
-          if (right_node) {
-            ParseLanes(road_id, s, right_node, map_builder);
-          }
+        pugi::xml_node center_node = lane_section_node.child("center");
+        if (center_node) {
+          ParseLanes(road_id, s, center_node, map_builder);
+        }
+
+        pugi::xml_node right_node = lane_section_node.child("right");
+        if (right_node) {
+          ParseLanes(road_id, s, right_node, map_builder);
         }
       }
     }
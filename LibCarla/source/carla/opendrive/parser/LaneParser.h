@@ -8,6 +8,7 @@
 
 namespace pugi {
   class xml_document;
+  class xml_node;
 } // namespace pugi
 
 namespace carla {
@@ -25,6 +26,11 @@ namespace parser {
     static void Parse(
         const pugi::xml_document &xml,
         carla::road::MapBuilder &map_builder);
+
+    /// Parse the lane sections of a single road node.
+    static void ParseRoad(
+        const pugi::xml_node &road_node,
+        carla::road::MapBuilder &map_builder);
   };
 
 } // namespace parser
@@ -6,11 +6,17 @@
 
 #pragma once
 
+#include "carla/Debug.h"
 #include "carla/FileSystem.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iterator>
 #include <iomanip>
+#include <type_traits>
+#include <vector>
 
 namespace carla {
 namespace pointcloud {
@@ -18,6 +24,17 @@ namespace pointcloud {
   class PointCloudIO {
 
   public:
+
+    enum class Format {
+      /// PLY with a line of text per point.
+      PlyAscii,
+      /// PLY with the points stored as little-endian binary, as they are in
+      /// memory.
+      PlyBinary,
+      /// PCD with the points stored as binary, as they are in memory.
+      PcdBinary
+    };
+
     template <typename PointIt>
     static void Dump(std::ostream &out, PointIt begin, PointIt end) {
       WriteHeader(out, begin, end);
@@ -27,24 +44,131 @@ namespace pointcloud {
       }
     }
 
+    /// Write the points in binary_little_endian PLY format. @a out should be
+    /// opened in binary mode.
+    template <typename PointIt>
+    static void DumpBinary(std::ostream &out, PointIt begin, PointIt end) {
+      out << "ply\n"
+             "format binary_little_endian 1.0\n"
+             "element vertex " << std::to_string(GetPointCount(begin, end)) << "\n";
+      if (begin != end) {
+        begin->WritePlyHeaderInfo(out);
+        out << '\n';
+      }
+      out << "end_header\n";
+      WritePoints(out, begin, end);
+    }
+
+    /// Write the points in binary PCD format. @a out should be opened in
+    /// binary mode.
+    template <typename PointIt>
+    static void DumpPcd(std::ostream &out, PointIt begin, PointIt end) {
+      const auto count = std::to_string(GetPointCount(begin, end));
+      out << "# .PCD v0.7 - Point Cloud Data file format\n"
+             "VERSION 0.7\n";
+      if (begin != end) {
+        begin->WritePcdHeaderInfo(out);
+        out << '\n';
+      }
+      out << "WIDTH " << count << "\n"
+             "HEIGHT 1\n"
+             "VIEWPOINT 0 0 0 1 0 0 0\n"
+             "POINTS " << count << "\n"
+             "DATA binary\n";
+      WritePoints(out, begin, end);
+    }
+
     template <typename PointIt>
-    static std::string SaveToDisk(std::string path, PointIt begin, PointIt end) {
-      FileSystem::ValidateFilePath(path, ".ply");
-      std::ofstream out(path);
-      Dump(out, begin, end);
+    static void Dump(std::ostream &out, PointIt begin, PointIt end, Format format) {
+      switch (format) {
+        case Format::PlyBinary:
+          return DumpBinary(out, begin, end);
+        case Format::PcdBinary:
+          return DumpPcd(out, begin, end);
+        default:
+          return Dump(out, begin, end);
+      }
+    }
+
+    template <typename PointIt>
+    static std::string SaveToDisk(
+        std::string path,
+        PointIt begin,
+        PointIt end,
+        Format format = Format::PlyAscii) {
+      FileSystem::ValidateFilePath(path, format == Format::PcdBinary ? ".pcd" : ".ply");
+      std::ofstream out(
+          path,
+          format == Format::PlyAscii ? std::ios::out : std::ios::out | std::ios::binary);
+      Dump(out, begin, end, format);
       return path;
     }
 
   private:
-    template <typename PointIt> static void WriteHeader(std::ostream &out, PointIt begin, PointIt end) {
+
+    template <typename PointIt>
+    static size_t GetPointCount(PointIt begin, PointIt end) {
       DEBUG_ASSERT(std::distance(begin, end) >= 0);
+      return static_cast<size_t>(std::distance(begin, end));
+    }
+
+    template <typename PointIt> static void WriteHeader(std::ostream &out, PointIt begin, PointIt end) {
       out << "ply\n"
            "format ascii 1.0\n"
-           "element vertex " << std::to_string(static_cast<size_t>(std::distance(begin, end))) << "\n";
+           "element vertex " << std::to_string(GetPointCount(begin, end)) << "\n";
       begin->WritePlyHeaderInfo(out);
       out << "\nend_header\n";
       out << std::fixed << std::setprecision(4u);
     }
+
+    static bool IsLittleEndian() {
+      const uint32_t one = 1u;
+      uint8_t first_byte;
+      std::memcpy(&first_byte, &one, 1u);
+      return first_byte == 1u;
+    }
+
+    /// Every property of the detections is 4 bytes, so a big-endian host only
+    /// needs to swap the bytes of each 4-byte word.
+    static void SwapWords(char *data, size_t size) {
+      for (size_t i = 0u; i + 3u < size; i += 4u) {
+        std::swap(data[i], data[i + 3u]);
+        std::swap(data[i + 1u], data[i + 2u]);
+      }
+    }
+
+    /// Contiguous points in a little-endian host are written with a single
+    /// call.
+    template <typename T>
+    static void WritePoints(std::ostream &out, T *begin, T *end) {
+      if (IsLittleEndian()) {
+        out.write(
+            reinterpret_cast<const char *>(begin),
+            static_cast<std::streamsize>(sizeof(T) * GetPointCount(begin, end)));
+      } else {
+        WritePoints<T *>(out, begin, end);
+      }
+    }
+
+    template <typename PointIt>
+    static void WritePoints(std::ostream &out, PointIt begin, PointIt end) {
+      using T = typename std::iterator_traits<PointIt>::value_type;
+      static_assert(std::is_trivially_copyable<T>::value, "Points must be trivially copyable");
+      static_assert(sizeof(T) % 4u == 0u, "Point properties must be 4 bytes");
+      constexpr size_t BatchSize = 4096u;
+      std::vector<char> buffer(sizeof(T) * BatchSize);
+      const bool swap = !IsLittleEndian();
+      while (begin != end) {
+        size_t size = 0u;
+        for (; (begin != end) && (size < buffer.size()); ++begin, size += sizeof(T)) {
+          std::memcpy(buffer.data() + size, &*begin, sizeof(T));
+        }
+        if (swap) {
+          SwapWords(buffer.data(), size);
+        }
+        out.write(buffer.data(), static_cast<std::streamsize>(size));
+      }
+    }
   };
 
 } // namespace pointcloud
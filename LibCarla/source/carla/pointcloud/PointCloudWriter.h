@@ -0,0 +1,116 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Logging.h"
+#include "carla/NonCopyable.h"
+#include "carla/ThreadPool.h"
+#include "carla/pointcloud/PointCloudIO.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <string>
+
+namespace carla {
+namespace pointcloud {
+
+  /// Writes point clouds to disk in a background thread, so saving every
+  /// measurement does not block the sensor callback.
+  ///
+  /// At most @a max_queued_clouds measurements wait to be written; when the
+  /// queue is full new measurements are dropped instead of blocking the
+  /// caller.
+  class PointCloudWriter : private NonCopyable {
+  public:
+
+    using Format = PointCloudIO::Format;
+
+    explicit PointCloudWriter(size_t max_queued_clouds = 16u)
+      : _max_queued_clouds(max_queued_clouds) {
+      _pool.AsyncRun(1u);
+    }
+
+    /// Writes the queued measurements before returning.
+    ~PointCloudWriter() {
+      Flush();
+      _pool.Stop();
+    }
+
+    /// Queue @a measurement to be written to @a path. @a measurement is a
+    /// shared pointer to a lidar measurement (or any range of detections),
+    /// it is kept alive until written so no data is copied.
+    ///
+    /// @return false if the queue is full and the measurement was dropped.
+    template <typename MeasurementPtrT>
+    bool Write(MeasurementPtrT measurement, std::string path, Format format = Format::PlyBinary) {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_queued_clouds >= _max_queued_clouds) {
+          ++_dropped_clouds;
+          return false;
+        }
+        ++_queued_clouds;
+      }
+      _pool.Post([this, measurement=std::move(measurement), path=std::move(path), format]() {
+        try {
+          PointCloudIO::SaveToDisk(path, measurement->begin(), measurement->end(), format);
+        } catch (const std::exception &e) {
+          ++_failed_clouds;
+          log_error("failed to write point cloud", path, ':', e.what());
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        --_queued_clouds;
+        _condition.notify_all();
+      });
+      return true;
+    }
+
+    /// Block until every queued measurement has been written.
+    void Flush() {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _condition.wait(lock, [this]() { return _queued_clouds == 0u; });
+    }
+
+    size_t GetQueuedCount() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _queued_clouds;
+    }
+
+    /// Number of measurements dropped because the queue was full.
+    size_t GetDroppedCount() const {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _dropped_clouds;
+    }
+
+    /// Number of measurements that could not be written.
+    size_t GetFailedCount() const {
+      return _failed_clouds;
+    }
+
+  private:
+
+    const size_t _max_queued_clouds;
+
+    mutable std::mutex _mutex;
+
+    std::condition_variable _condition;
+
+    size_t _queued_clouds = 0u;
+
+    size_t _dropped_clouds = 0u;
+
+    std::atomic_size_t _failed_clouds{0u};
+
+    /// Declared last so its thread is joined before the members it uses are
+    /// destroyed.
+    ThreadPool _pool;
+  };
+
+} // namespace pointcloud
+} // namespace carla
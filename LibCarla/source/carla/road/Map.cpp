@@ -6,6 +6,7 @@
 
 #include "carla/road/Map.h"
 #include "carla/Exception.h"
+#include "carla/ParallelFor.h"
 #include "carla/geom/Math.h"
 #include "carla/road/MeshFactory.h"
 #include "carla/road/element/LaneCrossingCalculator.h"
@@ -17,6 +18,10 @@
 #include "carla/road/element/RoadInfoMarkRecord.h"
 #include "carla/road/element/RoadInfoSignal.h"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <queue>
 #include <vector>
 #include <unordered_map>
 #include <stdexcept>
@@ -30,6 +35,10 @@ namespace road {
   /// sections to avoid floating point precision errors.
   static constexpr double EPSILON = 10.0 * std::numeric_limits<double>::epsilon();
 
+  /// Slack of the signal index, used to assign the signals at the ends of a
+  /// lane section to it and to compare distances summed in different order.
+  static constexpr double SIGNAL_INDEX_TOLERANCE = 1e-3;
+
   // ===========================================================================
   // -- Static local methods ---------------------------------------------------
   // ===========================================================================
@@ -149,6 +158,114 @@ namespace road {
     return section.ContainsLane(waypoint.lane_id);
   }
 
+  /// Part of the road mesh that can be built independently of the others,
+  /// either a road outside junctions or a whole junction.
+  struct MeshPiece {
+    const Road *road = nullptr;
+    const Junction *junction = nullptr;
+  };
+
+  /// Roads outside junctions followed by the junctions.
+  static std::vector<MeshPiece> GetMeshPieces(const MapData &data) {
+    std::vector<MeshPiece> pieces;
+    pieces.reserve(data.GetRoads().size() + data.GetJunctions().size());
+    for (const auto &pair : data.GetRoads()) {
+      if (!pair.second.IsJunction()) {
+        pieces.push_back(MeshPiece{&pair.second, nullptr});
+      }
+    }
+    for (const auto &pair : data.GetJunctions()) {
+      pieces.push_back(MeshPiece{nullptr, &pair.second});
+    }
+    return pieces;
+  }
+
+  /// Call `func(index)` for each index in [0, size) from as many threads as
+  /// ParallelChunkCount allows. Indexes are handed out one at a time, so a few
+  /// expensive items, like smoothed junctions, do not hold back a whole chunk.
+  template <typename FuncT>
+  static void ParallelForEachIndex(size_t size, FuncT &&func) {
+    std::atomic_size_t next_index{0u};
+    const size_t thread_count = ParallelChunkCount(size);
+    ParallelFor(thread_count, thread_count, [&](size_t, size_t, size_t) {
+      for (size_t i = next_index++; i < size; i = next_index++) {
+        func(i);
+      }
+    });
+  }
+
+  /// Append @a meshes in order to @a out_mesh, growing it only once.
+  static void AppendMeshes(
+      geom::Mesh &out_mesh,
+      const std::vector<std::unique_ptr<geom::Mesh>> &meshes) {
+    size_t vertex_count = out_mesh.GetVerticesNum();
+    size_t index_count = out_mesh.GetIndexesNum();
+    for (const auto &mesh : meshes) {
+      vertex_count += mesh->GetVerticesNum();
+      index_count += mesh->GetIndexesNum();
+    }
+    out_mesh.Reserve(vertex_count, index_count);
+    for (const auto &mesh : meshes) {
+      out_mesh += *mesh;
+    }
+  }
+
+  /// Mesh of the lanes of the roads inside @a junction. If @a split_sidewalks
+  /// is true, sidewalks are not smoothed and are appended at the end.
+  static std::unique_ptr<geom::Mesh> GenerateJunctionMesh(
+      const MapData &data,
+      const geom::MeshFactory &mesh_factory,
+      const Junction &junction,
+      const bool smooth_junctions,
+      const bool split_sidewalks) {
+    std::vector<std::unique_ptr<geom::Mesh>> lane_meshes;
+    std::vector<std::unique_ptr<geom::Mesh>> sidewalk_lane_meshes;
+    for (const auto &connection_pair : junction.GetConnections()) {
+      const auto &connection = connection_pair.second;
+      const auto &road = data.GetRoads().at(connection.connecting_road);
+      for (auto &&lane_section : road.GetLaneSections()) {
+        for (auto &&lane_pair : lane_section.GetLanes()) {
+          const auto &lane = lane_pair.second;
+          if (split_sidewalks && lane.GetType() == Lane::LaneType::Sidewalk) {
+            sidewalk_lane_meshes.push_back(mesh_factory.Generate(lane));
+          } else {
+            lane_meshes.push_back(mesh_factory.Generate(lane));
+          }
+        }
+      }
+    }
+    std::unique_ptr<geom::Mesh> junction_mesh;
+    if (smooth_junctions) {
+      junction_mesh = mesh_factory.MergeAndSmooth(lane_meshes);
+    } else {
+      junction_mesh = std::make_unique<geom::Mesh>();
+      AppendMeshes(*junction_mesh, lane_meshes);
+    }
+    AppendMeshes(*junction_mesh, sidewalk_lane_meshes);
+    return junction_mesh;
+  }
+
+  /// Meshes GenerateChunkedMesh builds for @a piece, without the empty ones.
+  static std::vector<std::unique_ptr<geom::Mesh>> GenerateChunkedMeshPiece(
+      const MapData &data,
+      const geom::MeshFactory &mesh_factory,
+      const MeshPiece &piece,
+      const bool smooth_junctions) {
+    std::vector<std::unique_ptr<geom::Mesh>> result;
+    if (piece.road != nullptr) {
+      result = mesh_factory.GenerateAllWithMaxLen(*piece.road);
+    } else {
+      result.push_back(GenerateJunctionMesh(
+          data, mesh_factory, *piece.junction, smooth_junctions, true));
+    }
+    result.erase(
+        std::remove_if(result.begin(), result.end(), [](const auto &mesh) {
+          return mesh == nullptr || mesh->GetVerticesNum() == 0u;
+        }),
+        result.end());
+    return result;
+  }
+
   // ===========================================================================
   // -- Map: Geometry ----------------------------------------------------------
   // ===========================================================================
@@ -320,93 +437,88 @@ namespace road {
 
   std::vector<Map::SignalSearchData> Map::GetSignalsInDistance(
       Waypoint waypoint, double distance, bool stop_at_junction) const {
+    std::vector<SignalSearchData> result;
+    AddSignalsInDistance(waypoint, distance, 0.0, stop_at_junction, result);
+    return result;
+  }
 
+  void Map::AddSignalsInDistance(
+      const Waypoint waypoint,
+      const double distance,
+      const double accumulated_s,
+      const bool stop_at_junction,
+      std::vector<SignalSearchData> &result) const {
     const auto &lane = GetLane(waypoint);
+    const auto lane_signals = _lane_signals.find(&lane);
+    if (lane_signals == _lane_signals.end()) {
+      // No signal can be reached from this lane.
+      return;
+    }
     const bool forward = (waypoint.lane_id <= 0);
-    const double signed_distance = forward ? distance : -distance;
     const double relative_s = waypoint.s - lane.GetDistance();
     const double remaining_lane_length = forward ? lane.GetLength() - relative_s : relative_s;
     DEBUG_ASSERT(remaining_lane_length >= 0.0);
 
-    auto &road =_data.GetRoad(waypoint.road_id);
-    std::vector<SignalSearchData> result;
-
-    // If after subtracting the distance we are still in the same lane, return
-    // same waypoint with the extra distance.
-    if (distance <= remaining_lane_length) {
-      auto signals = road.GetInfosInRange<RoadInfoSignal>(
-          waypoint.s, waypoint.s + signed_distance);
-      for(auto* signal : signals){
-        double distance_to_signal = 0;
-        if (waypoint.lane_id < 0){
-          distance_to_signal = signal->GetDistance() - waypoint.s;
-        } else {
-          distance_to_signal = waypoint.s - signal->GetDistance();
-        }
-        // check that the signal affects the waypoint
-        bool is_valid = false;
-        for (auto &validity : signal->GetValidities()) {
-          if (waypoint.lane_id >= validity._from_lane &&
-              waypoint.lane_id <= validity._to_lane) {
-            is_valid = true;
-            break;
-          }
-        }
-        if(!is_valid){
-          continue;
-        }
-        if (distance_to_signal == 0) {
-          result.emplace_back(SignalSearchData
-              {signal, waypoint,
-              distance_to_signal});
-        } else {
-          result.emplace_back(SignalSearchData
-              {signal, GetNext(waypoint, distance_to_signal).front(),
-              distance_to_signal});
-        }
-
-      }
-      return result;
-    }
-    const double signed_remaining_length = forward ? remaining_lane_length : -remaining_lane_length;
-
-    //result = road.GetInfosInRange<RoadInfoSignal>(waypoint.s, waypoint.s + signed_remaining_length);
-    auto signals = road.GetInfosInRange<RoadInfoSignal>(
-        waypoint.s, waypoint.s + signed_remaining_length);
-    for(auto* signal : signals){
-      double distance_to_signal = 0;
-      if (waypoint.lane_id < 0){
-        distance_to_signal = signal->GetDistance() - waypoint.s;
-      } else {
-        distance_to_signal = waypoint.s - signal->GetDistance();
-      }
-      // check that the signal affects the waypoint
-      bool is_valid = false;
-      for (auto &validity : signal->GetValidities()) {
-        if (waypoint.lane_id >= validity._from_lane &&
-            waypoint.lane_id <= validity._to_lane) {
-          is_valid = true;
-          break;
-        }
-      }
-      if(!is_valid){
-        continue;
-      }
+    // Signals of this lane in [s, s + distance] in the driving direction,
+    // or up to the end of the lane.
+    const double search_length = std::min(distance, remaining_lane_length);
+    const double min_s = forward ? waypoint.s : waypoint.s - search_length;
+    const double max_s = forward ? waypoint.s + search_length : waypoint.s;
+    const auto &signals = lane_signals->second.signals;
+    const auto begin = std::lower_bound(signals.begin(), signals.end(), min_s,
+        [](const RoadInfoSignal *signal, double s) { return signal->GetDistance() < s; });
+    const auto end = std::upper_bound(begin, signals.end(), max_s,
+        [](double s, const RoadInfoSignal *signal) { return s < signal->GetDistance(); });
+    const auto add_signal = [&](const RoadInfoSignal *signal) {
+      const double distance_to_signal = (waypoint.lane_id < 0) ?
+          signal->GetDistance() - waypoint.s :
+          waypoint.s - signal->GetDistance();
       if (distance_to_signal == 0) {
         result.emplace_back(SignalSearchData
             {signal, waypoint,
-            distance_to_signal});
+            accumulated_s + distance_to_signal});
       } else {
         result.emplace_back(SignalSearchData
             {signal, GetNext(waypoint, distance_to_signal).front(),
-            distance_to_signal});
+            accumulated_s + distance_to_signal});
       }
+    };
+    if (forward) {
+      std::for_each(begin, end, add_signal);
+    } else {
+      std::for_each(
+          std::make_reverse_iterator(end),
+          std::make_reverse_iterator(begin),
+          add_signal);
     }
-    // If we run out of remaining_lane_length we have to go to the successors.
-    for (auto &successor : GetSuccessors(waypoint)) {
+    if (distance <= remaining_lane_length) {
+      return;
+    }
+
+    // If we run out of remaining_lane_length we have to go to the successors,
+    // skipping those with no signal close enough.
+    const double distance_left = distance - remaining_lane_length;
+    for (const auto &successor : GetSuccessorsAtLaneStart(waypoint)) {
       if(_data.GetRoad(successor.road_id).IsJunction() && stop_at_junction){
         continue;
       }
+      const auto next = _lane_signals.find(&GetLane(successor));
+      if (next == _lane_signals.end() ||
+          distance_left + SIGNAL_INDEX_TOLERANCE < next->second.distance_to_next_signal) {
+        continue;
+      }
+      AddSignalsInDistance(
+          successor,
+          distance_left,
+          accumulated_s + remaining_lane_length,
+          stop_at_junction,
+          result);
+    }
+  }
+
+  std::vector<Waypoint> Map::GetSuccessorsAtLaneStart(const Waypoint waypoint) const {
+    auto successors = GetSuccessors(waypoint);
+    for (auto &successor : successors) {
       auto& sucessor_lane = _data.GetRoad(successor.road_id).
             GetLaneByDistance(successor.s, successor.lane_id);
       if (successor.lane_id < 0) {
@@ -414,27 +526,13 @@ namespace road {
       } else {
         successor.s = sucessor_lane.GetDistance() + sucessor_lane.GetLength();
       }
-      auto sucessor_signals = GetSignalsInDistance(
-          successor, distance - remaining_lane_length, stop_at_junction);
-      for(auto& signal : sucessor_signals){
-        signal.accumulated_s += remaining_lane_length;
-      }
-      result = ConcatVectors(result, sucessor_signals);
     }
-    return result;
+    return successors;
   }
 
   std::vector<const element::RoadInfoSignal*>
       Map::GetAllSignalReferences() const {
-    std::vector<const element::RoadInfoSignal*> result;
-    for (const auto& road_pair : _data.GetRoads()) {
-      const auto &road = road_pair.second;
-      auto road_infos = road.GetInfos<element::RoadInfoSignal>();
-      for(const auto* road_info : road_infos) {
-        result.push_back(road_info);
-      }
-    }
-    return result;
+    return _signal_references;
   }
 
   std::vector<LaneMarking> Map::CalculateCrossedLanes(
@@ -650,6 +748,51 @@ namespace road {
     return result;
   }
 
+  /// Export the waypoints returned by `get_waypoint(i)` for i in [0, @a size),
+  /// a null pointer leaves row i zero.
+  template <typename GetWaypointT>
+  static element::WaypointColumns ExportWaypointsImpl(
+      const Map &map,
+      const size_t size,
+      GetWaypointT &&get_waypoint) {
+    element::WaypointColumns columns;
+    columns.resize(size);
+    ParallelForChunks(size, 1024u, [&](size_t, size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        const Waypoint *waypoint = get_waypoint(i);
+        if (waypoint == nullptr) {
+          continue;
+        }
+        const auto &lane = map.GetLane(*waypoint);
+        const auto transform = lane.ComputeTransform(waypoint->s);
+        columns.road_id[i] = waypoint->road_id;
+        columns.section_id[i] = waypoint->section_id;
+        columns.lane_id[i] = waypoint->lane_id;
+        columns.s[i] = waypoint->s;
+        columns.x[i] = transform.location.x;
+        columns.y[i] = transform.location.y;
+        columns.z[i] = transform.location.z;
+        columns.yaw[i] = transform.rotation.yaw;
+        columns.lane_width[i] = map.GetLaneWidth(*waypoint);
+        columns.lane_type[i] = static_cast<int32_t>(lane.GetType());
+      }
+    });
+    return columns;
+  }
+
+  element::WaypointColumns Map::ExportWaypoints(const std::vector<Waypoint> &waypoints) const {
+    return ExportWaypointsImpl(*this, waypoints.size(), [&](size_t i) {
+      return &waypoints[i];
+    });
+  }
+
+  element::WaypointColumns Map::ExportWaypoints(
+      const std::vector<boost::optional<Waypoint>> &waypoints) const {
+    return ExportWaypointsImpl(*this, waypoints.size(), [&](size_t i) {
+      return waypoints[i].get_ptr();
+    });
+  }
+
   std::vector<Waypoint> Map::GenerateWaypointsOnRoadEntries(Lane::LaneType lane_type) const {
     std::vector<Waypoint> result;
     for (const auto &pair : _data.GetRoads()) {
@@ -896,93 +1039,190 @@ namespace road {
       });
     }
 
-    // Container of segments and waypoints
-    std::vector<Rtree::TreeElement> rtree_elements;
-    // Loop through all lanes
-    for (auto &waypoint : topology) {
-      auto &lane_start_waypoint = waypoint;
-
-      auto current_waypoint = lane_start_waypoint;
+    // Lanes are independent of each other, so each chunk of lanes fills its
+    // own container of segments and waypoints. Chunks are concatenated in
+    // order afterwards.
+    const size_t chunk_count = ParallelChunkCount(topology.size(), 64u);
+    std::vector<std::vector<Rtree::TreeElement>> chunk_elements(chunk_count);
+    ParallelFor(topology.size(), chunk_count, [&](size_t chunk, size_t begin, size_t end) {
+      auto &rtree_elements = chunk_elements[chunk];
+      // Loop through the lanes of this chunk
+      for (size_t i = begin; i < end; ++i) {
+        auto &waypoint = topology[i];
+        auto &lane_start_waypoint = waypoint;
 
-      const Lane &lane = GetLane(current_waypoint);
+        auto current_waypoint = lane_start_waypoint;
 
-      geom::Transform current_transform = ComputeTransform(current_waypoint);
+        const Lane &lane = GetLane(current_waypoint);
 
-      // Save computation time in straight lines
-      if (lane.IsStraight()) {
-        double delta_s = min_delta_s;
-        double remaining_length =
-            GetRemainingLength(lane, current_waypoint.s);
-        remaining_length -= epsilon;
-        delta_s = remaining_length;
-        if (delta_s < epsilon) {
-          continue;
-        }
-        auto next = GetNext(current_waypoint, delta_s);
-
-        RELEASE_ASSERT(next.size() == 1);
-        RELEASE_ASSERT(next.front().road_id == current_waypoint.road_id);
-        auto next_waypoint = next.front();
-
-        AddElementToRtreeAndUpdateTransforms(
-            rtree_elements,
-            current_transform,
-            current_waypoint,
-            next_waypoint);
-        // end of lane
-      } else {
-        auto next_waypoint = current_waypoint;
+        geom::Transform current_transform = ComputeTransform(current_waypoint);
 
-        // Loop until the end of the lane
-        // Advance in small s-increments
-        while (true) {
+        // Save computation time in straight lines
+        if (lane.IsStraight()) {
           double delta_s = min_delta_s;
           double remaining_length =
-              GetRemainingLength(lane, next_waypoint.s);
+              GetRemainingLength(lane, current_waypoint.s);
           remaining_length -= epsilon;
-          delta_s = std::min(delta_s, remaining_length);
-
+          delta_s = remaining_length;
           if (delta_s < epsilon) {
-            AddElementToRtreeAndUpdateTransforms(
-                rtree_elements,
-                current_transform,
-                current_waypoint,
-                next_waypoint);
-            break;
+            continue;
           }
+          auto next = GetNext(current_waypoint, delta_s);
+
+          RELEASE_ASSERT(next.size() == 1);
+          RELEASE_ASSERT(next.front().road_id == current_waypoint.road_id);
+          auto next_waypoint = next.front();
+
+          AddElementToRtreeAndUpdateTransforms(
+              rtree_elements,
+              current_transform,
+              current_waypoint,
+              next_waypoint);
+          // end of lane
+        } else {
+          auto next_waypoint = current_waypoint;
+
+          // Loop until the end of the lane
+          // Advance in small s-increments
+          while (true) {
+            double delta_s = min_delta_s;
+            double remaining_length =
+                GetRemainingLength(lane, next_waypoint.s);
+            remaining_length -= epsilon;
+            delta_s = std::min(delta_s, remaining_length);
+
+            if (delta_s < epsilon) {
+              AddElementToRtreeAndUpdateTransforms(
+                  rtree_elements,
+                  current_transform,
+                  current_waypoint,
+                  next_waypoint);
+              break;
+            }
+
+            auto next = GetNext(next_waypoint, delta_s);
+            if (next.size() != 1 ||
+            current_waypoint.section_id != next.front().section_id) {
+              AddElementToRtreeAndUpdateTransforms(
+                  rtree_elements,
+                  current_transform,
+                  current_waypoint,
+                  next_waypoint);
+              break;
+            }
 
-          auto next = GetNext(next_waypoint, delta_s);
-          if (next.size() != 1 ||
-          current_waypoint.section_id != next.front().section_id) {
-            AddElementToRtreeAndUpdateTransforms(
-                rtree_elements,
-                current_transform,
-                current_waypoint,
-                next_waypoint);
-            break;
+            next_waypoint = next.front();
+            geom::Transform next_transform = ComputeTransform(next_waypoint);
+            double angle = geom::Math::GetVectorAngle(
+                current_transform.GetForwardVector(), next_transform.GetForwardVector());
+
+            if (std::abs(angle) > angle_threshold ||
+                std::abs(current_waypoint.s - next_waypoint.s) > max_segment_length) {
+              AddElementToRtree(
+                  rtree_elements,
+                  current_transform,
+                  next_transform,
+                  current_waypoint,
+                  next_waypoint);
+              current_waypoint = next_waypoint;
+              current_transform = next_transform;
+            }
           }
+        }
+      }
+    });
 
-          next_waypoint = next.front();
-          geom::Transform next_transform = ComputeTransform(next_waypoint);
-          double angle = geom::Math::GetVectorAngle(
-              current_transform.GetForwardVector(), next_transform.GetForwardVector());
-
-          if (std::abs(angle) > angle_threshold ||
-              std::abs(current_waypoint.s - next_waypoint.s) > max_segment_length) {
-            AddElementToRtree(
-                rtree_elements,
-                current_transform,
-                next_transform,
-                current_waypoint,
-                next_waypoint);
-            current_waypoint = next_waypoint;
-            current_transform = next_transform;
+    size_t total_elements = 0u;
+    for (auto &elements : chunk_elements) {
+      total_elements += elements.size();
+    }
+    std::vector<Rtree::TreeElement> rtree_elements;
+    rtree_elements.reserve(total_elements);
+    for (auto &elements : chunk_elements) {
+      rtree_elements.insert(rtree_elements.end(), elements.begin(), elements.end());
+    }
+    // Build the Rtree from all the segments at once (bulk loading)
+    _rtree.BulkLoadElements(rtree_elements);
+  }
+
+  void Map::CreateSignalIndex() {
+    _lane_signals.clear();
+    _signal_references.clear();
+    std::vector<Waypoint> lane_starts;
+    for (const auto &road_pair : _data.GetRoads()) {
+      const auto &road = road_pair.second;
+      // Sorted by s.
+      const auto signals = road.GetInfos<RoadInfoSignal>();
+      _signal_references.insert(_signal_references.end(), signals.begin(), signals.end());
+      for (const auto &lane_section : road.GetLaneSections()) {
+        for (const auto &lane_pair : lane_section.GetLanes()) {
+          const auto &lane = lane_pair.second;
+          if (lane.GetId() == 0) {
+            continue;
+          }
+          lane_starts.push_back(Waypoint{
+              road.GetId(), lane_section.GetId(), lane.GetId(), lane.GetDistance()});
+          const double start_s = lane.GetDistance();
+          const double end_s = start_s + lane.GetLength();
+          std::vector<const RoadInfoSignal *> lane_signals;
+          for (const auto *signal : signals) {
+            const double s = signal->GetDistance();
+            if (s < start_s - SIGNAL_INDEX_TOLERANCE || s > end_s + SIGNAL_INDEX_TOLERANCE) {
+              continue;
+            }
+            for (const auto &validity : signal->GetValidities()) {
+              if (lane.GetId() >= validity._from_lane && lane.GetId() <= validity._to_lane) {
+                lane_signals.push_back(signal);
+                break;
+              }
+            }
           }
+          if (!lane_signals.empty()) {
+            const bool forward = (lane.GetId() <= 0);
+            auto &entry = _lane_signals[&lane];
+            entry.distance_to_next_signal = std::max(0.0, forward ?
+                lane_signals.front()->GetDistance() - start_s :
+                end_s - lane_signals.back()->GetDistance());
+            entry.signals = std::move(lane_signals);
+          }
+        }
+      }
+    }
+
+    // Propagate the distance to the next signal backwards through the lane
+    // graph, as GetSignalsInDistance walks it (Dijkstra from every lane with
+    // signals).
+    std::unordered_map<const Lane *, std::vector<const Lane *>> predecessors;
+    for (const auto &waypoint : lane_starts) {
+      const auto *lane = &GetLane(waypoint);
+      for (const auto &successor : GetSuccessorsAtLaneStart(waypoint)) {
+        predecessors[&GetLane(successor)].push_back(lane);
+      }
+    }
+    using Item = std::pair<double, const Lane *>;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+    for (const auto &pair : _lane_signals) {
+      queue.emplace(pair.second.distance_to_next_signal, pair.first);
+    }
+    while (!queue.empty()) {
+      const auto item = queue.top();
+      queue.pop();
+      if (item.first > _lane_signals[item.second].distance_to_next_signal) {
+        continue;
+      }
+      const auto it = predecessors.find(item.second);
+      if (it == predecessors.end()) {
+        continue;
+      }
+      for (const auto *predecessor : it->second) {
+        const double distance = predecessor->GetLength() + item.first;
+        auto &entry = _lane_signals[predecessor];
+        if (distance < entry.distance_to_next_signal) {
+          entry.distance_to_next_signal = distance;
+          queue.emplace(distance, predecessor);
         }
       }
     }
-    // Add segments to Rtree
-    _rtree.InsertElements(rtree_elements);
   }
 
   Junction* Map::GetJunction(JuncId id) {
@@ -999,101 +1239,46 @@ namespace road {
       const  bool smooth_junctions) const {
     RELEASE_ASSERT(distance > 0.0);
     geom::MeshFactory mesh_factory;
-    geom::Mesh out_mesh;
 
     mesh_factory.road_param.resolution = static_cast<float>(distance);
     mesh_factory.road_param.extra_lane_width = extra_width;
 
-    // Generate roads outside junctions
-    for (auto &&pair : _data.GetRoads()) {
-      const auto &road = pair.second;
-      if (road.IsJunction()) {
-        continue;
-      }
-      out_mesh += *mesh_factory.Generate(road);
-    }
-
-    // Generate roads within junctions and smooth them
-    for (const auto &junc_pair : _data.GetJunctions()) {
-      const auto &junction = junc_pair.second;
-      std::vector<std::unique_ptr<geom::Mesh>> lane_meshes;
-      for(const auto &connection_pair : junction.GetConnections()) {
-        const auto &connection = connection_pair.second;
-        const auto &road = _data.GetRoads().at(connection.connecting_road);
-        for (auto &&lane_section : road.GetLaneSections()) {
-          for (auto &&lane_pair : lane_section.GetLanes()) {
-            lane_meshes.push_back(mesh_factory.Generate(lane_pair.second));
-          }
-        }
-      }
-      if(smooth_junctions) {
-        out_mesh += *mesh_factory.MergeAndSmooth(lane_meshes);
-      } else {
-        geom::Mesh junction_mesh;
-        for(auto& lane : lane_meshes) {
-          junction_mesh += *lane;
-        }
-        out_mesh += junction_mesh;
-      }
-    }
+    // Generate roads outside junctions and smooth the junctions in parallel,
+    // then merge them in order so the result does not depend on scheduling.
+    const auto pieces = GetMeshPieces(_data);
+    std::vector<std::unique_ptr<geom::Mesh>> piece_meshes(pieces.size());
+    ParallelForEachIndex(pieces.size(), [&](size_t i) {
+      const auto &piece = pieces[i];
+      piece_meshes[i] = piece.road != nullptr ?
+          mesh_factory.Generate(*piece.road) :
+          GenerateJunctionMesh(_data, mesh_factory, *piece.junction, smooth_junctions, false);
+    });
 
+    geom::Mesh out_mesh;
+    AppendMeshes(out_mesh, piece_meshes);
     return out_mesh;
   }
 
   std::vector<std::unique_ptr<geom::Mesh>> Map::GenerateChunkedMesh(
       const rpc::OpendriveGenerationParameters& params) const {
     geom::MeshFactory mesh_factory(params);
-    std::vector<std::unique_ptr<geom::Mesh>> out_mesh_list;
 
-    std::unordered_map<JuncId, geom::Mesh> junction_map;
-    for (auto &&pair : _data.GetRoads()) {
-      const auto &road = pair.second;
-      if (!road.IsJunction()) {
-        std::vector<std::unique_ptr<geom::Mesh>> road_mesh_list =
-            mesh_factory.GenerateAllWithMaxLen(road);
-
-        out_mesh_list.insert(
-            out_mesh_list.end(),
-            std::make_move_iterator(road_mesh_list.begin()),
-            std::make_move_iterator(road_mesh_list.end()));
-      }
-    }
+    const auto pieces = GetMeshPieces(_data);
+    std::vector<std::vector<std::unique_ptr<geom::Mesh>>> piece_meshes(pieces.size());
+    ParallelForEachIndex(pieces.size(), [&](size_t i) {
+      piece_meshes[i] = GenerateChunkedMeshPiece(
+          _data, mesh_factory, pieces[i], params.smooth_junctions);
+    });
 
-    // Generate roads within junctions and smooth them
-    for (const auto &junc_pair : _data.GetJunctions()) {
-      const auto &junction = junc_pair.second;
-      std::vector<std::unique_ptr<geom::Mesh>> lane_meshes;
-      std::vector<std::unique_ptr<geom::Mesh>> sidewalk_lane_meshes;
-      for(const auto &connection_pair : junction.GetConnections()) {
-        const auto &connection = connection_pair.second;
-        const auto &road = _data.GetRoads().at(connection.connecting_road);
-        for (auto &&lane_section : road.GetLaneSections()) {
-          for (auto &&lane_pair : lane_section.GetLanes()) {
-            const auto &lane = lane_pair.second;
-            if (lane.GetType() != road::Lane::LaneType::Sidewalk) {
-              lane_meshes.push_back(mesh_factory.Generate(lane));
-            } else {
-              sidewalk_lane_meshes.push_back(mesh_factory.Generate(lane));
-            }
-          }
-        }
-      }
-      if(params.smooth_junctions) {
-        auto merged_mesh = mesh_factory.MergeAndSmooth(lane_meshes);
-        for(auto& lane : sidewalk_lane_meshes) {
-          *merged_mesh += *lane;
-        }
-        out_mesh_list.push_back(std::move(merged_mesh));
-      } else {
-        std::unique_ptr<geom::Mesh> junction_mesh = std::make_unique<geom::Mesh>();
-        for(auto& lane : lane_meshes) {
-          *junction_mesh += *lane;
-        }
-        for(auto& lane : sidewalk_lane_meshes) {
-          *junction_mesh += *lane;
-        }
-        out_mesh_list.push_back(std::move(junction_mesh));
-      }
+    std::vector<std::unique_ptr<geom::Mesh>> out_mesh_list;
+    for (auto &meshes : piece_meshes) {
+      out_mesh_list.insert(
+          out_mesh_list.end(),
+          std::make_move_iterator(meshes.begin()),
+          std::make_move_iterator(meshes.end()));
+    }
+    if (out_mesh_list.empty()) {
+      return out_mesh_list;
     }
 
     auto min_pos = geom::Vector2D(
@@ -1109,21 +1294,42 @@ namespace road {
     }
     size_t mesh_amount_x = static_cast<size_t>((max_pos.x - min_pos.x)/params.max_road_length) + 1;
     size_t mesh_amount_y = static_cast<size_t>((max_pos.y - min_pos.y)/params.max_road_length) + 1;
-    std::vector<std::unique_ptr<geom::Mesh>> result;
-    result.reserve(mesh_amount_x*mesh_amount_y);
-    for (size_t i = 0; i < mesh_amount_x*mesh_amount_y; ++i) {
-      result.emplace_back(std::make_unique<geom::Mesh>());
-    }
+
+    // Group the pieces by cell, then merge each cell in parallel.
+    std::vector<std::vector<std::unique_ptr<geom::Mesh>>> cell_meshes(mesh_amount_x*mesh_amount_y);
     for (auto & mesh : out_mesh_list) {
       auto vertex = mesh->GetVertices().front();
       size_t x_pos = static_cast<size_t>((vertex.x - min_pos.x) / params.max_road_length);
       size_t y_pos = static_cast<size_t>((vertex.y - min_pos.y) / params.max_road_length);
-      *(result[x_pos + mesh_amount_x*y_pos]) += *mesh;
+      cell_meshes[x_pos + mesh_amount_x*y_pos].push_back(std::move(mesh));
     }
+    std::vector<std::unique_ptr<geom::Mesh>> result(cell_meshes.size());
+    ParallelForChunks(cell_meshes.size(), 16u, [&](size_t, size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        result[i] = std::make_unique<geom::Mesh>();
+        AppendMeshes(*result[i], cell_meshes[i]);
+      }
+    });
 
     return result;
   }
 
+  void Map::StreamChunkedMesh(
+      const rpc::OpendriveGenerationParameters& params,
+      const MeshCallback &callback) const {
+    geom::MeshFactory mesh_factory(params);
+    const auto pieces = GetMeshPieces(_data);
+    std::mutex callback_mutex;
+    ParallelForEachIndex(pieces.size(), [&](size_t i) {
+      auto meshes = GenerateChunkedMeshPiece(
+          _data, mesh_factory, pieces[i], params.smooth_junctions);
+      std::lock_guard<std::mutex> lock(callback_mutex);
+      for (auto &mesh : meshes) {
+        callback(std::move(mesh));
+      }
+    });
+  }
+
   geom::Mesh Map::GetAllCrosswalkMesh() const {
     geom::Mesh out_mesh;
 
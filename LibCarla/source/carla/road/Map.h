@@ -13,12 +13,17 @@
 #include "carla/road/element/LaneMarking.h"
 #include "carla/road/element/RoadInfoMarkRecord.h"
 #include "carla/road/element/Waypoint.h"
+#include "carla/road/element/WaypointColumns.h"
 #include "carla/road/MapData.h"
 #include "carla/road/RoadTypes.h"
 #include "carla/rpc/OpendriveGenerationParameters.h"
 
 #include <boost/optional.hpp>
 
+#include <functional>
+#include <limits>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 namespace carla {
@@ -35,6 +40,7 @@ namespace road {
 
     Map(MapData m) : _data(std::move(m)) {
       CreateRtree();
+      CreateSignalIndex();
     }
 
     /// ========================================================================
@@ -130,6 +136,14 @@ namespace road {
     /// Generate all the waypoints in @a map separated by @a approx_distance.
     std::vector<Waypoint> GenerateWaypoints(double approx_distance) const;
 
+    /// Export @a waypoints column by column, computing their transforms and
+    /// lane widths in parallel.
+    element::WaypointColumns ExportWaypoints(const std::vector<Waypoint> &waypoints) const;
+
+    /// Same as above, the rows of the missing waypoints are left zero.
+    element::WaypointColumns ExportWaypoints(
+        const std::vector<boost::optional<Waypoint>> &waypoints) const;
+
     /// Generate waypoints on each @a lane at the start of each @a road
     std::vector<Waypoint> GenerateWaypointsOnRoadEntries(Lane::LaneType lane_type = Lane::LaneType::Driving) const;
 
@@ -159,6 +173,18 @@ namespace road {
     std::vector<std::unique_ptr<geom::Mesh>> GenerateChunkedMesh(
         const rpc::OpendriveGenerationParameters& params) const;
 
+    /// Receives each piece of a road mesh as soon as it is built.
+    using MeshCallback = std::function<void(std::unique_ptr<geom::Mesh>)>;
+
+    /// Builds the pieces merged by GenerateChunkedMesh, the chunks of each
+    /// road and the mesh of each junction, in parallel and hands each of them
+    /// to @a callback as soon as it is ready, without keeping the whole mesh
+    /// in memory. Calls to @a callback are serialized, but they are made from
+    /// worker threads and in no particular order.
+    void StreamChunkedMesh(
+        const rpc::OpendriveGenerationParameters& params,
+        const MeshCallback &callback) const;
+
     /// Buids a mesh of all crosswalks based on the OpenDRIVE
     geom::Mesh GetAllCrosswalkMesh() const;
 
@@ -188,6 +214,32 @@ private:
 
     void CreateRtree();
 
+    /// Signals that affect a lane, sorted by s, and a lower bound of the
+    /// distance from the start of the lane, in its driving direction, to the
+    /// first signal reachable from it.
+    struct LaneSignals {
+      std::vector<const element::RoadInfoSignal *> signals;
+      double distance_to_next_signal = std::numeric_limits<double>::max();
+    };
+
+    /// Only lanes from which a signal can be reached have an entry.
+    std::unordered_map<const Lane *, LaneSignals> _lane_signals;
+
+    std::vector<const element::RoadInfoSignal *> _signal_references;
+
+    void CreateSignalIndex();
+
+    /// Successors of @a waypoint placed at the start of their lane, as
+    /// GetSignalsInDistance walks them.
+    std::vector<Waypoint> GetSuccessorsAtLaneStart(Waypoint waypoint) const;
+
+    void AddSignalsInDistance(
+        Waypoint waypoint,
+        double distance,
+        double accumulated_s,
+        bool stop_at_junction,
+        std::vector<SignalSearchData> &result) const;
+
     /// Helper Functions for constructing the rtree element list
     void AddElementToRtree(
         std::vector<Rtree::TreeElement> &rtree_elements,
@@ -4,6 +4,7 @@
 // This work is licensed under the terms of the MIT license.
 // For a copy, see <https://opensource.org/licenses/MIT>.
 
+#include "carla/ParallelFor.h"
 #include "carla/StringUtil.h"
 #include "carla/road/MapBuilder.h"
 #include "carla/road/element/RoadInfoElevation.h"
@@ -597,14 +598,45 @@ namespace road {
       const RoadId road_id,
       const LaneId lane_id,
       const double s) {
+    if (_parent != nullptr) {
+      return _parent->GetLane(road_id, lane_id, s);
+    }
     return &_map_data.GetRoad(road_id).GetLaneByDistance(s, lane_id);
   }
 
   Road *MapBuilder::GetRoad(
       const RoadId road_id) {
+    if (_parent != nullptr) {
+      return _parent->GetRoad(road_id);
+    }
     return &_map_data.GetRoad(road_id);
   }
 
+  MapBuilder MapBuilder::CreateWorker() {
+    DEBUG_ASSERT(_parent == nullptr);
+    MapBuilder worker;
+    worker._parent = this;
+    return worker;
+  }
+
+  void MapBuilder::Merge(MapBuilder &&worker) {
+    DEBUG_ASSERT(worker._parent == this);
+    DEBUG_ASSERT(worker._temp_signal_container.empty());
+    DEBUG_ASSERT(worker._temp_signal_reference_container.empty());
+    for (auto &&info : worker._temp_road_info_container) {
+      auto &infos = _temp_road_info_container[info.first];
+      infos.reserve(infos.size() + info.second.size());
+      std::move(info.second.begin(), info.second.end(), std::back_inserter(infos));
+    }
+    for (auto &&info : worker._temp_lane_info_container) {
+      auto &infos = _temp_lane_info_container[info.first];
+      infos.reserve(infos.size() + info.second.size());
+      std::move(info.second.begin(), info.second.end(), std::back_inserter(infos));
+    }
+    worker._temp_road_info_container.clear();
+    worker._temp_lane_info_container.clear();
+  }
+
   // return the pointer to a lane object
   Lane *MapBuilder::GetEdgeLanePointer(RoadId road_id, bool from_start, LaneId lane_id) {
 
@@ -836,71 +868,82 @@ namespace road {
   }
 
   void MapBuilder::CreateJunctionBoundingBoxes(Map &map) {
+    std::vector<Junction *> junctions;
+    junctions.reserve(map._data.GetJunctions().size());
     for (auto &junctionpair : map._data.GetJunctions()) {
-      auto* junction = map.GetJunction(junctionpair.first);
-      auto waypoints = map.GetJunctionWaypoints(junction->GetId(), Lane::LaneType::Any);
-      const int number_intervals = 10;
-
-      float minx = std::numeric_limits<float>::max();
-      float miny = std::numeric_limits<float>::max();
-      float minz = std::numeric_limits<float>::max();
-      float maxx = -std::numeric_limits<float>::max();
-      float maxy = -std::numeric_limits<float>::max();
-      float maxz = -std::numeric_limits<float>::max();
-
-      auto get_min_max = [&](geom::Location position) {
-        if (position.x < minx) {
-          minx = position.x;
-        }
-        if (position.y < miny) {
-          miny = position.y;
-        }
-        if (position.z < minz) {
-          minz = position.z;
-        }
+      junctions.emplace_back(&junctionpair.second);
+    }
+    // Each junction only reads the map and writes its own bounding box.
+    ParallelForChunks(junctions.size(), 8u, [&](size_t, size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        CreateJunctionBoundingBox(map, junctions[i]);
+      }
+    });
+  }
 
-        if (position.x > maxx) {
-          maxx = position.x;
-        }
-        if (position.y > maxy) {
-          maxy = position.y;
-        }
-        if (position.z > maxz) {
-          maxz = position.z;
-        }
-      };
+  void MapBuilder::CreateJunctionBoundingBox(const Map &map, Junction *junction) {
+    auto waypoints = map.GetJunctionWaypoints(junction->GetId(), Lane::LaneType::Any);
+    const int number_intervals = 10;
 
-      for (auto &waypoint_p : waypoints) {
-        auto &waypoint_start = waypoint_p.first;
-        auto &waypoint_end = waypoint_p.second;
-        double interval = (waypoint_end.s - waypoint_start.s) / static_cast<double>(number_intervals);
-        auto next_wp = waypoint_end;
-        auto location = map.ComputeTransform(next_wp).location;
+    float minx = std::numeric_limits<float>::max();
+    float miny = std::numeric_limits<float>::max();
+    float minz = std::numeric_limits<float>::max();
+    float maxx = -std::numeric_limits<float>::max();
+    float maxy = -std::numeric_limits<float>::max();
+    float maxz = -std::numeric_limits<float>::max();
 
-        get_min_max(location);
+    auto get_min_max = [&](geom::Location position) {
+      if (position.x < minx) {
+        minx = position.x;
+      }
+      if (position.y < miny) {
+        miny = position.y;
+      }
+      if (position.z < minz) {
+        minz = position.z;
+      }
 
-        next_wp = waypoint_start;
-        location = map.ComputeTransform(next_wp).location;
+      if (position.x > maxx) {
+        maxx = position.x;
+      }
+      if (position.y > maxy) {
+        maxy = position.y;
+      }
+      if (position.z > maxz) {
+        maxz = position.z;
+      }
+    };
 
-        get_min_max(location);
+    for (auto &waypoint_p : waypoints) {
+      auto &waypoint_start = waypoint_p.first;
+      auto &waypoint_end = waypoint_p.second;
+      double interval = (waypoint_end.s - waypoint_start.s) / static_cast<double>(number_intervals);
+      auto next_wp = waypoint_end;
+      auto location = map.ComputeTransform(next_wp).location;
 
-        for (int i = 0; i < number_intervals; ++i) {
-          if (interval < std::numeric_limits<double>::epsilon())
-            break;
-          auto next = map.GetNext(next_wp, interval);
-          if(next.size()){
-            next_wp = next.back();
-          }
+      get_min_max(location);
 
-          location = map.ComputeTransform(next_wp).location;
-          get_min_max(location);
+      next_wp = waypoint_start;
+      location = map.ComputeTransform(next_wp).location;
+
+      get_min_max(location);
+
+      for (int i = 0; i < number_intervals; ++i) {
+        if (interval < std::numeric_limits<double>::epsilon())
+          break;
+        auto next = map.GetNext(next_wp, interval);
+        if(next.size()){
+          next_wp = next.back();
         }
-      }
-      carla::geom::Location location(0.5f * (maxx + minx), 0.5f * (maxy + miny), 0.5f * (maxz + minz));
-      carla::geom::Vector3D extent(0.5f * (maxx - minx), 0.5f * (maxy - miny), 0.5f * (maxz - minz));
 
-      junction->_bounding_box = carla::geom::BoundingBox(location, extent);
+        location = map.ComputeTransform(next_wp).location;
+        get_min_max(location);
+      }
     }
+    carla::geom::Location location(0.5f * (maxx + minx), 0.5f * (maxy + miny), 0.5f * (maxz + minz));
+    carla::geom::Vector3D extent(0.5f * (maxx - minx), 0.5f * (maxy - miny), 0.5f * (maxz - minz));
+
+    junction->_bounding_box = carla::geom::BoundingBox(location, extent);
   }
 
 void MapBuilder::CreateController(
@@ -932,10 +975,16 @@ void MapBuilder::CreateController(
 }
 
   void MapBuilder::ComputeJunctionRoadConflicts(Map &map) {
+    std::vector<Junction *> junctions;
+    junctions.reserve(map._data.GetJunctions().size());
     for (auto &junctionpair : map._data.GetJunctions()) {
-      auto& junction = junctionpair.second;
-      junction._road_conflicts = (map.ComputeJunctionConflicts(junction.GetId()));
+      junctions.emplace_back(&junctionpair.second);
     }
+    ParallelForChunks(junctions.size(), 8u, [&](size_t, size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        junctions[i]->_road_conflicts = map.ComputeJunctionConflicts(junctions[i]->GetId());
+      }
+    });
   }
 
   void MapBuilder::GenerateDefaultValiditiesForSignalReferences() {
@@ -22,6 +22,17 @@ namespace road {
 
     boost::optional<Map> Build();
 
+    /// Create a worker builder that looks up roads and lanes in this builder
+    /// but stores the road and lane infos it creates on its own. This allows
+    /// parsing different roads concurrently, one worker per thread. The
+    /// worker must not outlive this builder.
+    MapBuilder CreateWorker();
+
+    /// Move the road and lane infos created by @a worker into this builder.
+    /// Workers must be merged in the same order their roads appear in the
+    /// OpenDRIVE file to produce the same map as a serial parse.
+    void Merge(MapBuilder &&worker);
+
     // called from road parser
     carla::road::Road *AddRoad(
         const RoadId road_id,
@@ -366,12 +377,18 @@ namespace road {
 
     MapData _map_data;
 
+    /// Builder owning the map data, if this is a worker builder.
+    MapBuilder *_parent = nullptr;
+
     /// Create the pointers between RoadSegments based on the ids.
     void CreatePointersBetweenRoadSegments();
 
     /// Create the bounding boxes of each junction
     void CreateJunctionBoundingBoxes(Map &map);
 
+    /// Create the bounding box of a single junction
+    void CreateJunctionBoundingBox(const Map &map, Junction *junction);
+
     geom::Transform ComputeSignalTransform(std::unique_ptr<Signal> &signal,  MapData &data);
 
     /// Solves the signal references in the road
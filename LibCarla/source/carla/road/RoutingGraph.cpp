@@ -0,0 +1,782 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/road/RoutingGraph.h"
+
+#include "carla/ParallelFor.h"
+#include "carla/geom/Math.h"
+#include "carla/road/Map.h"
+#include "carla/road/element/RoadInfoMarkRecord.h"
+
+#include <boost/container_hash/hash.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <tuple>
+#include <utility>
+
+namespace carla {
+namespace road {
+
+  using element::LaneMarking;
+
+  static constexpr double INFINITE_COST = std::numeric_limits<double>::infinity();
+
+  static constexpr uint32_t INVALID_NODE = std::numeric_limits<uint32_t>::max();
+
+  /// Nodes settled by a witness search before giving up and adding the
+  /// shortcut anyway. A missing witness only adds a redundant shortcut.
+  static constexpr size_t MAX_WITNESS_SEARCH_SIZE = 500u;
+
+  // ===========================================================================
+  // -- Static local methods ---------------------------------------------------
+  // ===========================================================================
+
+  static uint8_t SwapLeftAndRight(uint8_t lane_change) {
+    const auto right = static_cast<uint8_t>(LaneMarking::LaneChange::Right);
+    const auto left = static_cast<uint8_t>(LaneMarking::LaneChange::Left);
+    return static_cast<uint8_t>(
+        ((lane_change & right) != 0u ? left : 0u) |
+        ((lane_change & left) != 0u ? right : 0u));
+  }
+
+  /// Lane changes allowed by the markings at @a waypoint, same as
+  /// client::Waypoint::GetLaneChange.
+  static uint8_t GetLaneChange(const Map &map, const element::Waypoint &waypoint) {
+    const auto both = static_cast<uint8_t>(LaneMarking::LaneChange::Both);
+    const auto mark_record = map.GetMarkRecord(waypoint);
+    uint8_t right = mark_record.first != nullptr ?
+        static_cast<uint8_t>(mark_record.first->GetLaneChange()) : both;
+    uint8_t left = mark_record.second != nullptr ?
+        static_cast<uint8_t>(mark_record.second->GetLaneChange()) : both;
+    if (waypoint.lane_id > 0) {
+      right = SwapLeftAndRight(right);
+    }
+    if (((waypoint.lane_id > 0) ? waypoint.lane_id - 1 : waypoint.lane_id + 1) > 0) {
+      left = SwapLeftAndRight(left);
+    }
+    return static_cast<uint8_t>(
+        (right & static_cast<uint8_t>(LaneMarking::LaneChange::Right)) |
+        (left & static_cast<uint8_t>(LaneMarking::LaneChange::Left)));
+  }
+
+  // ===========================================================================
+  // -- SearchSpace ------------------------------------------------------------
+  // ===========================================================================
+
+  /// State of a Dijkstra search, reusable between searches without clearing
+  /// the arrays.
+  class RoutingGraph::SearchSpace {
+  public:
+
+    explicit SearchSpace(size_t size)
+      : cost(size, INFINITE_COST),
+        parent(size, INVALID_NODE) {}
+
+    void Reset() {
+      for (auto node : touched) {
+        cost[node] = INFINITE_COST;
+        parent[node] = INVALID_NODE;
+      }
+      touched.clear();
+      settled.clear();
+      queue = Queue{};
+    }
+
+    void Relax(NodeId node, double new_cost, NodeId new_parent) {
+      if (new_cost < cost[node]) {
+        if (cost[node] == INFINITE_COST) {
+          touched.emplace_back(node);
+        }
+        cost[node] = new_cost;
+        parent[node] = new_parent;
+        queue.emplace(new_cost, node);
+      }
+    }
+
+    /// Pops the next node to settle, false if there is none left.
+    bool Pop(NodeId &node) {
+      while (!queue.empty()) {
+        const auto top = queue.top();
+        queue.pop();
+        if (top.first <= cost[top.second]) {
+          node = top.second;
+          settled.emplace_back(node);
+          return true;
+        }
+      }
+      return false;
+    }
+
+    using QueueEntry = std::pair<double, NodeId>;
+
+    using Queue = std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>>;
+
+    std::vector<double> cost;
+
+    std::vector<NodeId> parent;
+
+    std::vector<NodeId> touched;
+
+    /// Nodes in the order they were settled.
+    std::vector<NodeId> settled;
+
+    Queue queue;
+  };
+
+  // ===========================================================================
+  // -- RoutingGraph -----------------------------------------------------------
+  // ===========================================================================
+
+  size_t RoutingGraph::LaneKeyHash::operator()(const LaneKey &key) const {
+    size_t seed = 0u;
+    boost::hash_combine(seed, key.road_id);
+    boost::hash_combine(seed, key.section_id);
+    boost::hash_combine(seed, key.lane_id);
+    return seed;
+  }
+
+  RoutingGraph::RoutingGraph(const Map &map)
+    : RoutingGraph(map, Parameters{}) {}
+
+  RoutingGraph::RoutingGraph(const Map &map, Parameters parameters)
+    : _parameters(parameters) {
+    CreateNodes(map);
+    CreateEdges(map);
+    Contract();
+  }
+
+  void RoutingGraph::CreateNodes(const Map &map) {
+    std::vector<Waypoint> lanes;
+    for (const auto &pair : map.GenerateTopology()) {
+      lanes.emplace_back(pair.first);
+    }
+    // Same ids regardless of the order of the roads in the map.
+    const auto as_tuple = [](const Waypoint &waypoint) {
+      return std::make_tuple(waypoint.road_id, waypoint.section_id, waypoint.lane_id);
+    };
+    std::sort(lanes.begin(), lanes.end(), [&](const Waypoint &lhs, const Waypoint &rhs) {
+      return as_tuple(lhs) < as_tuple(rhs);
+    });
+    lanes.erase(std::unique(lanes.begin(), lanes.end(), [&](const Waypoint &lhs, const Waypoint &rhs) {
+      return as_tuple(lhs) == as_tuple(rhs);
+    }), lanes.end());
+
+    _nodes.reserve(lanes.size());
+    _node_ids.reserve(lanes.size());
+    for (const auto &waypoint : lanes) {
+      const auto &lane = map.GetLane(waypoint);
+      _node_ids.emplace(
+          LaneKey{waypoint.road_id, waypoint.section_id, waypoint.lane_id},
+          static_cast<NodeId>(_nodes.size()));
+      _nodes.emplace_back(Node{
+          waypoint.road_id,
+          waypoint.section_id,
+          waypoint.lane_id,
+          waypoint.s,
+          lane.GetDistance(),
+          lane.GetLength()});
+    }
+  }
+
+  void RoutingGraph::CreateEdges(const Map &map) {
+    const size_t size = _nodes.size();
+
+    // Turn cost of each junction lane, by the change of heading between its
+    // ends.
+    std::vector<double> turn_costs(size, 0.0);
+    for (NodeId node = 0u; node < size; ++node) {
+      const auto &info = _nodes[node];
+      if (!map.IsJunction(info.road_id)) {
+        continue;
+      }
+      // The lane end mirrors the lane start in the section.
+      auto end = MakeWaypoint(node);
+      end.s = 2.0 * info.begin_s + info.length - info.start_s;
+      const auto start_yaw = map.ComputeTransform(MakeWaypoint(node)).rotation.yaw;
+      const auto end_yaw = map.ComputeTransform(end).rotation.yaw;
+      double angle = std::fmod(std::abs(end_yaw - start_yaw), 360.0);
+      angle = angle > 180.0 ? 360.0 - angle : angle;
+      turn_costs[node] = _parameters.turn_cost * geom::Math::ToRadians(angle);
+    }
+
+    _successors.resize(size);
+    _lane_changes.resize(size);
+    const auto add_edge = [](std::vector<Edge> &edges, NodeId to, double cost) {
+      for (auto &edge : edges) {
+        if (edge.to == to) {
+          edge.cost = std::min(edge.cost, cost);
+          return;
+        }
+      }
+      edges.emplace_back(Edge{to, cost});
+    };
+
+    for (NodeId node = 0u; node < size; ++node) {
+      const auto &info = _nodes[node];
+      NodeId next;
+      for (const auto &successor : map.GetSuccessors(MakeWaypoint(node))) {
+        if (FindNode(successor, next)) {
+          add_edge(_successors[node], next, info.length + turn_costs[next]);
+        }
+      }
+      if (_parameters.lane_change_cost < 0.0) {
+        continue;
+      }
+      // Lane changes allowed by the markings in the middle of the lane.
+      auto middle = MakeWaypoint(node);
+      middle.s = info.begin_s + 0.5 * info.length;
+      const auto lane_change = GetLaneChange(map, middle);
+      const auto add_lane_change = [&](LaneMarking::LaneChange side, boost::optional<Waypoint> neighbour) {
+        if (((lane_change & static_cast<uint8_t>(side)) != 0u) &&
+            neighbour.has_value() &&
+            ((neighbour->lane_id > 0) == (info.lane_id > 0)) &&
+            FindNode(*neighbour, next)) {
+          add_edge(_lane_changes[node], next, _parameters.lane_change_cost);
+        }
+      };
+      add_lane_change(LaneMarking::LaneChange::Right, map.GetRight(middle));
+      add_lane_change(LaneMarking::LaneChange::Left, map.GetLeft(middle));
+    }
+
+    for (NodeId node = 0u; node < size; ++node) {
+      _number_of_edges += _successors[node].size() + _lane_changes[node].size();
+    }
+  }
+
+  void RoutingGraph::Contract() {
+    const size_t size = _nodes.size();
+
+    // Edges between the nodes not contracted yet; incoming edges store the
+    // node they come from in Edge::to.
+    std::vector<std::vector<Edge>> outgoing(size);
+    std::vector<std::vector<Edge>> incoming(size);
+    const auto update_edge = [](std::vector<Edge> &edges, NodeId to, double cost) {
+      for (auto &edge : edges) {
+        if (edge.to == to) {
+          edge.cost = std::min(edge.cost, cost);
+          return;
+        }
+      }
+      edges.emplace_back(Edge{to, cost});
+    };
+    const auto add_arc = [&](NodeId from, NodeId to, double cost, NodeId middle) {
+      auto result = _arcs.emplace(MakeArcKey(from, to), Arc{cost, middle});
+      if (!result.second) {
+        if (cost >= result.first->second.cost) {
+          return;
+        }
+        result.first->second = Arc{cost, middle};
+      }
+      update_edge(outgoing[from], to, cost);
+      update_edge(incoming[to], from, cost);
+    };
+    for (NodeId node = 0u; node < size; ++node) {
+      for (const auto *edges : {&_successors[node], &_lane_changes[node]}) {
+        for (const auto &edge : *edges) {
+          if (edge.to != node) {
+            add_arc(node, edge.to, edge.cost, INVALID_NODE);
+          }
+        }
+      }
+    }
+
+    std::vector<int> contracted_neighbours(size, 0);
+    std::vector<int> depth(size, 0);
+    std::vector<uint32_t> rank(size, 0u);
+
+    // Bounded Dijkstra from @a source that ignores @a skipped, until every
+    // neighbour of @a skipped is settled.
+    SearchSpace witness(size);
+    std::vector<uint32_t> target_marks(size, 0u);
+    uint32_t target_mark = 0u;
+    const auto search_witnesses = [&](NodeId source, NodeId skipped, size_t targets, double max_cost) {
+      witness.Reset();
+      witness.Relax(source, 0.0, INVALID_NODE);
+      NodeId node;
+      while ((targets > 0u) && witness.Pop(node)) {
+        if ((witness.cost[node] > max_cost) || (witness.settled.size() > MAX_WITNESS_SEARCH_SIZE)) {
+          break;
+        }
+        if (target_marks[node] == target_mark) {
+          --targets;
+        }
+        for (const auto &edge : outgoing[node]) {
+          if (edge.to != skipped) {
+            witness.Relax(edge.to, witness.cost[node] + edge.cost, node);
+          }
+        }
+      }
+    };
+
+    struct Shortcut {
+      NodeId from;
+      NodeId to;
+      double cost;
+    };
+
+    // Shortcuts needed to keep the distances if @a node is removed.
+    const auto find_shortcuts = [&](NodeId node, std::vector<Shortcut> &shortcuts) {
+      shortcuts.clear();
+      for (const auto &in : incoming[node]) {
+        ++target_mark;
+        size_t targets = 0u;
+        double max_out_cost = -1.0;
+        for (const auto &out : outgoing[node]) {
+          if (out.to != in.to) {
+            target_marks[out.to] = target_mark;
+            max_out_cost = std::max(max_out_cost, out.cost);
+            ++targets;
+          }
+        }
+        if (targets == 0u) {
+          continue;
+        }
+        search_witnesses(in.to, node, targets, in.cost + max_out_cost);
+        for (const auto &out : outgoing[node]) {
+          if (out.to == in.to) {
+            continue;
+          }
+          const double cost = in.cost + out.cost;
+          if (witness.cost[out.to] > cost) {
+            shortcuts.emplace_back(Shortcut{in.to, out.to, cost});
+          }
+        }
+      }
+    };
+
+    // Mostly the edge difference (shortcuts added minus edges removed), plus
+    // contracted neighbours and depth, to spread the hierarchy evenly over
+    // the map and keep it shallow.
+    std::vector<Shortcut> shortcuts;
+    const auto compute_priority = [&](NodeId node) {
+      find_shortcuts(node, shortcuts);
+      const auto degree = incoming[node].size() + outgoing[node].size();
+      return
+          4 * (static_cast<int>(shortcuts.size()) - static_cast<int>(degree)) +
+          contracted_neighbours[node] +
+          depth[node];
+    };
+
+    using QueueEntry = std::pair<int, NodeId>;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> queue;
+    for (NodeId node = 0u; node < size; ++node) {
+      queue.emplace(compute_priority(node), node);
+    }
+
+    // Lazy updates: a node is only contracted if its priority, recomputed
+    // now, is still the lowest.
+    uint32_t next_rank = 0u;
+    while (!queue.empty()) {
+      const NodeId node = queue.top().second;
+      queue.pop();
+      const int priority = compute_priority(node);
+      if (!queue.empty() && (priority > queue.top().first)) {
+        queue.emplace(priority, node);
+        continue;
+      }
+      for (const auto &shortcut : shortcuts) {
+        add_arc(shortcut.from, shortcut.to, shortcut.cost, node);
+      }
+      rank[node] = next_rank++;
+      // Drop the edges to the node from its neighbours, the remaining graph
+      // only keeps the nodes not contracted yet.
+      const auto remove_edges_to = [node](std::vector<Edge> &edges) {
+        edges.erase(std::remove_if(edges.begin(), edges.end(), [node](const Edge &edge) {
+          return edge.to == node;
+        }), edges.end());
+      };
+      for (const auto &edge : incoming[node]) {
+        remove_edges_to(outgoing[edge.to]);
+      }
+      for (const auto &edge : outgoing[node]) {
+        remove_edges_to(incoming[edge.to]);
+      }
+      for (const auto *edges : {&incoming[node], &outgoing[node]}) {
+        for (const auto &edge : *edges) {
+          ++contracted_neighbours[edge.to];
+          depth[edge.to] = std::max(depth[edge.to], depth[node] + 1);
+        }
+      }
+      std::vector<Edge>{}.swap(incoming[node]);
+      std::vector<Edge>{}.swap(outgoing[node]);
+    }
+
+    // Split the arcs in upward and downward edges, CSR layout.
+    std::vector<std::vector<Edge>> upward(size);
+    std::vector<std::vector<Edge>> downward(size);
+    for (const auto &pair : _arcs) {
+      const auto from = static_cast<NodeId>(pair.first >> 32u);
+      const auto to = static_cast<NodeId>(pair.first & 0xFFFFFFFFu);
+      if (pair.second.middle != INVALID_NODE) {
+        ++_number_of_shortcuts;
+      }
+      if (rank[from] < rank[to]) {
+        upward[from].emplace_back(Edge{to, pair.second.cost});
+      } else {
+        downward[to].emplace_back(Edge{from, pair.second.cost});
+      }
+    }
+    const auto flatten = [size](
+        std::vector<std::vector<Edge>> &edges,
+        std::vector<uint32_t> &offsets,
+        std::vector<Edge> &flat) {
+      offsets.resize(size + 1u);
+      offsets[0u] = 0u;
+      for (size_t node = 0u; node < size; ++node) {
+        // Fixed order, the arcs come from a hash map.
+        std::sort(edges[node].begin(), edges[node].end(), [](const Edge &lhs, const Edge &rhs) {
+          return lhs.to < rhs.to;
+        });
+        offsets[node + 1u] = offsets[node] + static_cast<uint32_t>(edges[node].size());
+        flat.insert(flat.end(), edges[node].begin(), edges[node].end());
+      }
+    };
+    flatten(upward, _upward_offsets, _upward_edges);
+    flatten(downward, _downward_offsets, _downward_edges);
+  }
+
+  bool RoutingGraph::FindNode(const Waypoint &waypoint, NodeId &node) const {
+    auto it = _node_ids.find(LaneKey{waypoint.road_id, waypoint.section_id, waypoint.lane_id});
+    if (it == _node_ids.end()) {
+      return false;
+    }
+    node = it->second;
+    return true;
+  }
+
+  double RoutingGraph::GetOffset(NodeId node, const Waypoint &waypoint) const {
+    const auto &info = _nodes[node];
+    const double offset = info.lane_id <= 0 ?
+        waypoint.s - info.begin_s :
+        info.begin_s + info.length - waypoint.s;
+    return geom::Math::Clamp(offset, 0.0, info.length);
+  }
+
+  std::vector<RoutingGraph::Neighbour> RoutingGraph::GetNeighbours(NodeId node) const {
+    // Every lane change costs the same, a breadth-first search finds the
+    // cheapest ones.
+    std::vector<Neighbour> result{Neighbour{node, 0.0}};
+    for (size_t i = 0u; i < result.size(); ++i) {
+      const auto current = result[i];
+      for (const auto &edge : _lane_changes[current.node]) {
+        const bool found = std::any_of(result.begin(), result.end(), [&](const Neighbour &neighbour) {
+          return neighbour.node == edge.to;
+        });
+        if (!found) {
+          result.emplace_back(Neighbour{edge.to, current.cost + edge.cost});
+        }
+      }
+    }
+    return result;
+  }
+
+  std::vector<RoutingGraph::Seed> RoutingGraph::GetSeeds(
+      const std::vector<Neighbour> &neighbours,
+      const double origin_offset) const {
+    std::vector<Seed> result;
+    for (const auto &neighbour : neighbours) {
+      const double offset = std::min(origin_offset, _nodes[neighbour.node].length);
+      for (const auto &edge : _successors[neighbour.node]) {
+        const double cost = neighbour.cost + edge.cost - offset;
+        auto it = std::find_if(result.begin(), result.end(), [&](const Seed &seed) {
+          return seed.node == edge.to;
+        });
+        if (it == result.end()) {
+          result.emplace_back(Seed{edge.to, cost, neighbour.node});
+        } else if (cost < it->cost) {
+          *it = Seed{edge.to, cost, neighbour.node};
+        }
+      }
+    }
+    return result;
+  }
+
+  double RoutingGraph::ComputeDirectDistance(
+      const std::vector<Neighbour> &neighbours,
+      const double origin_offset,
+      const NodeId destination,
+      const double destination_offset,
+      NodeId *via) const {
+    if (destination_offset < origin_offset) {
+      return INFINITE_COST;
+    }
+    for (const auto &neighbour : neighbours) {
+      if (neighbour.node == destination) {
+        if (via != nullptr) {
+          *via = neighbour.node;
+        }
+        return neighbour.cost + destination_offset - origin_offset;
+      }
+    }
+    return INFINITE_COST;
+  }
+
+  void RoutingGraph::SearchUpward(SearchSpace &space, const bool backward) const {
+    const auto &offsets = backward ? _downward_offsets : _upward_offsets;
+    const auto &edges = backward ? _downward_edges : _upward_edges;
+    // Edges from higher nodes into the node, in the direction of the search.
+    const auto &reverse_offsets = backward ? _upward_offsets : _downward_offsets;
+    const auto &reverse_edges = backward ? _upward_edges : _downward_edges;
+    NodeId node;
+    while (space.Pop(node)) {
+      const double cost = space.cost[node];
+      // Stall-on-demand: a higher node reaches this one for less, so the
+      // shortest routes through it are found from that node instead.
+      bool is_stalled = false;
+      for (auto i = reverse_offsets[node]; i < reverse_offsets[node + 1u]; ++i) {
+        if (space.cost[reverse_edges[i].to] + reverse_edges[i].cost < cost) {
+          is_stalled = true;
+          break;
+        }
+      }
+      if (is_stalled) {
+        space.settled.pop_back();
+        continue;
+      }
+      for (auto i = offsets[node]; i < offsets[node + 1u]; ++i) {
+        space.Relax(edges[i].to, cost + edges[i].cost, node);
+      }
+    }
+  }
+
+  void RoutingGraph::Unpack(NodeId from, NodeId to, std::vector<NodeId> &path) const {
+    const auto &arc = _arcs.at(MakeArcKey(from, to));
+    if (arc.middle == INVALID_NODE) {
+      path.emplace_back(to);
+    } else {
+      Unpack(from, arc.middle, path);
+      Unpack(arc.middle, to, path);
+    }
+  }
+
+  element::Waypoint RoutingGraph::MakeWaypoint(NodeId node) const {
+    const auto &info = _nodes[node];
+    return Waypoint{info.road_id, info.section_id, info.lane_id, info.start_s};
+  }
+
+  double RoutingGraph::ComputeDistance(
+      const Waypoint &origin,
+      const Waypoint &destination) const {
+    return ComputeDistances({origin}, {destination}).front();
+  }
+
+  std::vector<element::Waypoint> RoutingGraph::ComputeRoute(
+      const Waypoint &origin,
+      const Waypoint &destination) const {
+    NodeId from;
+    NodeId to;
+    if (!FindNode(origin, from) || !FindNode(destination, to)) {
+      return {};
+    }
+    const auto neighbours = GetNeighbours(from);
+    const double origin_offset = GetOffset(from, origin);
+    const double destination_offset = GetOffset(to, destination);
+
+    NodeId via = from;
+    double best = ComputeDirectDistance(
+        neighbours, origin_offset, to, destination_offset, &via);
+
+    const auto seeds = GetSeeds(neighbours, origin_offset);
+    SearchSpace forward(_nodes.size());
+    for (const auto &seed : seeds) {
+      forward.Relax(seed.node, seed.cost, INVALID_NODE);
+    }
+    SearchUpward(forward, false);
+    SearchSpace backward(_nodes.size());
+    backward.Relax(to, destination_offset, INVALID_NODE);
+    SearchUpward(backward, true);
+
+    NodeId meeting = INVALID_NODE;
+    for (auto node : backward.settled) {
+      const double cost = forward.cost[node] + backward.cost[node];
+      if (cost < best) {
+        best = cost;
+        meeting = node;
+      }
+    }
+    if (best == INFINITE_COST) {
+      return {};
+    }
+
+    std::vector<Waypoint> result{origin};
+    const auto add_lane_change = [&](NodeId lane) {
+      if (lane != from) {
+        auto waypoint = origin;
+        waypoint.lane_id = _nodes[lane].lane_id;
+        result.emplace_back(waypoint);
+      }
+    };
+    if (meeting == INVALID_NODE) {
+      // The route does not leave the section of the origin.
+      add_lane_change(via);
+      result.emplace_back(destination);
+      return result;
+    }
+
+    // Nodes of the hierarchy from a seed to the meeting node and from there to
+    // the destination.
+    std::vector<NodeId> nodes;
+    for (auto node = meeting; node != INVALID_NODE; node = forward.parent[node]) {
+      nodes.emplace_back(node);
+    }
+    std::reverse(nodes.begin(), nodes.end());
+    for (auto node = backward.parent[meeting]; node != INVALID_NODE; node = backward.parent[node]) {
+      nodes.emplace_back(node);
+    }
+
+    for (const auto &seed : seeds) {
+      if (seed.node == nodes.front()) {
+        add_lane_change(seed.via);
+        break;
+      }
+    }
+    std::vector<NodeId> path{nodes.front()};
+    for (size_t i = 1u; i < nodes.size(); ++i) {
+      Unpack(nodes[i - 1u], nodes[i], path);
+    }
+    for (auto node : path) {
+      result.emplace_back(MakeWaypoint(node));
+    }
+    result.emplace_back(destination);
+    return result;
+  }
+
+  std::vector<double> RoutingGraph::ComputeDistances(
+      const std::vector<Waypoint> &origins,
+      const std::vector<Waypoint> &destinations) const {
+    const size_t rows = origins.size();
+    const size_t columns = destinations.size();
+    std::vector<double> result(rows * columns, INFINITE_COST);
+    if (result.empty()) {
+      return result;
+    }
+
+    // Backward search from each destination, the nodes it settles with their
+    // cost to the destination.
+    struct BucketEntry {
+      uint32_t column;
+      double cost;
+    };
+    std::vector<NodeId> destination_nodes(columns, INVALID_NODE);
+    std::vector<double> destination_offsets(columns, 0.0);
+    std::vector<std::vector<std::pair<NodeId, double>>> backward_spaces(columns);
+    ParallelForChunks(columns, 16u, [&](size_t, size_t begin, size_t end) {
+      SearchSpace space(_nodes.size());
+      for (size_t column = begin; column < end; ++column) {
+        NodeId node;
+        if (!FindNode(destinations[column], node)) {
+          continue;
+        }
+        destination_nodes[column] = node;
+        destination_offsets[column] = GetOffset(node, destinations[column]);
+        space.Reset();
+        space.Relax(node, destination_offsets[column], INVALID_NODE);
+        SearchUpward(space, true);
+        auto &settled = backward_spaces[column];
+        settled.reserve(space.settled.size());
+        for (auto settled_node : space.settled) {
+          settled.emplace_back(settled_node, space.cost[settled_node]);
+        }
+      }
+    });
+
+    // Buckets of each node, CSR layout.
+    std::vector<uint32_t> bucket_offsets(_nodes.size() + 1u, 0u);
+    for (const auto &settled : backward_spaces) {
+      for (const auto &pair : settled) {
+        ++bucket_offsets[pair.first + 1u];
+      }
+    }
+    for (size_t node = 0u; node < _nodes.size(); ++node) {
+      bucket_offsets[node + 1u] += bucket_offsets[node];
+    }
+    std::vector<BucketEntry> buckets(bucket_offsets.back());
+    {
+      auto next = bucket_offsets;
+      for (uint32_t column = 0u; column < columns; ++column) {
+        for (const auto &pair : backward_spaces[column]) {
+          buckets[next[pair.first]++] = BucketEntry{column, pair.second};
+        }
+      }
+      backward_spaces.clear();
+    }
+
+    // Forward search from each origin, scanning the buckets of every node it
+    // settles.
+    ParallelForChunks(rows, 16u, [&](size_t, size_t begin, size_t end) {
+      SearchSpace space(_nodes.size());
+      for (size_t row_index = begin; row_index < end; ++row_index) {
+        NodeId node;
+        if (!FindNode(origins[row_index], node)) {
+          continue;
+        }
+        double *row = result.data() + row_index * columns;
+        const auto neighbours = GetNeighbours(node);
+        const double origin_offset = GetOffset(node, origins[row_index]);
+        space.Reset();
+        for (const auto &seed : GetSeeds(neighbours, origin_offset)) {
+          space.Relax(seed.node, seed.cost, INVALID_NODE);
+        }
+        SearchUpward(space, false);
+        for (auto settled_node : space.settled) {
+          const double cost = space.cost[settled_node];
+          for (auto i = bucket_offsets[settled_node]; i < bucket_offsets[settled_node + 1u]; ++i) {
+            const auto &entry = buckets[i];
+            row[entry.column] = std::min(row[entry.column], cost + entry.cost);
+          }
+        }
+        for (size_t column = 0u; column < columns; ++column) {
+          if (destination_nodes[column] != INVALID_NODE) {
+            row[column] = std::min(row[column], ComputeDirectDistance(
+                neighbours,
+                origin_offset,
+                destination_nodes[column],
+                destination_offsets[column]));
+          }
+        }
+      }
+    });
+    return result;
+  }
+
+#ifdef LIBCARLA_WITH_GTEST
+
+  double RoutingGraph::ComputeDistanceDijkstra(
+      const Waypoint &origin,
+      const Waypoint &destination) const {
+    NodeId from;
+    NodeId to;
+    if (!FindNode(origin, from) || !FindNode(destination, to)) {
+      return INFINITE_COST;
+    }
+    const auto neighbours = GetNeighbours(from);
+    const double origin_offset = GetOffset(from, origin);
+    const double destination_offset = GetOffset(to, destination);
+    SearchSpace space(_nodes.size());
+    for (const auto &seed : GetSeeds(neighbours, origin_offset)) {
+      space.Relax(seed.node, seed.cost, INVALID_NODE);
+    }
+    NodeId node;
+    while (space.Pop(node)) {
+      for (const auto *edges : {&_successors[node], &_lane_changes[node]}) {
+        for (const auto &edge : *edges) {
+          space.Relax(edge.to, space.cost[node] + edge.cost, node);
+        }
+      }
+    }
+    return std::min(
+        space.cost[to] + destination_offset,
+        ComputeDirectDistance(neighbours, origin_offset, to, destination_offset));
+  }
+
+#endif // LIBCARLA_WITH_GTEST
+
+} // namespace road
+} // namespace carla
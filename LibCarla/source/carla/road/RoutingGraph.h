@@ -0,0 +1,218 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/NonCopyable.h"
+#include "carla/road/RoadTypes.h"
+#include "carla/road/element/Waypoint.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace carla {
+namespace road {
+
+  class Map;
+
+  /// Shortest routes between waypoints over the lanes of a road::Map.
+  ///
+  /// Each drivable lane of each lane section is a node, connected to its
+  /// successor lanes and, where the lane markings allow it, to its
+  /// neighbouring lanes. The cost of a route is the distance driven, in
+  /// meters, plus a penalty per lane change and per radian turned inside
+  /// junctions. The graph is preprocessed into a contraction hierarchy when
+  /// constructed, so each query only explores a few hundred nodes even on the
+  /// biggest maps.
+  ///
+  /// A RoutingGraph is immutable once built and all its queries can be made
+  /// concurrently. It does not keep a reference to the map.
+  class RoutingGraph : private NonCopyable {
+  public:
+
+    using Waypoint = element::Waypoint;
+
+    struct Parameters {
+      /// Cost, in meters, of changing to a neighbouring lane. Negative
+      /// disables lane changes.
+      double lane_change_cost = 10.0;
+      /// Cost, in meters, added to a junction lane for each radian its
+      /// heading turns.
+      double turn_cost = 5.0;
+    };
+
+    explicit RoutingGraph(const Map &map);
+
+    RoutingGraph(const Map &map, Parameters parameters);
+
+    /// Number of lanes in the graph.
+    size_t GetNumberOfNodes() const {
+      return _nodes.size();
+    }
+
+    /// Number of connections between lanes, lane changes included.
+    size_t GetNumberOfEdges() const {
+      return _number_of_edges;
+    }
+
+    /// Number of shortcuts added by the contraction hierarchy.
+    size_t GetNumberOfShortcuts() const {
+      return _number_of_shortcuts;
+    }
+
+    /// Cost of the shortest route from @a origin to @a destination, infinity
+    /// if there is none or any of them is not on a drivable lane.
+    double ComputeDistance(const Waypoint &origin, const Waypoint &destination) const;
+
+    /// Shortest route from @a origin to @a destination: @a origin, the start
+    /// of each lane the route drives into and @a destination. A lane change
+    /// shows as two consecutive waypoints on neighbouring lanes. Empty if
+    /// there is no route.
+    std::vector<Waypoint> ComputeRoute(const Waypoint &origin, const Waypoint &destination) const;
+
+    /// Cost of the shortest route from each of @a origins to each of @a
+    /// destinations, row-major (one row per origin). Computed in parallel
+    /// with a single search per origin and per destination.
+    std::vector<double> ComputeDistances(
+        const std::vector<Waypoint> &origins,
+        const std::vector<Waypoint> &destinations) const;
+
+#ifdef LIBCARLA_WITH_GTEST
+    /// ComputeDistance with a plain Dijkstra search, without shortcuts.
+    double ComputeDistanceDijkstra(const Waypoint &origin, const Waypoint &destination) const;
+#endif // LIBCARLA_WITH_GTEST
+
+  private:
+
+    using NodeId = uint32_t;
+
+    struct Node {
+      RoadId road_id;
+      SectionId section_id;
+      LaneId lane_id;
+      /// The s of the lane start, in the direction of travel.
+      double start_s;
+      /// The s where the lane section begins.
+      double begin_s;
+      double length;
+    };
+
+    struct Edge {
+      NodeId to;
+      double cost;
+    };
+
+    /// Original edge or shortcut between two nodes, with the node it skips.
+    struct Arc {
+      double cost;
+      NodeId middle;
+    };
+
+    /// A node where a search starts, with its initial cost.
+    struct Seed {
+      NodeId node;
+      double cost;
+      /// Lane of the origin's section that the route leaves from.
+      NodeId via;
+    };
+
+    /// Lanes reachable from an origin's lane by changing lanes before leaving
+    /// its section, with the cost of the lane changes.
+    struct Neighbour {
+      NodeId node;
+      double cost;
+    };
+
+    class SearchSpace;
+
+    struct LaneKey {
+      RoadId road_id;
+      SectionId section_id;
+      LaneId lane_id;
+
+      bool operator==(const LaneKey &rhs) const {
+        return road_id == rhs.road_id &&
+               section_id == rhs.section_id &&
+               lane_id == rhs.lane_id;
+      }
+    };
+
+    struct LaneKeyHash {
+      size_t operator()(const LaneKey &key) const;
+    };
+
+    void CreateNodes(const Map &map);
+
+    void CreateEdges(const Map &map);
+
+    void Contract();
+
+    bool FindNode(const Waypoint &waypoint, NodeId &node) const;
+
+    /// Distance from the start of the lane to @a waypoint.
+    double GetOffset(NodeId node, const Waypoint &waypoint) const;
+
+    std::vector<Neighbour> GetNeighbours(NodeId node) const;
+
+    /// Successors of the lanes in @a neighbours, where the searches from an
+    /// origin at @a origin_offset start.
+    std::vector<Seed> GetSeeds(
+        const std::vector<Neighbour> &neighbours,
+        double origin_offset) const;
+
+    /// Cost of the routes that stay in the section of @a origin.
+    double ComputeDirectDistance(
+        const std::vector<Neighbour> &neighbours,
+        double origin_offset,
+        NodeId destination,
+        double destination_offset,
+        NodeId *via = nullptr) const;
+
+    /// Dijkstra over the upward (or downward if @a backward) edges of the
+    /// hierarchy.
+    void SearchUpward(SearchSpace &space, bool backward) const;
+
+    void Unpack(NodeId from, NodeId to, std::vector<NodeId> &path) const;
+
+    Waypoint MakeWaypoint(NodeId node) const;
+
+    static uint64_t MakeArcKey(NodeId from, NodeId to) {
+      return (static_cast<uint64_t>(from) << 32u) | static_cast<uint64_t>(to);
+    }
+
+    Parameters _parameters;
+
+    std::vector<Node> _nodes;
+
+    std::unordered_map<LaneKey, NodeId, LaneKeyHash> _node_ids;
+
+    /// Original edges to successor lanes, the cost of driving the whole lane
+    /// plus the turn cost of the successor.
+    std::vector<std::vector<Edge>> _successors;
+
+    std::vector<std::vector<Edge>> _lane_changes;
+
+    size_t _number_of_edges = 0u;
+
+    size_t _number_of_shortcuts = 0u;
+
+    /// Every edge of the hierarchy, by MakeArcKey.
+    std::unordered_map<uint64_t, Arc> _arcs;
+
+    /// Edges to nodes of higher rank, CSR layout.
+    std::vector<uint32_t> _upward_offsets;
+
+    std::vector<Edge> _upward_edges;
+
+    /// Edges from nodes of higher rank, reversed, CSR layout.
+    std::vector<uint32_t> _downward_offsets;
+
+    std::vector<Edge> _downward_edges;
+  };
+
+} // namespace road
+} // namespace carla
@@ -0,0 +1,204 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/road/element/ArcLengthTable.h"
+
+#include "carla/geom/Math.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace carla {
+namespace road {
+namespace element {
+
+  /// Distance between samples [meters].
+  static constexpr double SAMPLE_STEP = 1.0;
+
+  /// Below this |d(u, v)/dp| the curve is considered stopped.
+  static constexpr double MIN_SPEED = 1e-9;
+
+  ArcLengthTable::ArcLengthTable(
+      const geom::CubicPolynomial &u,
+      const geom::CubicPolynomial &v,
+      const double length)
+    : _u(u),
+      _v(v),
+      _length(std::max(length, 0.0)) {
+    const auto intervals = std::max<size_t>(1u, static_cast<size_t>(std::ceil(_length / SAMPLE_STEP)));
+    _step = _length / static_cast<double>(intervals);
+    _parameters.reserve(intervals + 1u);
+    _parameters.emplace_back(0.0);
+    for (auto i = 0u; i < intervals; ++i) {
+      _parameters.emplace_back(Advance(_parameters.back(), _step));
+    }
+    // Where the curve stops, fall back to the slope between samples.
+    _derivatives.reserve(_parameters.size());
+    for (auto i = 0u; i < _parameters.size(); ++i) {
+      const double speed = GetSpeed(_parameters[i]);
+      if (speed > MIN_SPEED) {
+        _derivatives.emplace_back(1.0 / speed);
+      } else if (_step > 0.0) {
+        const auto first = i == 0u ? 0u : i - 1u;
+        const auto last = std::min<size_t>(i + 1u, _parameters.size() - 1u);
+        _derivatives.emplace_back(
+            (_parameters[last] - _parameters[first]) / (static_cast<double>(last - first) * _step));
+      } else {
+        _derivatives.emplace_back(0.0);
+      }
+    }
+  }
+
+  double ArcLengthTable::GetParameter(double s) const {
+    if (_parameters.size() < 2u || _step <= 0.0) {
+      return 0.0;
+    }
+    s = geom::Math::Clamp(s, 0.0, _length);
+    const double x = s / _step;
+    const auto i = std::min(static_cast<size_t>(x), _parameters.size() - 2u);
+    const double t = x - static_cast<double>(i);
+    // Cubic Hermite basis.
+    const double t2 = t * t;
+    const double t3 = t2 * t;
+    const double h00 = 2.0 * t3 - 3.0 * t2 + 1.0;
+    const double h10 = t3 - 2.0 * t2 + t;
+    const double h01 = -2.0 * t3 + 3.0 * t2;
+    const double h11 = t3 - t2;
+    return
+        h00 * _parameters[i] +
+        h10 * _step * _derivatives[i] +
+        h01 * _parameters[i + 1u] +
+        h11 * _step * _derivatives[i + 1u];
+  }
+
+  std::pair<double, double> ArcLengthTable::GetNearestPoint(const double u, const double v) const {
+    const auto distance_to = [&](const Point &point) {
+      return std::hypot(point.u - u, point.v - v);
+    };
+    if (_parameters.size() < 2u) {
+      return {0.0, distance_to(Evaluate(0.0))};
+    }
+
+    // Nearest chord between consecutive samples.
+    size_t nearest = 0u;
+    double nearest_t = 0.0;
+    double nearest_distance = std::numeric_limits<double>::max();
+    Point a = Evaluate(_parameters.front());
+    for (auto i = 0u; i + 1u < _parameters.size(); ++i) {
+      const Point b = Evaluate(_parameters[i + 1u]);
+      const double du = b.u - a.u;
+      const double dv = b.v - a.v;
+      const double chord2 = du * du + dv * dv;
+      const double t = chord2 > 0.0 ?
+          geom::Math::Clamp(((u - a.u) * du + (v - a.v) * dv) / chord2, 0.0, 1.0) :
+          0.0;
+      const double distance = std::hypot(a.u + t * du - u, a.v + t * dv - v);
+      if (distance < nearest_distance) {
+        nearest = i;
+        nearest_t = t;
+        nearest_distance = distance;
+      }
+      a = b;
+    }
+
+    // Refine on the curve with Newton's method on (C(p) - q) . C'(p) = 0,
+    // allowing it to move into the neighbouring intervals.
+    const double p0 = _parameters[nearest];
+    const double initial_p = p0 + nearest_t * (_parameters[nearest + 1u] - p0);
+    const double min_p = _parameters[nearest == 0u ? 0u : nearest - 1u];
+    const double max_p = _parameters[std::min<size_t>(nearest + 2u, _parameters.size() - 1u)];
+    double p = initial_p;
+    for (auto i = 0u; i < 8u; ++i) {
+      const double du = _u.Evaluate(p) - u;
+      const double dv = _v.Evaluate(p) - v;
+      const double tu = _u.Tangent(p);
+      const double tv = _v.Tangent(p);
+      const double g = du * tu + dv * tv;
+      const double dg =
+          tu * tu + tv * tv +
+          du * (2.0 * _u.GetC() + 6.0 * _u.GetD() * p) +
+          dv * (2.0 * _v.GetC() + 6.0 * _v.GetD() * p);
+      if (dg <= 0.0) {
+        break;
+      }
+      const double next = geom::Math::Clamp(p - g / dg, min_p, max_p);
+      if (std::abs(next - p) < 1e-12) {
+        p = next;
+        break;
+      }
+      p = next;
+    }
+    if (distance_to(Evaluate(p)) > distance_to(Evaluate(initial_p))) {
+      p = initial_p;
+    }
+
+    const double s = static_cast<double>(nearest) * _step + Integrate(p0, p);
+    return {geom::Math::Clamp(s, 0.0, _length), distance_to(Evaluate(p))};
+  }
+
+  ArcLengthTable::Point ArcLengthTable::Evaluate(const double p) const {
+    return {_u.Evaluate(p), _v.Evaluate(p), std::atan2(_v.Tangent(p), _u.Tangent(p))};
+  }
+
+  double ArcLengthTable::GetSpeed(const double p) const {
+    return std::hypot(_u.Tangent(p), _v.Tangent(p));
+  }
+
+  double ArcLengthTable::Integrate(const double p0, const double p1) const {
+    // Five-point Gauss-Legendre, exact for the polynomial part of the speed
+    // up to degree nine.
+    static constexpr double nodes[] = {
+        0.0, -0.5384693101056831, 0.5384693101056831, -0.9061798459386640, 0.9061798459386640};
+    static constexpr double weights[] = {
+        0.5688888888888889, 0.4786286704993665, 0.4786286704993665, 0.2369268850561891, 0.2369268850561891};
+    const double half = 0.5 * (p1 - p0);
+    const double middle = 0.5 * (p1 + p0);
+    double result = 0.0;
+    for (auto i = 0u; i < 5u; ++i) {
+      result += weights[i] * GetSpeed(middle + half * nodes[i]);
+    }
+    return half * result;
+  }
+
+  double ArcLengthTable::Advance(const double p0, const double ds) const {
+    if (ds <= 0.0) {
+      return p0;
+    }
+    // Bracket the solution, then Newton's method falling back to bisection.
+    double low = p0;
+    double high = p0 + ds / std::max(GetSpeed(p0), MIN_SPEED);
+    for (auto i = 0u; (i < 64u) && (Integrate(p0, high) < ds); ++i) {
+      low = high;
+      high = p0 + 2.0 * (high - p0);
+    }
+    double p = high;
+    for (auto i = 0u; i < 64u; ++i) {
+      const double error = Integrate(p0, p) - ds;
+      if (std::abs(error) < 1e-10) {
+        break;
+      }
+      if (error < 0.0) {
+        low = p;
+      } else {
+        high = p;
+      }
+      const double speed = GetSpeed(p);
+      double next = speed > MIN_SPEED ? p - error / speed : low;
+      if (next <= low || next >= high) {
+        next = 0.5 * (low + high);
+      }
+      if (high - low < 1e-12) {
+        break;
+      }
+      p = next;
+    }
+    return p;
+  }
+
+} // namespace element
+} // namespace road
+} // namespace carla
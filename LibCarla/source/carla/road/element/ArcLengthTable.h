@@ -0,0 +1,97 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/geom/CubicPolynomial.h"
+
+#include <utility>
+#include <vector>
+
+namespace carla {
+namespace road {
+namespace element {
+
+  /// Arc-length parameterization of a planar curve (u(p), v(p)) given by two
+  /// cubic polynomials, shared by the poly3 and paramPoly3 geometries.
+  ///
+  /// Stores the curve parameter p at uniform steps of the distance s along
+  /// the curve, together with dp/ds, so finding the point at a distance is an
+  /// O(1) lookup followed by a cubic Hermite interpolation and the evaluation
+  /// of the polynomials. Points are exactly on the curve; only their distance
+  /// along it is interpolated.
+  class ArcLengthTable {
+  public:
+
+    /// Point of the curve in its local frame.
+    struct Point {
+      double u;
+      double v;
+      /// Heading of the curve in the local frame [radians].
+      double tangent;
+    };
+
+    ArcLengthTable() = default;
+
+    /// Parameterizes the first @a length meters of the curve.
+    ArcLengthTable(
+        const geom::CubicPolynomial &u,
+        const geom::CubicPolynomial &v,
+        double length);
+
+    double GetLength() const {
+      return _length;
+    }
+
+    size_t GetNumberOfSamples() const {
+      return _parameters.size();
+    }
+
+    /// Curve parameter at distance @a s, clamped to [0, length].
+    double GetParameter(double s) const;
+
+    /// Point at distance @a s, clamped to [0, length].
+    Point GetPoint(double s) const {
+      return Evaluate(GetParameter(s));
+    }
+
+    /// Distance along the curve to the nearest point to (@a u, @a v), and
+    /// the distance to it.
+    std::pair<double, double> GetNearestPoint(double u, double v) const;
+
+  private:
+
+    Point Evaluate(double p) const;
+
+    /// |d(u, v)/dp|
+    double GetSpeed(double p) const;
+
+    /// Arc length of the curve between parameters @a p0 and @a p1, with
+    /// Gauss-Legendre quadrature.
+    double Integrate(double p0, double p1) const;
+
+    /// Parameter at distance @a ds after @a p0.
+    double Advance(double p0, double ds) const;
+
+    geom::CubicPolynomial _u;
+
+    geom::CubicPolynomial _v;
+
+    double _length = 0.0;
+
+    /// Distance between samples.
+    double _step = 0.0;
+
+    /// Curve parameter at each multiple of _step.
+    std::vector<double> _parameters;
+
+    /// dp/ds at each sample.
+    std::vector<double> _derivatives;
+  };
+
+} // namespace element
+} // namespace road
+} // namespace carla
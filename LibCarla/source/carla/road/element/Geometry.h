@@ -9,7 +9,7 @@
 #include "carla/geom/Location.h"
 #include "carla/geom/Math.h"
 #include "carla/geom/CubicPolynomial.h"
-#include "carla/geom/Rtree.h"
+#include "carla/road/element/ArcLengthTable.h"
 
 namespace carla {
 namespace road {
@@ -209,10 +209,8 @@ namespace element {
         _a(a),
         _b(b),
         _c(c),
-        _d(d) {
-      _poly.Set(a, b, c, d);
-      PreComputeSpline();
-    }
+        _d(d),
+        _table({0.0, 1.0, 0.0, 0.0}, {a, b, c, d}, length) {}
 
     double Geta() const {
       return _a;
@@ -233,23 +231,12 @@ namespace element {
 
   private:
 
-    geom::CubicPolynomial _poly;
-
     double _a;
     double _b;
     double _c;
     double _d;
 
-    struct RtreeValue {
-      double u = 0;
-      double v = 0;
-      double s = 0;
-      double t = 0;
-    };
-    using Rtree = geom::SegmentCloudRtree<RtreeValue, 1>;
-    using TreeElement = Rtree::TreeElement;
-    Rtree _rtree;
-    void PreComputeSpline();
+    ArcLengthTable _table;
   };
 
   class GeometryParamPoly3 final : public Geometry {
@@ -278,11 +265,10 @@ namespace element {
         _bV(bV),
         _cV(cV),
         _dV(dV),
-        _arcLength(arcLength) {
-        _polyU.Set(aU, bU, cU, dU);
-        _polyV.Set(aV, bV, cV, dV);
-        PreComputeSpline();
-    }
+        _arcLength(arcLength),
+        // The table finds the parameter by arc length, so it works the same
+        // whether the parameter is normalized to [0, 1] or in meters.
+        _table({aU, bU, cU, dU}, {aV, bV, cV, dV}, length) {}
 
     double GetaU() const {
       return _aU;
@@ -315,8 +301,6 @@ namespace element {
 
   private:
 
-    geom::CubicPolynomial _polyU;
-    geom::CubicPolynomial _polyV;
     double _aU;
     double _bU;
     double _cU;
@@ -327,17 +311,7 @@ namespace element {
     double _dV;
     bool _arcLength;
 
-    struct RtreeValue {
-      double u = 0;
-      double v = 0;
-      double s = 0;
-      double t_u = 0;
-      double t_v = 0;
-    };
-    using Rtree = geom::SegmentCloudRtree<RtreeValue, 1>;
-    using TreeElement = Rtree::TreeElement;
-    Rtree _rtree;
-    void PreComputeSpline();
+    ArcLengthTable _table;
   };
 
 } // namespace element
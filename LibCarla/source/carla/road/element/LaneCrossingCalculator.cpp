@@ -8,8 +8,12 @@
 #include "carla/road/element/LaneMarking.h"
 
 #include "carla/geom/Location.h"
+#include "carla/geom/Math.h"
 #include "carla/road/Map.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace carla {
 namespace road {
 namespace element {
@@ -53,16 +57,34 @@ namespace element {
     return {};
   }
 
-  static bool IsOffRoad(const Map &map, const geom::Location &location) {
-    return !map.GetWaypoint(location, FLAGS).has_value();
+  /// Width of the lane at @a lane_id in the same section as @a lane, zero if
+  /// there is no such lane or it is not one of the lanes searched (FLAGS).
+  static double GetNeighbourWidth(const Lane &lane, LaneId lane_id, double s) {
+    if (lane_id == 0) {
+      return 0.0;
+    }
+    const auto *section = lane.GetLaneSection();
+    const auto *neighbour = section != nullptr ? section->GetLane(lane_id) : nullptr;
+    if ((neighbour == nullptr) ||
+        ((static_cast<uint32_t>(neighbour->GetType()) & FLAGS) == 0u)) {
+      return 0.0;
+    }
+    return neighbour->GetWidth(s);
   }
 
   std::vector<LaneMarking> LaneCrossingCalculator::Calculate(
       const Map &map,
       const geom::Location &origin,
       const geom::Location &destination) {
-    auto w0 = map.GetClosestWaypointOnRoad(origin, FLAGS);
-    auto w1 = map.GetClosestWaypointOnRoad(destination, FLAGS);
+    return Calculate(map, Locate(map, origin), Locate(map, destination));
+  }
+
+  std::vector<LaneMarking> LaneCrossingCalculator::Calculate(
+      const Map &map,
+      const Endpoint &origin,
+      const Endpoint &destination) {
+    const auto &w0 = origin.waypoint;
+    const auto &w1 = destination.waypoint;
 
     if (!w0.has_value() || !w1.has_value()) {
       return {};
@@ -77,8 +99,8 @@ namespace element {
       return {};
     }
 
-    const auto w0_is_offroad = IsOffRoad(map, origin);
-    const auto w1_is_offroad = IsOffRoad(map, destination);
+    const auto w0_is_offroad = origin.is_offroad;
+    const auto w1_is_offroad = destination.is_offroad;
 
     if (w0_is_offroad && w1_is_offroad) {
       // outside the road
@@ -90,9 +112,8 @@ namespace element {
       return {};
     }
 
-    const auto transform = map.ComputeTransform(*w0);
-    geom::Vector3D orig_vec = transform.GetForwardVector();
-    geom::Vector3D dest_vec = (destination - origin).MakeSafeUnitVector(2 * std::numeric_limits<float>::epsilon());
+    geom::Vector3D orig_vec = origin.transform.GetForwardVector();
+    geom::Vector3D dest_vec = (destination.location - origin.location).MakeSafeUnitVector(2 * std::numeric_limits<float>::epsilon());
 
     // cross product
     const auto dest_is_at_right =
@@ -106,6 +127,79 @@ namespace element {
         dest_is_at_right);
   }
 
+  LaneCrossingCalculator::Endpoint LaneCrossingCalculator::Locate(
+      const Map &map,
+      const geom::Location &location) {
+    Endpoint result;
+    result.location = location;
+    result.waypoint = map.GetClosestWaypointOnRoad(location, FLAGS);
+    if (result.waypoint.has_value()) {
+      // Same test as Map::GetWaypoint, without querying the R-tree again.
+      result.transform = map.ComputeTransform(*result.waypoint);
+      const auto half_lane_width = map.GetLaneWidth(*result.waypoint) * 0.5;
+      result.is_offroad =
+          geom::Math::Distance2D(result.transform.location, location) >= half_lane_width;
+    }
+    return result;
+  }
+
+  boost::optional<LaneCrossingCalculator::LaneArea> LaneCrossingCalculator::MakeLaneArea(
+      const Map &map,
+      const Endpoint &endpoint) {
+    if (endpoint.is_offroad || !endpoint.waypoint.has_value()) {
+      return boost::none;
+    }
+    const auto &waypoint = *endpoint.waypoint;
+    if (map.IsJunction(waypoint.road_id)) {
+      return boost::none;
+    }
+    const auto &lane = map.GetLane(waypoint);
+    const bool is_straight = lane.IsStraight();
+
+    // Keep the area inside the lane section, and short enough on curves that
+    // the lane center does not drift away from the tangent at the waypoint.
+    const double section_begin = lane.GetDistance();
+    const double section_end = section_begin + lane.GetLength();
+    const double half_length = std::min(
+        is_straight ? 10.0 : 1.5,
+        std::min(waypoint.s - section_begin, section_end - waypoint.s));
+    if (half_length < 0.1) {
+      // Too close to the section ends to be worth it.
+      return boost::none;
+    }
+
+    // Stay closer to this lane center than to the center of any neighbour
+    // lane, so the closest waypoint on road keeps being in this lane.
+    const auto lane_id = waypoint.lane_id;
+    const auto right_id = lane_id > 0 ? lane_id + 1 : lane_id - 1;
+    const auto left_id = std::abs(lane_id) == 1 ? -lane_id : (lane_id > 0 ? lane_id - 1 : lane_id + 1);
+    double half_width = std::numeric_limits<double>::max();
+    for (const double s : {waypoint.s - half_length, waypoint.s, waypoint.s + half_length}) {
+      const double width = lane.GetWidth(s);
+      half_width = std::min(half_width, 0.5 * width);
+      for (const auto neighbour_id : {left_id, right_id}) {
+        const double neighbour_width = GetNeighbourWidth(lane, neighbour_id, s);
+        if (neighbour_width > 0.0) {
+          half_width = std::min(half_width, 0.25 * (width + neighbour_width));
+        }
+      }
+    }
+    half_width -= is_straight ? 0.05 : 0.3;
+
+    LaneArea area;
+    area.waypoint = waypoint;
+    area.center = endpoint.transform.location;
+    const auto forward = endpoint.transform.GetForwardVector();
+    area.forward = geom::Vector3D(forward.x, forward.y, 0.0f).MakeSafeUnitVector(
+        std::numeric_limits<float>::epsilon());
+    area.half_length = static_cast<float>(half_length);
+    area.half_width = static_cast<float>(half_width);
+    if ((half_width <= 0.0) || !area.Contains(endpoint.location)) {
+      return boost::none;
+    }
+    return area;
+  }
+
 } // namespace element
 } // namespace road
 } // namespace carla
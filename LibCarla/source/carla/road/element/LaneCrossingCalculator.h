@@ -6,12 +6,17 @@
 
 #pragma once
 
+#include "carla/geom/Location.h"
+#include "carla/geom/Transform.h"
 #include "carla/road/element/LaneMarking.h"
+#include "carla/road/element/Waypoint.h"
 
+#include <boost/optional.hpp>
+
+#include <cmath>
 #include <vector>
 
 namespace carla {
-namespace geom { class Location; }
 namespace road {
 
   class Map;
@@ -21,10 +26,56 @@ namespace element {
   class LaneCrossingCalculator {
   public:
 
+    /// A location together with its closest lane, the result of the map
+    /// queries needed to compute a lane crossing.
+    struct Endpoint {
+      geom::Location location;
+      /// Closest waypoint on a lane where road marks can be found, none if
+      /// the map has no such lanes.
+      boost::optional<Waypoint> waypoint;
+      /// Transform of the lane center at waypoint.
+      geom::Transform transform;
+      /// Whether the location is outside the lane of the waypoint.
+      bool is_offroad = true;
+    };
+
+    /// A rectangle inside a lane, no lane marking can be crossed moving
+    /// between two locations inside it. Lets callers tracking a moving
+    /// location skip the map queries while it stays in its lane.
+    struct LaneArea {
+      Waypoint waypoint;
+      geom::Location center;
+      geom::Vector3D forward;
+      float half_length;
+      float half_width;
+
+      bool Contains(const geom::Location &location) const {
+        const auto offset = location - center;
+        const float along = offset.x * forward.x + offset.y * forward.y;
+        const float across = offset.y * forward.x - offset.x * forward.y;
+        return (std::abs(along) <= half_length) && (std::abs(across) <= half_width);
+      }
+    };
+
     static std::vector<LaneMarking> Calculate(
         const Map &map,
         const geom::Location &origin,
         const geom::Location &destination);
+
+    /// Same as above with both locations already located, see Locate.
+    static std::vector<LaneMarking> Calculate(
+        const Map &map,
+        const Endpoint &origin,
+        const Endpoint &destination);
+
+    /// Find the closest lane to @a location, a single R-tree query.
+    static Endpoint Locate(const Map &map, const geom::Location &location);
+
+    /// Build a LaneArea around the waypoint of @a endpoint, none if the
+    /// endpoint is off-road, in a junction, or outside the resulting area.
+    static boost::optional<LaneArea> MakeLaneArea(
+        const Map &map,
+        const Endpoint &endpoint);
   };
 
 } // namespace element
@@ -0,0 +1,71 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/road/RoadTypes.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace carla {
+namespace road {
+namespace element {
+
+  /// A list of waypoints stored column by column, one array per attribute,
+  /// for exporting large amounts of waypoints without an object per
+  /// waypoint. Row i of every column belongs to the same waypoint.
+  struct WaypointColumns {
+
+    std::vector<RoadId> road_id;
+
+    std::vector<SectionId> section_id;
+
+    std::vector<LaneId> lane_id;
+
+    std::vector<double> s;
+
+    /// Location of the waypoint [meters].
+    std::vector<float> x;
+
+    std::vector<float> y;
+
+    std::vector<float> z;
+
+    /// Yaw of the waypoint's transform [degrees].
+    std::vector<float> yaw;
+
+    std::vector<double> lane_width;
+
+    /// Lane::LaneType of the waypoint's lane.
+    std::vector<int32_t> lane_type;
+
+    size_t size() const {
+      return road_id.size();
+    }
+
+    bool empty() const {
+      return road_id.empty();
+    }
+
+    /// Resize every column to @a size rows, new rows are zero.
+    void resize(size_t size) {
+      road_id.resize(size);
+      section_id.resize(size);
+      lane_id.resize(size);
+      s.resize(size);
+      x.resize(size);
+      y.resize(size);
+      z.resize(size);
+      yaw.resize(size);
+      lane_width.resize(size);
+      lane_type.resize(size);
+    }
+  };
+
+} // namespace element
+} // namespace road
+} // namespace carla
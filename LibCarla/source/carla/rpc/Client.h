@@ -38,6 +38,14 @@ namespace rpc {
       _client.async_call(function, Metadata::MakeAsync(), std::forward<Args>(args)...);
     }
 
+    /// Same as call, but returns a future with the result instead of waiting
+    /// for it. Calls are told apart by their request id, so several threads
+    /// may share the same connection, each waiting with its own timeout.
+    template <typename... Args>
+    auto async_call_with_future(const std::string &function, Args &&... args) {
+      return _client.async_call(function, Metadata::MakeSync(), std::forward<Args>(args)...);
+    }
+
   private:
 
     ::rpc::client _client;
@@ -0,0 +1,34 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/MsgPack.h"
+
+#include <cstdint>
+#include <string>
+
+namespace carla {
+namespace rpc {
+
+  /// A file the server shares with the clients.
+  class FileInfo {
+  public:
+
+    /// Path relative to the content folder of the server.
+    std::string name;
+
+    /// Size in bytes.
+    uint64_t size = 0u;
+
+    /// ContentHash of the file.
+    std::string hash;
+
+    MSGPACK_DEFINE_ARRAY(name, size, hash);
+  };
+
+} // namespace rpc
+} // namespace carla
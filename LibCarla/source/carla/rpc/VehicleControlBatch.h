@@ -0,0 +1,248 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Exception.h"
+#include "carla/MsgPack.h"
+#include "carla/rpc/ActorId.h"
+#include "carla/rpc/Transform.h"
+#include "carla/rpc/VehicleControl.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace carla {
+namespace rpc {
+
+  /// Controls and transforms to apply to many vehicles at once, stored by
+  /// columns.
+  ///
+  /// It is an alternative to a batch of ApplyVehicleControl and
+  /// ApplyTransform commands for clients driving thousands of vehicles each
+  /// tick, like the Traffic Manager. It is sent as a single msgpack binary
+  /// blob holding each column contiguously, and applied by the server without
+  /// a response per vehicle.
+  class VehicleControlBatch {
+  public:
+
+    void Clear() {
+      _control_actors.clear();
+      _throttle.clear();
+      _steer.clear();
+      _brake.clear();
+      _gear.clear();
+      _flags.clear();
+      _transform_actors.clear();
+      _transforms.clear();
+    }
+
+    void Reserve(size_t number_of_controls, size_t number_of_transforms = 0u) {
+      _control_actors.reserve(number_of_controls);
+      _throttle.reserve(number_of_controls);
+      _steer.reserve(number_of_controls);
+      _brake.reserve(number_of_controls);
+      _gear.reserve(number_of_controls);
+      _flags.reserve(number_of_controls);
+      _transform_actors.reserve(number_of_transforms);
+      _transforms.reserve(number_of_transforms);
+    }
+
+    bool empty() const {
+      return _control_actors.empty() && _transform_actors.empty();
+    }
+
+    // =========================================================================
+    /// @name Vehicle controls
+    // =========================================================================
+    /// @{
+
+    void AddControl(ActorId actor, const VehicleControl &control) {
+      _control_actors.emplace_back(actor);
+      _throttle.emplace_back(control.throttle);
+      _steer.emplace_back(control.steer);
+      _brake.emplace_back(control.brake);
+      _gear.emplace_back(control.gear);
+      _flags.emplace_back(static_cast<uint8_t>(
+          (control.hand_brake ? static_cast<uint8_t>(HandBrake) : uint8_t(0u)) |
+          (control.reverse ? static_cast<uint8_t>(Reverse) : uint8_t(0u)) |
+          (control.manual_gear_shift ? static_cast<uint8_t>(ManualGearShift) : uint8_t(0u))));
+    }
+
+    size_t GetNumberOfControls() const {
+      return _control_actors.size();
+    }
+
+    ActorId GetControlActor(size_t index) const {
+      return _control_actors[index];
+    }
+
+    VehicleControl GetControl(size_t index) const {
+      const auto flags = _flags[index];
+      return {
+          _throttle[index],
+          _steer[index],
+          _brake[index],
+          (flags & HandBrake) != 0u,
+          (flags & Reverse) != 0u,
+          (flags & ManualGearShift) != 0u,
+          _gear[index]};
+    }
+
+    /// @}
+    // =========================================================================
+    /// @name Transforms
+    // =========================================================================
+    /// @{
+
+    void AddTransform(ActorId actor, const Transform &transform) {
+      _transform_actors.emplace_back(actor);
+      _transforms.emplace_back(transform);
+    }
+
+    size_t GetNumberOfTransforms() const {
+      return _transform_actors.size();
+    }
+
+    ActorId GetTransformActor(size_t index) const {
+      return _transform_actors[index];
+    }
+
+    const Transform &GetTransform(size_t index) const {
+      return _transforms[index];
+    }
+
+    /// @}
+    // =========================================================================
+    /// @name Binary encoding
+    // =========================================================================
+    /// @{
+
+    /// Size in bytes of the encoded batch.
+    size_t GetEncodedSize() const {
+      return 2u * sizeof(uint32_t) +
+          GetNumberOfControls() * ControlSize +
+          GetNumberOfTransforms() * TransformSize;
+    }
+
+    /// Call `write(const unsigned char *data, size_t size)` for each chunk of
+    /// the encoded batch, in order. The chunks add up to GetEncodedSize().
+    template <typename WriterT>
+    void Encode(WriterT &&write) const {
+      const uint32_t header[2u] = {
+          static_cast<uint32_t>(GetNumberOfControls()),
+          static_cast<uint32_t>(GetNumberOfTransforms())};
+      write(reinterpret_cast<const unsigned char *>(header), sizeof(header));
+      WriteColumn(write, _control_actors);
+      WriteColumn(write, _throttle);
+      WriteColumn(write, _steer);
+      WriteColumn(write, _brake);
+      WriteColumn(write, _gear);
+      WriteColumn(write, _flags);
+      WriteColumn(write, _transform_actors);
+      WriteColumn(write, _transforms);
+    }
+
+    /// Replace the contents of this batch by the batch encoded in @a data.
+    ///
+    /// @throw std::invalid_argument if @a size does not match the encoded
+    /// size.
+    void Decode(const unsigned char *data, size_t size) {
+      uint32_t header[2u] = {0u, 0u};
+      if (size >= sizeof(header)) {
+        std::memcpy(header, data, sizeof(header));
+      }
+      const size_t expected_size = sizeof(header) +
+          size_t(header[0u]) * ControlSize +
+          size_t(header[1u]) * TransformSize;
+      if ((size < sizeof(header)) || (size != expected_size)) {
+        throw_exception(std::invalid_argument("VehicleControlBatch: invalid encoded size"));
+        return;
+      }
+      data += sizeof(header);
+      ReadColumn(data, header[0u], _control_actors);
+      ReadColumn(data, header[0u], _throttle);
+      ReadColumn(data, header[0u], _steer);
+      ReadColumn(data, header[0u], _brake);
+      ReadColumn(data, header[0u], _gear);
+      ReadColumn(data, header[0u], _flags);
+      ReadColumn(data, header[1u], _transform_actors);
+      ReadColumn(data, header[1u], _transforms);
+    }
+
+    /// @}
+
+    template <typename PackerT>
+    void msgpack_pack(PackerT &packer) const {
+      packer.pack_bin(static_cast<uint32_t>(GetEncodedSize()));
+      Encode([&](const unsigned char *data, size_t size) {
+        packer.pack_bin_body(reinterpret_cast<const char *>(data), static_cast<uint32_t>(size));
+      });
+    }
+
+    void msgpack_unpack(const clmdep_msgpack::object &object) {
+      if (object.type != clmdep_msgpack::type::BIN) {
+        throw_exception(clmdep_msgpack::type_error());
+        return;
+      }
+      Decode(
+          reinterpret_cast<const unsigned char *>(object.via.bin.ptr),
+          object.via.bin.size);
+    }
+
+  private:
+
+    enum Flags : uint8_t {
+      HandBrake       = 1u << 0u,
+      Reverse         = 1u << 1u,
+      ManualGearShift = 1u << 2u
+    };
+
+    static_assert(std::is_trivially_copyable<Transform>::value, "Transform must be memcpy-able");
+
+    static constexpr size_t ControlSize =
+        sizeof(ActorId) + 3u * sizeof(float) + sizeof(int32_t) + sizeof(uint8_t);
+
+    static constexpr size_t TransformSize = sizeof(ActorId) + sizeof(Transform);
+
+    template <typename WriterT, typename T>
+    static void WriteColumn(WriterT &write, const std::vector<T> &column) {
+      if (!column.empty()) {
+        write(reinterpret_cast<const unsigned char *>(column.data()), sizeof(T) * column.size());
+      }
+    }
+
+    template <typename T>
+    static void ReadColumn(const unsigned char *&data, size_t count, std::vector<T> &column) {
+      column.resize(count);
+      if (count > 0u) {
+        std::memcpy(column.data(), data, sizeof(T) * count);
+      }
+      data += sizeof(T) * count;
+    }
+
+    std::vector<ActorId> _control_actors;
+
+    std::vector<float> _throttle;
+
+    std::vector<float> _steer;
+
+    std::vector<float> _brake;
+
+    std::vector<int32_t> _gear;
+
+    std::vector<uint8_t> _flags;
+
+    std::vector<ActorId> _transform_actors;
+
+    std::vector<Transform> _transforms;
+  };
+
+} // namespace rpc
+} // namespace carla
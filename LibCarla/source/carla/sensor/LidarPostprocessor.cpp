@@ -0,0 +1,146 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/sensor/LidarPostprocessor.h"
+
+#include "carla/Exception.h"
+#include "carla/ParallelFor.h"
+#include "carla/geom/Math.h"
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+namespace carla {
+namespace sensor {
+
+  /// Below this number of points per thread it is not worth to split the
+  /// channels among threads.
+  static constexpr size_t MIN_POINTS_PER_THREAD = 4096u;
+
+  void LidarPostprocessor::Process(
+      const std::vector<std::vector<geom::Location>> &hits,
+      data::LidarData &data) {
+    if (hits.size() != data.GetChannelCount()) {
+      throw_exception(std::invalid_argument("lidar hits do not match the number of channels"));
+    }
+    std::vector<std::vector<data::LidarDetection>> detections;
+    Process(hits, detections);
+
+    std::vector<uint32_t> points_per_channel(detections.size());
+    for (size_t channel = 0u; channel < detections.size(); ++channel) {
+      points_per_channel[channel] = static_cast<uint32_t>(detections[channel].size());
+    }
+    data.ResetMemory(points_per_channel);
+    for (size_t channel = 0u; channel < points_per_channel.size(); ++channel) {
+      for (auto &detection : detections[channel]) {
+        data.WritePointSync(detection);
+      }
+    }
+    data.WriteChannelCount(points_per_channel);
+  }
+
+  void LidarPostprocessor::Process(
+      const std::vector<std::vector<geom::Location>> &hits,
+      std::vector<std::vector<data::LidarDetection>> &detections) {
+    const uint64_t call = _number_of_calls++;
+    size_t total_points = 0u;
+    for (const auto &channel_hits : hits) {
+      total_points += channel_hits.size();
+    }
+    detections.resize(hits.size());
+    ParallelFor(
+        hits.size(),
+        ParallelChunkCount(total_points, MIN_POINTS_PER_THREAD),
+        [&](size_t, size_t begin, size_t end) {
+      for (size_t channel = begin; channel < end; ++channel) {
+        ProcessChannel(call, channel, hits[channel], detections[channel]);
+      }
+    });
+  }
+
+  void LidarPostprocessor::ProcessChannel(
+      const uint64_t call,
+      const size_t channel,
+      const std::vector<geom::Location> &hits,
+      std::vector<data::LidarDetection> &detections) const {
+    const auto &p = _parameters;
+    const size_t size = hits.size();
+    detections.clear();
+    detections.reserve(size);
+
+    // Distances and intensities, without branches so it vectorizes.
+    std::vector<float> distances(size);
+    std::vector<float> intensities(size);
+    for (size_t i = 0u; i < size; ++i) {
+      const auto &hit = hits[i];
+      distances[i] = std::sqrt(hit.x * hit.x + hit.y * hit.y + hit.z * hit.z);
+    }
+    for (size_t i = 0u; i < size; ++i) {
+      intensities[i] = std::exp(-p.atmosphere_attenuation_rate * distances[i]);
+    }
+
+    std::seed_seq seed{
+        static_cast<uint32_t>(_seed),
+        static_cast<uint32_t>(_seed >> 32u),
+        static_cast<uint32_t>(call),
+        static_cast<uint32_t>(call >> 32u),
+        static_cast<uint32_t>(channel)};
+    std::mt19937 random_engine(seed);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+    std::normal_distribution<float> normal(0.0f, std::max(p.noise_stddev, 0.0f));
+
+    const bool has_general_dropoff = p.dropoff_general_rate > std::numeric_limits<float>::epsilon();
+    const bool has_noise = p.noise_stddev > std::numeric_limits<float>::epsilon();
+    const bool check_horizontal_fov = p.horizontal_fov < 360.0f;
+    const bool check_vertical_fov = (p.upper_fov < 90.0f) || (p.lower_fov > -90.0f);
+    // A point is kept with probability alpha * intensity + beta.
+    const float dropoff_beta = 1.0f - p.dropoff_zero_intensity;
+    const float dropoff_alpha = p.dropoff_intensity_limit > 0.0f ?
+        p.dropoff_zero_intensity / p.dropoff_intensity_limit :
+        0.0f;
+    const float half_horizontal_fov = 0.5f * p.horizontal_fov;
+
+    for (size_t i = 0u; i < size; ++i) {
+      if (has_general_dropoff && uniform(random_engine) < p.dropoff_general_rate) {
+        continue;
+      }
+      geom::Location point = hits[i];
+      float distance = distances[i];
+      const float intensity = intensities[i];
+
+      // Noise along the ray.
+      if (has_noise && distance > 0.0f) {
+        const float noise = normal(random_engine);
+        point += point * (noise / distance);
+        distance += noise;
+      }
+
+      if ((intensity <= p.dropoff_intensity_limit) &&
+          (uniform(random_engine) >= dropoff_alpha * intensity + dropoff_beta)) {
+        continue;
+      }
+
+      if ((distance < p.min_range) || (distance > p.max_range)) {
+        continue;
+      }
+      if (check_horizontal_fov &&
+          std::abs(geom::Math::ToDegrees(std::atan2(point.y, point.x))) > half_horizontal_fov) {
+        continue;
+      }
+      if (check_vertical_fov) {
+        const float pitch = geom::Math::ToDegrees(
+            std::atan2(point.z, std::sqrt(point.x * point.x + point.y * point.y)));
+        if ((pitch > p.upper_fov) || (pitch < p.lower_fov)) {
+          continue;
+        }
+      }
+      detections.emplace_back(point, intensity);
+    }
+  }
+
+} // namespace sensor
+} // namespace carla
@@ -0,0 +1,113 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/geom/Location.h"
+#include "carla/sensor/data/LidarData.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace carla {
+namespace sensor {
+
+  /// Turns the raw hits of a ray-cast lidar into its measurement: computes
+  /// the intensity of each point, drops points randomly, adds noise along
+  /// the ray and culls the points out of range or field of view.
+  ///
+  /// Channels are processed in parallel, each with its own random generator
+  /// seeded from the seed, the number of calls and the channel, so results
+  /// do not depend on the number of threads. Distances and intensities are
+  /// computed in a separate pass over contiguous arrays so the compiler can
+  /// vectorize it.
+  class LidarPostprocessor {
+  public:
+
+    struct Parameters {
+      /// Attenuation rate in the atmosphere [1/meters].
+      float atmosphere_attenuation_rate = 0.004f;
+
+      /// Probability of dropping any point. Can be left at zero if rays are
+      /// already dropped before casting them.
+      float dropoff_general_rate = 0.0f;
+
+      /// Points with a higher intensity are never dropped.
+      float dropoff_intensity_limit = 0.8f;
+
+      /// Probability of dropping a point of zero intensity; it decreases
+      /// linearly up to dropoff_intensity_limit.
+      float dropoff_zero_intensity = 0.4f;
+
+      /// Standard deviation of the noise along the ray [meters].
+      float noise_stddev = 0.0f;
+
+      /// Points closer or farther are culled [meters].
+      float min_range = 0.0f;
+
+      float max_range = std::numeric_limits<float>::infinity();
+
+      /// Horizontal field of view centered on the X axis [degrees].
+      float horizontal_fov = 360.0f;
+
+      /// Vertical angles above the horizontal plane, points out of them are
+      /// culled [degrees].
+      float upper_fov = 90.0f;
+
+      float lower_fov = -90.0f;
+    };
+
+    LidarPostprocessor() = default;
+
+    explicit LidarPostprocessor(Parameters parameters, uint64_t seed = 0u)
+      : _parameters(parameters),
+        _seed(seed) {}
+
+    const Parameters &GetParameters() const {
+      return _parameters;
+    }
+
+    void SetParameters(const Parameters &parameters) {
+      _parameters = parameters;
+    }
+
+    void SetSeed(uint64_t seed) {
+      _seed = seed;
+      _number_of_calls = 0u;
+    }
+
+    /// Process @a hits, the points hit by each channel in the sensor's frame
+    /// [meters], and write the resulting detections and the number of points
+    /// of each channel to @a data.
+    ///
+    /// @throw std::invalid_argument if @a hits does not have one element per
+    /// channel of @a data.
+    void Process(const std::vector<std::vector<geom::Location>> &hits, data::LidarData &data);
+
+    /// Same as Process, writing the detections of each channel to @a
+    /// detections instead.
+    void Process(
+        const std::vector<std::vector<geom::Location>> &hits,
+        std::vector<std::vector<data::LidarDetection>> &detections);
+
+  private:
+
+    void ProcessChannel(
+        uint64_t call,
+        size_t channel,
+        const std::vector<geom::Location> &hits,
+        std::vector<data::LidarDetection> &detections) const;
+
+    Parameters _parameters;
+
+    uint64_t _seed = 0u;
+
+    uint64_t _number_of_calls = 0u;
+  };
+
+} // namespace sensor
+} // namespace carla
@@ -12,6 +12,7 @@
 #include "carla/rpc/ActorState.h"
 #include "carla/rpc/VehicleFailureState.h"
 #include "carla/rpc/TrafficLightState.h"
+#include "carla/rpc/VehicleLightState.h"
 #include "carla/rpc/VehicleControl.h"
 #include "carla/rpc/WalkerControl.h"
 
@@ -65,6 +66,7 @@ namespace detail {
     bool has_traffic_light;
     rpc::ActorId traffic_light_id;
     rpc::VehicleFailureState failure_state;
+    rpc::VehicleLightState::flag_type light_state;
   };
 #pragma pack(pop)
 
@@ -11,6 +11,8 @@
 #include "carla/sensor/data/Array.h"
 #include "carla/sensor/s11n/EpisodeStateSerializer.h"
 
+#include <boost/optional.hpp>
+
 namespace carla {
 namespace sensor {
 namespace data {
@@ -66,6 +68,15 @@ namespace data {
       return GetHeader().simulation_state;
     }
 
+    /// Weather at this frame, if the simulator sent it.
+    boost::optional<rpc::WeatherParameters> GetWeather() const {
+      const auto header = GetHeader();
+      if ((header.simulation_state & Serializer::SimulationState::HasWeather) == 0) {
+        return boost::none;
+      }
+      return header.weather;
+    }
+
   };
 
 } // namespace data
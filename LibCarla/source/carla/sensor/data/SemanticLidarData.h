@@ -71,6 +71,13 @@ namespace data {
            "property uint32 ObjTag";
       }
 
+      void WritePcdHeaderInfo(std::ostream& out) const{
+        out << "FIELDS x y z cos_angle object_idx object_tag\n" \
+           "SIZE 4 4 4 4 4 4\n" \
+           "TYPE F F F F U U\n" \
+           "COUNT 1 1 1 1 1 1";
+      }
+
       void WriteDetection(std::ostream& out) const{
         out << point.x << ' ' << point.y << ' ' << point.z << ' ' \
           << cos_inc_angle << ' ' << object_idx << ' ' << object_tag;
@@ -111,7 +118,7 @@ namespace data {
     }
 
     virtual void ResetMemory(std::vector<uint32_t> points_per_channel) {
-      DEBUG_ASSERT(GetChannelCount() > points_per_channel.size());
+      DEBUG_ASSERT(GetChannelCount() >= points_per_channel.size());
       std::memset(_header.data() + Index::SIZE, 0, sizeof(uint32_t) * GetChannelCount());
 
       uint32_t total_points = static_cast<uint32_t>(
@@ -11,6 +11,7 @@
 #include "carla/Memory.h"
 #include "carla/geom/Transform.h"
 #include "carla/geom/Vector3DInt.h"
+#include "carla/rpc/WeatherParameters.h"
 #include "carla/sensor/RawData.h"
 #include "carla/sensor/data/ActorDynamicState.h"
 
@@ -30,7 +31,9 @@ namespace s11n {
     enum SimulationState {
       None               = (0x0 << 0),
       MapChange          = (0x1 << 0),
-      PendingLightUpdate = (0x1 << 1)
+      PendingLightUpdate = (0x1 << 1),
+      /// The header carries the current weather.
+      HasWeather         = (0x1 << 2)
     };
 
 #pragma pack(push, 1)
@@ -40,6 +43,7 @@ namespace s11n {
       float delta_seconds;
       geom::Vector3DInt map_origin;
       SimulationState simulation_state = SimulationState::None;
+      rpc::WeatherParameters weather;
     };
 #pragma pack(pop)
 
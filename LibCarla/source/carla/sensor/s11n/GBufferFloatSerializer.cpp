@@ -13,6 +13,7 @@ namespace sensor {
 namespace s11n {
 
   SharedPtr<SensorData> GBufferFloatSerializer::Deserialize(RawData &&data) {
+    ImageCompression::Decompress(data, header_offset, sizeof(rpc::FloatColor));
     auto image = SharedPtr<data::FloatImage>(new data::FloatImage{std::move(data)});
     return image;
   }
@@ -8,6 +8,8 @@
 
 #include "carla/Memory.h"
 #include "carla/sensor/RawData.h"
+#include "carla/sensor/data/Color.h"
+#include "carla/sensor/s11n/ImageCompression.h"
 
 #include <cstdint>
 #include <cstring>
@@ -39,14 +41,16 @@ namespace s11n {
 
     template <typename Sensor>
     static Buffer Serialize(const Sensor &sensor, Buffer &&bitmap, 
-        uint32_t ImageWidth, uint32_t ImageHeight, float FovAngle);
+        uint32_t ImageWidth, uint32_t ImageHeight, float FovAngle,
+        ImageCodec Codec = ImageCodec::None);
 
     static SharedPtr<SensorData> Deserialize(RawData &&data);
   };
 
   template <typename Sensor>
   inline Buffer GBufferFloatSerializer::Serialize(const Sensor &/*sensor*/, Buffer &&bitmap, 
-      uint32_t ImageWidth, uint32_t ImageHeight, float FovAngle) {
+      uint32_t ImageWidth, uint32_t ImageHeight, float FovAngle,
+      ImageCodec Codec) {
     DEBUG_ASSERT(bitmap.size() > sizeof(ImageHeader));
     ImageHeader header = {
       ImageWidth,
@@ -54,7 +58,7 @@ namespace s11n {
       FovAngle
     };
     std::memcpy(bitmap.data(), reinterpret_cast<const void *>(&header), sizeof(header));
-    return std::move(bitmap);
+    return ImageCompression::Compress(Codec, header_offset, sizeof(rpc::FloatColor), std::move(bitmap));
   }
 
 } // namespace s11n
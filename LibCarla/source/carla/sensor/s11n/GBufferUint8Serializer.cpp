@@ -13,6 +13,7 @@ namespace sensor {
 namespace s11n {
 
   SharedPtr<SensorData> GBufferUint8Serializer::Deserialize(RawData &&data) {
+    ImageCompression::Decompress(data, header_offset, sizeof(data::Color));
     auto image = SharedPtr<data::Image>(new data::Image{std::move(data)});
     return image;
   }
@@ -0,0 +1,575 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "carla/sensor/s11n/ImageCompression.h"
+
+#include "carla/BufferPool.h"
+#include "carla/Debug.h"
+#include "carla/Exception.h"
+#include "carla/StringUtil.h"
+#include "carla/ThreadPool.h"
+#include "carla/sensor/RawData.h"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace carla {
+namespace sensor {
+namespace s11n {
+
+  // ===========================================================================
+  // -- Static local methods ---------------------------------------------------
+  // ===========================================================================
+
+  /// Images are split in bands of at least this size to compress them in
+  /// parallel.
+  static constexpr size_t MinBandSize = 256u * 1024u;
+
+  [[ noreturn ]] static void ThrowCorrupted() {
+    throw_exception(std::runtime_error("corrupted compressed image"));
+  }
+
+  static uint32_t ReadWord(const unsigned char *data) {
+    uint32_t word;
+    std::memcpy(&word, data, sizeof(word));
+    return word;
+  }
+
+  static void WriteWord(unsigned char *data, uint32_t word) {
+    std::memcpy(data, &word, sizeof(word));
+  }
+
+  /// Worker threads shared by every stream compressing or decompressing
+  /// images in this process.
+  class CompressionWorkers {
+  public:
+
+    CompressionWorkers()
+      : _number_of_threads(std::max(1u, std::thread::hardware_concurrency() / 2u)) {
+      _pool.AsyncRun(_number_of_threads);
+    }
+
+    static CompressionWorkers &Get() {
+      static CompressionWorkers workers;
+      return workers;
+    }
+
+    size_t GetNumberOfThreads() const {
+      return _number_of_threads;
+    }
+
+    /// Call `functor(band)` for every band, the first one in the calling
+    /// thread. Blocks until all of them finish.
+    template <typename FunctorT>
+    void ForEachBand(size_t band_count, FunctorT &&functor) {
+      std::vector<std::future<void>> results;
+      results.reserve(band_count);
+      for (size_t band = 1u; band < band_count; ++band) {
+        results.emplace_back(_pool.Post([&functor, band]() { functor(band); }));
+      }
+#ifndef LIBCARLA_NO_EXCEPTIONS
+      std::exception_ptr error;
+      try {
+        functor(0u);
+      } catch (...) {
+        error = std::current_exception();
+      }
+#else
+      functor(0u);
+#endif // LIBCARLA_NO_EXCEPTIONS
+      // Every task references the functor, wait for all of them before any
+      // exception leaves this scope.
+      for (auto &result : results) {
+        result.wait();
+      }
+#ifndef LIBCARLA_NO_EXCEPTIONS
+      if (error) {
+        std::rethrow_exception(error);
+      }
+#endif // LIBCARLA_NO_EXCEPTIONS
+      for (auto &result : results) {
+        result.get();
+      }
+    }
+
+  private:
+
+    const size_t _number_of_threads;
+
+    ThreadPool _pool;
+  };
+
+  /// First byte of the band @a band when @a size bytes of pixels of
+  /// @a bytes_per_pixel are split in @a band_count bands.
+  static size_t BandBegin(size_t band, size_t band_count, size_t size, size_t bytes_per_pixel) {
+    const size_t pixels = size / bytes_per_pixel;
+    return ((band * pixels) / band_count) * bytes_per_pixel;
+  }
+
+  // ===========================================================================
+  // -- Run-length encoding ----------------------------------------------------
+  // ===========================================================================
+
+  // Encoded as a sequence of (run length as a varint, pixel).
+
+  static size_t EncodeRLE(
+      const size_t bytes_per_pixel,
+      const unsigned char *source,
+      const size_t size,
+      unsigned char *destination,
+      const size_t capacity) {
+    unsigned char *out = destination;
+    unsigned char *const out_end = destination + capacity;
+    for (size_t i = 0u; i < size;) {
+      const unsigned char *pixel = source + i;
+      size_t run = 1u;
+      i += bytes_per_pixel;
+      while ((i < size) && (std::memcmp(pixel, source + i, bytes_per_pixel) == 0)) {
+        ++run;
+        i += bytes_per_pixel;
+      }
+      // At most 10 bytes for the varint.
+      if (static_cast<size_t>(out_end - out) < 10u + bytes_per_pixel) {
+        return 0u;
+      }
+      while (run >= 0x80u) {
+        *out++ = static_cast<unsigned char>(run | 0x80u);
+        run >>= 7u;
+      }
+      *out++ = static_cast<unsigned char>(run);
+      std::memcpy(out, pixel, bytes_per_pixel);
+      out += bytes_per_pixel;
+    }
+    return static_cast<size_t>(out - destination);
+  }
+
+  static void DecodeRLE(
+      const size_t bytes_per_pixel,
+      const unsigned char *source,
+      const size_t size,
+      unsigned char *destination,
+      const size_t decoded_size) {
+    const unsigned char *in = source;
+    const unsigned char *const in_end = source + size;
+    unsigned char *out = destination;
+    unsigned char *const out_end = destination + decoded_size;
+    while (in < in_end) {
+      size_t run = 0u;
+      for (unsigned shift = 0u;; shift += 7u) {
+        if ((in == in_end) || (shift > 63u)) {
+          ThrowCorrupted();
+        }
+        const unsigned char byte = *in++;
+        run |= static_cast<size_t>(byte & 0x7Fu) << shift;
+        if ((byte & 0x80u) == 0u) {
+          break;
+        }
+      }
+      if ((static_cast<size_t>(in_end - in) < bytes_per_pixel) ||
+          (run > static_cast<size_t>(out_end - out) / bytes_per_pixel)) {
+        ThrowCorrupted();
+      }
+      for (size_t i = 0u; i < run; ++i) {
+        std::memcpy(out, in, bytes_per_pixel);
+        out += bytes_per_pixel;
+      }
+      in += bytes_per_pixel;
+    }
+    if (out != out_end) {
+      ThrowCorrupted();
+    }
+  }
+
+  // ===========================================================================
+  // -- LZ4 --------------------------------------------------------------------
+  // ===========================================================================
+
+  // Implements the LZ4 block format, so the data can be decoded with any LZ4
+  // implementation too.
+
+  static constexpr size_t LZ4MinMatch = 4u;
+  static constexpr size_t LZ4LastLiterals = 5u;
+  static constexpr size_t LZ4MatchFindLimit = 12u;
+  static constexpr size_t LZ4MaxOffset = 65535u;
+  static constexpr unsigned LZ4HashLog = 14u;
+
+  static uint32_t LZ4Hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32u - LZ4HashLog);
+  }
+
+  /// Write the extra bytes of a length that did not fit in the token.
+  static unsigned char *LZ4WriteLength(unsigned char *out, size_t length) {
+    while (length >= 255u) {
+      *out++ = 255u;
+      length -= 255u;
+    }
+    *out++ = static_cast<unsigned char>(length);
+    return out;
+  }
+
+  static size_t EncodeLZ4(
+      const unsigned char *source,
+      const size_t size,
+      unsigned char *destination,
+      const size_t capacity) {
+    std::vector<uint32_t> table(size_t(1u) << LZ4HashLog, 0u);
+    unsigned char *out = destination;
+    unsigned char *const out_end = destination + capacity;
+    size_t anchor = 0u;
+
+    auto write_sequence = [&](size_t literals, size_t match_length, size_t offset) {
+      // Token, literals, and the worst case for both lengths and the offset.
+      const size_t worst_case = 1u + literals + (literals / 255u) + 1u + 2u + (match_length / 255u) + 1u;
+      if (static_cast<size_t>(out_end - out) < worst_case) {
+        return false;
+      }
+      unsigned char *token = out++;
+      *token = static_cast<unsigned char>(std::min<size_t>(literals, 15u) << 4u);
+      if (literals >= 15u) {
+        out = LZ4WriteLength(out, literals - 15u);
+      }
+      std::memcpy(out, source + anchor, literals);
+      out += literals;
+      if (match_length > 0u) {
+        *out++ = static_cast<unsigned char>(offset & 0xFFu);
+        *out++ = static_cast<unsigned char>(offset >> 8u);
+        const size_t length = match_length - LZ4MinMatch;
+        *token |= static_cast<unsigned char>(std::min<size_t>(length, 15u));
+        if (length >= 15u) {
+          out = LZ4WriteLength(out, length - 15u);
+        }
+      }
+      return true;
+    };
+
+    if (size > LZ4MatchFindLimit) {
+      const size_t match_start_limit = size - LZ4MatchFindLimit;
+      const size_t match_end_limit = size - LZ4LastLiterals;
+      size_t position = 0u;
+      size_t misses = 0u;
+      while (position < match_start_limit) {
+        const uint32_t sequence = ReadWord(source + position);
+        uint32_t &entry = table[LZ4Hash(sequence)];
+        const size_t candidate = entry;
+        entry = static_cast<uint32_t>(position);
+        if ((candidate < position) &&
+            (position - candidate <= LZ4MaxOffset) &&
+            (ReadWord(source + candidate) == sequence)) {
+          size_t length = LZ4MinMatch;
+          while ((position + length < match_end_limit) &&
+                 (source[candidate + length] == source[position + length])) {
+            ++length;
+          }
+          if (!write_sequence(position - anchor, length, position - candidate)) {
+            return 0u;
+          }
+          position += length;
+          anchor = position;
+          misses = 0u;
+        } else {
+          // Skip faster over data that does not compress.
+          position += 1u + (misses++ >> 6u);
+        }
+      }
+    }
+    if (!write_sequence(size - anchor, 0u, 0u)) {
+      return 0u;
+    }
+    return static_cast<size_t>(out - destination);
+  }
+
+  static size_t LZ4ReadLength(const unsigned char *&in, const unsigned char *in_end) {
+    size_t length = 0u;
+    unsigned char byte;
+    do {
+      if (in == in_end) {
+        ThrowCorrupted();
+      }
+      byte = *in++;
+      length += byte;
+    } while (byte == 255u);
+    return length;
+  }
+
+  static void DecodeLZ4(
+      const unsigned char *source,
+      const size_t size,
+      unsigned char *destination,
+      const size_t decoded_size) {
+    const unsigned char *in = source;
+    const unsigned char *const in_end = source + size;
+    unsigned char *out = destination;
+    unsigned char *const out_end = destination + decoded_size;
+    for (;;) {
+      if (in == in_end) {
+        ThrowCorrupted();
+      }
+      const unsigned char token = *in++;
+      size_t literals = token >> 4u;
+      if (literals == 15u) {
+        literals += LZ4ReadLength(in, in_end);
+      }
+      if ((literals > static_cast<size_t>(in_end - in)) ||
+          (literals > static_cast<size_t>(out_end - out))) {
+        ThrowCorrupted();
+      }
+      std::memcpy(out, in, literals);
+      in += literals;
+      out += literals;
+      if (in == in_end) {
+        // The last sequence has only literals.
+        break;
+      }
+      if (in_end - in < 2) {
+        ThrowCorrupted();
+      }
+      const size_t offset = static_cast<size_t>(in[0u]) | (static_cast<size_t>(in[1u]) << 8u);
+      in += 2u;
+      size_t length = token & 0x0Fu;
+      if (length == 15u) {
+        length += LZ4ReadLength(in, in_end);
+      }
+      length += LZ4MinMatch;
+      if ((offset == 0u) ||
+          (offset > static_cast<size_t>(out - destination)) ||
+          (length > static_cast<size_t>(out_end - out))) {
+        ThrowCorrupted();
+      }
+      // Matches may overlap with the bytes being written.
+      const unsigned char *match = out - offset;
+      for (size_t i = 0u; i < length; ++i) {
+        out[i] = match[i];
+      }
+      out += length;
+    }
+    if (out != out_end) {
+      ThrowCorrupted();
+    }
+  }
+
+  // ===========================================================================
+  // -- XOR delta --------------------------------------------------------------
+  // ===========================================================================
+
+  static void XorWithPreviousPixel(
+      const size_t bytes_per_pixel,
+      const unsigned char *source,
+      const size_t size,
+      unsigned char *destination) {
+    std::memcpy(destination, source, std::min(size, bytes_per_pixel));
+    for (size_t i = bytes_per_pixel; i + sizeof(uint32_t) <= size; i += sizeof(uint32_t)) {
+      WriteWord(destination + i, ReadWord(source + i) ^ ReadWord(source + i - bytes_per_pixel));
+    }
+  }
+
+  static void UndoXorWithPreviousPixel(
+      const size_t bytes_per_pixel,
+      unsigned char *data,
+      const size_t size) {
+    for (size_t i = bytes_per_pixel; i + sizeof(uint32_t) <= size; i += sizeof(uint32_t)) {
+      WriteWord(data + i, ReadWord(data + i) ^ ReadWord(data + i - bytes_per_pixel));
+    }
+  }
+
+  // ===========================================================================
+  // -- ImageCompression -------------------------------------------------------
+  // ===========================================================================
+
+  ImageCodec ImageCompression::CodecFromString(const std::string &name) {
+    auto lower = name;
+    StringUtil::ToLower(lower);
+    if (lower.empty() || (lower == "none")) {
+      return ImageCodec::None;
+    } else if (lower == "rle") {
+      return ImageCodec::RLE;
+    } else if (lower == "lz4") {
+      return ImageCodec::LZ4;
+    } else if (lower == "delta") {
+      return ImageCodec::DeltaLZ4;
+    }
+    throw_exception(std::invalid_argument("unknown image compression '" + name + "'"));
+  }
+
+  size_t ImageCompression::Encode(
+      const ImageCodec codec,
+      const size_t bytes_per_pixel,
+      const unsigned char *source,
+      const size_t size,
+      unsigned char *destination,
+      const size_t capacity) {
+    DEBUG_ASSERT(bytes_per_pixel > 0u);
+    switch (codec) {
+      case ImageCodec::RLE:
+        return EncodeRLE(bytes_per_pixel, source, size, destination, capacity);
+      case ImageCodec::LZ4:
+        return EncodeLZ4(source, size, destination, capacity);
+      case ImageCodec::DeltaLZ4: {
+        DEBUG_ASSERT(bytes_per_pixel % sizeof(uint32_t) == 0u);
+        Buffer delta = BufferPool::GetDefault()->Pop(size);
+        delta.reset(size);
+        XorWithPreviousPixel(bytes_per_pixel, source, size, delta.data());
+        return EncodeLZ4(delta.data(), size, destination, capacity);
+      }
+      default:
+        return 0u;
+    }
+  }
+
+  void ImageCompression::Decode(
+      const ImageCodec codec,
+      const size_t bytes_per_pixel,
+      const unsigned char *source,
+      const size_t size,
+      unsigned char *destination,
+      const size_t decoded_size) {
+    DEBUG_ASSERT(bytes_per_pixel > 0u);
+    switch (codec) {
+      case ImageCodec::RLE:
+        DecodeRLE(bytes_per_pixel, source, size, destination, decoded_size);
+        break;
+      case ImageCodec::LZ4:
+        DecodeLZ4(source, size, destination, decoded_size);
+        break;
+      case ImageCodec::DeltaLZ4:
+        DecodeLZ4(source, size, destination, decoded_size);
+        UndoXorWithPreviousPixel(bytes_per_pixel, destination, decoded_size);
+        break;
+      default:
+        ThrowCorrupted();
+    }
+  }
+
+  Buffer ImageCompression::Compress(
+      const ImageCodec codec,
+      const size_t header_offset,
+      const size_t bytes_per_pixel,
+      Buffer &&bitmap) {
+    if ((codec == ImageCodec::None) ||
+        (bitmap.size() <= header_offset) ||
+        ((bitmap.size() - header_offset) % bytes_per_pixel != 0u) ||
+        ((codec == ImageCodec::DeltaLZ4) && (bytes_per_pixel % sizeof(uint32_t) != 0u))) {
+      return std::move(bitmap);
+    }
+    const unsigned char *pixels = bitmap.data() + header_offset;
+    const size_t size = bitmap.size() - header_offset;
+
+    auto &workers = CompressionWorkers::Get();
+    const size_t band_count = std::max<size_t>(1u, std::min({
+        size / MinBandSize,
+        workers.GetNumberOfThreads() + 1u,
+        size_t(255u)}));
+    const size_t table_size = sizeof(Header) + band_count * sizeof(uint32_t);
+    if (header_offset + table_size >= bitmap.size()) {
+      return std::move(bitmap);
+    }
+
+    // Every band must fit in the space left by the raw image, otherwise it is
+    // not worth compressing.
+    const size_t capacity = size - table_size;
+    std::vector<Buffer> bands(band_count);
+    std::vector<size_t> band_sizes(band_count, 0u);
+    workers.ForEachBand(band_count, [&](size_t band) {
+      const size_t begin = BandBegin(band, band_count, size, bytes_per_pixel);
+      const size_t end = BandBegin(band + 1u, band_count, size, bytes_per_pixel);
+      bands[band] = BufferPool::GetDefault()->Pop(capacity);
+      bands[band].reset(capacity);
+      band_sizes[band] = Encode(
+          codec, bytes_per_pixel, pixels + begin, end - begin, bands[band].data(), capacity);
+    });
+
+    size_t total = table_size;
+    for (auto band_size : band_sizes) {
+      if (band_size == 0u) {
+        return std::move(bitmap);
+      }
+      total += band_size;
+    }
+    if (total >= size) {
+      return std::move(bitmap);
+    }
+
+    Buffer result = BufferPool::GetDefault()->Pop(header_offset + total);
+    result.reset(header_offset + total);
+    unsigned char *out = result.data();
+    std::memcpy(out, bitmap.data(), header_offset);
+    out += header_offset;
+    const Header header = {static_cast<uint8_t>(codec), static_cast<uint8_t>(band_count), 0u};
+    std::memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+    for (auto band_size : band_sizes) {
+      WriteWord(out, static_cast<uint32_t>(band_size));
+      out += sizeof(uint32_t);
+    }
+    for (size_t band = 0u; band < band_count; ++band) {
+      std::memcpy(out, bands[band].data(), band_sizes[band]);
+      out += band_sizes[band];
+    }
+    return result;
+  }
+
+  void ImageCompression::Decompress(
+      RawData &data,
+      const size_t header_offset,
+      const size_t bytes_per_pixel) {
+    const size_t size = data.size();
+    if (size < header_offset) {
+      return;
+    }
+    const uint32_t width = ReadWord(data.begin());
+    const uint32_t height = ReadWord(data.begin() + sizeof(uint32_t));
+    const size_t decoded_size = size_t(width) * size_t(height) * bytes_per_pixel;
+    if (size - header_offset == decoded_size) {
+      // Not compressed.
+      return;
+    }
+
+    const unsigned char *in = data.begin() + header_offset;
+    const unsigned char *const in_end = data.end();
+    if (static_cast<size_t>(in_end - in) < sizeof(Header)) {
+      ThrowCorrupted();
+    }
+    Header header;
+    std::memcpy(&header, in, sizeof(header));
+    in += sizeof(header);
+    const size_t band_count = header.band_count;
+    if ((band_count == 0u) ||
+        (static_cast<size_t>(in_end - in) < band_count * sizeof(uint32_t))) {
+      ThrowCorrupted();
+    }
+    std::vector<const unsigned char *> band_data(band_count);
+    std::vector<size_t> band_sizes(band_count);
+    const unsigned char *band_begin = in + band_count * sizeof(uint32_t);
+    for (size_t band = 0u; band < band_count; ++band) {
+      band_sizes[band] = ReadWord(in + band * sizeof(uint32_t));
+      if (band_sizes[band] > static_cast<size_t>(in_end - band_begin)) {
+        ThrowCorrupted();
+      }
+      band_data[band] = band_begin;
+      band_begin += band_sizes[band];
+    }
+
+    const size_t prefix = SensorHeaderSerializer::header_offset + header_offset;
+    Buffer result = BufferPool::GetDefault()->Pop(prefix + decoded_size);
+    result.reset(prefix + decoded_size);
+    std::memcpy(result.data(), data._buffer.data(), prefix);
+    unsigned char *pixels = result.data() + prefix;
+    const auto codec = static_cast<ImageCodec>(header.codec);
+    CompressionWorkers::Get().ForEachBand(band_count, [&](size_t band) {
+      const size_t begin = BandBegin(band, band_count, decoded_size, bytes_per_pixel);
+      const size_t end = BandBegin(band + 1u, band_count, decoded_size, bytes_per_pixel);
+      Decode(codec, bytes_per_pixel, band_data[band], band_sizes[band], pixels + begin, end - begin);
+    });
+    data._buffer = std::move(result);
+  }
+
+} // namespace s11n
+} // namespace sensor
+} // namespace carla
@@ -0,0 +1,101 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include "carla/Buffer.h"
+
+#include <cstdint>
+#include <string>
+
+namespace carla {
+namespace sensor {
+
+  class RawData;
+
+namespace s11n {
+
+  /// Lossless codecs available to compress the images sent by camera sensors.
+  enum class ImageCodec : uint8_t {
+    None = 0u,
+    /// Run-length encoding of whole pixels. Best suited for images with large
+    /// areas of a single value, like semantic or instance segmentation.
+    RLE = 1u,
+    /// General purpose LZ4 block compression.
+    LZ4 = 2u,
+    /// Each 32-bit word is XOR-ed with the same word of the previous pixel
+    /// before LZ4, so smoothly varying data (depth, optical flow, float
+    /// G-buffers) leaves mostly zero bytes behind.
+    DeltaLZ4 = 3u
+  };
+
+  /// Compresses the image data of a serialized image in the server, and
+  /// restores it in the client before the image is constructed.
+  ///
+  /// An image is only sent compressed if that makes it smaller, a compressed
+  /// image is recognized in the client because its size does not match the
+  /// size given by its header. Big images are split in bands compressed in
+  /// parallel on a shared worker pool.
+  class ImageCompression {
+  public:
+
+#pragma pack(push, 1)
+    struct Header {
+      uint8_t codec;
+      uint8_t band_count;
+      uint16_t reserved;
+    };
+#pragma pack(pop)
+
+    /// Parse the value of the "compression" attribute of a camera: "none",
+    /// "rle", "lz4" or "delta".
+    static ImageCodec CodecFromString(const std::string &name);
+
+    /// Compress the pixels stored after the first @a header_offset bytes of
+    /// @a bitmap. If @a codec is ImageCodec::None or the data does not
+    /// compress, @a bitmap is returned as it is.
+    static Buffer Compress(
+        ImageCodec codec,
+        size_t header_offset,
+        size_t bytes_per_pixel,
+        Buffer &&bitmap);
+
+    /// If the image in @a data was compressed, replace it by the decompressed
+    /// image. The width and height are read from the first two 32-bit fields
+    /// of the image header.
+    static void Decompress(
+        RawData &data,
+        size_t header_offset,
+        size_t bytes_per_pixel);
+
+    /// Encode @a size bytes at @a source into @a destination, with at most
+    /// @a capacity bytes.
+    ///
+    /// @return the size of the encoded data, or zero if it does not fit.
+    static size_t Encode(
+        ImageCodec codec,
+        size_t bytes_per_pixel,
+        const unsigned char *source,
+        size_t size,
+        unsigned char *destination,
+        size_t capacity);
+
+    /// Decode @a size bytes at @a source into exactly @a decoded_size bytes
+    /// at @a destination.
+    ///
+    /// @throw std::runtime_error if the data is corrupted.
+    static void Decode(
+        ImageCodec codec,
+        size_t bytes_per_pixel,
+        const unsigned char *source,
+        size_t size,
+        unsigned char *destination,
+        size_t decoded_size);
+  };
+
+} // namespace s11n
+} // namespace sensor
+} // namespace carla
@@ -8,6 +8,8 @@
 
 #include "carla/Memory.h"
 #include "carla/sensor/RawData.h"
+#include "carla/sensor/data/Color.h"
+#include "carla/sensor/s11n/ImageCompression.h"
 
 #include <cstdint>
 #include <cstring>
@@ -52,7 +54,11 @@ namespace s11n {
       sensor.GetFOVAngle()
     };
     std::memcpy(bitmap.data(), reinterpret_cast<const void *>(&header), sizeof(header));
-    return std::move(bitmap);
+    return ImageCompression::Compress(
+        sensor.GetImageCodec(),
+        header_offset,
+        sizeof(data::Color),
+        std::move(bitmap));
   }
 
 } // namespace s11n
@@ -12,6 +12,7 @@ namespace carla {
     namespace s11n {
 
       SharedPtr<SensorData> NormalsImageSerializer::Deserialize(RawData &&data) {
+        ImageCompression::Decompress(data, header_offset, sizeof(data::Color));
         auto image = SharedPtr<data::NormalsImage>(new data::NormalsImage{std::move(data)});
         return image;
       }
@@ -12,6 +12,7 @@ namespace carla {
     namespace s11n {
 
       SharedPtr<SensorData> OpticalFlowImageSerializer::Deserialize(RawData &&data) {
+        ImageCompression::Decompress(data, header_offset, sizeof(data::OpticalFlowPixel));
         auto image = SharedPtr<data::OpticalFlowImage>(new data::OpticalFlowImage{std::move(data)});
         return image;
       }
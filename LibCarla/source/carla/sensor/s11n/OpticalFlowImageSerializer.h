@@ -6,6 +6,8 @@
 
 #include "carla/Memory.h"
 #include "carla/sensor/RawData.h"
+#include "carla/sensor/data/Color.h"
+#include "carla/sensor/s11n/ImageCompression.h"
 
 #include <cstdint>
 #include <cstring>
@@ -50,7 +52,11 @@ namespace carla {
             sensor.GetFOVAngle()
         };
         std::memcpy(bitmap.data(), reinterpret_cast<const void *>(&header), sizeof(header));
-        return std::move(bitmap);
+        return ImageCompression::Compress(
+            sensor.GetImageCodec(),
+            header_offset,
+            sizeof(data::OpticalFlowPixel),
+            std::move(bitmap));
       }
 
     } // namespace s11n
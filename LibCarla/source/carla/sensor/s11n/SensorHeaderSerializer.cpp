@@ -16,11 +16,6 @@ namespace s11n {
       SensorHeaderSerializer::header_offset == 3u * 8u + 6u * 4u,
       "Header size missmatch");
 
-  static Buffer PopBufferFromPool() {
-    static auto pool = std::make_shared<BufferPool>();
-    return pool->Pop();
-  }
-
   Buffer SensorHeaderSerializer::Serialize(
       const uint64_t index,
       const uint64_t frame,
@@ -31,7 +26,7 @@ namespace s11n {
     h.frame = frame;
     h.timestamp = timestamp;
     h.sensor_transform = transform;
-    auto buffer = PopBufferFromPool();
+    auto buffer = BufferPool::GetDefault()->Pop(sizeof(h));
     buffer.copy_from(reinterpret_cast<const unsigned char *>(&h), sizeof(h));
     return buffer;
   }
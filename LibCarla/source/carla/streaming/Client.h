@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include "carla/Debug.h"
 #include "carla/Logging.h"
+#include "carla/NonCopyable.h"
 #include "carla/ThreadPool.h"
 #include "carla/streaming/Token.h"
 #include "carla/streaming/detail/tcp/Client.h"
@@ -14,6 +16,10 @@
 
 #include <boost/asio/io_context.hpp>
 
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
 namespace carla {
 namespace streaming {
 
@@ -24,20 +30,40 @@ namespace streaming {
     using underlying_client = low_level::Client<detail::tcp::Client>;
   public:
 
-    Client() = default;
+    Client()
+      : _service(std::make_shared<ThreadPool>()) {}
 
     explicit Client(const std::string &fallback_address)
-      : _client(fallback_address) {}
+      : _service(std::make_shared<ThreadPool>()),
+        _client(fallback_address) {}
+
+    /// Run the streams in the io_context of @a service, which may be shared
+    /// with other clients and is run by its owner. Run and AsyncRun cannot be
+    /// called on this client.
+    Client(const std::string &fallback_address, std::shared_ptr<ThreadPool> service)
+      : _service(std::move(service)),
+        _is_service_shared(true),
+        _client(fallback_address) {
+      DEBUG_ASSERT(_service != nullptr);
+    }
 
     ~Client() {
-      _service.Stop();
+      Stop();
     }
 
     /// @warning cannot subscribe twice to the same stream (even if it's a
     /// MultiStream).
     template <typename Functor>
     void Subscribe(const Token &token, Functor &&callback) {
-      _client.Subscribe(_service.io_context(), token, std::forward<Functor>(callback));
+      _client.Subscribe(
+          _service->io_context(),
+          token,
+          [state=_callbacks, callback=std::forward<Functor>(callback)](Buffer message) mutable {
+        CallbackState::Scope scope(*state);
+        if (scope.IsOpen()) {
+          callback(std::move(message));
+        }
+      });
     }
 
     void UnSubscribe(const Token &token) {
@@ -45,18 +71,101 @@ namespace streaming {
     }
 
     void Run() {
-      _service.Run();
+      DEBUG_ASSERT(!_is_service_shared);
+      _service->Run();
     }
 
     void AsyncRun(size_t worker_threads) {
-      _service.AsyncRun(worker_threads);
+      DEBUG_ASSERT(!_is_service_shared);
+      _service->AsyncRun(worker_threads);
+    }
+
+    /// Stop calling the callbacks and wait for the ones running in other
+    /// threads to finish, so nothing they use is destroyed under them. The
+    /// service is also stopped, unless it is shared with other clients.
+    void Stop() {
+      _callbacks->Close();
+      if (!_is_service_shared) {
+        _service->Stop();
+      }
     }
 
   private:
 
+    /// Keeps track of the callbacks running, a shared service keeps running
+    /// them after this client is gone.
+    class CallbackState : private NonCopyable {
+    public:
+
+      /// Marks a callback as running in this thread while alive.
+      class Scope : private NonCopyable {
+      public:
+
+        explicit Scope(CallbackState &state) : _state(state), _previous(Current()) {
+          std::lock_guard<std::mutex> lock(_state._mutex);
+          _is_open = _state._is_open;
+          if (_is_open) {
+            ++_state._running;
+            Current() = &_state;
+          }
+        }
+
+        ~Scope() {
+          if (_is_open) {
+            Current() = _previous;
+            {
+              std::lock_guard<std::mutex> lock(_state._mutex);
+              --_state._running;
+            }
+            _state._cv.notify_all();
+          }
+        }
+
+        bool IsOpen() const {
+          return _is_open;
+        }
+
+      private:
+
+        CallbackState &_state;
+
+        const CallbackState *const _previous;
+
+        bool _is_open = false;
+      };
+
+      /// Wait for the running callbacks, except the one calling this.
+      void Close() {
+        const size_t own = (Current() == this) ? 1u : 0u;
+        std::unique_lock<std::mutex> lock(_mutex);
+        _is_open = false;
+        _cv.wait(lock, [&]() { return _running <= own; });
+      }
+
+    private:
+
+      /// The callback state of the callback running in this thread.
+      static const CallbackState *&Current() {
+        static thread_local const CallbackState *current = nullptr;
+        return current;
+      }
+
+      std::mutex _mutex;
+
+      std::condition_variable _cv;
+
+      size_t _running = 0u;
+
+      bool _is_open = true;
+    };
+
     // The order of these two arguments is very important.
 
-    ThreadPool _service;
+    std::shared_ptr<ThreadPool> _service;
+
+    const bool _is_service_shared = false;
+
+    std::shared_ptr<CallbackState> _callbacks = std::make_shared<CallbackState>();
 
     underlying_client _client;
   };
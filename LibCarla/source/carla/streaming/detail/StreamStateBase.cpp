@@ -14,7 +14,7 @@ namespace detail {
 
   StreamStateBase::StreamStateBase(const token_type &token)
     : _token(token),
-      _buffer_pool(std::make_shared<BufferPool>()) {}
+      _buffer_pool(BufferPool::GetDefault()) {}
 
   StreamStateBase::~StreamStateBase() = default;
 
@@ -51,6 +51,7 @@ void ALSM::Update() {
   std::vector<ActorId> unregistered_list_to_be_deleted;
 
   current_timestamp = world.GetSnapshot().GetTimestamp();
+  simulation_state.SetTimestamp(current_timestamp);
   ActorList world_actors = world.GetActors();
 
   // Find destroyed actors and perform clean up.
@@ -39,7 +39,6 @@ MotionPlanStage::MotionPlanStage(
   const LocalizationFrame &localization_frame,
   const CollisionFrame&collision_frame,
   const TLFrame &tl_frame,
-  const cc::World &world,
   ControlFrame &output_array,
   RandomGenerator &random_device,
   const LocalMapPtr &local_map)
@@ -55,7 +54,6 @@ MotionPlanStage::MotionPlanStage(
     localization_frame(localization_frame),
     collision_frame(collision_frame),
     tl_frame(tl_frame),
-    world(world),
     output_array(output_array),
     random_device(random_device),
     local_map(local_map) {}
@@ -73,7 +71,7 @@ void MotionPlanStage::Update(const unsigned long index) {
   const LocalizationData &localization = localization_frame.at(index);
   const CollisionHazardData &collision_hazard = collision_frame.at(index);
   const bool &tl_hazard = tl_frame.at(index);
-  current_timestamp = world.GetSnapshot().GetTimestamp();
+  current_timestamp = simulation_state.GetTimestamp();
   StateEntry current_state;
 
   // Instanciating teleportation transform as current vehicle transform.
@@ -32,6 +32,7 @@ void SimulationState::Reset() {
   kinematic_state_map.clear();
   static_attribute_map.clear();
   tl_state_map.clear();
+  timestamp = cc::Timestamp();
 }
 
 void SimulationState::UpdateKinematicState(ActorId actor_id, KinematicState state) {
@@ -99,5 +100,13 @@ cg::Vector3D SimulationState::GetDimensions(ActorId actor_id) const {
   return cg::Vector3D(attributes.half_length, attributes.half_width, attributes.half_height);
 }
 
+void SimulationState::SetTimestamp(const cc::Timestamp &current_timestamp) {
+  timestamp = current_timestamp;
+}
+
+const cc::Timestamp &SimulationState::GetTimestamp() const {
+  return timestamp;
+}
+
 } // namespace  traffic_manager
 } // namespace carla
@@ -51,6 +51,8 @@ private:
   StaticAttributeMap static_attribute_map;
   // Structure containing dynamic traffic light related state of actors.
   TrafficLightStateMap tl_state_map;
+  // Timestamp of the simulation frame the state belongs to.
+  cc::Timestamp timestamp;
 
 public :
   SimulationState();
@@ -100,6 +102,10 @@ public :
 
   cg::Vector3D GetDimensions(const ActorId actor_id) const;
 
+  void SetTimestamp(const cc::Timestamp &current_timestamp);
+
+  const cc::Timestamp &GetTimestamp() const;
+
 };
 
 } // namespace traffic_manager
@@ -17,14 +17,12 @@ TrafficLightStage::TrafficLightStage(
   const SimulationState &simulation_state,
   const BufferMap &buffer_map,
   const Parameters &parameters,
-  const cc::World &world,
   TLFrame &output_array,
   RandomGenerator &random_device)
   : vehicle_id_list(vehicle_id_list),
     simulation_state(simulation_state),
     buffer_map(buffer_map),
     parameters(parameters),
-    world(world),
     output_array(output_array),
     random_device(random_device) {}
 
@@ -40,7 +38,7 @@ void TrafficLightStage::Update(const unsigned long index) {
     }
     auto affected_junction_id = GetAffectedJunctionId(ego_actor_id);
 
-    current_timestamp = world.GetSnapshot().GetTimestamp();
+    current_timestamp = simulation_state.GetTimestamp();
 
     const TrafficLightState tl_state = simulation_state.GetTLS(ego_actor_id);
     const TLS traffic_light_state = tl_state.tl_state;
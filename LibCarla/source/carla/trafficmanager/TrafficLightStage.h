@@ -18,7 +18,6 @@ private:
   const SimulationState &simulation_state;
   const BufferMap &buffer_map;
   const Parameters &parameters;
-  const cc::World &world;
 
   /// Variables used to handle non signalized junctions
 
@@ -49,7 +48,6 @@ public:
                     const SimulationState &Simulation_state,
                     const BufferMap &buffer_map,
                     const Parameters &parameters,
-                    const cc::World &world,
                     TLFrame &output_array,
                     RandomGenerator &random_device);
 
@@ -56,7 +56,6 @@ TrafficManagerLocal::TrafficManagerLocal(
                                           simulation_state,
                                           buffer_map,
                                           parameters,
-                                          world,
                                           tl_frame,
                                           random_device)),
 
@@ -72,7 +71,6 @@ TrafficManagerLocal::TrafficManagerLocal(
                                       localization_frame,
                                       collision_frame,
                                       tl_frame,
-                                      world,
                                       control_frame,
                                       random_device,
                                       local_map)),
@@ -237,17 +235,41 @@ void TrafficManagerLocal::Run() {
 
     // Sending the current cycle's batch command to the simulator.
     if (synchronous_mode) {
-      episode_proxy.Lock()->ApplyBatchSync(control_frame, false);
+      SendControlFrame();
       step_end.store(true);
       step_end_trigger.notify_one();
     } else {
       if (control_frame.size() > 0){
-        episode_proxy.Lock()->ApplyBatchSync(control_frame, false);
+        SendControlFrame();
       }
     }
   }
 }
 
+void TrafficManagerLocal::SendControlFrame() {
+  using Cmd = carla::rpc::Command;
+  control_batch.Clear();
+  control_batch.Reserve(control_frame.size());
+  remaining_commands.clear();
+  for (const auto &command : control_frame) {
+    if (auto *control = boost::variant2::get_if<Cmd::ApplyVehicleControl>(&command.command)) {
+      control_batch.AddControl(control->actor, control->control);
+    } else if (auto *transform = boost::variant2::get_if<Cmd::ApplyTransform>(&command.command)) {
+      control_batch.AddTransform(transform->actor, transform->transform);
+    } else {
+      remaining_commands.push_back(command);
+    }
+  }
+
+  auto simulator = episode_proxy.Lock();
+  if (!control_batch.empty()) {
+    simulator->ApplyVehicleControlBatch(control_batch, false);
+  }
+  if (!remaining_commands.empty()) {
+    simulator->ApplyBatchSync(remaining_commands, false);
+  }
+}
+
 bool TrafficManagerLocal::SynchronousTick() {
   if (parameters.GetSynchronousMode()) {
     step_begin.store(true);
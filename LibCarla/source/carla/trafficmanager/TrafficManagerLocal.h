@@ -17,6 +17,7 @@
 #include "carla/client/World.h"
 #include "carla/Memory.h"
 #include "carla/rpc/Command.h"
+#include "carla/rpc/VehicleControlBatch.h"
 
 #include "carla/trafficmanager/AtomicActorSet.h"
 #include "carla/trafficmanager/InMemoryMap.h"
@@ -86,6 +87,11 @@ private:
   TLFrame tl_frame;
   /// Array to hold output data of motion planning.
   ControlFrame control_frame;
+  /// Vehicle controls and transforms of control_frame, sent to the simulator
+  /// in a single columnar message.
+  carla::rpc::VehicleControlBatch control_batch;
+  /// Commands of control_frame that do not fit in control_batch.
+  ControlFrame remaining_commands;
   /// Variable to keep track of currently reserved array space for frames.
   uint64_t current_reserved_capacity {0u};
   /// Various stages representing core operations of traffic manager.
@@ -120,6 +126,9 @@ private:
   /// Method to check if all traffic lights are frozen in a group.
   bool CheckAllFrozen(TLGroup tl_to_freeze);
 
+  /// Method to send the commands in control_frame to the simulator.
+  void SendControlFrame();
+
 public:
   /// Private constructor for singleton lifecycle management.
   TrafficManagerLocal(std::vector<float> longitudinal_PID_parameters,
@@ -22,9 +22,19 @@ VehicleLightStage::VehicleLightStage(
     control_frame(control_frame) {}
 
 void VehicleLightStage::UpdateWorldInfo() {
-  // Get the global weather and all the vehicle light states at once
-  all_light_states = world.GetVehiclesLightStates();
-  weather = world.GetWeather();
+  // The light states and the weather come with the episode state, so there
+  // is no need to ask the simulator for them.
+  const cc::WorldSnapshot snapshot = world.GetSnapshot();
+  light_states.clear();
+  light_states.reserve(vehicle_id_list.size());
+  for (const ActorId actor_id : vehicle_id_list) {
+    const auto actor = snapshot.Find(actor_id);
+    if (actor.has_value()) {
+      light_states.emplace(actor_id, actor->state.vehicle_data.light_state);
+    }
+  }
+  const auto &current_weather = snapshot.GetWeather();
+  weather = current_weather.has_value() ? *current_weather : world.GetWeather();
 }
 
 void VehicleLightStage::Update(const unsigned long index) {
@@ -33,7 +43,7 @@ void VehicleLightStage::Update(const unsigned long index) {
   if (!parameters.GetUpdateVehicleLights(actor_id))
     return; // this vehicle is not set to have automatic lights update
 
-  rpc::VehicleLightState::flag_type light_states = uint32_t(-1);
+  rpc::VehicleLightState::flag_type current_light_states = uint32_t(-1);
   bool brake_lights = false;
   bool left_turn_indicator = false;
   bool right_turn_indicator = false;
@@ -43,11 +53,9 @@ void VehicleLightStage::Update(const unsigned long index) {
   bool fog_lights = false;
 
   // search the current light state of the vehicle
-  for (auto&& vls : all_light_states) {
-    if (vls.first == actor_id) {
-      light_states = vls.second;
-      break;
-    }
+  const auto it = light_states.find(actor_id);
+  if (it != light_states.end()) {
+    current_light_states = it->second;
   }
 
   // Determine if the vehicle is truning left or right by checking the close waypoints
@@ -105,7 +113,7 @@ void VehicleLightStage::Update(const unsigned long index) {
   }
 
   // Determine the new vehicle light state
-  rpc::VehicleLightState::flag_type new_light_states = light_states;
+  rpc::VehicleLightState::flag_type new_light_states = current_light_states;
   if (brake_lights)
     new_light_states |= rpc::VehicleLightState::flag_type(rpc::VehicleLightState::LightState::Brake);
   else
@@ -142,7 +150,7 @@ void VehicleLightStage::Update(const unsigned long index) {
     new_light_states &= ~rpc::VehicleLightState::flag_type(rpc::VehicleLightState::LightState::Fog);
 
   // Update the vehicle light state if it has changed
-  if (new_light_states != light_states)
+  if (new_light_states != current_light_states)
     control_frame.push_back(carla::rpc::Command::SetVehicleLightState(actor_id, new_light_states));
 }
 
@@ -19,8 +19,8 @@ private:
   const Parameters &parameters;
   const cc::World &world;
   ControlFrame& control_frame;
-  /// All vehicle light states
-  rpc::VehicleLightStateList all_light_states;
+  /// Light states of the registered vehicles, read from the world snapshot.
+  std::unordered_map<ActorId, rpc::VehicleLightState::flag_type> light_states;
   /// Current weather parameters
   rpc::WeatherParameters weather;
 
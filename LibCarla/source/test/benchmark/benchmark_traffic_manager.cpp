@@ -0,0 +1,184 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+/// Benchmark of the traffic manager stages, run offline on an OpenDRIVE map.
+///
+/// Usage: libcarla_benchmark_tm [--map file.xodr] [--ticks N] [--hybrid]
+///                              [--vehicles 10,100,1000]
+///
+/// By default it uses the biggest map of the test content folder. For each
+/// number of vehicles it prints the time per tick spent in each stage and the
+/// number of heap allocations per tick.
+
+#include "client/OpenDrive.h"
+#include "client/TrafficSimulation.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// =============================================================================
+// -- Allocation counter -------------------------------------------------------
+// =============================================================================
+
+static std::atomic<uint64_t> number_of_allocations{0u};
+
+void *operator new(size_t size) {
+  ++number_of_allocations;
+  void *ptr = std::malloc(size == 0u ? 1u : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+  ::operator delete(ptr);
+}
+
+// =============================================================================
+// -- Benchmark ----------------------------------------------------------------
+// =============================================================================
+
+struct Options {
+  std::string map;
+  size_t ticks = 100u;
+  size_t warm_up_ticks = 20u;
+  bool hybrid_physics_mode = false;
+  std::vector<size_t> vehicles = {10u, 50u, 100u, 500u, 1000u, 2000u, 5000u};
+};
+
+static std::vector<size_t> ParseList(const std::string &str) {
+  std::vector<size_t> result;
+  std::stringstream stream(str);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    result.emplace_back(std::stoul(item));
+  }
+  return result;
+}
+
+static Options ParseOptions(int argc, char *argv[]) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool has_value = (i + 1) < argc;
+    if (arg == "--map" && has_value) {
+      options.map = argv[++i];
+    } else if (arg == "--ticks" && has_value) {
+      options.ticks = std::stoul(argv[++i]);
+    } else if (arg == "--vehicles" && has_value) {
+      options.vehicles = ParseList(argv[++i]);
+    } else if (arg == "--hybrid") {
+      options.hybrid_physics_mode = true;
+    } else {
+      std::cerr << "unknown argument " << arg << std::endl;
+      std::exit(1);
+    }
+  }
+  return options;
+}
+
+static std::string LoadMap(const Options &options, std::string &name) {
+  if (!options.map.empty()) {
+    name = options.map;
+    std::ifstream file(options.map);
+    return std::string{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  }
+  // The biggest of the test maps.
+  std::string content;
+  for (auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto xodr = util::OpenDrive::Load(file);
+    if (xodr.size() > content.size()) {
+      name = file;
+      content = std::move(xodr);
+    }
+  }
+  return content;
+}
+
+static void PrintRow(std::ostream &out, const std::vector<std::string> &columns) {
+  for (auto &column : columns) {
+    out << ' ' << std::setw(13) << column;
+  }
+  out << std::endl;
+}
+
+template <typename T>
+static std::string ToString(T value, int precision = 3) {
+  std::stringstream stream;
+  stream << std::fixed << std::setprecision(precision) << value;
+  return stream.str();
+}
+
+int main(int argc, char *argv[]) {
+  const auto options = ParseOptions(argc, argv);
+
+  std::string map_name;
+  const auto xodr = LoadMap(options, map_name);
+  if (xodr.empty()) {
+    std::cerr << "no OpenDRIVE map found" << std::endl;
+    return 1;
+  }
+
+  const auto begin = std::chrono::steady_clock::now();
+  util::TrafficSimulation simulation(xodr, options.hybrid_physics_mode);
+  const std::chrono::duration<double> setup_time = std::chrono::steady_clock::now() - begin;
+
+  std::cout << "map: " << map_name
+            << " (" << simulation.GetLocalMap().GetDenseTopology().size() << " waypoints, "
+            << "set up in " << ToString(setup_time.count()) << " s)\n"
+            << "mode: " << (options.hybrid_physics_mode ? "hybrid" : "physics")
+            << ", " << options.ticks << " ticks\n"
+            << "times in milliseconds per tick\n\n";
+
+  PrintRow(std::cout, {
+      "vehicles", "total", "localization", "collision", "traffic_light",
+      "motion_plan", "kinematics", "us/vehicle", "allocs/tick"});
+
+  for (auto number_of_vehicles : options.vehicles) {
+    simulation.Reset();
+    const auto spawned = simulation.SpawnVehicles(number_of_vehicles, 8.0f);
+    if (spawned == 0u) {
+      continue;
+    }
+    for (auto i = 0u; i < options.warm_up_ticks; ++i) {
+      simulation.Tick();
+    }
+    simulation.ResetStageTimes();
+    const auto allocations_before = number_of_allocations.load();
+    for (auto i = 0u; i < options.ticks; ++i) {
+      simulation.Tick();
+    }
+    const auto allocations = number_of_allocations.load() - allocations_before;
+
+    const auto &times = simulation.GetStageTimes();
+    const double ms = 1e3 / static_cast<double>(options.ticks);
+    PrintRow(std::cout, {
+        std::to_string(spawned),
+        ToString(times.Total() * ms),
+        ToString(times.localization * ms),
+        ToString(times.collision * ms),
+        ToString(times.traffic_light * ms),
+        ToString(times.motion_plan * ms),
+        ToString(times.kinematics * ms),
+        ToString(times.Total() * ms * 1e3 / static_cast<double>(spawned), 2),
+        std::to_string(allocations / options.ticks)});
+  }
+  return 0;
+}
@@ -0,0 +1,320 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "TrafficSimulation.h"
+
+#include <carla/Memory.h>
+#include <carla/client/Map.h>
+#include <carla/geom/Math.h>
+#include <carla/rpc/Command.h>
+#include <carla/trafficmanager/Constants.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <unordered_map>
+
+namespace util {
+
+  namespace tm = carla::traffic_manager;
+  namespace cg = carla::geom;
+
+  using tm::constants::HybridMode::HYBRID_MODE_DT;
+  using tm::constants::HybridMode::HYBRID_MODE_DT_FL;
+
+  // ===========================================================================
+  // -- Static local methods ---------------------------------------------------
+  // ===========================================================================
+
+  /// Kinematic bicycle model of a passenger car.
+  /// @{
+  static constexpr float MAX_ACCELERATION = 4.0f;
+  static constexpr float MAX_DECELERATION = 8.0f;
+  static constexpr float DRAG_COEFFICIENT = 0.05f;
+  static constexpr float WHEELBASE = 2.8f;
+  static constexpr float MAX_STEER_ANGLE = 1.22f;
+  static const cg::Vector3D VEHICLE_EXTENT{2.4f, 1.0f, 0.8f};
+  /// @}
+
+  /// Speed limit given to every vehicle, in km/h.
+  static constexpr float SPEED_LIMIT = 30.0f;
+
+  template <typename FunctorT>
+  static double Measure(FunctorT &&functor) {
+    const auto begin = std::chrono::steady_clock::now();
+    functor();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    return elapsed.count();
+  }
+
+  static int64_t GetCellKey(const cg::Location &location, float cell_size, int dx, int dy) {
+    const auto x = static_cast<int64_t>(std::floor(location.x / cell_size)) + dx;
+    const auto y = static_cast<int64_t>(std::floor(location.y / cell_size)) + dy;
+    return (x << 32) ^ (y & 0xFFFFFFFF);
+  }
+
+  // ===========================================================================
+  // -- TrafficSimulation ------------------------------------------------------
+  // ===========================================================================
+
+  TrafficSimulation::TrafficSimulation(
+      const std::string &xodr_content,
+      const bool hybrid_physics_mode,
+      const uint64_t seed)
+    : _local_map(std::make_shared<tm::InMemoryMap>(
+          carla::MakeShared<carla::client::Map>("TrafficSimulation", xodr_content))),
+      _random_device(seed),
+      _longitudinal_parameters(tm::constants::PID::LONGITUDIAL_PARAM),
+      _longitudinal_highway_parameters(tm::constants::PID::LONGITUDIAL_HIGHWAY_PARAM),
+      _lateral_parameters(tm::constants::PID::LATERAL_PARAM),
+      _lateral_highway_parameters(tm::constants::PID::LATERAL_HIGHWAY_PARAM),
+      _localization_stage(
+          _vehicle_id_list,
+          _buffer_map,
+          _simulation_state,
+          _track_traffic,
+          _local_map,
+          _parameters,
+          _marked_for_removal,
+          _localization_frame,
+          _random_device),
+      _collision_stage(
+          _vehicle_id_list,
+          _simulation_state,
+          _buffer_map,
+          _track_traffic,
+          _parameters,
+          _collision_frame,
+          _random_device),
+      _traffic_light_stage(
+          _vehicle_id_list,
+          _simulation_state,
+          _buffer_map,
+          _parameters,
+          _tl_frame,
+          _random_device),
+      _motion_plan_stage(
+          _vehicle_id_list,
+          _simulation_state,
+          _parameters,
+          _buffer_map,
+          _track_traffic,
+          _longitudinal_parameters,
+          _longitudinal_highway_parameters,
+          _lateral_parameters,
+          _lateral_highway_parameters,
+          _localization_frame,
+          _collision_frame,
+          _tl_frame,
+          _control_frame,
+          _random_device,
+          _local_map),
+      _hybrid_physics_mode(hybrid_physics_mode),
+      _seed(seed) {
+    _local_map->SetUp();
+    _parameters.SetSynchronousMode(true);
+    _parameters.SetHybridPhysicsMode(hybrid_physics_mode);
+    _parameters.SetMaxBoundaries(20.0f, 2000.0f);
+    _parameters.SetGlobalPercentageSpeedDifference(
+        tm::constants::SpeedThreshold::INITIAL_PERCENTAGE_SPEED_DIFFERENCE);
+  }
+
+  size_t TrafficSimulation::SpawnVehicles(const size_t number_of_vehicles, const float min_distance) {
+    std::vector<tm::SimpleWaypointPtr> candidates;
+    for (auto &waypoint : _local_map->GetDenseTopology()) {
+      if (waypoint != nullptr && !waypoint->CheckJunction()) {
+        candidates.emplace_back(waypoint);
+      }
+    }
+    std::mt19937_64 rng(_seed + _vehicles.size());
+    std::shuffle(candidates.begin(), candidates.end(), rng);
+
+    // Grid of cells of min_distance side to look for nearby vehicles.
+    std::unordered_map<int64_t, std::vector<cg::Location>> grid;
+    for (auto &vehicle : _vehicles) {
+      const auto &location = vehicle.transform.location;
+      grid[GetCellKey(location, min_distance, 0, 0)].emplace_back(location);
+    }
+    auto is_free = [&](const cg::Location &location) {
+      for (int dx = -1; dx <= 1; ++dx) {
+        for (int dy = -1; dy <= 1; ++dy) {
+          auto it = grid.find(GetCellKey(location, min_distance, dx, dy));
+          if (it == grid.end()) {
+            continue;
+          }
+          for (auto &other : it->second) {
+            if (cg::Math::DistanceSquared(location, other) < min_distance * min_distance) {
+              return false;
+            }
+          }
+        }
+      }
+      return true;
+    };
+
+    size_t count = 0u;
+    for (auto &waypoint : candidates) {
+      if (count == number_of_vehicles) {
+        break;
+      }
+      const auto transform = waypoint->GetTransform();
+      if (!is_free(transform.location)) {
+        continue;
+      }
+      grid[GetCellKey(transform.location, min_distance, 0, 0)].emplace_back(transform.location);
+
+      const auto id = static_cast<ActorId>(_vehicles.size() + 1u);
+      Vehicle vehicle;
+      vehicle.transform = transform;
+      _vehicles.emplace_back(vehicle);
+      _vehicle_id_list.emplace_back(id);
+      _simulation_state.AddActor(
+          id,
+          tm::KinematicState{
+              transform.location,
+              transform.rotation,
+              cg::Vector3D(),
+              SPEED_LIMIT,
+              !_hybrid_physics_mode,
+              false,
+              cg::Location()},
+          tm::StaticAttributes{tm::ActorType::Vehicle, VEHICLE_EXTENT.x, VEHICLE_EXTENT.y, VEHICLE_EXTENT.z},
+          tm::TrafficLightState{carla::rpc::TrafficLightState::Green, false});
+      ++count;
+    }
+    return count;
+  }
+
+  void TrafficSimulation::Reset() {
+    _vehicle_id_list.clear();
+    _vehicles.clear();
+    _buffer_map.clear();
+    _marked_for_removal.clear();
+    _simulation_state.Reset();
+    _track_traffic.Clear();
+    _localization_stage.Reset();
+    _collision_stage.Reset();
+    _traffic_light_stage.Reset();
+    _motion_plan_stage.Reset();
+    _localization_frame.clear();
+    _collision_frame.clear();
+    _tl_frame.clear();
+    _control_frame.clear();
+    _timestamp = carla::client::Timestamp{};
+    ResetStageTimes();
+  }
+
+  void TrafficSimulation::Tick() {
+    _timestamp.frame += 1u;
+    _timestamp.delta_seconds = HYBRID_MODE_DT;
+    _timestamp.elapsed_seconds += HYBRID_MODE_DT;
+    _simulation_state.SetTimestamp(_timestamp);
+    UpdateSimulationState();
+
+    const auto number_of_vehicles = _vehicle_id_list.size();
+    _localization_frame.clear();
+    _localization_frame.resize(number_of_vehicles);
+    _collision_frame.clear();
+    _collision_frame.resize(number_of_vehicles);
+    _tl_frame.clear();
+    _tl_frame.resize(number_of_vehicles);
+    _control_frame.clear();
+    _control_frame.resize(number_of_vehicles);
+
+    // Same order as TrafficManagerLocal::Run.
+    _stage_times.localization += Measure([this, number_of_vehicles]() {
+      for (unsigned long index = 0u; index < number_of_vehicles; ++index) {
+        _localization_stage.Update(index);
+      }
+    });
+    _stage_times.collision += Measure([this, number_of_vehicles]() {
+      for (unsigned long index = 0u; index < number_of_vehicles; ++index) {
+        _collision_stage.Update(index);
+      }
+      _collision_stage.ClearCycleCache();
+    });
+    for (unsigned long index = 0u; index < number_of_vehicles; ++index) {
+      _stage_times.traffic_light += Measure([this, index]() {
+        _traffic_light_stage.Update(index);
+      });
+      _stage_times.motion_plan += Measure([this, index]() {
+        _motion_plan_stage.Update(index);
+      });
+    }
+    _marked_for_removal.clear();
+
+    _stage_times.kinematics += Measure([this]() { ApplyCommands(); });
+  }
+
+  cg::Transform TrafficSimulation::GetTransform(const ActorId id) const {
+    return GetVehicle(id).transform;
+  }
+
+  float TrafficSimulation::GetSpeed(const ActorId id) const {
+    return GetVehicle(id).speed;
+  }
+
+  TrafficSimulation::Vehicle &TrafficSimulation::GetVehicle(const ActorId id) {
+    return _vehicles.at(id - 1u);
+  }
+
+  const TrafficSimulation::Vehicle &TrafficSimulation::GetVehicle(const ActorId id) const {
+    return _vehicles.at(id - 1u);
+  }
+
+  void TrafficSimulation::UpdateSimulationState() {
+    for (auto id : _vehicle_id_list) {
+      const auto &vehicle = GetVehicle(id);
+      _simulation_state.UpdateKinematicState(id, tm::KinematicState{
+          vehicle.transform.location,
+          vehicle.transform.rotation,
+          vehicle.velocity,
+          SPEED_LIMIT,
+          !_hybrid_physics_mode,
+          false,
+          cg::Location()});
+    }
+  }
+
+  void TrafficSimulation::ApplyCommands() {
+    using Cmd = carla::rpc::Command;
+    for (const auto &command : _control_frame) {
+      if (auto *control = boost::variant2::get_if<Cmd::ApplyVehicleControl>(&command.command)) {
+        ApplyControl(GetVehicle(control->actor), control->control);
+      } else if (auto *transform = boost::variant2::get_if<Cmd::ApplyTransform>(&command.command)) {
+        ApplyTransform(GetVehicle(transform->actor), transform->transform);
+      }
+    }
+  }
+
+  void TrafficSimulation::ApplyControl(Vehicle &vehicle, const carla::rpc::VehicleControl &control) {
+    const float acceleration =
+        control.throttle * MAX_ACCELERATION -
+        control.brake * MAX_DECELERATION -
+        DRAG_COEFFICIENT * vehicle.speed;
+    vehicle.speed = control.hand_brake ?
+        0.0f :
+        std::max(0.0f, vehicle.speed + acceleration * HYBRID_MODE_DT_FL);
+
+    auto &rotation = vehicle.transform.rotation;
+    const float yaw_rate = vehicle.speed * std::tan(control.steer * MAX_STEER_ANGLE) / WHEELBASE;
+    rotation.yaw += carla::geom::Math::ToDegrees(yaw_rate * HYBRID_MODE_DT_FL);
+
+    const float yaw = carla::geom::Math::ToRadians(rotation.yaw);
+    const cg::Vector3D forward{std::cos(yaw), std::sin(yaw), 0.0f};
+    vehicle.velocity = vehicle.speed * forward;
+    vehicle.transform.location += cg::Location(vehicle.velocity * HYBRID_MODE_DT_FL);
+  }
+
+  void TrafficSimulation::ApplyTransform(Vehicle &vehicle, const cg::Transform &transform) {
+    const auto displacement = transform.location - vehicle.transform.location;
+    vehicle.velocity = displacement * static_cast<float>(1.0 / HYBRID_MODE_DT);
+    vehicle.speed = vehicle.velocity.Length();
+    vehicle.transform = transform;
+  }
+
+} // namespace util
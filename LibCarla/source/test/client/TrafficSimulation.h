@@ -0,0 +1,182 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <carla/NonCopyable.h>
+#include <carla/client/Timestamp.h>
+#include <carla/geom/Transform.h>
+#include <carla/trafficmanager/CollisionStage.h>
+#include <carla/trafficmanager/DataStructures.h>
+#include <carla/trafficmanager/InMemoryMap.h>
+#include <carla/trafficmanager/LocalizationStage.h>
+#include <carla/trafficmanager/MotionPlanStage.h>
+#include <carla/trafficmanager/Parameters.h>
+#include <carla/trafficmanager/RandomGenerator.h>
+#include <carla/trafficmanager/SimulationState.h>
+#include <carla/trafficmanager/TrackTraffic.h>
+#include <carla/trafficmanager/TrafficLightStage.h>
+
+#include <string>
+#include <vector>
+
+namespace util {
+
+  /// Runs the stages of the traffic manager in-process, without a simulator.
+  ///
+  /// It plays the role of the episode and of ALSM: the map comes from an
+  /// OpenDRIVE file, vehicles are spawned on its waypoints, and the commands
+  /// produced each tick are applied to a simple kinematic model instead of
+  /// being sent to the server. Traffic lights are always green and vehicle
+  /// lights are not computed.
+  class TrafficSimulation : private carla::NonCopyable {
+  public:
+
+    using ActorId = carla::ActorId;
+
+    /// Accumulated wall-clock time spent in each part of the tick, in seconds.
+    struct StageTimes {
+      double localization = 0.0;
+      double collision = 0.0;
+      double traffic_light = 0.0;
+      double motion_plan = 0.0;
+      double kinematics = 0.0;
+
+      double Total() const {
+        return localization + collision + traffic_light + motion_plan + kinematics;
+      }
+    };
+
+    /// Build the local map of @a xodr_content. In hybrid mode vehicles are
+    /// teleported like physics-less vehicles in the simulator, otherwise the
+    /// vehicle controls are integrated with a kinematic bicycle model.
+    explicit TrafficSimulation(
+        const std::string &xodr_content,
+        bool hybrid_physics_mode = false,
+        uint64_t seed = 42u);
+
+    /// Spawn up to @a number_of_vehicles vehicles on random waypoints outside
+    /// junctions, at least @a min_distance meters apart.
+    ///
+    /// @return the number of vehicles spawned, it may be smaller if the map
+    /// runs out of space.
+    size_t SpawnVehicles(size_t number_of_vehicles, float min_distance = 10.0f);
+
+    /// Remove all the vehicles and reset the state of the stages.
+    void Reset();
+
+    /// Advance the simulation one frame of constants::HybridMode::HYBRID_MODE_DT
+    /// seconds.
+    void Tick();
+
+    size_t GetNumberOfVehicles() const {
+      return _vehicle_id_list.size();
+    }
+
+    const std::vector<ActorId> &GetVehicleIds() const {
+      return _vehicle_id_list;
+    }
+
+    carla::geom::Transform GetTransform(ActorId id) const;
+
+    float GetSpeed(ActorId id) const;
+
+    const carla::client::Timestamp &GetTimestamp() const {
+      return _timestamp;
+    }
+
+    const carla::traffic_manager::InMemoryMap &GetLocalMap() const {
+      return *_local_map;
+    }
+
+    carla::traffic_manager::Parameters &GetParameters() {
+      return _parameters;
+    }
+
+    const StageTimes &GetStageTimes() const {
+      return _stage_times;
+    }
+
+    void ResetStageTimes() {
+      _stage_times = StageTimes{};
+    }
+
+  private:
+
+    struct Vehicle {
+      carla::geom::Transform transform;
+      float speed = 0.0f;
+      carla::geom::Vector3D velocity;
+    };
+
+    Vehicle &GetVehicle(ActorId id);
+
+    const Vehicle &GetVehicle(ActorId id) const;
+
+    void UpdateSimulationState();
+
+    void ApplyCommands();
+
+    void ApplyControl(Vehicle &vehicle, const carla::rpc::VehicleControl &control);
+
+    void ApplyTransform(Vehicle &vehicle, const carla::geom::Transform &transform);
+
+    // Declaration order matters, the stages keep references to the members
+    // declared before them.
+
+    std::shared_ptr<carla::traffic_manager::InMemoryMap> _local_map;
+
+    carla::traffic_manager::Parameters _parameters;
+
+    carla::traffic_manager::RandomGenerator _random_device;
+
+    std::vector<ActorId> _vehicle_id_list;
+
+    carla::traffic_manager::BufferMap _buffer_map;
+
+    carla::traffic_manager::SimulationState _simulation_state;
+
+    carla::traffic_manager::TrackTraffic _track_traffic;
+
+    std::vector<ActorId> _marked_for_removal;
+
+    carla::traffic_manager::LocalizationFrame _localization_frame;
+
+    carla::traffic_manager::CollisionFrame _collision_frame;
+
+    carla::traffic_manager::TLFrame _tl_frame;
+
+    carla::traffic_manager::ControlFrame _control_frame;
+
+    const std::vector<float> _longitudinal_parameters;
+
+    const std::vector<float> _longitudinal_highway_parameters;
+
+    const std::vector<float> _lateral_parameters;
+
+    const std::vector<float> _lateral_highway_parameters;
+
+    carla::traffic_manager::LocalizationStage _localization_stage;
+
+    carla::traffic_manager::CollisionStage _collision_stage;
+
+    carla::traffic_manager::TrafficLightStage _traffic_light_stage;
+
+    carla::traffic_manager::MotionPlanStage _motion_plan_stage;
+
+    const bool _hybrid_physics_mode;
+
+    uint64_t _seed;
+
+    /// Indexed by actor id - 1.
+    std::vector<Vehicle> _vehicles;
+
+    carla::client::Timestamp _timestamp;
+
+    StageTimes _stage_times;
+  };
+
+} // namespace util
@@ -0,0 +1,297 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "OpenDrive.h"
+#include "Random.h"
+
+#include <carla/Version.h>
+#include <carla/opendrive/OpenDriveParser.h>
+#include <carla/road/Map.h>
+#include <carla/road/RoutingGraph.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <vector>
+
+#ifndef _WIN32
+#  include <sys/resource.h>
+#endif // _WIN32
+
+using carla::opendrive::OpenDriveParser;
+using carla::road::Map;
+using carla::road::RoutingGraph;
+using carla::road::element::Waypoint;
+
+namespace {
+
+  // ===========================================================================
+  // -- Results ----------------------------------------------------------------
+  // ===========================================================================
+
+  /// Peak resident set size of the process in kilobytes, 0 if unknown.
+  size_t GetPeakRSS() {
+#if defined(_WIN32)
+    return 0u;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+      return 0u;
+    }
+#  if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss) / 1024u;
+#  else
+    return static_cast<size_t>(usage.ru_maxrss);
+#  endif
+#endif // _WIN32
+  }
+
+  /// Latencies of the calls to an API on a map.
+  class Measurement {
+  public:
+
+    Measurement(std::string map, std::string api)
+      : _map(std::move(map)),
+        _api(std::move(api)) {}
+
+    ~Measurement();
+
+    /// Time a call to @a functor.
+    template <typename FunctorT>
+    void operator()(FunctorT &&functor) {
+      const auto begin = std::chrono::steady_clock::now();
+      functor();
+      const std::chrono::duration<double, std::micro> elapsed =
+          std::chrono::steady_clock::now() - begin;
+      _latencies.emplace_back(elapsed.count());
+    }
+
+  private:
+
+    friend class Results;
+
+    std::string _map;
+
+    std::string _api;
+
+    std::vector<double> _latencies;
+  };
+
+  /// Writes the measurements to benchmark_road.csv and to the log.
+  class Results {
+  public:
+
+    static Results &Get() {
+      static Results results{"benchmark_road.csv"};
+      return results;
+    }
+
+    void Write(Measurement &measurement) {
+      auto &latencies = measurement._latencies;
+      if (latencies.empty()) {
+        return;
+      }
+      std::sort(latencies.begin(), latencies.end());
+      // Nearest-rank percentile.
+      const auto percentile = [&](double p) {
+        const auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(latencies.size())));
+        return latencies[std::max<size_t>(rank, 1u) - 1u];
+      };
+      const double total = std::accumulate(latencies.begin(), latencies.end(), 0.0);
+      const double mean = total / static_cast<double>(latencies.size());
+      const double throughput = total > 0.0 ? 1e6 * static_cast<double>(latencies.size()) / total : 0.0;
+      const auto peak_rss = GetPeakRSS();
+
+      carla::logging::log(
+          measurement._api, "on", measurement._map, ':',
+          latencies.size(), "calls, mean", mean, "us, p99", percentile(0.99),
+          "us,", throughput, "calls/s, peak RSS", peak_rss, "kB");
+
+      std::lock_guard<std::mutex> lock(_mutex);
+      std::ofstream file(_filename, std::ios_base::app);
+      file << std::fixed << std::setprecision(3)
+           << measurement._map << ','
+           << measurement._api << ','
+           << latencies.size() << ','
+           << mean << ','
+           << percentile(0.5) << ','
+           << percentile(0.99) << ','
+           << latencies.back() << ','
+           << throughput << ','
+           << peak_rss << std::endl;
+    }
+
+  private:
+
+    explicit Results(std::string filename) : _filename(std::move(filename)) {
+      std::ofstream file(_filename);
+      file << "# LibCarla road benchmark " << carla::version()
+#ifdef NDEBUG
+           << " (release)"
+#else
+           << " (debug)"
+#endif // NDEBUG
+           << "\n# map,api,calls,mean_us,p50_us,p99_us,max_us,calls_per_second,peak_rss_kb"
+           << std::endl;
+    }
+
+    const std::string _filename;
+
+    std::mutex _mutex;
+  };
+
+  Measurement::~Measurement() {
+    Results::Get().Write(*this);
+  }
+
+  // ===========================================================================
+  // -- Helpers ----------------------------------------------------------------
+  // ===========================================================================
+
+  constexpr size_t NUMBER_OF_QUERIES = 10000u;
+
+  /// Call @a functor with the name and the map of each test file.
+  template <typename FunctorT>
+  void ForEachMap(FunctorT &&functor) {
+    for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+      auto map = OpenDriveParser::Load(util::OpenDrive::Load(file));
+      ASSERT_TRUE(map.has_value()) << file;
+      functor(file, *map);
+    }
+  }
+
+  /// Random waypoints of @a map, each lane weighted by its length.
+  std::vector<Waypoint> GetRandomWaypoints(const Map &map, size_t count) {
+    auto waypoints = map.GenerateWaypoints(1.0);
+    if (waypoints.empty()) {
+      return waypoints;
+    }
+    util::Random::Shuffle(waypoints);
+    std::vector<Waypoint> result;
+    result.reserve(count);
+    for (auto i = 0u; i < count; ++i) {
+      result.emplace_back(waypoints[i % waypoints.size()]);
+    }
+    return result;
+  }
+
+  /// Random location around @a location.
+  carla::geom::Location Jitter(const carla::geom::Location &location, float distance) {
+    auto offset = util::Random::Location(-distance, distance);
+    offset.z = 0.0f;
+    return location + offset;
+  }
+
+} // namespace
+
+// =============================================================================
+// -- Benchmarks ---------------------------------------------------------------
+// =============================================================================
+
+TEST(benchmark_road, load) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    const auto xodr = util::OpenDrive::Load(file);
+    Measurement measure(file, "OpenDriveParser::Load");
+    for (auto i = 0u; i < 3u; ++i) {
+      measure([&]() { ASSERT_TRUE(OpenDriveParser::Load(xodr).has_value()); });
+    }
+  }
+}
+
+TEST(benchmark_road, get_waypoint) {
+  ForEachMap([](const std::string &file, const Map &map) {
+    std::vector<carla::geom::Location> locations;
+    for (auto &waypoint : GetRandomWaypoints(map, NUMBER_OF_QUERIES)) {
+      locations.emplace_back(Jitter(map.ComputeTransform(waypoint).location, 5.0f));
+    }
+    Measurement measure(file, "Map::GetWaypoint");
+    for (auto &location : locations) {
+      measure([&]() { map.GetWaypoint(location); });
+    }
+  });
+}
+
+TEST(benchmark_road, get_next) {
+  ForEachMap([](const std::string &file, const Map &map) {
+    const auto waypoints = GetRandomWaypoints(map, NUMBER_OF_QUERIES);
+    Measurement measure(file, "Map::GetNext");
+    for (auto &waypoint : waypoints) {
+      measure([&]() { map.GetNext(waypoint, 2.0); });
+    }
+  });
+}
+
+TEST(benchmark_road, generate_waypoints) {
+  ForEachMap([](const std::string &file, const Map &map) {
+    Measurement measure(file, "Map::GenerateWaypoints");
+    for (auto i = 0u; i < 3u; ++i) {
+      measure([&]() { map.GenerateWaypoints(2.0); });
+    }
+  });
+}
+
+TEST(benchmark_road, calculate_crossed_lanes) {
+  ForEachMap([](const std::string &file, const Map &map) {
+    std::vector<std::pair<carla::geom::Location, carla::geom::Location>> segments;
+    for (auto &waypoint : GetRandomWaypoints(map, NUMBER_OF_QUERIES)) {
+      const auto origin = map.ComputeTransform(waypoint).location;
+      segments.emplace_back(origin, Jitter(origin, 2.0f));
+    }
+    Measurement measure(file, "Map::CalculateCrossedLanes");
+    for (auto &segment : segments) {
+      measure([&]() { map.CalculateCrossedLanes(segment.first, segment.second); });
+    }
+  });
+}
+
+TEST(benchmark_road, get_signals_in_distance) {
+  ForEachMap([](const std::string &file, const Map &map) {
+    const auto waypoints = GetRandomWaypoints(map, NUMBER_OF_QUERIES);
+    Measurement measure(file, "Map::GetSignalsInDistance");
+    for (auto &waypoint : waypoints) {
+      measure([&]() { map.GetSignalsInDistance(waypoint, 50.0); });
+    }
+  });
+}
+
+TEST(benchmark_road, generate_mesh) {
+  ForEachMap([](const std::string &file, const Map &map) {
+    Measurement measure(file, "Map::GenerateMesh");
+    for (auto i = 0u; i < 3u; ++i) {
+      measure([&]() { map.GenerateMesh(2.0); });
+    }
+  });
+}
+
+TEST(benchmark_road, routing) {
+  ForEachMap([](const std::string &file, const Map &map) {
+    std::unique_ptr<RoutingGraph> graph;
+    {
+      Measurement measure(file, "RoutingGraph::RoutingGraph");
+      measure([&]() { graph = std::make_unique<RoutingGraph>(map); });
+    }
+    const auto origins = GetRandomWaypoints(map, 100u);
+    const auto destinations = GetRandomWaypoints(map, 100u);
+    {
+      Measurement measure(file, "RoutingGraph::ComputeRoute");
+      for (auto i = 0u; i < origins.size(); ++i) {
+        measure([&]() { graph->ComputeRoute(origins[i], destinations[i]); });
+      }
+    }
+    {
+      Measurement measure(file, "RoutingGraph::ComputeDistances(100x100)");
+      for (auto i = 0u; i < 3u; ++i) {
+        measure([&]() { graph->ComputeDistances(origins, destinations); });
+      }
+    }
+  });
+}
@@ -0,0 +1,120 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/client/detail/CachedActorList.h>
+
+#include <set>
+#include <vector>
+
+using carla::client::detail::CachedActorList;
+using carla::rpc::ActorAttributeType;
+using carla::rpc::ActorAttributeValue;
+using carla::rpc::ActorId;
+
+static carla::rpc::Actor MakeActor(ActorId id, const std::string &color) {
+  carla::rpc::Actor actor;
+  actor.id = id;
+  actor.parent_id = id / 2u;
+  actor.description.uid = 7u;
+  actor.description.id = "vehicle.test.car";
+  ActorAttributeValue attribute;
+  attribute.id = "color";
+  attribute.type = ActorAttributeType::RGBColor;
+  attribute.value = color;
+  actor.description.attributes.emplace_back(attribute);
+  attribute.id = "role_name";
+  attribute.type = ActorAttributeType::String;
+  attribute.value = "autopilot";
+  actor.description.attributes.emplace_back(attribute);
+  actor.bounding_box.extent = {2.0f, 1.0f, 0.75f};
+  actor.semantic_tags = {10u};
+  actor.stream_token = {1u, 2u, 3u};
+  return actor;
+}
+
+TEST(cached_actor_list, insert_and_find) {
+  CachedActorList list;
+  list.Insert(MakeActor(3u, "255,0,0"));
+  std::vector<carla::rpc::Actor> actors;
+  for (auto id : {5u, 1u, 4u, 3u}) {
+    actors.emplace_back(MakeActor(id, "0,0,255"));
+  }
+  list.InsertRange(actors);
+  ASSERT_EQ(list.size(), 4u);
+
+  // The first description of an actor is kept.
+  auto actor = list.GetActorById(3u);
+  ASSERT_TRUE(actor.has_value());
+  ASSERT_EQ(actor->id, 3u);
+  ASSERT_EQ(actor->parent_id, 1u);
+  ASSERT_EQ(actor->description.uid, 7u);
+  ASSERT_EQ(actor->description.id, "vehicle.test.car");
+  ASSERT_EQ(actor->description.attributes.size(), 2u);
+  ASSERT_EQ(actor->description.attributes[0u].id, "color");
+  ASSERT_EQ(actor->description.attributes[0u].value, "255,0,0");
+  ASSERT_EQ(actor->description.attributes[1u].type, ActorAttributeType::String);
+  ASSERT_EQ(actor->bounding_box.extent.x, 2.0f);
+  ASSERT_EQ(actor->semantic_tags, std::vector<uint8_t>{10u});
+  ASSERT_EQ(actor->stream_token, (std::vector<unsigned char>{1u, 2u, 3u}));
+
+  ASSERT_FALSE(list.GetActorById(2u).has_value());
+  const std::vector<ActorId> ids = {1u, 2u, 5u, 6u};
+  ASSERT_EQ(list.GetMissingIds(ids), (std::vector<ActorId>{2u, 6u}));
+  const auto found = list.GetActorsById(ids);
+  ASSERT_EQ(found.size(), 2u);
+  ASSERT_EQ(found[0u].id, 1u);
+  ASSERT_EQ(found[1u].id, 5u);
+
+  list.Clear();
+  ASSERT_EQ(list.size(), 0u);
+  ASSERT_FALSE(list.GetActorById(1u).has_value());
+}
+
+TEST(cached_actor_list, evict_dead_actors) {
+  CachedActorList list;
+  for (ActorId id = 1u; id <= 10u; ++id) {
+    list.Insert(MakeActor(id, "0,0,0"));
+  }
+  std::set<ActorId> alive = {2u, 4u, 6u};
+  auto is_gone = [&](ActorId id) { return alive.count(id) == 0u; };
+
+  // Actors inserted since the last call are spared once.
+  ASSERT_EQ(list.EvictIf(is_gone), 0u);
+  ASSERT_EQ(list.size(), 10u);
+
+  list.Insert(MakeActor(11u, "0,0,0"));
+  ASSERT_EQ(list.EvictIf(is_gone), 7u);
+  ASSERT_EQ(list.size(), 4u);
+  ASSERT_EQ(list.GetMissingIds(std::vector<ActorId>{1u, 2u, 4u, 6u, 11u}),
+      std::vector<ActorId>{1u});
+
+  ASSERT_EQ(list.EvictIf(is_gone), 1u);
+  ASSERT_FALSE(list.GetActorById(11u).has_value());
+  ASSERT_TRUE(list.GetActorById(4u).has_value());
+
+  // Evicted actors can be inserted again.
+  list.Insert(MakeActor(1u, "0,0,0"));
+  ASSERT_TRUE(list.GetActorById(1u).has_value());
+  ASSERT_EQ(list.size(), 4u);
+}
+
+TEST(cached_actor_list, interned_values_survive_eviction) {
+  CachedActorList list;
+  list.Insert(MakeActor(1u, "1,2,3"));
+  list.EvictIf([](ActorId) { return false; });
+  std::vector<carla::rpc::Actor> actors;
+  for (ActorId id = 2u; id < 100u; ++id) {
+    actors.emplace_back(MakeActor(id, "1,2,3"));
+  }
+  list.InsertRange(std::move(actors));
+  ASSERT_EQ(list.EvictIf([](ActorId id) { return id != 50u; }), 1u);
+  ASSERT_EQ(list.EvictIf([](ActorId id) { return id != 50u; }), 97u);
+  auto actor = list.GetActorById(50u);
+  ASSERT_TRUE(actor.has_value());
+  ASSERT_EQ(actor->description.attributes[0u].value, "1,2,3");
+}
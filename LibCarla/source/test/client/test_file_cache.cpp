@@ -0,0 +1,100 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/ContentHash.h>
+#include <carla/client/FileCache.h>
+#include <carla/client/FileTransfer.h>
+
+#include <boost/filesystem.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+using carla::ContentHash;
+using carla::client::FileCache;
+using carla::client::FileTransfer;
+
+namespace fs = boost::filesystem;
+
+static carla::rpc::FileInfo MakeFileInfo(const std::string &name, const std::vector<uint8_t> &content) {
+  carla::rpc::FileInfo info;
+  info.name = name;
+  info.size = content.size();
+  info.hash = ContentHash::Compute(content.data(), content.size());
+  return info;
+}
+
+TEST(file_cache, store_and_open) {
+  const auto previous_folder = FileTransfer::GetFilesBaseFolder();
+  const auto folder = fs::temp_directory_path() / fs::unique_path();
+  ASSERT_TRUE(FileTransfer::SetFilesBaseFolder(folder.string()));
+
+  std::vector<uint8_t> content(3u * 1024u * 1024u + 7u);
+  for (size_t i = 0u; i < content.size(); ++i) {
+    content[i] = static_cast<uint8_t>(i * 31u);
+  }
+  const auto info = MakeFileInfo("Carla/Maps/Nav/Town01.bin", content);
+  ASSERT_FALSE(FileCache::Contains(info));
+  ASSERT_EQ(FileCache::Open(info), nullptr);
+
+  {
+    FileCache::Writer writer(info);
+    for (size_t offset = 0u; offset < content.size(); offset += 1024u * 1024u) {
+      writer.Write(content.data() + offset, std::min<size_t>(1024u * 1024u, content.size() - offset));
+    }
+    writer.Commit();
+  }
+  ASSERT_TRUE(FileCache::Contains(info));
+  auto file = FileCache::Open(info);
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(std::vector<uint8_t>(file->data(), file->data() + file->size()), content);
+
+  // Storing it again, as another client would, keeps the same file.
+  FileCache::Store(info, content.data(), content.size());
+  ASSERT_TRUE(FileCache::Contains(info));
+
+  FileCache::Export(info);
+  FileCache::Export(info);
+  ASSERT_TRUE(FileTransfer::FileExists(info.name));
+  ASSERT_EQ(FileTransfer::ReadFile(info.name), content);
+
+  const std::vector<uint8_t> empty;
+  const auto empty_info = MakeFileInfo("empty.bin", empty);
+  FileCache::Store(empty_info, empty.data(), empty.size());
+  file = FileCache::Open(empty_info);
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(file->size(), 0u);
+
+  file = nullptr;
+  fs::remove_all(folder);
+  FileTransfer::SetFilesBaseFolder(previous_folder);
+}
+
+TEST(file_cache, corrupted_files_are_rejected) {
+  const auto previous_folder = FileTransfer::GetFilesBaseFolder();
+  const auto folder = fs::temp_directory_path() / fs::unique_path();
+  ASSERT_TRUE(FileTransfer::SetFilesBaseFolder(folder.string()));
+
+  std::vector<uint8_t> content(1000u, 42u);
+  const auto info = MakeFileInfo("TM/Town01.bin", content);
+
+  content[500u] = 0u;
+  ASSERT_THROW(FileCache::Store(info, content.data(), content.size()), std::runtime_error);
+  content.pop_back();
+  ASSERT_THROW(FileCache::Store(info, content.data(), content.size()), std::runtime_error);
+  ASSERT_FALSE(FileCache::Contains(info));
+  // No temporary files are left behind.
+  ASSERT_TRUE(fs::is_empty(fs::path(FileCache::GetPath(info.hash)).parent_path()));
+
+  auto invalid = info;
+  invalid.hash = "../../" + info.hash.substr(6u);
+  ASSERT_THROW(FileCache::GetPath(invalid.hash), std::invalid_argument);
+
+  fs::remove_all(folder);
+  FileTransfer::SetFilesBaseFolder(previous_folder);
+}
@@ -6,11 +6,24 @@
 
 #include "test.h"
 
+#include <carla/image/ColorConverterKernels.h>
 #include <carla/image/ImageConverter.h>
+#include <carla/image/ImageEncoder.h>
 #include <carla/image/ImageIO.h>
 #include <carla/image/ImageView.h>
+#include <carla/image/ImageWriter.h>
+#include <carla/sensor/CompositeSerializer.h>
+#include <carla/sensor/data/Image.h>
+#include <carla/sensor/s11n/ImageSerializer.h>
+#include <carla/sensor/s11n/SensorHeaderSerializer.h>
 
+#include <boost/filesystem.hpp>
+
+#include <cstring>
+#include <fstream>
 #include <memory>
+#include <random>
+#include <vector>
 
 template <typename ViewT, typename PixelT>
 struct TestImage {
@@ -186,3 +199,283 @@ TEST(image, semantic_segmentation) {
     }
   }
 }
+
+/// Compare a kernel of ColorConverterKernels with ImageConverter.
+template <typename ColorConverterT, typename KernelT>
+static void TestColorConverterKernel(std::vector<uint8_t> pixels, KernelT kernel) {
+  using namespace boost::gil;
+  using namespace carla::image;
+  const size_t pixel_count = pixels.size() / 4u;
+  auto view = interleaved_view(
+      pixel_count,
+      1u,
+      reinterpret_cast<bgra8_pixel_t *>(pixels.data()),
+      static_cast<long>(pixels.size()));
+  std::vector<uint8_t> converted(pixels.size());
+  kernel(pixels.data(), converted.data(), pixel_count, false);
+  std::vector<uint8_t> converted_in_parallel(pixels.data(), pixels.data() + pixels.size());
+  kernel(converted_in_parallel.data(), converted_in_parallel.data(), pixel_count, true);
+  ImageConverter::ConvertInPlace(view, ColorConverterT());
+  ASSERT_EQ(converted, pixels);
+  ASSERT_EQ(converted_in_parallel, pixels);
+}
+
+TEST(image, color_converter_kernels) {
+  using namespace carla::image;
+#ifdef NDEBUG
+  constexpr uint32_t step = 1u;
+#else
+  constexpr uint32_t step = 61u;
+#endif // NDEBUG
+  // Every depth, or a sample in debug.
+  std::vector<uint8_t> depths;
+  for (uint32_t depth = 0u; depth < (1u << 24u); depth += step) {
+    depths.insert(depths.end(), {
+        static_cast<uint8_t>(depth >> 16u),
+        static_cast<uint8_t>(depth >> 8u),
+        static_cast<uint8_t>(depth),
+        static_cast<uint8_t>(depth % 7u)});
+  }
+  TestColorConverterKernel<ColorConverter::Depth>(depths, &ColorConverterKernels::Depth);
+  TestColorConverterKernel<ColorConverter::LogarithmicDepth>(depths, &ColorConverterKernels::LogarithmicDepth);
+
+  std::vector<uint8_t> tags;
+  for (uint32_t tag = 0u; tag < 256u; ++tag) {
+    tags.insert(tags.end(), {7u, 3u, static_cast<uint8_t>(tag), 0u});
+  }
+  TestColorConverterKernel<ColorConverter::CityScapesPalette>(tags, &ColorConverterKernels::CityScapesPalette);
+
+  // Optical flow, only the result of splitting the image among threads.
+  std::mt19937 random_engine(3u);
+  std::normal_distribution<float> flow(0.0f, 2.0f);
+  std::vector<float> flows(2u * 300000u);
+  for (auto &value : flows) {
+    value = flow(random_engine);
+  }
+  std::vector<uint8_t> colors(2u * flows.size());
+  std::vector<uint8_t> colors_in_parallel(colors.size());
+  ColorConverterKernels::OpticalFlow(flows.data(), colors.data(), flows.size() / 2u, false);
+  ColorConverterKernels::OpticalFlow(flows.data(), colors_in_parallel.data(), flows.size() / 2u, true);
+  ASSERT_EQ(colors, colors_in_parallel);
+  const float zero[2u] = {0.0f, 0.0f};
+  uint8_t black[4u] = {1u, 1u, 1u, 1u};
+  ColorConverterKernels::OpticalFlow(zero, black, 1u);
+  ASSERT_EQ(black[0u], 0u);
+  ASSERT_EQ(black[1u], 0u);
+  ASSERT_EQ(black[2u], 0u);
+  ASSERT_EQ(black[3u], 0u);
+}
+
+/// BGRA pixels with smooth gradients, flat areas and some noise, so every QOI
+/// operation is used.
+static std::vector<uint8_t> MakeBGRA(uint32_t width, uint32_t height) {
+  std::mt19937 random_engine(7u);
+  std::vector<uint8_t> pixels(4u * width * height);
+  for (uint32_t y = 0u; y < height; ++y) {
+    for (uint32_t x = 0u; x < width; ++x) {
+      auto *pixel = &pixels[4u * (y * width + x)];
+      if (y < height / 3u) {
+        pixel[0u] = static_cast<uint8_t>(x);
+        pixel[1u] = static_cast<uint8_t>(x + y);
+        pixel[2u] = static_cast<uint8_t>(y);
+        pixel[3u] = 255u;
+      } else if (y < 2u * height / 3u) {
+        pixel[0u] = static_cast<uint8_t>(x / 64u * 40u);
+        pixel[1u] = 10u;
+        pixel[2u] = static_cast<uint8_t>(y / 16u * 20u);
+        pixel[3u] = 255u;
+      } else {
+        const auto value = random_engine();
+        std::memcpy(pixel, &value, 4u);
+      }
+    }
+  }
+  return pixels;
+}
+
+TEST(image, qoi) {
+  using carla::image::ImageEncoder;
+  for (auto size : {std::make_pair(1u, 1u), std::make_pair(300u, 200u), std::make_pair(1u, 500u)}) {
+    const auto pixels = MakeBGRA(size.first, size.second);
+    std::vector<uint8_t> encoded;
+    ImageEncoder::EncodeQOI(pixels.data(), size.first, size.second, encoded);
+    std::vector<uint8_t> decoded;
+    uint32_t width = 0u;
+    uint32_t height = 0u;
+    ImageEncoder::DecodeQOI(encoded.data(), encoded.size(), decoded, width, height);
+    ASSERT_EQ(width, size.first);
+    ASSERT_EQ(height, size.second);
+    ASSERT_EQ(decoded, pixels);
+  }
+
+  // A single opaque black pixel is a run of the initial pixel.
+  const uint8_t black[4u] = {0u, 0u, 0u, 255u};
+  std::vector<uint8_t> encoded;
+  ImageEncoder::EncodeQOI(black, 1u, 1u, encoded);
+  const std::vector<uint8_t> expected = {
+      'q', 'o', 'i', 'f', 0u, 0u, 0u, 1u, 0u, 0u, 0u, 1u, 4u, 0u,
+      0xc0u,
+      0u, 0u, 0u, 0u, 0u, 0u, 0u, 1u};
+  ASSERT_EQ(encoded, expected);
+
+#ifndef LIBCARLA_NO_EXCEPTIONS
+  std::vector<uint8_t> decoded;
+  uint32_t width = 0u;
+  uint32_t height = 0u;
+  const auto pixels = MakeBGRA(64u, 64u);
+  encoded.clear();
+  ImageEncoder::EncodeQOI(pixels.data(), 64u, 64u, encoded);
+  ASSERT_THROW(ImageEncoder::DecodeQOI(encoded.data(), encoded.size() / 2u, decoded, width, height), std::runtime_error);
+  ASSERT_THROW(ImageEncoder::DecodeQOI(pixels.data(), pixels.size(), decoded, width, height), std::runtime_error);
+#endif // LIBCARLA_NO_EXCEPTIONS
+}
+
+TEST(image, bmp) {
+  using carla::image::ImageEncoder;
+  const auto pixels = MakeBGRA(31u, 7u);
+  std::vector<uint8_t> encoded;
+  ImageEncoder::EncodeBMP(pixels.data(), 31u, 7u, encoded);
+  ASSERT_EQ(encoded.size(), 54u + pixels.size());
+  ASSERT_EQ(encoded[0u], 'B');
+  ASSERT_EQ(encoded[1u], 'M');
+  int32_t width;
+  int32_t height;
+  uint16_t bits;
+  std::memcpy(&width, &encoded[18u], 4u);
+  std::memcpy(&height, &encoded[22u], 4u);
+  std::memcpy(&bits, &encoded[28u], 2u);
+  ASSERT_EQ(width, 31);
+  ASSERT_EQ(height, -7);
+  ASSERT_EQ(bits, 32u);
+  ASSERT_TRUE(std::equal(pixels.begin(), pixels.end(), encoded.begin() + 54u));
+}
+
+#if LIBCARLA_IMAGE_WITH_PNG_SUPPORT
+TEST(image, png_compression_level) {
+  namespace fs = boost::filesystem;
+  using namespace carla::image;
+  const uint32_t width = 256u;
+  const uint32_t height = 128u;
+  const auto pixels = MakeBGRA(width, height);
+  const auto path = (fs::temp_directory_path() / fs::unique_path("%%%%-%%%%.png")).string();
+  size_t previous_size = 0u;
+  for (int level : {0, 1, 6}) {
+    std::vector<uint8_t> encoded;
+    ImageEncoder::EncodePNG(pixels.data(), width, height, encoded, level);
+    if (level == 0) {
+      ASSERT_GT(encoded.size(), pixels.size());
+    } else {
+      ASSERT_LT(encoded.size(), previous_size);
+    }
+    previous_size = encoded.size();
+    {
+      std::ofstream out(path, std::ios::binary);
+      out.write(reinterpret_cast<const char *>(encoded.data()), static_cast<std::streamsize>(encoded.size()));
+    }
+    boost::gil::rgba8_image_t image;
+    ImageIO::ReadImage(path, image, io::png());
+    ASSERT_EQ(image.width(), width);
+    ASSERT_EQ(image.height(), height);
+    const auto view = boost::gil::const_view(image);
+    for (uint32_t y = 0u; y < height; ++y) {
+      for (uint32_t x = 0u; x < width; ++x) {
+        const auto &pixel = view(x, y);
+        const auto *expected = &pixels[4u * (y * width + x)];
+        ASSERT_EQ(pixel[0u], expected[2u]);
+        ASSERT_EQ(pixel[1u], expected[1u]);
+        ASSERT_EQ(pixel[2u], expected[0u]);
+        ASSERT_EQ(pixel[3u], expected[3u]);
+      }
+    }
+  }
+  fs::remove(path);
+}
+#endif // LIBCARLA_IMAGE_WITH_PNG_SUPPORT
+
+namespace {
+
+  struct FakeCamera {
+    uint32_t GetImageWidth() const { return width; }
+    uint32_t GetImageHeight() const { return height; }
+    float GetFOVAngle() const { return 90.0f; }
+    carla::sensor::s11n::ImageCodec GetImageCodec() const { return carla::sensor::s11n::ImageCodec::None; }
+
+    uint32_t width;
+    uint32_t height;
+  };
+
+  using FakeRegistry = carla::sensor::CompositeSerializer<
+      std::pair<FakeCamera *, carla::sensor::s11n::ImageSerializer>>;
+
+} // namespace
+
+/// Build a sensor image the way the client receives it.
+static carla::SharedPtr<carla::sensor::data::Image> MakeSensorImage(
+    uint32_t width,
+    uint32_t height,
+    const std::vector<uint8_t> &pixels) {
+  using namespace carla::sensor;
+  FakeCamera camera{width, height};
+  carla::Buffer bitmap(static_cast<uint64_t>(s11n::ImageSerializer::header_offset + pixels.size()));
+  std::memcpy(bitmap.data() + s11n::ImageSerializer::header_offset, pixels.data(), pixels.size());
+  auto payload = FakeRegistry::Serialize(camera, std::move(bitmap));
+  auto header = s11n::SensorHeaderSerializer::Serialize(0u, 1u, 1.0, carla::rpc::Transform{});
+  carla::Buffer message(static_cast<uint64_t>(header.size() + payload.size()));
+  std::memcpy(message.data(), header.data(), header.size());
+  std::memcpy(message.data() + header.size(), payload.data(), payload.size());
+  return boost::dynamic_pointer_cast<data::Image>(FakeRegistry::Deserialize(std::move(message)));
+}
+
+TEST(image, writer) {
+  namespace fs = boost::filesystem;
+  using namespace carla::image;
+  const uint32_t width = 160u;
+  const uint32_t height = 90u;
+  const auto pixels = MakeBGRA(width, height);
+  const auto image = MakeSensorImage(width, height, pixels);
+  ASSERT_NE(image, nullptr);
+  const auto folder = fs::temp_directory_path() / fs::unique_path();
+
+  {
+    ImageWriter writer(2u, 64u);
+    auto bmp = writer.Write(image, (folder / "image.bmp").string());
+    auto qoi = writer.Write(image, (folder / "image.QOI").string());
+    auto no_extension = writer.Write(image, (folder / "image").string());
+    ASSERT_TRUE(bmp.valid());
+    ASSERT_TRUE(qoi.valid());
+    ASSERT_TRUE(no_extension.valid());
+    ASSERT_EQ(bmp.get(), (folder / "image.bmp").string());
+    ASSERT_EQ(qoi.get(), (folder / "image.QOI").string());
+    ASSERT_EQ(no_extension.get(), (folder / "image.png").string());
+    ASSERT_EQ(fs::file_size(folder / "image.bmp"), 54u + pixels.size());
+
+    std::ifstream in((folder / "image.QOI").string(), std::ios::binary);
+    const std::vector<uint8_t> encoded{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    std::vector<uint8_t> decoded;
+    uint32_t decoded_width = 0u;
+    uint32_t decoded_height = 0u;
+    ImageEncoder::DecodeQOI(encoded.data(), encoded.size(), decoded, decoded_width, decoded_height);
+    ASSERT_EQ(decoded_width, width);
+    ASSERT_EQ(decoded_height, height);
+    // The client makes every pixel opaque.
+    ASSERT_EQ(decoded.size(), pixels.size());
+    ASSERT_EQ(std::memcmp(decoded.data(), image->data(), decoded.size()), 0);
+  }
+
+  {
+    // A full queue drops the images instead of blocking.
+    constexpr size_t number_of_images = 50u;
+    ImageWriter writer(1u, 2u);
+    size_t written = 0u;
+    for (size_t i = 0u; i < number_of_images; ++i) {
+      auto future = writer.Write(image, (folder / ("drop_" + std::to_string(i) + ".bmp")).string());
+      written += future.valid() ? 1u : 0u;
+    }
+    writer.Flush();
+    ASSERT_EQ(writer.GetQueuedCount(), 0u);
+    ASSERT_EQ(written + writer.GetDroppedCount(), number_of_images);
+    ASSERT_GE(written, 2u);
+  }
+
+  fs::remove_all(folder);
+}
@@ -14,13 +14,17 @@
 #include <carla/geom/Math.h>
 #include <carla/opendrive/OpenDriveParser.h>
 #include <carla/road/MapBuilder.h>
+#include <carla/road/RoutingGraph.h>
+#include <carla/road/element/LaneCrossingCalculator.h>
 #include <carla/road/element/RoadInfoElevation.h>
 #include <carla/road/element/RoadInfoGeometry.h>
 #include <carla/road/element/RoadInfoMarkRecord.h>
+#include <carla/road/element/RoadInfoSignal.h>
 #include <carla/road/element/RoadInfoVisitor.h>
 
 #include <pugixml/pugixml.hpp>
 
+#include <cmath>
 #include <fstream>
 #include <string>
 
@@ -301,6 +305,70 @@ TEST(road, parse_geometry) {
 
 }
 
+/// Point at distance @a s along the curve (u(p), v(p)) from p = 0, walking
+/// chords of a tiny parameter step.
+template <typename FunctorT>
+static std::pair<double, double> WalkCurve(FunctorT &&curve, double s) {
+  constexpr double dp = 1e-5;
+  auto last = curve(0.0);
+  double walked = 0.0;
+  for (double p = dp; ; p += dp) {
+    const auto next = curve(p);
+    const double chord = std::hypot(next.first - last.first, next.second - last.second);
+    if (walked + chord >= s) {
+      const double t = chord > 0.0 ? (s - walked) / chord : 0.0;
+      return {last.first + t * (next.first - last.first), last.second + t * (next.second - last.second)};
+    }
+    walked += chord;
+    last = next;
+  }
+}
+
+TEST(road, poly3_arc_length) {
+  const CubicPolynomial u(0.0, 50.0, -10.0, 5.0);
+  const CubicPolynomial v(0.0, 0.0, 25.0, -10.0);
+  const auto param_curve = [&](double p) { return std::make_pair(u.Evaluate(p), v.Evaluate(p)); };
+  const CubicPolynomial poly(1.0, 0.1, 0.02, -0.0005);
+  const auto poly_curve = [&](double p) { return std::make_pair(p, poly.Evaluate(p)); };
+
+  constexpr double length = 40.0;
+  const Location start(10.0f, -5.0f, 0.0f);
+  const double heading = 0.3;
+  const GeometryParamPoly3 param_poly3(
+      0.0, length, heading, start,
+      u.GetA(), u.GetB(), u.GetC(), u.GetD(),
+      v.GetA(), v.GetB(), v.GetC(), v.GetD(),
+      false);
+  const GeometryPoly3 poly3(
+      0.0, length, heading, start,
+      poly.GetA(), poly.GetB(), poly.GetC(), poly.GetD());
+
+  const auto check = [&](const Geometry &geometry, auto &&curve) {
+    for (double s = 0.0; s <= length; s += 2.7) {
+      const auto expected_local = WalkCurve(curve, s);
+      const double c = std::cos(heading);
+      const double sn = std::sin(heading);
+      const Location expected(
+          start.x + static_cast<float>(c * expected_local.first - sn * expected_local.second),
+          start.y + static_cast<float>(sn * expected_local.first + c * expected_local.second),
+          0.0f);
+      const auto point = geometry.PosFromDist(s);
+      ASSERT_NEAR(point.location.x, expected.x, 1e-3) << "s = " << s;
+      ASSERT_NEAR(point.location.y, expected.y, 1e-3) << "s = " << s;
+
+      // A point two meters to the left projects back onto s.
+      Location offset = point.location;
+      offset.x += static_cast<float>(-2.0 * std::sin(point.tangent));
+      offset.y += static_cast<float>(2.0 * std::cos(point.tangent));
+      const auto nearest = geometry.DistanceTo(offset);
+      ASSERT_NEAR(nearest.first, s, 1e-2) << "s = " << s;
+      ASSERT_NEAR(nearest.second, 2.0, 1e-2) << "s = " << s;
+    }
+  };
+  check(param_poly3, param_curve);
+  check(poly3, poly_curve);
+}
+
 TEST(road, iterate_waypoints) {
   carla::ThreadPool pool;
   pool.AsyncRun();
@@ -424,3 +492,190 @@ TEST(road, get_waypoint) {
     result.get();
   }
 }
+
+TEST(road, export_waypoints) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto map = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(map.has_value());
+    const auto waypoints = map->GenerateWaypoints(2.0);
+    const auto columns = map->ExportWaypoints(waypoints);
+    ASSERT_EQ(columns.size(), waypoints.size()) << file;
+    for (size_t i = 0u; i < waypoints.size(); ++i) {
+      const auto &waypoint = waypoints[i];
+      const auto transform = map->ComputeTransform(waypoint);
+      ASSERT_EQ(columns.road_id[i], waypoint.road_id);
+      ASSERT_EQ(columns.section_id[i], waypoint.section_id);
+      ASSERT_EQ(columns.lane_id[i], waypoint.lane_id);
+      ASSERT_EQ(columns.s[i], waypoint.s);
+      ASSERT_EQ(columns.x[i], transform.location.x);
+      ASSERT_EQ(columns.y[i], transform.location.y);
+      ASSERT_EQ(columns.z[i], transform.location.z);
+      ASSERT_EQ(columns.yaw[i], transform.rotation.yaw);
+      ASSERT_EQ(columns.lane_width[i], map->GetLaneWidth(waypoint));
+      ASSERT_EQ(columns.lane_type[i], static_cast<int32_t>(map->GetLaneType(waypoint)));
+    }
+
+    // Missing waypoints leave their row zero.
+    std::vector<boost::optional<Waypoint>> optional_waypoints(3u);
+    if (!waypoints.empty()) {
+      optional_waypoints[1u] = waypoints.back();
+    }
+    const auto optional_columns = map->ExportWaypoints(optional_waypoints);
+    ASSERT_EQ(optional_columns.size(), 3u);
+    ASSERT_EQ(optional_columns.road_id[0u], 0u);
+    ASSERT_EQ(optional_columns.lane_width[2u], 0.0);
+    if (!waypoints.empty()) {
+      ASSERT_EQ(optional_columns.road_id[1u], columns.road_id.back());
+      ASSERT_EQ(optional_columns.x[1u], columns.x.back());
+    }
+  }
+}
+
+TEST(road, lane_area_has_no_crossings) {
+  using Calculator = LaneCrossingCalculator;
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto m = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(m.has_value());
+    auto &map = *m;
+    size_t areas = 0u;
+    for (const auto &waypoint : map.GenerateWaypoints(2.0)) {
+      const auto origin = Calculator::Locate(map, map.ComputeTransform(waypoint).location);
+      const auto area = Calculator::MakeLaneArea(map, origin);
+      if (!area.has_value()) {
+        continue;
+      }
+      ++areas;
+      // Moving between any two locations inside the area crosses nothing.
+      const Vector3D right{-area->forward.y, area->forward.x, 0.0f};
+      std::vector<Location> locations;
+      for (const float u : {-1.0f, -0.5f, 0.0f, 0.5f, 1.0f}) {
+        for (const float v : {-1.0f, 0.0f, 1.0f}) {
+          locations.emplace_back(
+              area->center + Location(
+                  0.99f * area->half_length * u * area->forward +
+                  0.99f * area->half_width * v * right));
+          ASSERT_TRUE(area->Contains(locations.back()));
+        }
+      }
+      for (const auto &from : locations) {
+        for (const auto &to : locations) {
+          ASSERT_TRUE(map.CalculateCrossedLanes(from, to).empty());
+        }
+      }
+      ASSERT_FALSE(area->Contains(area->center + Location(1.01f * area->half_width * right)));
+    }
+    ASSERT_GT(areas, 0u);
+  }
+}
+
+TEST(road, generate_mesh) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto map = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(map.has_value());
+    // Pieces are built in parallel but merged in a fixed order.
+    const auto mesh = map->GenerateMesh(2.0);
+    ASSERT_TRUE(mesh.IsValid()) << file;
+    ASSERT_EQ(mesh.GetVertices(), map->GenerateMesh(2.0).GetVertices()) << file;
+
+    carla::rpc::OpendriveGenerationParameters params;
+    size_t chunked_vertices = 0u;
+    size_t chunked_indexes = 0u;
+    for (const auto &chunk : map->GenerateChunkedMesh(params)) {
+      chunked_vertices += chunk->GetVerticesNum();
+      chunked_indexes += chunk->GetIndexesNum();
+    }
+    size_t streamed_vertices = 0u;
+    size_t streamed_indexes = 0u;
+    map->StreamChunkedMesh(params, [&](std::unique_ptr<Mesh> piece) {
+      streamed_vertices += piece->GetVerticesNum();
+      streamed_indexes += piece->GetIndexesNum();
+    });
+    ASSERT_GT(streamed_vertices, 0u) << file;
+    ASSERT_EQ(streamed_vertices, chunked_vertices) << file;
+    ASSERT_EQ(streamed_indexes, chunked_indexes) << file;
+  }
+}
+
+TEST(road, get_signals_in_distance) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto map = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(map.has_value());
+    size_t signal_references = 0u;
+    for (const auto &road : map->GetMap().GetRoads()) {
+      signal_references += road.second.GetInfos<RoadInfoSignal>().size();
+    }
+    ASSERT_EQ(map->GetAllSignalReferences().size(), signal_references) << file;
+    for (const auto &waypoint : map->GenerateWaypoints(5.0)) {
+      const auto near = map->GetSignalsInDistance(waypoint, 20.0);
+      const auto far = map->GetSignalsInDistance(waypoint, 100.0);
+      ASSERT_LE(near.size(), far.size()) << file;
+      for (const auto &result : far) {
+        ASSERT_GE(result.accumulated_s, 0.0);
+        ASSERT_LE(result.accumulated_s, 100.0 + 1e-3);
+      }
+      // Every signal found nearby is also found farther away.
+      for (const auto &result : near) {
+        ASSERT_LE(result.accumulated_s, 20.0 + 1e-3);
+        ASSERT_TRUE(std::any_of(far.begin(), far.end(), [&](const Map::SignalSearchData &other) {
+          return other.signal == result.signal &&
+                 std::abs(other.accumulated_s - result.accumulated_s) < 1e-3;
+        })) << file;
+      }
+    }
+  }
+}
+
+TEST(road, routing) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    auto map = OpenDriveParser::Load(util::OpenDrive::Load(file));
+    ASSERT_TRUE(map.has_value());
+    const RoutingGraph graph(*map);
+    ASSERT_GT(graph.GetNumberOfNodes(), 0u) << file;
+    carla::logging::log(file, ':', graph.GetNumberOfNodes(), "lanes,",
+        graph.GetNumberOfEdges(), "edges,", graph.GetNumberOfShortcuts(), "shortcuts");
+
+    auto waypoints = map->GenerateWaypoints(5.0);
+    util::Random::Shuffle(waypoints);
+    const size_t size = std::min<size_t>(20u, waypoints.size() / 2u);
+    const std::vector<Waypoint> origins(waypoints.begin(), waypoints.begin() + size);
+    const std::vector<Waypoint> destinations(waypoints.begin() + size, waypoints.begin() + 2u * size);
+
+    // The hierarchy finds the same distances as a plain Dijkstra.
+    const auto distances = graph.ComputeDistances(origins, destinations);
+    ASSERT_EQ(distances.size(), size * size);
+    for (size_t i = 0u; i < size; ++i) {
+      for (size_t j = 0u; j < size; ++j) {
+        const double expected = graph.ComputeDistanceDijkstra(origins[i], destinations[j]);
+        const double distance = distances[i * size + j];
+        if (std::isinf(expected)) {
+          ASSERT_TRUE(std::isinf(distance)) << file;
+          ASSERT_TRUE(graph.ComputeRoute(origins[i], destinations[j]).empty());
+          continue;
+        }
+        ASSERT_NEAR(distance, expected, 1e-6 * (1.0 + expected)) << file;
+        ASSERT_NEAR(graph.ComputeDistance(origins[i], destinations[j]), expected, 1e-6 * (1.0 + expected));
+
+        // Each waypoint of the route follows the previous lane or is on a
+        // neighbouring lane.
+        const auto route = graph.ComputeRoute(origins[i], destinations[j]);
+        ASSERT_GE(route.size(), 2u);
+        ASSERT_EQ(route.front(), origins[i]);
+        ASSERT_EQ(route.back(), destinations[j]);
+        for (size_t k = 2u; k + 1u < route.size(); ++k) {
+          const auto &previous = route[k - 1u];
+          const auto &current = route[k];
+          const bool is_lane_change =
+              previous.road_id == current.road_id &&
+              previous.section_id == current.section_id;
+          const auto successors = map->GetSuccessors(previous);
+          const bool is_successor = std::any_of(successors.begin(), successors.end(), [&](const Waypoint &successor) {
+            return successor.road_id == current.road_id &&
+                   successor.section_id == current.section_id &&
+                   successor.lane_id == current.lane_id;
+          });
+          ASSERT_TRUE(is_lane_change || is_successor) << file;
+        }
+      }
+    }
+  }
+}
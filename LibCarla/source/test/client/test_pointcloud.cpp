@@ -0,0 +1,147 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/pointcloud/PointCloudIO.h>
+#include <carla/pointcloud/PointCloudWriter.h>
+#include <carla/sensor/data/LidarData.h>
+#include <carla/sensor/data/SemanticLidarData.h>
+
+#include <boost/filesystem.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+using carla::pointcloud::PointCloudIO;
+using carla::pointcloud::PointCloudWriter;
+using carla::sensor::data::LidarDetection;
+using carla::sensor::data::SemanticLidarDetection;
+
+static std::vector<LidarDetection> MakeDetections(size_t count) {
+  std::vector<LidarDetection> detections;
+  for (size_t i = 0u; i < count; ++i) {
+    const float f = static_cast<float>(i);
+    detections.emplace_back(f, -f, 0.5f * f, 1.0f / (1.0f + f));
+  }
+  return detections;
+}
+
+/// Split @a data into the header, up to and including "end_header\n" or
+/// "DATA binary\n", and the body.
+static std::pair<std::string, std::string> SplitHeader(const std::string &data, const std::string &last_line) {
+  const auto end = data.find(last_line);
+  EXPECT_NE(end, std::string::npos);
+  return {data.substr(0u, end + last_line.size()), data.substr(end + last_line.size())};
+}
+
+TEST(pointcloud, ply_binary) {
+  const auto detections = MakeDetections(10000u);
+  std::ostringstream out;
+  PointCloudIO::DumpBinary(out, detections.data(), detections.data() + detections.size());
+  const auto split = SplitHeader(out.str(), "end_header\n");
+  ASSERT_EQ(split.first,
+      "ply\n"
+      "format binary_little_endian 1.0\n"
+      "element vertex 10000\n"
+      "property float32 x\n"
+      "property float32 y\n"
+      "property float32 z\n"
+      "property float32 I\n"
+      "end_header\n");
+  ASSERT_EQ(split.second.size(), sizeof(float) * 4u * detections.size());
+  for (size_t i = 0u; i < detections.size(); ++i) {
+    float point[4u];
+    std::memcpy(point, split.second.data() + sizeof(point) * i, sizeof(point));
+    ASSERT_EQ(point[0u], detections[i].point.x);
+    ASSERT_EQ(point[1u], detections[i].point.y);
+    ASSERT_EQ(point[2u], detections[i].point.z);
+    ASSERT_EQ(point[3u], detections[i].intensity);
+  }
+
+  // Non-contiguous points are written in batches with the same result.
+  const std::list<LidarDetection> list(detections.begin(), detections.end());
+  std::ostringstream list_out;
+  PointCloudIO::DumpBinary(list_out, list.begin(), list.end());
+  ASSERT_EQ(list_out.str(), out.str());
+}
+
+TEST(pointcloud, pcd_binary) {
+  const std::vector<SemanticLidarDetection> detections = {
+      {1.0f, 2.0f, 3.0f, 0.5f, 7u, 10u},
+      {-1.0f, -2.0f, -3.0f, 0.25f, 8u, 12u}};
+  std::ostringstream out;
+  PointCloudIO::DumpPcd(out, detections.begin(), detections.end());
+  const auto split = SplitHeader(out.str(), "DATA binary\n");
+  ASSERT_EQ(split.first,
+      "# .PCD v0.7 - Point Cloud Data file format\n"
+      "VERSION 0.7\n"
+      "FIELDS x y z cos_angle object_idx object_tag\n"
+      "SIZE 4 4 4 4 4 4\n"
+      "TYPE F F F F U U\n"
+      "COUNT 1 1 1 1 1 1\n"
+      "WIDTH 2\n"
+      "HEIGHT 1\n"
+      "VIEWPOINT 0 0 0 1 0 0 0\n"
+      "POINTS 2\n"
+      "DATA binary\n");
+  ASSERT_EQ(split.second.size(), sizeof(SemanticLidarDetection) * detections.size());
+  ASSERT_EQ(std::memcmp(split.second.data(), detections.data(), split.second.size()), 0);
+}
+
+TEST(pointcloud, empty) {
+  const std::vector<LidarDetection> detections;
+  std::ostringstream out;
+  PointCloudIO::DumpBinary(out, detections.begin(), detections.end());
+  ASSERT_EQ(out.str(),
+      "ply\n"
+      "format binary_little_endian 1.0\n"
+      "element vertex 0\n"
+      "end_header\n");
+}
+
+TEST(pointcloud, writer) {
+  namespace fs = boost::filesystem;
+  const auto folder = fs::temp_directory_path() / fs::unique_path();
+  auto detections = std::make_shared<const std::vector<LidarDetection>>(MakeDetections(1000u));
+
+  std::ostringstream expected;
+  PointCloudIO::DumpBinary(expected, detections->begin(), detections->end());
+
+  constexpr size_t number_of_clouds = 20u;
+  size_t written = 0u;
+  {
+    PointCloudWriter writer(4u);
+    for (size_t i = 0u; i < number_of_clouds; ++i) {
+      if (writer.Write(detections, (folder / std::to_string(i)).string())) {
+        ++written;
+      }
+    }
+    ASSERT_EQ(written + writer.GetDroppedCount(), number_of_clouds);
+    writer.Flush();
+    ASSERT_EQ(writer.GetQueuedCount(), 0u);
+    ASSERT_EQ(writer.GetFailedCount(), 0u);
+  }
+  ASSERT_GE(written, 4u);
+
+  size_t files = 0u;
+  for (size_t i = 0u; i < number_of_clouds; ++i) {
+    const auto path = folder / (std::to_string(i) + ".ply");
+    if (!fs::exists(path)) {
+      continue;
+    }
+    ++files;
+    std::ifstream in(path.string(), std::ios::binary);
+    const std::string data{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    ASSERT_EQ(data, expected.str());
+  }
+  ASSERT_EQ(files, written);
+  fs::remove_all(folder);
+}
@@ -8,6 +8,8 @@
 
 #include <carla/MsgPackAdaptors.h>
 #include <carla/ThreadGroup.h>
+#include <carla/client/TimeoutException.h>
+#include <carla/client/detail/Client.h>
 #include <carla/rpc/Actor.h>
 #include <carla/rpc/Client.h>
 #include <carla/rpc/Response.h>
@@ -62,3 +64,67 @@ TEST(rpc, server_bind_sync_run_on_game_thread) {
   std::cout << "game thread: run " << i << " slices.\n";
   ASSERT_TRUE(done);
 }
+
+TEST(rpc, shared_connection) {
+  const uint16_t port = (TESTING_PORT != 0u ? TESTING_PORT : 2017u);
+
+  Server server(port);
+
+  server.BindAsync("is_traffic_manager_running", [](uint16_t tm_port) -> Response<bool> {
+    return (tm_port % 2u) == 0u;
+  });
+
+  server.BindAsync("version", []() -> Response<std::string> {
+    std::this_thread::sleep_for(200ms);
+    return std::string("slow");
+  });
+
+  server.AsyncRun(4u);
+
+  using carla::client::detail::Client;
+  const size_t initial_connections = Client::GetNumberOfConnections();
+  constexpr size_t number_of_clients = 4u;
+  std::vector<std::unique_ptr<Client>> clients;
+  for (auto i = 0u; i < number_of_clients; ++i) {
+    clients.emplace_back(std::make_unique<Client>("localhost", port, 1u, true));
+  }
+  ASSERT_EQ(Client::GetNumberOfConnections(), initial_connections + 1u);
+  {
+    // A client that does not share opens its own connection.
+    Client alone("localhost", port, 1u);
+    ASSERT_EQ(Client::GetNumberOfConnections(), initial_connections + 2u);
+  }
+  ASSERT_EQ(Client::GetNumberOfConnections(), initial_connections + 1u);
+
+  // Calls of every client are multiplexed in the same connection.
+  {
+    carla::ThreadGroup threads;
+    for (auto &client : clients) {
+      threads.CreateThread([&]() {
+        for (uint16_t i = 0u; i < 200u; ++i) {
+          EXPECT_EQ(client->IsTrafficManagerRunning(i), (i % 2u) == 0u);
+        }
+      });
+    }
+  }
+
+  // Each client keeps its own timeout.
+  clients[0u]->SetTimeout(50ms);
+  clients[1u]->SetTimeout(5s);
+  ASSERT_EQ(clients[1u]->GetTimeout().milliseconds(), 5000u);
+  ASSERT_THROW(clients[0u]->GetServerVersion(), carla::client::TimeoutException);
+  ASSERT_EQ(clients[1u]->GetServerVersion(), "slow");
+
+  // The connection stays open while any client uses it.
+  clients.erase(clients.begin(), clients.begin() + 2u);
+  ASSERT_TRUE(clients[0u]->IsTrafficManagerRunning(2u));
+  {
+    Client other("localhost", port, 1u, true);
+    ASSERT_FALSE(other.IsTrafficManagerRunning(3u));
+    ASSERT_EQ(Client::GetNumberOfConnections(), initial_connections + 1u);
+  }
+
+  // And it is closed with its last client.
+  clients.clear();
+  ASSERT_EQ(Client::GetNumberOfConnections(), initial_connections);
+}
@@ -0,0 +1,140 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/client/detail/SensorFrameQueue.h>
+#include <carla/sensor/SensorData.h>
+
+#include <thread>
+
+using carla::time_duration;
+using carla::client::detail::SensorFrameQueue;
+using Policy = SensorFrameQueue::Policy;
+
+namespace {
+
+  class FakeData : public carla::sensor::SensorData {
+  public:
+
+    explicit FakeData(size_t frame) : SensorData(frame, 0.0, carla::rpc::Transform{}) {}
+  };
+
+} // namespace
+
+static void Push(SensorFrameQueue &queue, size_t sensor, size_t frame) {
+  queue.Push(sensor, carla::MakeShared<FakeData>(frame));
+}
+
+static const auto no_wait = time_duration::milliseconds(0);
+
+TEST(sensor_bundle, join_out_of_order) {
+  SensorFrameQueue queue(3u, Policy::Queue, 8u);
+  queue.Open();
+  Push(queue, 2u, 11u);
+  Push(queue, 0u, 10u);
+  Push(queue, 1u, 11u);
+  Push(queue, 2u, 10u);
+  ASSERT_FALSE(queue.WaitForNext(no_wait).has_value());
+  Push(queue, 0u, 11u);
+  // Frame 11 is complete before frame 10.
+  auto bundle = queue.WaitForNext(no_wait);
+  ASSERT_TRUE(bundle.has_value());
+  ASSERT_EQ(bundle->GetFrame(), 11u);
+  ASSERT_TRUE(bundle->IsComplete());
+  ASSERT_EQ(bundle->size(), 3u);
+  for (const auto &data : *bundle) {
+    ASSERT_NE(data, nullptr);
+    ASSERT_EQ(data->GetFrame(), 11u);
+  }
+  // Frame 10 is not going to complete anymore.
+  ASSERT_EQ(queue.GetNumberOfDroppedFrames(), 1u);
+  Push(queue, 1u, 10u);
+  ASSERT_FALSE(queue.WaitForFrame(10u, no_wait, true).has_value());
+}
+
+TEST(sensor_bundle, missing_frames) {
+  SensorFrameQueue queue(2u, Policy::Queue, 8u);
+  queue.Open();
+  for (size_t frame = 1u; frame <= 4u; ++frame) {
+    Push(queue, 0u, frame);
+    // The second sensor misses the odd frames.
+    if (frame % 2u == 0u) {
+      Push(queue, 1u, frame);
+    }
+  }
+  ASSERT_FALSE(queue.WaitForFrame(1u, no_wait).has_value());
+  auto incomplete = queue.WaitForFrame(1u, no_wait, true);
+  ASSERT_TRUE(incomplete.has_value());
+  ASSERT_FALSE(incomplete->IsComplete());
+  ASSERT_NE((*incomplete)[0u], nullptr);
+  ASSERT_EQ((*incomplete)[1u], nullptr);
+  // Late data for a frame already returned is discarded.
+  Push(queue, 1u, 1u);
+  ASSERT_FALSE(queue.WaitForFrame(1u, no_wait, true).has_value());
+
+  ASSERT_EQ(queue.WaitForNext(no_wait)->GetFrame(), 2u);
+  ASSERT_EQ(queue.WaitForNext(no_wait)->GetFrame(), 4u);
+  ASSERT_EQ(queue.GetNumberOfDroppedFrames(), 1u);
+  ASSERT_FALSE(queue.WaitForNext(no_wait).has_value());
+}
+
+TEST(sensor_bundle, bounded_queue) {
+  SensorFrameQueue queue(2u, Policy::Queue, 3u);
+  queue.Open();
+  // The second sensor lags behind.
+  for (size_t frame = 1u; frame <= 10u; ++frame) {
+    Push(queue, 0u, frame);
+  }
+  ASSERT_EQ(queue.GetNumberOfDroppedFrames(), 7u);
+  Push(queue, 1u, 5u);
+  Push(queue, 1u, 8u);
+  auto bundle = queue.WaitForNext(no_wait);
+  ASSERT_TRUE(bundle.has_value());
+  ASSERT_EQ(bundle->GetFrame(), 8u);
+  ASSERT_TRUE(bundle->IsComplete());
+}
+
+TEST(sensor_bundle, latest_only) {
+  SensorFrameQueue queue(2u, Policy::LatestOnly, 8u);
+  queue.Open();
+  Push(queue, 0u, 1u);
+  Push(queue, 0u, 2u);
+  Push(queue, 1u, 2u);
+  Push(queue, 0u, 3u);
+  Push(queue, 1u, 3u);
+  ASSERT_EQ(queue.GetNumberOfDroppedFrames(), 2u);
+  ASSERT_EQ(queue.WaitForNext(no_wait)->GetFrame(), 3u);
+  ASSERT_FALSE(queue.WaitForNext(no_wait).has_value());
+}
+
+TEST(sensor_bundle, wait_across_threads) {
+  SensorFrameQueue queue(2u, Policy::Queue, 8u);
+  queue.Open();
+  std::thread sensors([&]() {
+    Push(queue, 1u, 5u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    Push(queue, 0u, 5u);
+  });
+  auto bundle = queue.WaitForFrame(5u, time_duration::seconds(10));
+  sensors.join();
+  ASSERT_TRUE(bundle.has_value());
+  ASSERT_TRUE(bundle->IsComplete());
+}
+
+TEST(sensor_bundle, close_wakes_up_waiters) {
+  SensorFrameQueue queue(2u, Policy::Queue, 8u);
+  ASSERT_FALSE(queue.IsOpen());
+  queue.Open();
+  ASSERT_TRUE(queue.IsOpen());
+  std::thread closer([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.Close();
+  });
+  ASSERT_FALSE(queue.WaitForNext(time_duration::seconds(10)).has_value());
+  closer.join();
+  ASSERT_FALSE(queue.IsOpen());
+}
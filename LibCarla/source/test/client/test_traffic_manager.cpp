@@ -0,0 +1,65 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+#include "OpenDrive.h"
+#include "TrafficSimulation.h"
+
+#include <carla/geom/Math.h>
+
+using util::TrafficSimulation;
+
+static void CheckVehiclesDrive(const std::string &filename, const bool hybrid_physics_mode) {
+  TrafficSimulation simulation(util::OpenDrive::Load(filename), hybrid_physics_mode);
+  const size_t number_of_vehicles = simulation.SpawnVehicles(20u);
+  if (number_of_vehicles == 0u) {
+    return;
+  }
+
+  std::vector<carla::geom::Location> start;
+  for (auto id : simulation.GetVehicleIds()) {
+    start.emplace_back(simulation.GetTransform(id).location);
+  }
+  for (auto i = 0u; i < 200u; ++i) {
+    simulation.Tick();
+  }
+  ASSERT_EQ(simulation.GetTimestamp().frame, 200u);
+
+  size_t moving_vehicles = 0u;
+  for (auto id : simulation.GetVehicleIds()) {
+    const auto location = simulation.GetTransform(id).location;
+    if (carla::geom::Math::Distance2D(location, start[id - 1u]) > 5.0f) {
+      ++moving_vehicles;
+    }
+    // Vehicles follow the road.
+    auto waypoint = simulation.GetLocalMap().GetWaypoint(location);
+    ASSERT_NE(waypoint, nullptr);
+    ASSERT_LT(carla::geom::Math::Distance2D(waypoint->GetLocation(), location), 5.0f) << filename;
+  }
+  ASSERT_GT(moving_vehicles, 0u) << filename;
+}
+
+TEST(traffic_manager, offline_simulation) {
+  for (const auto &file : util::OpenDrive::GetAvailableFiles()) {
+    carla::logging::log("traffic_manager: simulating", file);
+    CheckVehiclesDrive(file, false);
+    CheckVehiclesDrive(file, true);
+  }
+}
+
+TEST(traffic_manager, offline_simulation_reset) {
+  auto files = util::OpenDrive::GetAvailableFiles();
+  ASSERT_FALSE(files.empty());
+  TrafficSimulation simulation(util::OpenDrive::Load(files.front()));
+  const auto count = simulation.SpawnVehicles(10u);
+  simulation.Tick();
+  simulation.Reset();
+  ASSERT_EQ(simulation.GetNumberOfVehicles(), 0u);
+  ASSERT_EQ(simulation.SpawnVehicles(10u), count);
+  simulation.Tick();
+  ASSERT_EQ(simulation.GetTimestamp().frame, 1u);
+  ASSERT_GT(simulation.GetStageTimes().Total(), 0.0);
+}
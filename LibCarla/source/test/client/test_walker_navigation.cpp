@@ -0,0 +1,38 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/client/detail/WalkerStepSchedule.h>
+
+using carla::client::detail::WalkerStepSchedule;
+
+TEST(walker_navigation, step_once_per_send) {
+  WalkerStepSchedule schedule;
+  ASSERT_TRUE(schedule.ShouldStep(10u));
+  schedule.OnStepped(10u);
+  // The worker got the next state before Tick sent the previous step.
+  ASSERT_FALSE(schedule.ShouldStep(11u));
+  schedule.OnSent();
+  // Tick with the same state the worker already stepped with.
+  ASSERT_FALSE(schedule.ShouldStep(10u));
+  ASSERT_TRUE(schedule.ShouldStep(11u));
+}
+
+TEST(walker_navigation, discard_stale_worker_step) {
+  WalkerStepSchedule schedule;
+  schedule.OnStepped(10u);
+  schedule.OnSent();
+  // The worker job for frame 11 waits for the lock while Tick steps inline
+  // with frame 12 and sends it.
+  ASSERT_TRUE(schedule.ShouldStep(12u));
+  schedule.OnStepped(12u);
+  schedule.OnSent();
+  // The delayed job must not step the crowd again with an older state.
+  ASSERT_FALSE(schedule.ShouldStep(11u));
+  ASSERT_FALSE(schedule.ShouldStep(12u));
+  ASSERT_TRUE(schedule.ShouldStep(13u));
+}
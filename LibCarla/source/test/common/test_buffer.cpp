@@ -8,11 +8,18 @@
 
 #include <carla/Buffer.h>
 #include <carla/BufferPool.h>
+#include <carla/BufferStream.h>
+#include <carla/ThreadGroup.h>
 
 #include <array>
+#include <atomic>
+#include <istream>
+#include <iterator>
 #include <list>
+#include <ostream>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 using namespace util::buffer;
@@ -134,3 +141,111 @@ TEST(buffer, buffer_pool) {
   // Now delete the pool to test the weak reference inside the buffers.
   pool.reset();
 }
+
+TEST(buffer, buffer_pool_size_classes) {
+  auto pool = std::make_shared<carla::BufferPool>();
+  {
+    auto small = pool->Pop(100u);
+    ASSERT_GE(small.capacity(), 100u);
+    auto big = pool->Pop(5000u);
+    ASSERT_GE(big.capacity(), 5000u);
+  }
+  auto stats = pool->GetStats();
+  ASSERT_EQ(stats.misses, 2u);
+  ASSERT_EQ(stats.buffers_held, 2u);
+  // A big request must not get the small buffer.
+  auto big = pool->Pop(3000u);
+  ASSERT_GE(big.capacity(), 3000u);
+  auto small = pool->Pop(10u);
+  ASSERT_GE(small.capacity(), 10u);
+  stats = pool->GetStats();
+  ASSERT_EQ(stats.hits, 1u);
+  ASSERT_EQ(stats.misses, 3u);
+  ASSERT_EQ(stats.buffers_held, 1u);
+}
+
+TEST(buffer, buffer_pool_trim) {
+  auto pool = std::make_shared<carla::BufferPool>();
+  pool->SetMaxBytesHeld(4096u);
+  {
+    auto buff0 = pool->Pop(2048u);
+    auto buff1 = pool->Pop(2048u);
+    auto buff2 = pool->Pop(2048u);
+  }
+  auto stats = pool->GetStats();
+  ASSERT_EQ(stats.buffers_held, 2u);
+  ASSERT_EQ(stats.bytes_held, 4096u);
+  ASSERT_EQ(stats.trimmed, 1u);
+  pool->Trim(2048u);
+  stats = pool->GetStats();
+  ASSERT_EQ(stats.buffers_held, 1u);
+  ASSERT_EQ(stats.bytes_held, 2048u);
+  pool->Trim();
+  ASSERT_EQ(pool->GetStats().bytes_held, 0u);
+}
+
+TEST(buffer, buffer_pool_limit_concurrent_push) {
+  constexpr size_t number_of_threads = 16u;
+  constexpr size_t buffers_per_thread = 2000u;
+  constexpr size_t max_buffers_held = 64u;
+  auto pool = std::make_shared<carla::BufferPool>();
+  pool->SetMaxBytesHeld(max_buffers_held * 1024u);
+  std::vector<std::vector<Buffer>> buffers(number_of_threads);
+  for (auto &list : buffers) {
+    for (auto i = 0u; i < buffers_per_thread; ++i) {
+      list.emplace_back(pool->Pop(1024u));
+    }
+  }
+  std::atomic_bool start{false};
+  {
+    // Return every buffer to the pool at once.
+    carla::ThreadGroup threads;
+    for (auto &list : buffers) {
+      threads.CreateThread([&]() {
+        while (!start) {
+          std::this_thread::yield();
+        }
+        list.clear();
+      });
+    }
+    start = true;
+  }
+  const auto stats = pool->GetStats();
+  ASSERT_EQ(stats.bytes_held, max_buffers_held * 1024u);
+  ASSERT_EQ(stats.buffers_held, max_buffers_held);
+  ASSERT_EQ(stats.trimmed, number_of_threads * buffers_per_thread - max_buffers_held);
+}
+
+TEST(buffer, resize_keeps_content) {
+  const std::string str = "Hello buffer!";
+  Buffer buf(str);
+  buf.resize(1024u);
+  ASSERT_EQ(buf.size(), 1024u);
+  ASSERT_EQ(std::string(reinterpret_cast<const char *>(buf.data()), str.size()), str);
+  buf.resize(str.size());
+  ASSERT_EQ(as_string(buf), str);
+}
+
+TEST(buffer, stream_round_trip) {
+  auto pool = std::make_shared<carla::BufferPool>();
+  std::string expected;
+  Buffer result;
+  {
+    carla::BufferOutputStreamBuf stream_buf(pool->Pop());
+    std::ostream out(&stream_buf);
+    for (auto i = 0u; i < 1000u; ++i) {
+      const std::string line = "line " + std::to_string(i) + "\n";
+      out << line;
+      out.put('#');
+      expected += line + "#";
+    }
+    ASSERT_EQ(stream_buf.size(), expected.size());
+    result = stream_buf.Release();
+  }
+  ASSERT_EQ(as_string(result), expected);
+
+  carla::BufferInputStreamBuf in_buf(result);
+  std::istream in(&in_buf);
+  std::string read{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+  ASSERT_EQ(read, expected);
+}
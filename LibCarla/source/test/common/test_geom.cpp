@@ -9,8 +9,11 @@
 #include <carla/geom/Vector3D.h>
 #include <carla/geom/Math.h>
 #include <carla/geom/BoundingBox.h>
+#include <carla/geom/CompactMesh.h>
 #include <carla/geom/Transform.h>
+#include <carla/geom/TransformMatrix.h>
 #include <limits>
+#include <vector>
 
 namespace carla {
 namespace geom {
@@ -227,3 +230,147 @@ TEST(geom, nearest_point_arc) {
   ASSERT_NEAR(Math::DistanceArcToPoint(Vector3D(1,2,0),
       Vector3D(0,0,0), 1.57f, 0, 1).second, 1.0f, 0.01f);
 }
+
+TEST(geom, transform_matrix) {
+  constexpr double error = 0.001;
+  const Transform transform(Location(-3.14f, 1.337f, 4.20f), Rotation(-59.0f, 17.0f, -650.2f));
+  const TransformMatrix matrix(transform);
+
+  const auto forward = transform.GetForwardVector();
+  ASSERT_NEAR(matrix.GetForwardVector().x, forward.x, error);
+  ASSERT_NEAR(matrix.GetForwardVector().y, forward.y, error);
+  ASSERT_NEAR(matrix.GetForwardVector().z, forward.z, error);
+  const auto up = transform.GetUpVector();
+  ASSERT_NEAR(matrix.GetUpVector().x, up.x, error);
+  ASSERT_NEAR(matrix.GetUpVector().y, up.y, error);
+  ASSERT_NEAR(matrix.GetUpVector().z, up.z, error);
+
+  // An odd count and a stride of four to cover the remainders of the SIMD
+  // paths and the untouched fourth column.
+  for (size_t stride : {3u, 4u}) {
+    constexpr size_t count = 103u;
+    std::vector<float> points(count * stride);
+    for (auto i = 0u; i < points.size(); ++i) {
+      points[i] = static_cast<float>(i % 17u) - 0.37f * static_cast<float>(i % 5u);
+    }
+    std::vector<float> transformed(points.size());
+    matrix.TransformPoints(points.data(), transformed.data(), count, stride);
+    auto inverse = transformed;
+    matrix.InverseTransformPoints(inverse.data(), inverse.data(), count, stride);
+    for (auto i = 0u; i < count; ++i) {
+      const float *point = points.data() + i * stride;
+      Location expected(point[0u], point[1u], point[2u]);
+      transform.TransformPoint(expected);
+      const float *result = transformed.data() + i * stride;
+      ASSERT_NEAR(result[0u], expected.x, error) << "point " << i;
+      ASSERT_NEAR(result[1u], expected.y, error) << "point " << i;
+      ASSERT_NEAR(result[2u], expected.z, error) << "point " << i;
+      for (auto j = 0u; j < stride; ++j) {
+        if (j >= 3u) {
+          ASSERT_EQ(result[j], point[j]);
+        }
+        ASSERT_NEAR(inverse[i * stride + j], point[j], error) << "point " << i;
+      }
+    }
+  }
+
+  std::vector<Location> locations = {{1.0f, 2.0f, 3.0f}, {-4.0f, 5.0f, -6.0f}};
+  auto expected = locations;
+  matrix.TransformPoints(locations.data(), locations.size());
+  for (auto i = 0u; i < locations.size(); ++i) {
+    transform.TransformPoint(expected[i]);
+    ASSERT_NEAR(locations[i].x, expected[i].x, error);
+    ASSERT_NEAR(locations[i].y, expected[i].y, error);
+    ASSERT_NEAR(locations[i].z, expected[i].z, error);
+  }
+}
+
+TEST(geom, batch_math) {
+  constexpr double error = 0.001;
+  std::vector<Vector3D> points = {{1.0f, 2.0f, 3.0f}, {-4.0f, 5.0f, -6.0f}, {0.5f, 0.0f, 0.0f}};
+  const Vector3D origin(1.0f, -1.0f, 2.0f);
+  std::vector<float> distances(points.size());
+  Math::DistanceSquared(origin, points.data(), points.size(), distances.data());
+  auto rotated = points;
+  Math::RotatePointsOnOrigin2D(rotated.data(), rotated.size(), 0.7f);
+  for (auto i = 0u; i < points.size(); ++i) {
+    ASSERT_NEAR(distances[i], Math::DistanceSquared(origin, points[i]), error);
+    const auto expected = Math::RotatePointOnOrigin2D(points[i], 0.7f);
+    ASSERT_NEAR(rotated[i].x, expected.x, error);
+    ASSERT_NEAR(rotated[i].y, expected.y, error);
+    ASSERT_NEAR(rotated[i].z, expected.z, error);
+  }
+}
+
+static Mesh MakeTwoLaneMesh() {
+  // Two strips sharing their border, like adjacent lanes built by MeshFactory.
+  Mesh mesh;
+  mesh.AddMaterial("road");
+  for (const float y : {0.0f, 3.5f}) {
+    std::vector<Vector3D> strip;
+    for (auto i = 0u; i < 10u; ++i) {
+      const float x = 2.0f * static_cast<float>(i);
+      strip.emplace_back(x, y, 0.0f);
+      strip.emplace_back(x, y + 3.5f, 0.0f);
+    }
+    mesh.AddTriangleStrip(strip);
+  }
+  mesh.EndMaterial();
+  return mesh;
+}
+
+TEST(geom, compact_mesh_welds_vertices) {
+  const auto mesh = MakeTwoLaneMesh();
+  CompactMeshBuilder builder;
+  builder.AddMesh(mesh);
+  const auto compact = builder.Build();
+  ASSERT_EQ(mesh.GetVerticesNum(), 40u);
+  ASSERT_EQ(compact.GetVerticesNum(), 30u);
+  ASSERT_EQ(compact.GetIndexesNum(), mesh.GetIndexesNum());
+  ASSERT_EQ(compact.GetSections().size(), 1u);
+  ASSERT_EQ(compact.GetSections()[0].index_start, 0u);
+  ASSERT_EQ(compact.GetSections()[0].index_end, compact.GetIndexesNum());
+  for (auto i = 0u; i < compact.GetVerticesNum(); ++i) {
+    // Centimeters, facing up.
+    ASSERT_LE(compact.GetVertices()[i].x, 1800.0f);
+    ASSERT_NEAR(compact.GetNormal(i).z, 1.0f, 1e-6f);
+  }
+  for (auto index : compact.GetIndexes()) {
+    ASSERT_LT(index, compact.GetVerticesNum());
+  }
+  ASSERT_LT(compact.GetSizeInBytes(), mesh.GetVerticesNum() * sizeof(Vector3D) + mesh.GetIndexesNum() * sizeof(size_t));
+
+  CompactMeshBuilder::Parameters parameters;
+  parameters.weld_distance = 0.0f;
+  CompactMeshBuilder unwelded(parameters);
+  unwelded.AddMesh(mesh);
+  ASSERT_EQ(unwelded.Build().GetVerticesNum(), mesh.GetVerticesNum());
+}
+
+TEST(geom, compact_mesh_serialization) {
+  for (const bool half_precision : {false, true}) {
+    CompactMeshBuilder::Parameters parameters;
+    parameters.half_precision = half_precision;
+    CompactMeshBuilder builder(parameters);
+    builder.AddMesh(MakeTwoLaneMesh());
+    builder.AddTriangle({0.0f, 0.0f, 0.0f}, {0.0f, -1.0f, 0.0f}, {1.0f, 0.0f, 1.0f});
+    const auto compact = builder.Build();
+    ASSERT_EQ(compact.IsHalfPrecision(), half_precision);
+
+    const auto blob = compact.Serialize();
+    const auto result = CompactMesh::Deserialize(blob.data(), blob.size());
+    ASSERT_EQ(result.GetVertices(), compact.GetVertices());
+    ASSERT_EQ(result.GetIndexes(), compact.GetIndexes());
+    ASSERT_EQ(result.GetSections().size(), compact.GetSections().size());
+    ASSERT_EQ(result.GetSections()[0].material, "road");
+    for (auto i = 0u; i < compact.GetVerticesNum(); ++i) {
+      const auto normal = result.GetNormal(i);
+      ASSERT_NEAR(normal.Length(), 1.0f, 2e-3f);
+      ASSERT_NEAR(Math::Distance(normal, compact.GetNormal(i)), 0.0f, 1e-6f);
+    }
+#ifndef LIBCARLA_NO_EXCEPTIONS
+    ASSERT_THROW(CompactMesh::Deserialize(blob.data(), blob.size() - 1u), std::invalid_argument);
+    ASSERT_THROW(CompactMesh::Deserialize(blob.data() + 4u, blob.size() - 4u), std::invalid_argument);
+#endif // LIBCARLA_NO_EXCEPTIONS
+  }
+}
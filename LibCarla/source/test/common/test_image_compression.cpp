@@ -0,0 +1,160 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/sensor/CompositeSerializer.h>
+#include <carla/sensor/data/Image.h>
+#include <carla/sensor/s11n/ImageCompression.h>
+#include <carla/sensor/s11n/ImageSerializer.h>
+#include <carla/sensor/s11n/SensorHeaderSerializer.h>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace carla::sensor;
+using carla::sensor::s11n::ImageCodec;
+using carla::sensor::s11n::ImageCompression;
+
+namespace {
+
+  struct FakeCamera {
+    uint32_t GetImageWidth() const { return width; }
+    uint32_t GetImageHeight() const { return height; }
+    float GetFOVAngle() const { return 90.0f; }
+    ImageCodec GetImageCodec() const { return codec; }
+
+    uint32_t width;
+    uint32_t height;
+    ImageCodec codec;
+  };
+
+  using FakeRegistry = CompositeSerializer<std::pair<FakeCamera *, s11n::ImageSerializer>>;
+
+} // namespace
+
+/// Image resembling semantic segmentation, a few big blocks of a single tag.
+static std::vector<unsigned char> MakeSegmentation(size_t width, size_t height) {
+  std::vector<unsigned char> pixels(width * height * 4u);
+  for (size_t y = 0u; y < height; ++y) {
+    for (size_t x = 0u; x < width; ++x) {
+      auto *pixel = &pixels[4u * (y * width + x)];
+      pixel[2u] = static_cast<unsigned char>((x / 64u + y / 32u) % 23u);
+      pixel[3u] = 255u;
+    }
+  }
+  return pixels;
+}
+
+/// Smoothly varying float data, like depth or optical flow.
+static std::vector<unsigned char> MakeGradient(size_t width, size_t height) {
+  std::vector<float> values(width * height * 2u);
+  for (size_t i = 0u; i < values.size(); i += 2u) {
+    values[i] = 0.25f * static_cast<float>((i / 2u) % width);
+    values[i + 1u] = -3.0f;
+  }
+  std::vector<unsigned char> pixels(values.size() * sizeof(float));
+  std::memcpy(pixels.data(), values.data(), pixels.size());
+  return pixels;
+}
+
+static std::vector<unsigned char> MakeNoise(size_t size) {
+  std::mt19937 rng(42u);
+  std::vector<unsigned char> pixels(size);
+  for (auto &byte : pixels) {
+    byte = static_cast<unsigned char>(rng());
+  }
+  return pixels;
+}
+
+static void CheckRoundTrip(
+    ImageCodec codec,
+    size_t bytes_per_pixel,
+    const std::vector<unsigned char> &pixels,
+    bool expect_smaller) {
+  std::vector<unsigned char> encoded(pixels.size() + 1024u);
+  const size_t size = ImageCompression::Encode(
+      codec, bytes_per_pixel, pixels.data(), pixels.size(), encoded.data(), encoded.size());
+  ASSERT_GT(size, 0u);
+  if (expect_smaller) {
+    ASSERT_LT(size, pixels.size() / 4u);
+  }
+  std::vector<unsigned char> decoded(pixels.size());
+  ImageCompression::Decode(
+      codec, bytes_per_pixel, encoded.data(), size, decoded.data(), decoded.size());
+  ASSERT_EQ(decoded, pixels);
+}
+
+TEST(image_compression, codec_round_trip) {
+  const auto segmentation = MakeSegmentation(640u, 480u);
+  CheckRoundTrip(ImageCodec::RLE, 4u, segmentation, true);
+  CheckRoundTrip(ImageCodec::LZ4, 4u, segmentation, true);
+  CheckRoundTrip(ImageCodec::DeltaLZ4, 4u, segmentation, true);
+  const auto gradient = MakeGradient(640u, 480u);
+  CheckRoundTrip(ImageCodec::DeltaLZ4, 8u, gradient, true);
+  CheckRoundTrip(ImageCodec::LZ4, 8u, gradient, false);
+  // Incompressible and tiny inputs must still decode back.
+  const auto noise = MakeNoise(100000u);
+  CheckRoundTrip(ImageCodec::LZ4, 4u, noise, false);
+  CheckRoundTrip(ImageCodec::LZ4, 4u, {1u, 2u, 3u, 4u}, false);
+}
+
+TEST(image_compression, incompressible_is_not_encoded) {
+  const auto noise = MakeNoise(4096u);
+  std::vector<unsigned char> encoded(noise.size());
+  ASSERT_EQ(ImageCompression::Encode(
+      ImageCodec::RLE, 4u, noise.data(), noise.size(), encoded.data(), encoded.size()), 0u);
+}
+
+#ifndef LIBCARLA_NO_EXCEPTIONS
+TEST(image_compression, corrupted_data_throws) {
+  const auto segmentation = MakeSegmentation(64u, 64u);
+  std::vector<unsigned char> encoded(segmentation.size());
+  const size_t size = ImageCompression::Encode(
+      ImageCodec::LZ4, 4u, segmentation.data(), segmentation.size(), encoded.data(), encoded.size());
+  ASSERT_GT(size, 0u);
+  std::vector<unsigned char> decoded(segmentation.size());
+  ASSERT_THROW(ImageCompression::Decode(
+      ImageCodec::LZ4, 4u, encoded.data(), size - 1u, decoded.data(), decoded.size()),
+      std::runtime_error);
+  ASSERT_THROW(ImageCompression::Decode(
+      ImageCodec::LZ4, 4u, encoded.data(), size, decoded.data(), decoded.size() - 4u),
+      std::runtime_error);
+  ASSERT_THROW(ImageCompression::CodecFromString("jpeg"), std::invalid_argument);
+}
+#endif // LIBCARLA_NO_EXCEPTIONS
+
+TEST(image_compression, image_serializer) {
+  for (auto codec : {ImageCodec::None, ImageCodec::RLE, ImageCodec::LZ4, ImageCodec::DeltaLZ4}) {
+    // Big enough to be split in several bands.
+    FakeCamera camera{1280u, 720u, codec};
+    const auto pixels = MakeSegmentation(camera.width, camera.height);
+    carla::Buffer bitmap(static_cast<uint64_t>(s11n::ImageSerializer::header_offset + pixels.size()));
+    std::memcpy(bitmap.data() + s11n::ImageSerializer::header_offset, pixels.data(), pixels.size());
+
+    auto payload = FakeRegistry::Serialize(camera, std::move(bitmap));
+    if (codec == ImageCodec::None) {
+      ASSERT_EQ(payload.size(), s11n::ImageSerializer::header_offset + pixels.size());
+    } else {
+      ASSERT_LT(payload.size(), pixels.size() / 4u);
+    }
+
+    auto header = s11n::SensorHeaderSerializer::Serialize(0u, 42u, 1.0, carla::rpc::Transform{});
+    carla::Buffer message(static_cast<uint64_t>(header.size() + payload.size()));
+    std::memcpy(message.data(), header.data(), header.size());
+    std::memcpy(message.data() + header.size(), payload.data(), payload.size());
+
+    auto data = FakeRegistry::Deserialize(std::move(message));
+    auto image = boost::dynamic_pointer_cast<data::Image>(data);
+    ASSERT_NE(image, nullptr);
+    ASSERT_EQ(image->GetFrame(), 42u);
+    ASSERT_EQ(image->GetWidth(), camera.width);
+    ASSERT_EQ(image->GetHeight(), camera.height);
+    ASSERT_EQ(image->size(), camera.width * camera.height);
+    ASSERT_EQ(std::memcmp(image->data(), pixels.data(), pixels.size()), 0);
+  }
+}
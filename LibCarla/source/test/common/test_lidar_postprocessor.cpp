@@ -0,0 +1,232 @@
+// Copyright (c) 2023 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/sensor/LidarPostprocessor.h>
+#include <carla/sensor/s11n/LidarSerializer.h>
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using carla::geom::Location;
+using carla::sensor::LidarPostprocessor;
+using carla::sensor::data::LidarData;
+using carla::sensor::data::LidarDetection;
+
+using Hits = std::vector<std::vector<Location>>;
+using Detections = std::vector<std::vector<LidarDetection>>;
+
+/// Hits at random directions and distances in [1, 100) meters.
+static Hits MakeHits(size_t channels, size_t points_per_channel) {
+  std::mt19937 random_engine(42u);
+  std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+  std::uniform_real_distribution<float> pitch(-0.5f, 0.5f);
+  std::uniform_real_distribution<float> distance(1.0f, 100.0f);
+  Hits hits(channels);
+  for (auto &channel : hits) {
+    for (size_t i = 0u; i < points_per_channel; ++i) {
+      const float yaw = angle(random_engine);
+      const float p = pitch(random_engine);
+      const float d = distance(random_engine);
+      channel.emplace_back(
+          d * std::cos(p) * std::cos(yaw),
+          d * std::cos(p) * std::sin(yaw),
+          d * std::sin(p));
+    }
+  }
+  return hits;
+}
+
+static size_t CountDetections(const Detections &detections) {
+  size_t count = 0u;
+  for (const auto &channel : detections) {
+    count += channel.size();
+  }
+  return count;
+}
+
+/// Parameters that keep every point.
+static LidarPostprocessor::Parameters KeepAll() {
+  LidarPostprocessor::Parameters parameters;
+  parameters.dropoff_zero_intensity = 0.0f;
+  return parameters;
+}
+
+TEST(lidar_postprocessor, intensity) {
+  const auto hits = MakeHits(16u, 1000u);
+  auto parameters = KeepAll();
+  parameters.atmosphere_attenuation_rate = 0.01f;
+  LidarPostprocessor postprocessor(parameters);
+  Detections detections;
+  postprocessor.Process(hits, detections);
+  ASSERT_EQ(detections.size(), hits.size());
+  for (size_t channel = 0u; channel < hits.size(); ++channel) {
+    ASSERT_EQ(detections[channel].size(), hits[channel].size());
+    for (size_t i = 0u; i < hits[channel].size(); ++i) {
+      const auto &hit = hits[channel][i];
+      const auto &detection = detections[channel][i];
+      ASSERT_EQ(detection.point, hit);
+      ASSERT_NEAR(detection.intensity, std::exp(-0.01f * hit.Length()), 1e-5f);
+    }
+  }
+}
+
+TEST(lidar_postprocessor, dropoff) {
+  const auto hits = MakeHits(32u, 10000u);
+  const size_t total = 32u * 10000u;
+  Detections detections;
+
+  // General drop off.
+  auto parameters = KeepAll();
+  parameters.dropoff_general_rate = 0.45f;
+  LidarPostprocessor general(parameters);
+  general.Process(hits, detections);
+  ASSERT_NEAR(static_cast<double>(CountDetections(detections)) / total, 0.55, 0.01);
+
+  // Intensity based drop off, all the points are nearly zero intensity.
+  parameters = LidarPostprocessor::Parameters{};
+  parameters.atmosphere_attenuation_rate = 100.0f;
+  parameters.dropoff_zero_intensity = 0.4f;
+  LidarPostprocessor intensity(parameters);
+  intensity.Process(hits, detections);
+  ASSERT_NEAR(static_cast<double>(CountDetections(detections)) / total, 0.6, 0.01);
+
+  // Points above the intensity limit are never dropped.
+  parameters.atmosphere_attenuation_rate = 0.0f;
+  intensity.SetParameters(parameters);
+  intensity.Process(hits, detections);
+  ASSERT_EQ(CountDetections(detections), total);
+}
+
+TEST(lidar_postprocessor, noise) {
+  const auto hits = MakeHits(8u, 20000u);
+  auto parameters = KeepAll();
+  parameters.noise_stddev = 0.1f;
+  LidarPostprocessor postprocessor(parameters);
+  Detections detections;
+  postprocessor.Process(hits, detections);
+  double sum = 0.0;
+  double sum_squared = 0.0;
+  size_t count = 0u;
+  for (size_t channel = 0u; channel < hits.size(); ++channel) {
+    ASSERT_EQ(detections[channel].size(), hits[channel].size());
+    for (size_t i = 0u; i < hits[channel].size(); ++i) {
+      const auto &hit = hits[channel][i];
+      const auto &point = detections[channel][i].point;
+      // The noise is along the ray.
+      const auto direction = hit.MakeUnitVector();
+      const auto noisy_direction = point.MakeUnitVector();
+      ASSERT_NEAR(direction.x, noisy_direction.x, 1e-3f);
+      ASSERT_NEAR(direction.y, noisy_direction.y, 1e-3f);
+      ASSERT_NEAR(direction.z, noisy_direction.z, 1e-3f);
+      const double error = point.Length() - hit.Length();
+      sum += error;
+      sum_squared += error * error;
+      ++count;
+    }
+  }
+  const double mean = sum / static_cast<double>(count);
+  ASSERT_NEAR(mean, 0.0, 0.005);
+  ASSERT_NEAR(std::sqrt(sum_squared / static_cast<double>(count) - mean * mean), 0.1, 0.005);
+}
+
+TEST(lidar_postprocessor, culling) {
+  const auto hits = MakeHits(8u, 5000u);
+  auto parameters = KeepAll();
+  parameters.min_range = 10.0f;
+  parameters.max_range = 50.0f;
+  parameters.horizontal_fov = 90.0f;
+  parameters.upper_fov = 10.0f;
+  parameters.lower_fov = -20.0f;
+  LidarPostprocessor postprocessor(parameters);
+  Detections detections;
+  postprocessor.Process(hits, detections);
+  size_t expected = 0u;
+  for (const auto &channel : hits) {
+    for (const auto &hit : channel) {
+      const float distance = hit.Length();
+      const float yaw = std::atan2(hit.y, hit.x) * 180.0f / 3.14159265f;
+      const float pitch = std::atan2(hit.z, std::hypot(hit.x, hit.y)) * 180.0f / 3.14159265f;
+      if (distance >= 10.0f && distance <= 50.0f &&
+          std::abs(yaw) <= 45.0f && pitch <= 10.0f && pitch >= -20.0f) {
+        ++expected;
+      }
+    }
+  }
+  ASSERT_GT(expected, 0u);
+  ASSERT_EQ(CountDetections(detections), expected);
+  for (const auto &channel : detections) {
+    for (const auto &detection : channel) {
+      ASSERT_GE(detection.point.Length(), 10.0f - 1e-3f);
+      ASSERT_LE(detection.point.Length(), 50.0f + 1e-3f);
+      ASSERT_GE(detection.point.x, 0.0f);
+    }
+  }
+}
+
+TEST(lidar_postprocessor, deterministic) {
+  const auto hits = MakeHits(64u, 2000u);
+  LidarPostprocessor::Parameters parameters;
+  parameters.dropoff_general_rate = 0.3f;
+  parameters.noise_stddev = 0.05f;
+  LidarPostprocessor postprocessor(parameters, 7u);
+  Detections first;
+  Detections second;
+  Detections third;
+  postprocessor.Process(hits, first);
+  postprocessor.Process(hits, second);
+  postprocessor.SetSeed(7u);
+  postprocessor.Process(hits, third);
+  ASSERT_EQ(CountDetections(first), CountDetections(third));
+  bool differs = CountDetections(first) != CountDetections(second);
+  for (size_t channel = 0u; channel < hits.size(); ++channel) {
+    ASSERT_EQ(first[channel].size(), third[channel].size());
+    for (size_t i = 0u; i < first[channel].size(); ++i) {
+      ASSERT_EQ(first[channel][i].point, third[channel][i].point);
+      ASSERT_EQ(first[channel][i].intensity, third[channel][i].intensity);
+    }
+    differs = differs || (first[channel].size() != second[channel].size());
+  }
+  // Each call draws different random numbers.
+  ASSERT_TRUE(differs);
+}
+
+TEST(lidar_postprocessor, write_lidar_data) {
+  const auto hits = MakeHits(4u, 100u);
+  LidarPostprocessor postprocessor(KeepAll());
+  Detections detections;
+  postprocessor.Process(hits, detections);
+
+  LidarData data(4u);
+  postprocessor.SetSeed(0u);
+  postprocessor.Process(hits, data);
+  const auto buffer = carla::sensor::s11n::LidarSerializer::Serialize(0, data, carla::Buffer{});
+  const auto *header = reinterpret_cast<const uint32_t *>(buffer.data());
+  ASSERT_EQ(header[1u], 4u);
+  size_t offset = sizeof(uint32_t) * (2u + 4u);
+  for (size_t channel = 0u; channel < 4u; ++channel) {
+    ASSERT_EQ(header[2u + channel], detections[channel].size());
+    for (const auto &detection : detections[channel]) {
+      float point[4u];
+      std::memcpy(point, buffer.data() + offset, sizeof(point));
+      offset += sizeof(point);
+      ASSERT_EQ(point[0u], detection.point.x);
+      ASSERT_EQ(point[1u], detection.point.y);
+      ASSERT_EQ(point[2u], detection.point.z);
+      ASSERT_EQ(point[3u], detection.intensity);
+    }
+  }
+  ASSERT_EQ(offset, buffer.size());
+
+#ifndef LIBCARLA_NO_EXCEPTIONS
+  LidarData other(5u);
+  ASSERT_THROW(postprocessor.Process(hits, other), std::invalid_argument);
+#endif // LIBCARLA_NO_EXCEPTIONS
+}
@@ -6,8 +6,63 @@
 
 #include "test.h"
 
+#include <carla/ContentHash.h>
+#include <carla/ParallelFor.h>
 #include <carla/Version.h>
 
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
 TEST(miscellaneous, version) {
   std::cout << "LibCarla " << carla::version() << std::endl;
 }
+
+TEST(miscellaneous, parallel_for) {
+  constexpr size_t size = 1000u;
+  for (size_t chunk_count : {1u, 3u, 8u, 2000u}) {
+    std::vector<int> visits(size, 0);
+    std::vector<size_t> chunk_begins(std::min(chunk_count, size), size);
+    carla::ParallelFor(size, chunk_count, [&](size_t chunk, size_t begin, size_t end) {
+      chunk_begins[chunk] = begin;
+      for (size_t i = begin; i < end; ++i) {
+        ++visits[i];
+      }
+    });
+    for (auto count : visits) {
+      ASSERT_EQ(count, 1);
+    }
+    ASSERT_TRUE(std::is_sorted(chunk_begins.begin(), chunk_begins.end()));
+  }
+#ifndef LIBCARLA_NO_EXCEPTIONS
+  ASSERT_THROW(carla::ParallelFor(size, 4u, [](size_t chunk, size_t, size_t) {
+    if (chunk == 2u) {
+      throw std::runtime_error("chunk failed");
+    }
+  }), std::runtime_error);
+#endif // LIBCARLA_NO_EXCEPTIONS
+}
+
+TEST(miscellaneous, content_hash) {
+  using carla::ContentHash;
+  ASSERT_EQ(
+      ContentHash::Compute("", 0u),
+      "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+  ASSERT_EQ(
+      ContentHash::Compute("abc", 3u),
+      "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  // One million 'a' fed in uneven pieces.
+  const std::string chunk(999u, 'a');
+  ContentHash hash;
+  size_t total = 0u;
+  while (total < 1000000u) {
+    const size_t size = std::min(chunk.size(), 1000000u - total);
+    hash.Update(chunk.data(), size);
+    total += size;
+  }
+  const auto result = hash.Finish();
+  ASSERT_EQ(result, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+  ASSERT_TRUE(ContentHash::IsValid(result));
+  ASSERT_FALSE(ContentHash::IsValid("../" + result.substr(3u)));
+  ASSERT_FALSE(ContentHash::IsValid(result.substr(1u)));
+}
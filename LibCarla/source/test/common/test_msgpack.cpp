@@ -9,6 +9,7 @@
 #include <carla/MsgPackAdaptors.h>
 #include <carla/rpc/Actor.h>
 #include <carla/rpc/Response.h>
+#include <carla/rpc/VehicleControlBatch.h>
 
 #include <thread>
 
@@ -105,3 +106,37 @@ TEST(msgpack, optional) {
   ASSERT_TRUE(result.has_value());
   ASSERT_EQ(*result, 42.0f);
 }
+
+TEST(msgpack, vehicle_control_batch) {
+  using mp = carla::MsgPack;
+  VehicleControlBatch batch;
+  for (auto i = 0u; i < 100u; ++i) {
+    batch.AddControl(i, VehicleControl{
+        0.01f * i, -0.5f, 0.25f, (i % 2u) == 0u, (i % 3u) == 0u, (i % 5u) == 0u, int32_t(i % 7u) - 1});
+  }
+  batch.AddTransform(1000u, Transform{carla::geom::Location{1.0f, 2.0f, 3.0f}, Rotation{4.0f, 5.0f, 6.0f}});
+
+  const auto buffer = mp::Pack(batch);
+  // A single binary blob, not one msgpack object per value.
+  ASSERT_LT(buffer.size(), batch.GetEncodedSize() + 8u);
+
+  const auto result = mp::UnPack<VehicleControlBatch>(buffer);
+  ASSERT_EQ(result.GetNumberOfControls(), batch.GetNumberOfControls());
+  ASSERT_EQ(result.GetNumberOfTransforms(), 1u);
+  for (auto i = 0u; i < batch.GetNumberOfControls(); ++i) {
+    ASSERT_EQ(result.GetControlActor(i), i);
+    ASSERT_EQ(result.GetControl(i), batch.GetControl(i));
+  }
+  ASSERT_EQ(result.GetTransformActor(0u), 1000u);
+  ASSERT_EQ(result.GetTransform(0u), batch.GetTransform(0u));
+
+  std::vector<unsigned char> encoded;
+  batch.Encode([&](const unsigned char *data, size_t size) {
+    encoded.insert(encoded.end(), data, data + size);
+  });
+  ASSERT_EQ(encoded.size(), batch.GetEncodedSize());
+#ifndef LIBCARLA_NO_EXCEPTIONS
+  VehicleControlBatch truncated;
+  ASSERT_THROW(truncated.Decode(encoded.data(), encoded.size() - 1u), std::invalid_argument);
+#endif // LIBCARLA_NO_EXCEPTIONS
+}
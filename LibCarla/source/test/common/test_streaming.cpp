@@ -259,3 +259,47 @@ TEST(streaming, multi_stream) {
     }
   }
 }
+
+TEST(streaming, shared_service_waits_for_callbacks) {
+  using namespace carla::streaming;
+  using namespace util::buffer;
+  const std::string message = "Hello from a shared service!";
+
+  Server srv(TESTING_PORT);
+  srv.AsyncRun(2u);
+  auto stream = srv.MakeStream();
+
+  auto service = std::make_shared<carla::ThreadPool>();
+  service->AsyncRun(2u);
+
+  std::atomic_bool entered{false};
+  std::atomic_bool finished{false};
+  std::atomic_size_t calls_after_stop{0u};
+  std::atomic_bool stopped{false};
+  {
+    Client c("127.0.0.1", service);
+    c.Subscribe(stream.token(), [&](auto) {
+      if (stopped) {
+        ++calls_after_stop;
+      }
+      entered = true;
+      std::this_thread::sleep_for(100ms);
+      finished = true;
+    });
+    for (auto i = 0u; (i < 1000u) && !entered; ++i) {
+      std::this_thread::sleep_for(2ms);
+      stream << message;
+    }
+    ASSERT_TRUE(entered);
+  } // client dies here, the service keeps running.
+  stopped = true;
+  ASSERT_TRUE(finished);
+
+  // Messages keep arriving while the subscription closes.
+  for (auto i = 0u; i < 20u; ++i) {
+    std::this_thread::sleep_for(2ms);
+    stream << message;
+  }
+  ASSERT_EQ(calls_after_stop, 0u);
+  ASSERT_EQ(service->Post([]() { return 42; }).get(), 42);
+}
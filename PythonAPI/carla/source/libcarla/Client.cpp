@@ -9,6 +9,7 @@
 #include "carla/client/World.h"
 #include "carla/Logging.h"
 #include "carla/rpc/ActorId.h"
+#include "carla/rpc/VehicleControlBatch.h"
 #include "carla/trafficmanager/TrafficManager.h"
 
 #include <thread>
@@ -186,8 +187,28 @@ void export_client() {
     .def_readwrite("enable_pedestrian_navigation", &rpc::OpendriveGenerationParameters::enable_pedestrian_navigation)
   ;
 
+  using ActorPtr = carla::SharedPtr<cc::Actor>;
+
+  class_<rpc::VehicleControlBatch>("VehicleControlBatch")
+    .def("add_control", +[](rpc::VehicleControlBatch &self, rpc::ActorId id, const rpc::VehicleControl &control) {
+      self.AddControl(id, control);
+    }, (arg("actor_id"), arg("control")))
+    .def("add_control", +[](rpc::VehicleControlBatch &self, const ActorPtr &actor, const rpc::VehicleControl &control) {
+      self.AddControl(actor->GetId(), control);
+    }, (arg("actor"), arg("control")))
+    .def("add_transform", +[](rpc::VehicleControlBatch &self, rpc::ActorId id, const rpc::Transform &transform) {
+      self.AddTransform(id, transform);
+    }, (arg("actor_id"), arg("transform")))
+    .def("add_transform", +[](rpc::VehicleControlBatch &self, const ActorPtr &actor, const rpc::Transform &transform) {
+      self.AddTransform(actor->GetId(), transform);
+    }, (arg("actor"), arg("transform")))
+    .def("clear", &rpc::VehicleControlBatch::Clear)
+    .add_property("number_of_controls", &rpc::VehicleControlBatch::GetNumberOfControls)
+    .add_property("number_of_transforms", &rpc::VehicleControlBatch::GetNumberOfTransforms)
+  ;
+
   class_<cc::Client>("Client",
-      init<std::string, uint16_t, size_t>((arg("host"), arg("port"), arg("worker_threads")=0u)))
+      init<std::string, uint16_t, size_t, bool>((arg("host"), arg("port"), arg("worker_threads")=0u, arg("share_connection")=false)))
     .def("set_timeout", &::SetTimeout, (arg("seconds")))
     .def("get_client_version", &cc::Client::GetClientVersion)
     .def("get_server_version", CONST_CALL_WITHOUT_GIL(cc::Client, GetServerVersion))
@@ -212,6 +233,7 @@ void export_client() {
     .def("set_replayer_ignore_hero", &cc::Client::SetReplayerIgnoreHero, (arg("ignore_hero")))
     .def("apply_batch", &ApplyBatchCommands, (arg("commands"), arg("do_tick")=false))
     .def("apply_batch_sync", &ApplyBatchCommandsSync, (arg("commands"), arg("do_tick")=false))
+    .def("apply_vehicle_control_batch", CONST_CALL_WITHOUT_GIL_2(cc::Client, ApplyVehicleControlBatch, const rpc::VehicleControlBatch &, bool), (arg("batch"), arg("do_tick")=false))
     .def("get_trafficmanager", CONST_CALL_WITHOUT_GIL_1(cc::Client, GetInstanceTM, uint16_t), (arg("port")=ctm::TM_DEFAULT_PORT))
   ;
 }
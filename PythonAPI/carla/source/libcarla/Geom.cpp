@@ -9,13 +9,16 @@
 #include <carla/geom/Location.h>
 #include <carla/geom/Rotation.h>
 #include <carla/geom/Transform.h>
+#include <carla/geom/TransformMatrix.h>
 #include <carla/geom/Vector2D.h>
 #include <carla/geom/Vector3D.h>
 
 #include <boost/python/implicit.hpp>
 #include <boost/python/suite/indexing/vector_indexing_suite.hpp>
 
+#include <memory>
 #include <ostream>
+#include <string>
 
 namespace carla {
 namespace geom {
@@ -81,12 +84,52 @@ namespace geom {
 } // namespace carla
 
 static void TransformList(const carla::geom::Transform &self, boost::python::list &list) {
+  const carla::geom::TransformMatrix matrix(self);
   auto length = boost::python::len(list);
-   for (auto i = 0u; i < length; ++i) {
-    self.TransformPoint(boost::python::extract<carla::geom::Vector3D &>(list[i]));
+  for (auto i = 0u; i < length; ++i) {
+    carla::geom::Vector3D &point = boost::python::extract<carla::geom::Vector3D &>(list[i]);
+    point = matrix.TransformPoint(point);
   }
 }
 
+/// Transforms in place the points of @a array, a writable C-contiguous
+/// float32 buffer of shape (N, 3) or (N, 4), like a numpy array.
+static boost::python::object TransformBuffer(
+    const carla::geom::TransformMatrix &matrix,
+    boost::python::object array) {
+  Py_buffer view;
+  if (PyObject_GetBuffer(array.ptr(), &view, PyBUF_WRITABLE | PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) != 0) {
+    boost::python::throw_error_already_set();
+  }
+  std::unique_ptr<Py_buffer, decltype(&PyBuffer_Release)> release(&view, &PyBuffer_Release);
+  const std::string format = view.format != nullptr ? view.format : "B";
+  const bool is_float32 =
+      (view.itemsize == sizeof(float)) &&
+      (format == "f" || format == "=f" || format == "@f" || format == "<f");
+  if (!is_float32 || (view.ndim != 2) || (view.shape[1] != 3 && view.shape[1] != 4)) {
+    PyErr_SetString(PyExc_TypeError, "points must be a float32 array of shape (N, 3) or (N, 4)");
+    boost::python::throw_error_already_set();
+  }
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    auto *data = static_cast<float *>(view.buf);
+    matrix.TransformPoints(
+        data,
+        data,
+        static_cast<size_t>(view.shape[0]),
+        static_cast<size_t>(view.shape[1]));
+  }
+  return array;
+}
+
+static auto TransformPoints(const carla::geom::Transform &self, boost::python::object array) {
+  return TransformBuffer(carla::geom::TransformMatrix(self), array);
+}
+
+static auto InverseTransformPoints(const carla::geom::Transform &self, boost::python::object array) {
+  return TransformBuffer(carla::geom::TransformMatrix(self).GetInverse(), array);
+}
+
 static boost::python::list BuildMatrix(const std::array<float, 16> &m) {
   boost::python::list r_out;
   boost::python::list r[4];
@@ -241,6 +284,8 @@ void export_geom() {
       self.TransformVector(vector);
       return vector;
     }, arg("in_point"))
+    .def("transform_points", &TransformPoints, arg("points"))
+    .def("inverse_transform_points", &InverseTransformPoints, arg("points"))
     .def("get_forward_vector", &cg::Transform::GetForwardVector)
     .def("get_right_vector", &cg::Transform::GetRightVector)
     .def("get_up_vector", &cg::Transform::GetUpVector)
@@ -13,6 +13,7 @@
 #include <carla/client/Landmark.h>
 #include <carla/road/SignalType.h>
 
+#include <memory>
 #include <ostream>
 #include <fstream>
 
@@ -52,6 +53,121 @@ static auto GetTopology(const carla::client::Map &self) {
   return result;
 }
 
+#if PY_MAJOR_VERSION >= 3
+/// Copy @a column into a new memoryview of struct @a format, that
+/// numpy.asarray turns into an array without copying it again.
+template <typename T>
+static boost::python::object MakeColumn(const std::vector<T> &column, const char *format) {
+  namespace py = boost::python;
+  py::object bytes(py::handle<>(PyBytes_FromStringAndSize(
+      reinterpret_cast<const char *>(column.data()),
+      static_cast<Py_ssize_t>(sizeof(T) * column.size()))));
+  py::object view(py::handle<>(PyMemoryView_FromObject(bytes.ptr())));
+  return view.attr("cast")(format);
+}
+
+static boost::python::dict MakeWaypointColumns(const carla::road::element::WaypointColumns &columns) {
+  boost::python::dict result;
+  result["road_id"] = MakeColumn(columns.road_id, "I");
+  result["section_id"] = MakeColumn(columns.section_id, "I");
+  result["lane_id"] = MakeColumn(columns.lane_id, "i");
+  result["s"] = MakeColumn(columns.s, "d");
+  result["x"] = MakeColumn(columns.x, "f");
+  result["y"] = MakeColumn(columns.y, "f");
+  result["z"] = MakeColumn(columns.z, "f");
+  result["yaw"] = MakeColumn(columns.yaw, "f");
+  result["lane_width"] = MakeColumn(columns.lane_width, "d");
+  result["lane_type"] = MakeColumn(columns.lane_type, "i");
+  return result;
+}
+
+static auto GetTopologyArrays(const carla::client::Map &self) {
+  std::pair<carla::road::element::WaypointColumns, carla::road::element::WaypointColumns> topology;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    topology = self.GetTopologyColumns();
+  }
+  return boost::python::make_tuple(
+      MakeWaypointColumns(topology.first),
+      MakeWaypointColumns(topology.second));
+}
+
+static auto GenerateWaypointArrays(const carla::client::Map &self, double distance) {
+  carla::road::element::WaypointColumns columns;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    columns = self.GenerateWaypointColumns(distance);
+  }
+  return MakeWaypointColumns(columns);
+}
+#endif // PY_MAJOR_VERSION >= 3
+
+static auto GetWaypoint(
+    const carla::client::Map &self,
+    const carla::geom::Location &location,
+    bool project_to_road,
+    int32_t lane_type) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  return self.GetWaypoint(location, project_to_road, lane_type);
+}
+
+#if PY_MAJOR_VERSION >= 3
+/// Read @a array, a C-contiguous float32 or float64 buffer of shape (N, 3)
+/// like a numpy array, as a list of locations.
+static std::vector<carla::geom::Location> GetLocations(const boost::python::object &array) {
+  Py_buffer view;
+  if (PyObject_GetBuffer(array.ptr(), &view, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) != 0) {
+    boost::python::throw_error_already_set();
+  }
+  std::unique_ptr<Py_buffer, decltype(&PyBuffer_Release)> release(&view, &PyBuffer_Release);
+  const std::string format = view.format != nullptr ? view.format : "B";
+  const char type = format.empty() ? 'B' : format.back();
+  const bool is_float =
+      (type == 'f' && view.itemsize == sizeof(float)) ||
+      (type == 'd' && view.itemsize == sizeof(double));
+  if (!is_float || (view.ndim != 2) || (view.shape[1] != 3)) {
+    PyErr_SetString(PyExc_TypeError, "locations must be a float32 or float64 array of shape (N, 3)");
+    boost::python::throw_error_already_set();
+  }
+  std::vector<carla::geom::Location> locations(static_cast<size_t>(view.shape[0]));
+  for (size_t i = 0u; i < locations.size(); ++i) {
+    if (type == 'f') {
+      const auto *data = static_cast<const float *>(view.buf) + 3u * i;
+      locations[i] = {data[0], data[1], data[2]};
+    } else {
+      const auto *data = static_cast<const double *>(view.buf) + 3u * i;
+      locations[i] = {
+          static_cast<float>(data[0]),
+          static_cast<float>(data[1]),
+          static_cast<float>(data[2])};
+    }
+  }
+  return locations;
+}
+
+static auto GetWaypoints(
+    const carla::client::Map &self,
+    const boost::python::object &locations,
+    bool project_to_road,
+    int32_t lane_type) {
+  const auto location_list = GetLocations(locations);
+  carla::road::element::WaypointColumns columns;
+  std::vector<uint8_t> valid;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    const auto waypoints = self.GetWaypoints(location_list, project_to_road, lane_type);
+    columns = self.GetMap().ExportWaypoints(waypoints);
+    valid.reserve(waypoints.size());
+    for (const auto &waypoint : waypoints) {
+      valid.emplace_back(waypoint.has_value() ? 1u : 0u);
+    }
+  }
+  auto result = MakeWaypointColumns(columns);
+  result["valid"] = MakeColumn(valid, "?");
+  return result;
+}
+#endif // PY_MAJOR_VERSION >= 3
+
 static auto GetJunctionWaypoints(const carla::client::Junction &self, const carla::road::Lane::LaneType lane_type) {
   namespace py = boost::python;
   auto topology = self.GetWaypoints(lane_type);
@@ -72,6 +188,50 @@ static auto GetLaneValidities(const carla::client::Landmark &self){
   return result;
 }
 
+static auto ComputeRoute(
+    const carla::client::Map &self,
+    const carla::client::Waypoint &origin,
+    const carla::client::Waypoint &destination) {
+  std::vector<carla::SharedPtr<carla::client::Waypoint>> route;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    route = self.ComputeRoute(origin, destination);
+  }
+  boost::python::list result;
+  for (auto &waypoint : route) {
+    result.append(waypoint);
+  }
+  return result;
+}
+
+static auto ComputeRouteDistances(
+    const carla::client::Map &self,
+    const boost::python::object &origins,
+    const boost::python::object &destinations) {
+  namespace py = boost::python;
+  using WaypointPtr = carla::SharedPtr<carla::client::Waypoint>;
+  const std::vector<WaypointPtr> origin_list{
+      py::stl_input_iterator<WaypointPtr>(origins),
+      py::stl_input_iterator<WaypointPtr>()};
+  const std::vector<WaypointPtr> destination_list{
+      py::stl_input_iterator<WaypointPtr>(destinations),
+      py::stl_input_iterator<WaypointPtr>()};
+  std::vector<double> distances;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    distances = self.ComputeRouteDistances(origin_list, destination_list);
+  }
+  py::list result;
+  for (size_t i = 0u; i < origin_list.size(); ++i) {
+    py::list row;
+    for (size_t j = 0u; j < destination_list.size(); ++j) {
+      row.append(distances[i * destination_list.size() + j]);
+    }
+    result.append(row);
+  }
+  return result;
+}
+
 static carla::geom::GeoLocation ToGeolocation(
     const carla::client::Map &self,
     const carla::geom::Location &location) {
@@ -158,7 +318,7 @@ void export_map() {
     .def(init<std::string, std::string>((arg("name"), arg("xodr_content"))))
     .add_property("name", CALL_RETURNING_COPY(cc::Map, GetName))
     .def("get_spawn_points", CALL_RETURNING_LIST(cc::Map, GetRecommendedSpawnPoints))
-    .def("get_waypoint", &cc::Map::GetWaypoint, (arg("location"), arg("project_to_road")=true, arg("lane_type")=cr::Lane::LaneType::Driving))
+    .def("get_waypoint", &GetWaypoint, (arg("location"), arg("project_to_road")=true, arg("lane_type")=cr::Lane::LaneType::Driving))
     .def("get_waypoint_xodr", &cc::Map::GetWaypointXODR, (arg("road_id"), arg("lane_id"), arg("s")))
     .def("get_topology", &GetTopology)
     .def("generate_waypoints", CALL_RETURNING_LIST_1(cc::Map, GenerateWaypoints, double), (args("distance")))
@@ -171,6 +331,14 @@ void export_map() {
     .def("get_all_landmarks_of_type", CALL_RETURNING_LIST_1(cc::Map, GetAllLandmarksOfType, std::string), (args("type")))
     .def("get_landmark_group", CALL_RETURNING_LIST_1(cc::Map, GetLandmarkGroup, cc::Landmark), args("landmark"))
     .def("cook_in_memory_map", &cc::Map::CookInMemoryMap, (arg("path")=""))
+    .def("compute_route", &ComputeRoute, (arg("origin"), arg("destination")))
+    .def("compute_route_distances", &ComputeRouteDistances, (arg("origins"), arg("destinations")))
+#if PY_MAJOR_VERSION >= 3
+    // memoryview.cast, used for the column arrays, is Python 3 only
+    .def("get_waypoints", &GetWaypoints, (arg("locations"), arg("project_to_road")=true, arg("lane_type")=cr::Lane::LaneType::Driving))
+    .def("get_topology_arrays", &GetTopologyArrays)
+    .def("generate_waypoint_arrays", &GenerateWaypointArrays, (arg("distance")))
+#endif // PY_MAJOR_VERSION >= 3
     .def(self_ns::str(self_ns::self))
   ;
 
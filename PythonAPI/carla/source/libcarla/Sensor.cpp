@@ -8,7 +8,9 @@
 #include <carla/client/ClientSideSensor.h>
 #include <carla/client/LaneInvasionSensor.h>
 #include <carla/client/Sensor.h>
+#include <carla/client/SensorBundle.h>
 #include <carla/client/ServerSideSensor.h>
+#include <carla/sensor/SensorData.h>
 
 static void SubscribeToStream(carla::client::Sensor &self, boost::python::object callback) {
   self.Listen(MakeCallback(std::move(callback)));
@@ -21,6 +23,39 @@ static void SubscribeToGBuffer(
   self.ListenToGBuffer(GBufferId, MakeCallback(std::move(callback)));
 }
 
+static boost::shared_ptr<carla::client::SensorBundle> MakeSensorBundle(
+    boost::python::object py_sensors,
+    bool latest_only,
+    size_t max_queued_frames) {
+  using SensorPtr = carla::SharedPtr<carla::client::Sensor>;
+  std::vector<SensorPtr> sensors{
+      boost::python::stl_input_iterator<SensorPtr>(py_sensors),
+      boost::python::stl_input_iterator<SensorPtr>()};
+  using Policy = carla::client::SensorBundle::Policy;
+  return boost::make_shared<carla::client::SensorBundle>(
+      std::move(sensors),
+      latest_only ? Policy::LatestOnly : Policy::Queue,
+      max_queued_frames);
+}
+
+static boost::python::object GetSensorBundleFrame(
+    carla::client::SensorBundle &self,
+    boost::python::object frame,
+    double seconds,
+    bool allow_incomplete) {
+  const auto timeout = TimeDurationFromSeconds(seconds);
+  const bool wait_for_next = frame.is_none();
+  const size_t frame_number = wait_for_next ? 0u : boost::python::extract<size_t>(frame)();
+  boost::optional<carla::client::SensorDataBundle> result;
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    result = wait_for_next ?
+        self.WaitForNext(timeout) :
+        self.WaitForFrame(frame_number, timeout, allow_incomplete);
+  }
+  return result ? boost::python::object(*result) : boost::python::object();
+}
+
 void export_sensor() {
   using namespace boost::python;
   namespace cc = carla::client;
@@ -46,6 +81,26 @@ void export_sensor() {
     .def(self_ns::str(self_ns::self))
   ;
 
+  class_<cc::SensorDataBundle>("SensorDataBundle", no_init)
+    .add_property("frame", &cc::SensorDataBundle::GetFrame)
+    .def("is_complete", &cc::SensorDataBundle::IsComplete)
+    .def("__len__", &cc::SensorDataBundle::size)
+    .def("__iter__", range(&cc::SensorDataBundle::begin, &cc::SensorDataBundle::end))
+    .def("__getitem__", +[](const cc::SensorDataBundle &self, size_t pos) {
+      return self.at(pos);
+    })
+  ;
+
+  class_<cc::SensorBundle, boost::noncopyable, boost::shared_ptr<cc::SensorBundle>>("SensorBundle", no_init)
+    .def("__init__", make_constructor(&MakeSensorBundle, default_call_policies(),
+        (arg("sensors"), arg("latest_only")=false, arg("max_queued_frames")=8u)))
+    .add_property("is_listening", &cc::SensorBundle::IsListening)
+    .add_property("dropped_frames", &cc::SensorBundle::GetNumberOfDroppedFrames)
+    .def("listen", &cc::SensorBundle::Listen)
+    .def("stop", &cc::SensorBundle::Stop)
+    .def("get", &GetSensorBundleFrame, (arg("frame")=object(), arg("seconds")=2.0, arg("allow_incomplete")=false))
+  ;
+
   class_<cc::LaneInvasionSensor, bases<cc::ClientSideSensor>, boost::noncopyable, boost::shared_ptr<cc::LaneInvasionSensor>>
       ("LaneInvasionSensor", no_init)
     .def(self_ns::str(self_ns::self))
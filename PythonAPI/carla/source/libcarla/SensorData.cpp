@@ -5,10 +5,14 @@
 // For a copy, see <https://opensource.org/licenses/MIT>.
 
 #include <carla/PythonUtil.h>
+#include <carla/StringUtil.h>
+#include <carla/image/ColorConverterKernels.h>
 #include <carla/image/ImageConverter.h>
 #include <carla/image/ImageIO.h>
 #include <carla/image/ImageView.h>
+#include <carla/image/ImageWriter.h>
 #include <carla/pointcloud/PointCloudIO.h>
+#include <carla/pointcloud/PointCloudWriter.h>
 #include <carla/sensor/SensorData.h>
 #include <carla/sensor/data/CollisionEvent.h>
 #include <carla/sensor/data/IMUMeasurement.h>
@@ -30,7 +34,6 @@
 #include <cmath>
 #include <vector>
 #include <algorithm>
-#include <thread>
 
 namespace carla {
 namespace sensor {
@@ -193,16 +196,16 @@ template <typename T>
 static void ConvertImage(T &self, EColorConverter cc) {
   carla::PythonUtil::ReleaseGIL unlock;
   using namespace carla::image;
-  auto view = ImageView::MakeView(self);
+  auto *data = reinterpret_cast<uint8_t *>(self.data());
   switch (cc) {
     case EColorConverter::Depth:
-      ImageConverter::ConvertInPlace(view, ColorConverter::Depth());
+      ColorConverterKernels::Depth(data, data, self.size(), true);
       break;
     case EColorConverter::LogarithmicDepth:
-      ImageConverter::ConvertInPlace(view, ColorConverter::LogarithmicDepth());
+      ColorConverterKernels::LogarithmicDepth(data, data, self.size(), true);
       break;
     case EColorConverter::CityScapesPalette:
-      ImageConverter::ConvertInPlace(view, ColorConverter::CityScapesPalette());
+      ColorConverterKernels::CityScapesPalette(data, data, self.size(), true);
       break;
     case EColorConverter::Raw:
       break; // ignore.
@@ -221,139 +224,103 @@ class FakeImage : public std::vector<uint8_t> {
 // method to convert optical flow images to rgb
 static FakeImage ColorCodedFlow (
     carla::sensor::data::OpticalFlowImage& image) {
-  namespace bp = boost::python;
-  namespace csd = carla::sensor::data;
-  constexpr float pi = 3.1415f;
-  constexpr float rad2ang = 360.f/(2.f*pi);
   FakeImage result;
   result.Width = image.GetWidth();
   result.Height = image.GetHeight();
   result.FOV = image.GetFOVAngle();
   result.resize(image.GetHeight()*image.GetWidth()* 4);
-
-  // lambda for computing batches of pixels
-  auto command = [&] (size_t min_index, size_t max_index) {
-    for (size_t index = min_index; index < max_index; index++) {
-      const csd::OpticalFlowPixel& pixel = image[index];
-      float vx = pixel.x;
-      float vy = pixel.y;
-
-      float angle = 180.f + std::atan2(vy, vx)*rad2ang;
-      if (angle < 0) angle = 360.f + angle;
-      angle = std::fmod(angle, 360.f);
-
-      float norm = std::sqrt(vx*vx + vy*vy);
-      const float shift = 0.999f;
-      const float a = 1.f/std::log(0.1f + shift);
-      float intensity = carla::geom::Math::Clamp(a*std::log(norm + shift), 0.f, 1.f);
-
-      float& H = angle;
-      float  S = 1.f;
-      float V = intensity;
-      float H_60 = H*(1.f/60.f);
-
-      float C = V * S;
-      float X = C*(1.f - std::abs(std::fmod(H_60, 2.f) - 1.f));
-      float m = V - C;
-
-      float r = 0,g = 0,b = 0;
-      unsigned int angle_case = static_cast<unsigned int>(H_60);
-      switch (angle_case) {
-      case 0:
-        r = C;
-        g = X;
-        b = 0;
-        break;
-      case 1:
-        r = X;
-        g = C;
-        b = 0;
-        break;
-      case 2:
-        r = 0;
-        g = C;
-        b = X;
-        break;
-      case 3:
-        r = 0;
-        g = X;
-        b = C;
-        break;
-      case 4:
-        r = X;
-        g = 0;
-        b = C;
-        break;
-      case 5:
-        r = C;
-        g = 0;
-        b = X;
-        break;
-      default:
-        r = 1;
-        g = 1;
-        b = 1;
-        break;
-      }
-
-      uint8_t R = static_cast<uint8_t>((r+m)*255.f);
-      uint8_t G = static_cast<uint8_t>((g+m)*255.f);
-      uint8_t B = static_cast<uint8_t>((b+m)*255.f);
-      result[4*index] = B;
-      result[4*index + 1] = G;
-      result[4*index + 2] = R;
-      result[4*index + 3] = 0;
-    }
-  };
-  size_t num_threads = std::max(8u, std::thread::hardware_concurrency());
-  size_t batch_size = image.size() / num_threads;
-  std::vector<std::thread*> t(num_threads+1);
-
-  for(size_t n = 0; n < num_threads; n++) {
-    t[n] = new std::thread(command, n * batch_size, (n+1) * batch_size);
+  {
+    carla::PythonUtil::ReleaseGIL unlock;
+    carla::image::ColorConverterKernels::OpticalFlow(
+        reinterpret_cast<const float *>(image.data()),
+        result.data(),
+        image.size(),
+        true);
   }
-  t[num_threads] = new std::thread(command, num_threads * batch_size, image.size());
+  return result;
+}
 
-  for(size_t n = 0; n <= num_threads; n++) {
-    if(t[n]->joinable()){
-      t[n]->join();
-    }
-    delete t[n];
+/// Convert @a self with @a kernel into a temporary buffer and write it to
+/// disk. Depth images are saved in grayscale.
+template <typename T, typename KernelT>
+static std::string SaveConvertedImageToDisk(const T &self, std::string path, KernelT kernel, bool grayscale) {
+  std::vector<uint8_t> converted(4u * self.size());
+  kernel(reinterpret_cast<const uint8_t *>(self.data()), converted.data(), self.size(), true);
+  const auto view = boost::gil::interleaved_view(
+      self.GetWidth(),
+      self.GetHeight(),
+      reinterpret_cast<const boost::gil::bgra8_pixel_t *>(converted.data()),
+      4u * self.GetWidth());
+  if (grayscale) {
+    return carla::image::ImageIO::WriteView(std::move(path), boost::gil::nth_channel_view(view, 0));
   }
-  return result;
+  return carla::image::ImageIO::WriteView(std::move(path), view);
 }
 
 template <typename T>
 static std::string SaveImageToDisk(T &self, std::string path, EColorConverter cc) {
   carla::PythonUtil::ReleaseGIL unlock;
   using namespace carla::image;
-  auto view = ImageView::MakeView(self);
   switch (cc) {
     case EColorConverter::Raw:
       return ImageIO::WriteView(
           std::move(path),
-          view);
+          ImageView::MakeView(self));
     case EColorConverter::Depth:
-      return ImageIO::WriteView(
-          std::move(path),
-          ImageView::MakeColorConvertedView(view, ColorConverter::Depth()));
+      return SaveConvertedImageToDisk(self, std::move(path), ColorConverterKernels::Depth, true);
     case EColorConverter::LogarithmicDepth:
-      return ImageIO::WriteView(
-          std::move(path),
-          ImageView::MakeColorConvertedView(view, ColorConverter::LogarithmicDepth()));
+      return SaveConvertedImageToDisk(self, std::move(path), ColorConverterKernels::LogarithmicDepth, true);
     case EColorConverter::CityScapesPalette:
-      return ImageIO::WriteView(
-          std::move(path),
-          ImageView::MakeColorConvertedView(view, ColorConverter::CityScapesPalette()));
+      return SaveConvertedImageToDisk(self, std::move(path), ColorConverterKernels::CityScapesPalette, false);
     default:
       throw std::invalid_argument("invalid color converter!");
   }
 }
 
+static bool WriteImage(carla::image::ImageWriter &self, const carla::sensor::data::Image &image, std::string path) {
+  // Keep the image alive with its own shared pointer, not with one holding a
+  // reference to the Python object.
+  auto shared = boost::static_pointer_cast<const carla::sensor::data::Image>(image.shared_from_this());
+  return self.Write(std::move(shared), std::move(path)).valid();
+}
+
+static void FlushImageWriter(carla::image::ImageWriter &self) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  self.Flush();
+}
+
+/// Paths ending in ".pcd" are always written in binary PCD format.
+static carla::pointcloud::PointCloudIO::Format GetPointCloudFormat(const std::string &path, bool binary) {
+  using Format = carla::pointcloud::PointCloudIO::Format;
+  if (carla::StringUtil::EndsWith(path, ".pcd")) {
+    return Format::PcdBinary;
+  }
+  return binary ? Format::PlyBinary : Format::PlyAscii;
+}
+
+template <typename T>
+static std::string SavePointCloudToDisk(T &self, std::string path, bool binary) {
+  carla::PythonUtil::ReleaseGIL unlock;
+  const auto format = GetPointCloudFormat(path, binary);
+  return carla::pointcloud::PointCloudIO::SaveToDisk(std::move(path), self.begin(), self.end(), format);
+}
+
 template <typename T>
-static std::string SavePointCloudToDisk(T &self, std::string path) {
+static bool WritePointCloud(
+    carla::pointcloud::PointCloudWriter &self,
+    const T &measurement,
+    std::string path,
+    bool binary) {
+  // Keep the measurement alive with its own shared pointer, not with one
+  // holding a reference to the Python object.
+  auto shared = boost::static_pointer_cast<const T>(measurement.shared_from_this());
+  const auto format = GetPointCloudFormat(path, binary);
+  return self.Write(std::move(shared), std::move(path), format);
+}
+
+static void FlushPointCloudWriter(carla::pointcloud::PointCloudWriter &self) {
   carla::PythonUtil::ReleaseGIL unlock;
-  return carla::pointcloud::PointCloudIO::SaveToDisk(std::move(path), self.begin(), self.end());
+  self.Flush();
 }
 
 void export_sensor_data() {
@@ -423,6 +390,14 @@ void export_sensor_data() {
     .def(self_ns::str(self_ns::self))
   ;
 
+  class_<carla::image::ImageWriter, boost::noncopyable>("ImageWriter", init<size_t, size_t, int>((arg("workers")=0u, arg("max_queued")=32u, arg("png_compression_level")=1)))
+    .add_property("queued_count", &carla::image::ImageWriter::GetQueuedCount)
+    .add_property("dropped_count", &carla::image::ImageWriter::GetDroppedCount)
+    .add_property("failed_count", &carla::image::ImageWriter::GetFailedCount)
+    .def("save", &WriteImage, (arg("image"), arg("path")))
+    .def("flush", &FlushImageWriter)
+  ;
+
   class_<csd::OpticalFlowImage, bases<cs::SensorData>, boost::noncopyable, boost::shared_ptr<csd::OpticalFlowImage>>("OpticalFlowImage", no_init)
     .add_property("width", &csd::OpticalFlowImage::GetWidth)
     .add_property("height", &csd::OpticalFlowImage::GetHeight)
@@ -445,7 +420,7 @@ void export_sensor_data() {
     .add_property("channels", &csd::LidarMeasurement::GetChannelCount)
     .add_property("raw_data", &GetRawDataAsBuffer<csd::LidarMeasurement>)
     .def("get_point_count", &csd::LidarMeasurement::GetPointCount, (arg("channel")))
-    .def("save_to_disk", &SavePointCloudToDisk<csd::LidarMeasurement>, (arg("path")))
+    .def("save_to_disk", &SavePointCloudToDisk<csd::LidarMeasurement>, (arg("path"), arg("binary")=false))
     .def("__len__", &csd::LidarMeasurement::size)
     .def("__iter__", iterator<csd::LidarMeasurement>())
     .def("__getitem__", +[](const csd::LidarMeasurement &self, size_t pos) -> csd::LidarDetection {
@@ -462,7 +437,7 @@ void export_sensor_data() {
     .add_property("channels", &csd::SemanticLidarMeasurement::GetChannelCount)
     .add_property("raw_data", &GetRawDataAsBuffer<csd::SemanticLidarMeasurement>)
     .def("get_point_count", &csd::SemanticLidarMeasurement::GetPointCount, (arg("channel")))
-    .def("save_to_disk", &SavePointCloudToDisk<csd::SemanticLidarMeasurement>, (arg("path")))
+    .def("save_to_disk", &SavePointCloudToDisk<csd::SemanticLidarMeasurement>, (arg("path"), arg("binary")=false))
     .def("__len__", &csd::SemanticLidarMeasurement::size)
     .def("__iter__", iterator<csd::SemanticLidarMeasurement>())
     .def("__getitem__", +[](const csd::SemanticLidarMeasurement &self, size_t pos) -> csd::SemanticLidarDetection {
@@ -474,6 +449,15 @@ void export_sensor_data() {
     .def(self_ns::str(self_ns::self))
   ;
 
+  class_<carla::pointcloud::PointCloudWriter, boost::noncopyable>("PointCloudWriter", init<size_t>((arg("max_queued")=16u)))
+    .add_property("queued_count", &carla::pointcloud::PointCloudWriter::GetQueuedCount)
+    .add_property("dropped_count", &carla::pointcloud::PointCloudWriter::GetDroppedCount)
+    .add_property("failed_count", &carla::pointcloud::PointCloudWriter::GetFailedCount)
+    .def("save", &WritePointCloud<csd::LidarMeasurement>, (arg("measurement"), arg("path"), arg("binary")=true))
+    .def("save", &WritePointCloud<csd::SemanticLidarMeasurement>, (arg("measurement"), arg("path"), arg("binary")=true))
+    .def("flush", &FlushPointCloudWriter)
+  ;
+
   class_<csd::CollisionEvent, bases<cs::SensorData>, boost::noncopyable, boost::shared_ptr<csd::CollisionEvent>>("CollisionEvent", no_init)
     .add_property("actor", &csd::CollisionEvent::GetActor)
     .add_property("other_actor", &csd::CollisionEvent::GetOtherActor)
@@ -236,6 +236,18 @@ static void AddVariationsForSensor(FActorDefinition &Def)
   Def.Variations.Emplace(Tick);
 }
 
+static void AddVariationsForImageCompression(FActorDefinition &Def)
+{
+  // Lossless compression of the images sent to the clients.
+  FActorVariation Compression;
+  Compression.Id = TEXT("compression");
+  Compression.Type = EActorAttributeType::String;
+  Compression.RecommendedValues = { TEXT("none"), TEXT("rle"), TEXT("lz4"), TEXT("delta") };
+  Compression.bRestrictToRecommended = true;
+
+  Def.Variations.Emplace(Compression);
+}
+
 static void AddVariationsForTrigger(FActorDefinition &Def)
 {
   // Friction
@@ -302,6 +314,7 @@ void UActorBlueprintFunctionLibrary::MakeCameraDefinition(
   FillIdAndTags(Definition, TEXT("sensor"), TEXT("camera"), Id);
   AddRecommendedValuesForSensorRoleNames(Definition);
   AddVariationsForSensor(Definition);
+  AddVariationsForImageCompression(Definition);
 
   // FOV
   FActorVariation FOV;
@@ -660,6 +673,7 @@ void UActorBlueprintFunctionLibrary::MakeNormalsCameraDefinition(bool &Success,
   FillIdAndTags(Definition, TEXT("sensor"), TEXT("camera"), TEXT("normals"));
   AddRecommendedValuesForSensorRoleNames(Definition);
   AddVariationsForSensor(Definition);
+  AddVariationsForImageCompression(Definition);
 
   // FOV
   FActorVariation FOV;
@@ -1534,6 +1548,8 @@ void UActorBlueprintFunctionLibrary::SetCamera(
       RetrieveActorAttributeToInt("image_size_y", Description.Variations, 600));
   Camera->SetFOVAngle(
       RetrieveActorAttributeToFloat("fov", Description.Variations, 90.0f));
+  Camera->SetImageCodec(carla::sensor::s11n::ImageCompression::CodecFromString(
+      TCHAR_TO_UTF8(*RetrieveActorAttributeToString("compression", Description.Variations, "none"))));
   if (Description.Variations.Contains("enable_postprocess_effects"))
   {
     Camera->EnablePostProcessingEffects(
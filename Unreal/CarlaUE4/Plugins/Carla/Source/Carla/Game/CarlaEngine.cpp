@@ -19,6 +19,7 @@
 #include "Carla/MapGen/LargeMapManager.h"
 
 #include <compiler/disable-ue4-macros.h>
+#include <carla/BufferStream.h>
 #include <carla/Logging.h>
 #include <carla/multigpu/primaryCommands.h>
 #include <carla/multigpu/commands.h>
@@ -102,24 +103,22 @@ void FCarlaEngine::NotifyInitGame(const UCarlaSettings &Settings)
       
       // define the commands executor (when a command comes from the primary server)
       auto CommandExecutor = [=](carla::multigpu::MultiGPUCommand Id, carla::Buffer Data) {
-        struct CarlaStreamBuffer : public std::streambuf
-        {
-            CarlaStreamBuffer(char *buf, std::size_t size) { setg(buf, buf, buf + size); }
-        };
         switch (Id) {
           case carla::multigpu::MultiGPUCommand::SEND_FRAME:
           {
             if(GetCurrentEpisode())
             {
               TRACE_CPUPROFILER_EVENT_SCOPE_STR("MultiGPUCommand::SEND_FRAME");
-              // convert frame data from buffer to istream
-              CarlaStreamBuffer TempStream((char *) Data.data(), Data.size());
+              // read the frame data directly from the received buffer
+              carla::BufferInputStreamBuf TempStream(Data);
               std::istream InStream(&TempStream);
-              GetCurrentEpisode()->GetFrameData().Read(InStream);
+              FFrameData Frame;
+              Frame.SetEpisode(GetCurrentEpisode());
+              Frame.Read(InStream);
               {
                 TRACE_CPUPROFILER_EVENT_SCOPE_STR("FramesToProcess.emplace_back");
                 std::lock_guard<std::mutex> Lock(FrameToProcessMutex);
-                FramesToProcess.emplace_back(GetCurrentEpisode()->GetFrameData());
+                FramesToProcess.emplace_back(std::move(Frame));
               }
             }
             // forces a tick
@@ -292,12 +291,13 @@ void FCarlaEngine::OnPostTick(UWorld *World, ELevelTick TickType, float DeltaSec
       if (SecondaryServer->HasClientsConnected()) {
         GetCurrentEpisode()->GetFrameData().GetFrameData(GetCurrentEpisode(), true, bNewConnection);
         bNewConnection = false;
-        std::ostringstream OutStream;
+        // serialize the frame data straight into a pooled buffer
+        carla::BufferOutputStreamBuf OutBuffer(FrameDataBufferPool->Pop());
+        std::ostream OutStream(&OutBuffer);
         GetCurrentEpisode()->GetFrameData().Write(OutStream);
 
         // send frame data to secondary
-        std::string Tmp(OutStream.str());
-        SecondaryServer->GetCommander().SendFrameData(carla::Buffer(std::move((unsigned char *) Tmp.c_str()), (size_t) Tmp.size()));
+        SecondaryServer->GetCommander().SendFrameData(OutBuffer.Release());
 
         GetCurrentEpisode()->GetFrameData().Clear();
       }
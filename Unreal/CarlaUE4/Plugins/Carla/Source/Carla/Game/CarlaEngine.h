@@ -15,6 +15,7 @@
 #include "Misc/CoreDelegates.h"
 
 #include <compiler/disable-ue4-macros.h>
+#include <carla/BufferPool.h>
 #include <carla/multigpu/router.h>
 #include <carla/multigpu/primaryCommands.h>
 #include <carla/multigpu/secondary.h>
@@ -121,6 +122,10 @@ private:
 
   std::shared_ptr<carla::multigpu::Router>    SecondaryServer;
   std::shared_ptr<carla::multigpu::Secondary> Secondary;
+
+  // buffers for the frame data sent to secondary servers, they return to the
+  // pool once every secondary has received them
+  std::shared_ptr<carla::BufferPool> FrameDataBufferPool = carla::BufferPool::GetDefault();
  
   std::vector<FFrameData> FramesToProcess;
   std::mutex FrameToProcessMutex;
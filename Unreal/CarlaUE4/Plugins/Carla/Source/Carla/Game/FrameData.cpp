@@ -20,6 +20,8 @@ void FFrameData::GetFrameData(UCarlaEpisode *ThisEpisode, bool bAdditionalData,
   if (bIncludeActorsAgain)
   {
     AddExistingActors();
+    // new secondaries need the position of every actor
+    LastPositions.clear();
   }
 
   // through all actors in registry
@@ -342,13 +344,25 @@ void FFrameData::AddActorPosition(FCarlaActor *CarlaActor)
   check(CarlaActor != nullptr);
 
   FTransform Transform = CarlaActor->GetActorGlobalTransform();
-  // get position of the vehicle
-  AddPosition(CarlaRecorderPosition
+  CarlaRecorderPosition Position
   {
     CarlaActor->GetActorId(),
     Transform.GetLocation(),
     Transform.GetRotation().Euler()
-  });
+  };
+
+  // only send the position if it changed since the last frame sent
+  auto Last = LastPositions.find(Position.DatabaseId);
+  if (Last != LastPositions.end() &&
+      Last->second.Location == Position.Location &&
+      Last->second.Rotation == Position.Rotation)
+  {
+    return;
+  }
+  LastPositions[Position.DatabaseId] = Position;
+
+  // get position of the vehicle
+  AddPosition(Position);
 }
 
 
@@ -506,6 +520,7 @@ void FFrameData::AddEvent(const CarlaRecorderEventAdd &Event)
 
 void FFrameData::AddEvent(const CarlaRecorderEventDel &Event)
 {
+  LastPositions.erase(Event.DatabaseId);
   EventsDel.Add(std::move(Event));
 }
 
@@ -25,6 +25,7 @@
 #include "Carla/Recorder/CarlaRecorderFrameCounter.h"
 
 #include <sstream>
+#include <unordered_map>
 
 class UCarlaEpisode;
 class FCarlaActor;
@@ -162,4 +163,8 @@ private:
   void AddExistingActors(void);
 
   UCarlaEpisode *Episode;
+
+  // last position sent for each actor, positions that did not change since
+  // the previous frame are not sent again (secondaries keep the old one)
+  std::unordered_map<uint32_t, CarlaRecorderPosition> LastPositions;
 };
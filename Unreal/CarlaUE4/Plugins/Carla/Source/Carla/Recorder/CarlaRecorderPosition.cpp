@@ -60,15 +60,16 @@ void CarlaRecorderPositions::Write(std::ostream &OutFile)
 
 void CarlaRecorderPositions::Read(std::istream &InFile)
 {
-  uint16_t i, Total;
+  uint16_t Total;
 
-  // read all positions
+  // read all positions at once, they are written as a packed array
   ReadValue<uint16_t>(InFile, Total);
-  for (i = 0; i < Total; ++i)
+  const size_t Offset = Positions.size();
+  Positions.resize(Offset + Total);
+  if (Total > 0)
   {
-    CarlaRecorderPosition Pos;
-    Pos.Read(InFile);
-    Add(Pos);
+    InFile.read(reinterpret_cast<char *>(Positions.data() + Offset),
+        Total * sizeof(CarlaRecorderPosition));
   }
 }
 
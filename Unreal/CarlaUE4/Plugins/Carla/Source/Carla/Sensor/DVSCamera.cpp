@@ -33,6 +33,11 @@ FActorDefinition ADVSCamera::GetSensorDefinition()
   constexpr bool bEnableModifyingPostProcessEffects = true;
   auto Definition = UActorBlueprintFunctionLibrary::MakeCameraDefinition(TEXT("dvs"), bEnableModifyingPostProcessEffects);
 
+  // The events are not serialized as an image, they cannot be compressed.
+  Definition.Variations.RemoveAll([](const FActorVariation &Variation) {
+    return Variation.Id == TEXT("compression");
+  });
+
   FActorVariation Cp;
   Cp.Id = TEXT("positive_threshold");
   Cp.Type = EActorAttributeType::Float;
@@ -48,10 +48,14 @@ void ARayCastLidar::Set(const FLidarDescription &LidarDescription)
   CreateLasers();
   PointsPerChannel.resize(Description.Channels);
 
-  // Compute drop off model parameters
-  DropOffBeta = 1.0f - Description.DropOffAtZeroIntensity;
-  DropOffAlpha = Description.DropOffAtZeroIntensity / Description.DropOffIntensityLimit;
   DropOffGenActive = Description.DropOffGenRate > std::numeric_limits<float>::epsilon();
+
+  carla::sensor::LidarPostprocessor::Parameters Parameters;
+  Parameters.atmosphere_attenuation_rate = Description.AtmospAttenRate;
+  Parameters.dropoff_intensity_limit = Description.DropOffIntensityLimit;
+  Parameters.dropoff_zero_intensity = Description.DropOffAtZeroIntensity;
+  Parameters.noise_stddev = Description.NoiseStdDev;
+  Postprocessor = carla::sensor::LidarPostprocessor(Parameters, Description.RandomSeed);
 }
 
 void ARayCastLidar::PostPhysTick(UWorld *World, ELevelTick TickType, float DeltaTime)
@@ -79,24 +83,6 @@ float ARayCastLidar::ComputeIntensity(const FSemanticDetection& RawDetection) co
   return IntRec;
 }
 
-ARayCastLidar::FDetection ARayCastLidar::ComputeDetection(const FHitResult& HitInfo, const FTransform& SensorTransf) const
-{
-  FDetection Detection;
-  const FVector HitPoint = HitInfo.ImpactPoint;
-  Detection.point = SensorTransf.Inverse().TransformPosition(HitPoint);
-
-  const float Distance = Detection.point.Length();
-
-  const float AttenAtm = Description.AtmospAttenRate;
-  const float AbsAtm = exp(-AttenAtm * Distance);
-
-  const float IntRec = AbsAtm;
-
-  Detection.intensity = IntRec;
-
-  return Detection;
-}
-
   void ARayCastLidar::PreprocessRays(uint32_t Channels, uint32_t MaxPointsPerChannel) {
     Super::PreprocessRays(Channels, MaxPointsPerChannel);
 
@@ -107,36 +93,17 @@ ARayCastLidar::FDetection ARayCastLidar::ComputeDetection(const FHitResult& HitI
     }
   }
 
-  bool ARayCastLidar::PostprocessDetection(FDetection& Detection) const
-  {
-    if (Description.NoiseStdDev > std::numeric_limits<float>::epsilon()) {
-      const auto ForwardVector = Detection.point.MakeUnitVector();
-      const auto Noise = ForwardVector * RandomEngine->GetNormalDistribution(0.0f, Description.NoiseStdDev);
-      Detection.point += Noise;
-    }
-
-    const float Intensity = Detection.intensity;
-    if(Intensity > Description.DropOffIntensityLimit)
-      return true;
-    else
-      return RandomEngine->GetUniformFloat() < DropOffAlpha * Intensity + DropOffBeta;
-  }
-
   void ARayCastLidar::ComputeAndSaveDetections(const FTransform& SensorTransform) {
-    for (auto idxChannel = 0u; idxChannel < Description.Channels; ++idxChannel)
-      PointsPerChannel[idxChannel] = RecordedHits[idxChannel].size();
-
-    LidarData.ResetMemory(PointsPerChannel);
-
-    for (auto idxChannel = 0u; idxChannel < Description.Channels; ++idxChannel) {
+    const FTransform InverseTransform = SensorTransform.Inverse();
+    HitPoints.resize(Description.Channels);
+    ParallelFor(Description.Channels, [&](int32 idxChannel) {
+      auto& Points = HitPoints[idxChannel];
+      Points.clear();
+      Points.reserve(RecordedHits[idxChannel].size());
       for (auto& hit : RecordedHits[idxChannel]) {
-        FDetection Detection = ComputeDetection(hit, SensorTransform);
-        if (PostprocessDetection(Detection))
-          LidarData.WritePointSync(Detection);
-        else
-          PointsPerChannel[idxChannel]--;
+        Points.emplace_back(InverseTransform.TransformPosition(hit.ImpactPoint));
       }
-    }
+    });
 
-    LidarData.WriteChannelCount(PointsPerChannel);
+    Postprocessor.Process(HitPoints, LidarData);
   }
@@ -14,6 +14,7 @@
 #include "Carla/Actor/ActorBlueprintFunctionLibrary.h"
 
 #include <compiler/disable-ue4-macros.h>
+#include <carla/sensor/LidarPostprocessor.h>
 #include <carla/sensor/data/LidarData.h>
 #include <compiler/enable-ue4-macros.h>
 
@@ -40,23 +41,20 @@ public:
 private:
   /// Compute the received intensity of the point
   float ComputeIntensity(const FSemanticDetection& RawDetection) const;
-  FDetection ComputeDetection(const FHitResult& HitInfo, const FTransform& SensorTransf) const;
 
   void PreprocessRays(uint32_t Channels, uint32_t MaxPointsPerChannel) override;
-  bool PostprocessDetection(FDetection& Detection) const;
 
   void ComputeAndSaveDetections(const FTransform& SensorTransform) override;
 
   FLidarData LidarData;
 
+  /// Computes intensity, intensity drop off and noise of the hits in
+  /// parallel. The general drop off is applied before casting the rays.
+  carla::sensor::LidarPostprocessor Postprocessor;
+
+  /// Hits of each channel in the sensor's frame.
+  std::vector<std::vector<carla::geom::Location>> HitPoints;
+
   /// Enable/Disable general dropoff of lidar points
   bool DropOffGenActive;
-
-  /// Slope for the intensity dropoff of lidar points, it is calculated
-  /// throught the dropoff limit and the dropoff at zero intensity
-  /// The points is kept with a probality alpha*Intensity + beta where
-  /// alpha = (1 - dropoff_zero_intensity) / droppoff_limit
-  /// beta = (1 - dropoff_zero_intensity)
-  float DropOffAlpha;
-  float DropOffBeta;
 };
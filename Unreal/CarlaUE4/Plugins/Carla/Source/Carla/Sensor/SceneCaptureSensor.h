@@ -149,6 +149,18 @@ public:
     return ImageHeight;
   }
 
+  /// Set the compression applied to the images before sending them to the
+  /// clients.
+  void SetImageCodec(carla::sensor::s11n::ImageCodec Codec)
+  {
+    ImageCodec = Codec;
+  }
+
+  carla::sensor::s11n::ImageCodec GetImageCodec() const
+  {
+    return ImageCodec;
+  }
+
   UFUNCTION(BlueprintCallable)
   void EnablePostProcessingEffects(bool Enable = true)
   {
@@ -461,6 +473,9 @@ protected:
   UPROPERTY(EditAnywhere)
   bool bEnable16BitFormat = false;
 
+  /// Compression of the images sent to the clients.
+  carla::sensor::s11n::ImageCodec ImageCodec = carla::sensor::s11n::ImageCodec::None;
+
 private:
 
   template <
@@ -526,7 +541,8 @@ private:
         std::move(Buffer),
         ViewSize.X,
         ViewSize.Y,
-        Self.GetFOVAngle());
+        Self.GetFOVAngle(),
+        Self.GetImageCodec());
   }
 
 protected:
@@ -64,6 +64,8 @@ static auto FWorldObserver_GetActorState(const FCarlaActor &View, const FActorRe
       // Get the failure state by checking the rollover one as it is the only one currently implemented.
       // This will have to be expanded once more states are added
       state.vehicle_data.failure_state = Vehicle->GetFailureState();
+      state.vehicle_data.light_state =
+          carla::rpc::VehicleLightState(Vehicle->GetVehicleLightState()).GetLightStateAsValue();
     }
   }
 
@@ -176,6 +178,8 @@ static auto FWorldObserver_GetDormantActorState(const FCarlaActor &View, const F
       state.vehicle_data.traffic_light_state = TLS::Green;
       state.vehicle_data.speed_limit = ActorData->SpeedLimit;
       state.vehicle_data.has_traffic_light = false;
+      state.vehicle_data.light_state =
+          carla::rpc::VehicleLightState(ActorData->LightState).GetLightStateAsValue();
   }
   else if (AType::Walker == View.GetActorType())
   {
@@ -302,6 +306,13 @@ static carla::Buffer FWorldObserver_Serialize(
   uint8_t simulation_state = (SimulationState::MapChange * MapChange);
   simulation_state |= (SimulationState::PendingLightUpdate * PendingLightUpdates);
 
+  // Send the weather along so clients don't need to ask for it every tick.
+  if (const AWeather *Weather = Episode.GetWeather())
+  {
+    header.weather = carla::rpc::WeatherParameters{Weather->GetCurrentWeather()};
+    simulation_state |= SimulationState::HasWeather;
+  }
+
   header.simulation_state = static_cast<SimulationState>(simulation_state);
 
   write_data(header);
@@ -25,8 +25,11 @@
 #include "CarlaServerResponse.h"
 #include "Carla/Util/BoundingBoxCalculator.h"
 #include "Misc/FileHelper.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/PlatformFilemanager.h"
 
 #include <compiler/disable-ue4-macros.h>
+#include <carla/ContentHash.h>
 #include <carla/Functional.h>
 #include <carla/multigpu/router.h>
 #include <carla/Version.h>
@@ -41,6 +44,7 @@
 #include <carla/rpc/EnvironmentObject.h>
 #include <carla/rpc/EpisodeInfo.h>
 #include <carla/rpc/EpisodeSettings.h>
+#include <carla/rpc/FileInfo.h>
 #include <carla/rpc/LabelledPoint.h>
 #include <carla/rpc/LightState.h>
 #include <carla/rpc/MapInfo.h>
@@ -54,6 +58,7 @@
 #include <carla/rpc/VehicleDoor.h>
 #include <carla/rpc/VehicleAckermannControl.h>
 #include <carla/rpc/VehicleControl.h>
+#include <carla/rpc/VehicleControlBatch.h>
 #include <carla/rpc/VehiclePhysicsControl.h>
 #include <carla/rpc/VehicleLightState.h>
 #include <carla/rpc/VehicleLightStateList.h>
@@ -126,8 +131,79 @@ public:
 private:
 
   void BindActions();
+
+  /// Xodr and bin files of the current map in @a folder, relative to the
+  /// content folder.
+  std::vector<std::string> FindRequiredFiles(std::string folder) const;
+
+  /// Size and hash of the file @a Name in the content folder. Each file is
+  /// hashed again only if it changed.
+  carla::rpc::FileInfo GetFileInfo(const std::string &Name);
+
+  /// FileInfo of the files shared with the clients with the time stamp of
+  /// the file when it was hashed.
+  std::map<std::string, std::pair<FDateTime, carla::rpc::FileInfo>> FileInfoCache;
+
+  /// Hash of the OpenDRIVE of the episode MapDataEpisodeId.
+  carla::rpc::FileInfo MapDataInfo;
+
+  uint64 MapDataEpisodeId = 0u;
 };
 
+// =============================================================================
+// -- FCarlaServer::FPimpl shared files ----------------------------------------
+// =============================================================================
+
+/// Maximum size of the chunks sent by request_file_chunk.
+static constexpr uint64_t MaxFileChunkSize = 16u * 1024u * 1024u;
+
+std::vector<std::string> FCarlaServer::FPimpl::FindRequiredFiles(std::string folder) const
+{
+  // Check that the path ends in a slash, add it otherwise
+  if (folder.empty() || (folder[folder.size() - 1] != '/' && folder[folder.size() - 1] != '\\')) {
+    folder += "/";
+  }
+
+  // Get the map's folder absolute path and check if it's in its own folder
+  ACarlaGameModeBase* GameMode = UCarlaStatics::GetGameMode(Episode->GetWorld());
+  const auto mapDir = GameMode->GetFullMapPath();
+  const auto folderDir = mapDir + "/" + folder.c_str();
+  const auto fileName = mapDir.EndsWith(Episode->GetMapName()) ? "*" : Episode->GetMapName();
+
+  // Find all the xodr and bin files from the map
+  TArray<FString> Files;
+  IFileManager::Get().FindFilesRecursive(Files, *folderDir, *(fileName + ".xodr"), true, false, false);
+  IFileManager::Get().FindFilesRecursive(Files, *folderDir, *(fileName + ".bin"), true, false, false);
+
+  // Remove the start of the path until the content folder and put each file in the result
+  std::vector<std::string> result;
+  for (auto File : Files) {
+    File.RemoveFromStart(FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir()));
+    result.emplace_back(TCHAR_TO_UTF8(*File));
+  }
+
+  return result;
+}
+
+carla::rpc::FileInfo FCarlaServer::FPimpl::GetFileInfo(const std::string &Name)
+{
+  FString Path(FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir()));
+  Path.Append(Name.c_str());
+
+  const FDateTime TimeStamp = IFileManager::Get().GetTimeStamp(*Path);
+  auto &Entry = FileInfoCache[Name];
+  if (Entry.second.name.empty() || Entry.first != TimeStamp)
+  {
+    TArray<uint8> Content;
+    FFileHelper::LoadFileToArray(Content, *Path, 0);
+    Entry.first = TimeStamp;
+    Entry.second.name = Name;
+    Entry.second.size = static_cast<uint64_t>(Content.Num());
+    Entry.second.hash = carla::ContentHash::Compute(Content.GetData(), Content.Num());
+  }
+  return Entry.second;
+}
+
 // =============================================================================
 // -- Define helper macros -----------------------------------------------------
 // =============================================================================
@@ -469,6 +545,21 @@ void FCarlaServer::FPimpl::BindActions()
     return cr::FromLongFString(UOpenDrive::GetXODR(Episode->GetWorld()));
   };
 
+  BIND_SYNC(get_map_data_info) << [this]() -> R<cr::FileInfo>
+  {
+    REQUIRE_CARLA_EPISODE();
+    // The OpenDRIVE does not change during an episode, hash it only once
+    if (MapDataInfo.hash.empty() || MapDataEpisodeId != Episode->GetId())
+    {
+      const std::string MapData = cr::FromLongFString(UOpenDrive::GetXODR(Episode->GetWorld()));
+      MapDataInfo.name = TCHAR_TO_UTF8(*Episode->GetMapName());
+      MapDataInfo.size = MapData.size();
+      MapDataInfo.hash = carla::ContentHash::Compute(MapData.data(), MapData.size());
+      MapDataEpisodeId = Episode->GetId();
+    }
+    return MapDataInfo;
+  };
+
   BIND_SYNC(get_navigation_mesh) << [this]() -> R<std::vector<uint8_t>>
   {
     REQUIRE_CARLA_EPISODE();
@@ -482,32 +573,20 @@ void FCarlaServer::FPimpl::BindActions()
   BIND_SYNC(get_required_files) << [this](std::string folder = "") -> R<std::vector<std::string>>
   {
     REQUIRE_CARLA_EPISODE();
+    return FindRequiredFiles(folder);
+  };
 
-    // Check that the path ends in a slash, add it otherwise
-    if (folder[folder.size() - 1] != '/' && folder[folder.size() - 1] != '\\') {
-      folder += "/";
-    }
-
-    // Get the map's folder absolute path and check if it's in its own folder
-    ACarlaGameModeBase* GameMode = UCarlaStatics::GetGameMode(Episode->GetWorld());
-    const auto mapDir = GameMode->GetFullMapPath();
-    const auto folderDir = mapDir + "/" + folder.c_str();
-    const auto fileName = mapDir.EndsWith(Episode->GetMapName()) ? "*" : Episode->GetMapName();
-
-    // Find all the xodr and bin files from the map
-    TArray<FString> Files;
-    IFileManager::Get().FindFilesRecursive(Files, *folderDir, *(fileName + ".xodr"), true, false, false);
-    IFileManager::Get().FindFilesRecursive(Files, *folderDir, *(fileName + ".bin"), true, false, false);
-
-    // Remove the start of the path until the content folder and put each file in the result
-    std::vector<std::string> result;
-    for (auto File : Files) {
-      File.RemoveFromStart(FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir()));
-      result.emplace_back(TCHAR_TO_UTF8(*File));
+  BIND_SYNC(get_required_files_info) << [this](std::string folder = "") -> R<std::vector<cr::FileInfo>>
+  {
+    REQUIRE_CARLA_EPISODE();
+    std::vector<cr::FileInfo> Result;
+    for (const auto &File : FindRequiredFiles(folder))
+    {
+      Result.emplace_back(GetFileInfo(File));
     }
-
-    return result;
+    return Result;
   };
+
   BIND_SYNC(request_file) << [this](std::string name) -> R<std::vector<uint8_t>>
   {
     REQUIRE_CARLA_EPISODE();
@@ -525,6 +604,37 @@ void FCarlaServer::FPimpl::BindActions()
     return Result;
   };
 
+  BIND_SYNC(request_file_chunk) << [this](
+      std::string name,
+      uint64_t offset,
+      uint64_t size) -> R<std::vector<uint8_t>>
+  {
+    REQUIRE_CARLA_EPISODE();
+
+    // Get the absolute path of the file
+    FString path(FPaths::ConvertRelativePathToFull(FPaths::ProjectContentDir()));
+    path.Append(name.c_str());
+
+    // Read only the requested part of the file
+    TUniquePtr<IFileHandle> File(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*path));
+    if (!File.IsValid())
+    {
+      RESPOND_ERROR("unable to open the requested file");
+    }
+    const uint64_t FileSize = static_cast<uint64_t>(File->Size());
+    if (offset > FileSize)
+    {
+      RESPOND_ERROR("offset past the end of the requested file");
+    }
+    std::vector<uint8_t> Result(std::min({size, MaxFileChunkSize, FileSize - offset}));
+    if (!Result.empty() &&
+        (!File->Seek(static_cast<int64>(offset)) || !File->Read(Result.data(), Result.size())))
+    {
+      RESPOND_ERROR("unable to read the requested file");
+    }
+    return Result;
+  };
+
   BIND_SYNC(get_episode_settings) << [this]() -> R<cr::EpisodeSettings>
   {
     REQUIRE_CARLA_EPISODE();
@@ -2332,6 +2442,46 @@ void FCarlaServer::FPimpl::BindActions()
     return result;
   };
 
+  BIND_SYNC(apply_vehicle_control_batch) << [=](
+      const cr::VehicleControlBatch &Batch,
+      bool do_tick_cue) -> R<void>
+  {
+    REQUIRE_CARLA_EPISODE();
+    uint32 NotApplied = 0u;
+    for (size_t i = 0u; i < Batch.GetNumberOfControls(); ++i)
+    {
+      FCarlaActor* CarlaActor = Episode->FindCarlaActor(Batch.GetControlActor(i));
+      if (!CarlaActor ||
+          CarlaActor->ApplyControlToVehicle(Batch.GetControl(i), EVehicleInputPriority::Client) !=
+              ECarlaServerResponse::Success)
+      {
+        ++NotApplied;
+      }
+    }
+    for (size_t i = 0u; i < Batch.GetNumberOfTransforms(); ++i)
+    {
+      FCarlaActor* CarlaActor = Episode->FindCarlaActor(Batch.GetTransformActor(i));
+      if (!CarlaActor)
+      {
+        ++NotApplied;
+        continue;
+      }
+      CarlaActor->SetActorGlobalTransform(
+          Batch.GetTransform(i), ETeleportType::TeleportPhysics);
+    }
+    if (NotApplied > 0u)
+    {
+      UE_LOG(LogCarlaServer, Verbose,
+          TEXT("apply_vehicle_control_batch: %u vehicles not found or not controllable"),
+          NotApplied);
+    }
+    if (do_tick_cue)
+    {
+      tick_cue();
+    }
+    return R<void>::Success();
+  };
+
   // ~~ Light Subsystem ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
   BIND_SYNC(query_lights_state) << [this](std::string client) -> R<std::vector<cr::LightState>>
@@ -69,6 +69,10 @@ check.PythonAPI.3: PythonAPI.3
 benchmark: LibCarla.release
 	@${CARLA_BUILD_TOOLS_FOLDER}/Check.sh --benchmark $(ARGS)
 	@cat profiler.csv
+	@cat benchmark_road.csv
+
+benchmark.TrafficManager: LibCarla.client.release
+	@${LIBCARLA_INSTALL_CLIENT_FOLDER}/test/libcarla_benchmark_tm $(ARGS)
 
 smoke_tests:
 	@${CARLA_BUILD_TOOLS_FOLDER}/Check.sh --smoke $(ARGS)